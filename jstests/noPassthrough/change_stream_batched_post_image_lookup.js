@@ -0,0 +1,75 @@
+/*
+ * Tests that a change stream with fullDocument: "updateLookup" looks up the post-images of
+ * consecutive update events together, and still returns the current version of each document, or
+ * null for the documents deleted since.
+ * @tags: [
+ *   uses_change_streams,
+ *   requires_majority_read_concern,
+ *   requires_replication,
+ * ]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({nodes: 1});
+rst.startSet();
+rst.initiate();
+
+const db = rst.getPrimary().getDB("test");
+const coll = db.coll;
+const numDocs = 20;
+
+function postImageLookupMetrics() {
+    return db.serverStatus().metrics.changeStreams.postImageLookup;
+}
+
+function assertNextUpdates(cursor, expectedFullDocuments) {
+    for (let expected of expectedFullDocuments) {
+        assert.soon(() => cursor.hasNext());
+        const event = cursor.next();
+        assert.eq(event.operationType, "update", event);
+        assert.eq(event.fullDocument, expected, event);
+    }
+}
+
+for (let id = 0; id < numDocs; ++id) {
+    assert.commandWorked(coll.insert({_id: id, x: 0}));
+}
+
+let stream = coll.watch([], {fullDocument: "updateLookup"});
+const before = postImageLookupMetrics();
+
+// Update every document twice, then delete one of them before the events are returned.
+const expected = [];
+for (let round = 1; round <= 2; ++round) {
+    for (let id = 0; id < numDocs; ++id) {
+        assert.commandWorked(coll.update({_id: id}, {$set: {x: round}}));
+        expected.push(id === 0 ? null : {_id: id, x: 2});
+    }
+}
+assert.commandWorked(coll.remove({_id: 0}));
+
+// The updates are in the oplog before the stream reads any of them, so their post-images are
+// looked up together.
+assertNextUpdates(stream, expected);
+let after = postImageLookupMetrics();
+assert.eq(after.events - before.events, 2 * numDocs, tojson(after));
+assert.lt(after.lookups - before.lookups, 2 * numDocs, tojson(after));
+stream.close();
+
+// With a batch size of 1 each post-image is looked up separately.
+assert.commandWorked(
+    db.adminCommand({setParameter: 1, internalChangeStreamPostImageLookupBatchSize: 1}));
+stream = coll.watch([], {fullDocument: "updateLookup"});
+const unbatchedBefore = postImageLookupMetrics();
+for (let id = 1; id < numDocs; ++id) {
+    assert.commandWorked(coll.update({_id: id}, {$set: {x: 3}}));
+}
+assertNextUpdates(stream, Array.from({length: numDocs - 1}, (_, i) => ({_id: i + 1, x: 3})));
+after = postImageLookupMetrics();
+assert.eq(after.events - unbatchedBefore.events, numDocs - 1, tojson(after));
+assert.eq(after.lookups - unbatchedBefore.lookups, numDocs - 1, tojson(after));
+stream.close();
+
+rst.stopSet();
+})();
@@ -0,0 +1,93 @@
+/*
+ * Tests that change streams return the same events when they take the oplog entries from the
+ * reader shared by all of them, which internalChangeStreamUseSharedOplogReader enables, including
+ * when they resume from before the entries the reader has cached.
+ * @tags: [
+ *   uses_change_streams,
+ *   requires_majority_read_concern,
+ *   requires_replication,
+ * ]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest(
+    {nodes: 1, nodeOptions: {setParameter: {internalChangeStreamUseSharedOplogReader: true}}});
+rst.startSet();
+rst.initiate();
+
+const db = rst.getPrimary().getDB("test");
+const numColls = 5;
+const numDocs = 20;
+
+function sharedOplogReaderMetrics() {
+    return db.serverStatus().metrics.changeStreams.sharedOplogReader;
+}
+
+function assertNextInserts(cursor, ids) {
+    for (let id of ids) {
+        assert.soon(() => cursor.hasNext());
+        const event = cursor.next();
+        assert.eq(event.operationType, "insert", event);
+        assert.eq(event.documentKey._id, id, event);
+    }
+}
+
+// Writes made before the streams are opened are read from the oplog directly when resuming.
+assert.commandWorked(db.coll_0.insert({_id: -1}));
+const resumeToken = db.coll_0.watch().getResumeToken();
+assert.commandWorked(db.coll_0.insert({_id: -2}));
+
+const streams = [];
+for (let i = 0; i < numColls; ++i) {
+    streams.push(db.getCollection("coll_" + i).watch());
+}
+
+const before = sharedOplogReaderMetrics();
+const expectedIds = [];
+for (let id = 0; id < numDocs; ++id) {
+    for (let i = 0; i < numColls; ++i) {
+        assert.commandWorked(db.getCollection("coll_" + i).insert({_id: id}));
+    }
+    expectedIds.push(id);
+}
+
+// Each stream only sees the writes to its own collection, in order.
+for (let i = 0; i < numColls; ++i) {
+    assertNextInserts(streams[i], expectedIds);
+    assert(!streams[i].hasNext());
+}
+
+const resumed = db.coll_0.watch([], {resumeAfter: resumeToken});
+assertNextInserts(resumed, [-2].concat(expectedIds));
+
+// A stream on the whole database sees the writes to every collection.
+const wholeDbStream = db.watch([], {resumeAfter: resumeToken});
+assertNextInserts(wholeDbStream, [-2]);
+for (let id = 0; id < numDocs; ++id) {
+    for (let i = 0; i < numColls; ++i) {
+        assert.soon(() => wholeDbStream.hasNext());
+        const event = wholeDbStream.next();
+        assert.eq(event.ns.coll, "coll_" + i, event);
+        assert.eq(event.documentKey._id, id, event);
+    }
+}
+
+const after = sharedOplogReaderMetrics();
+assert.gte(after.entriesRead - before.entriesRead, numColls * numDocs, tojson(after));
+assert.gt(after.entriesFromCache, before.entriesFromCache, tojson(after));
+assert.gt(after.entriesReadDirectly, 0, tojson(after));
+
+for (let stream of streams.concat([resumed, wholeDbStream])) {
+    stream.close();
+}
+
+// Disabling the shared reader at runtime only affects the streams opened afterwards.
+assert.commandWorked(
+    db.adminCommand({setParameter: 1, internalChangeStreamUseSharedOplogReader: false}));
+const unsharedStream = db.coll_0.watch([], {resumeAfter: resumeToken});
+assertNextInserts(unsharedStream, [-2].concat(expectedIds));
+unsharedStream.close();
+
+rst.stopSet();
+})();
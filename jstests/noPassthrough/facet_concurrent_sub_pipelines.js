@@ -0,0 +1,73 @@
+/*
+ * Tests that $facet returns the same results whether its sub-pipelines run one after the other or
+ * concurrently, and that the results of concurrent sub-pipelines together are limited in size.
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod({setParameter: {internalQueryFacetBufferSizeBytes: 4 * 1024}});
+const db = conn.getDB("test");
+const coll = db.facet_concurrent_sub_pipelines;
+const foreignColl = db.facet_concurrent_sub_pipelines_foreign;
+
+const numDocs = 1000;
+const docs = [];
+for (let i = 0; i < numDocs; ++i) {
+    docs.push({_id: i, x: i % 10, y: i, s: "a".repeat(i % 50)});
+}
+assert.commandWorked(coll.insert(docs));
+assert.commandWorked(foreignColl.insert([{_id: 0, name: "zero"}, {_id: 1, name: "one"}]));
+
+const facet = {
+    count: [{$count: "n"}],
+    byX: [{$group: {_id: "$x", total: {$sum: "$y"}}}, {$sort: {_id: 1}}],
+    top: [{$sort: {y: -1}}, {$limit: 3}, {$project: {_id: 1}}],
+    first: [{$limit: 2}],
+    computed: [
+        {$match: {x: 7}},
+        {$project: {_id: 0, z: {$let: {vars: {v: "$y"}, in: {$add: ["$$v", 1]}}}}}
+    ],
+    lengths: [{$bucket: {groupBy: {$strLenCP: "$s"}, boundaries: [0, 10, 25, 50]}}],
+};
+const lookupFacet = Object.assign({
+    joined: [
+        {$match: {_id: {$lt: 2}}},
+        {$lookup: {from: foreignColl.getName(), localField: "_id", foreignField: "_id", as: "j"}}
+    ]
+},
+                                  facet);
+
+function setMaxConcurrentBranches(value) {
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryFacetMaxConcurrentBranches: value}));
+}
+
+setMaxConcurrentBranches(1);
+const expected = coll.aggregate([{$facet: facet}]).toArray();
+const expectedWithLookup = coll.aggregate([{$facet: lookupFacet}]).toArray();
+assert.eq(expected[0].count, [{n: numDocs}]);
+
+// Sub-pipelines run concurrently, and those which read other collections make the $facet fall back
+// to running them one after the other.
+for (let maxConcurrentBranches of [2, 8]) {
+    setMaxConcurrentBranches(maxConcurrentBranches);
+    assert.eq(coll.aggregate([{$facet: facet}]).toArray(), expected);
+    assert.eq(coll.aggregate([{$facet: lookupFacet}]).toArray(), expectedWithLookup);
+}
+
+// The results of all the sub-pipelines together must fit within the limit when they run
+// concurrently. Running them one after the other is not limited.
+assert.commandWorked(
+    db.adminCommand({setParameter: 1, internalQueryFacetMaxOutputDocSizeBytes: 64 * 1024}));
+const bothFacets = {
+    aggregate: coll.getName(),
+    pipeline: [{$facet: {a: [], b: []}}],
+    cursor: {},
+};
+setMaxConcurrentBranches(4);
+assert.commandFailedWithCode(db.runCommand(bothFacets), 4918035);
+setMaxConcurrentBranches(1);
+assert.commandWorked(db.runCommand(bothFacets));
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,104 @@
+// Tests that getMore prepares the next batch of a find cursor ahead of time when
+// getMoreReadAheadEnabled is set, that the cursor returns the same documents either way, and that
+// the read-ahead is accounted for in the "metrics.getMore.readAhead" serverStatus section.
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod({setParameter: {getMoreReadAheadEnabled: true}});
+const db = conn.getDB("test");
+const coll = db.getmore_read_ahead;
+
+const numDocs = 1000;
+const docs = [];
+for (let i = 0; i < numDocs; ++i) {
+    docs.push({_id: i, padding: "x".repeat(100)});
+}
+assert.commandWorked(coll.insert(docs));
+
+function readAheadMetrics() {
+    return db.serverStatus().metrics.getMore.readAhead;
+}
+
+function drainCursor(findCmd, getMoreBatchSize) {
+    let res = assert.commandWorked(db.runCommand(findCmd));
+    const ids = res.cursor.firstBatch.map((doc) => doc._id);
+    while (res.cursor.id != 0) {
+        // Give the read-ahead time to finish, as a client processing the batch would.
+        sleep(10);
+        res = assert.commandWorked(db.runCommand(
+            {getMore: res.cursor.id, collection: coll.getName(), batchSize: getMoreBatchSize}));
+        ids.push(...res.cursor.nextBatch.map((doc) => doc._id));
+    }
+    return ids;
+}
+
+const expectedIds = [...Array(numDocs).keys()];
+let before = readAheadMetrics();
+assert.eq(drainCursor({find: coll.getName(), sort: {_id: 1}, batchSize: 10}, 100), expectedIds);
+let after = readAheadMetrics();
+assert.gt(after.scheduled, before.scheduled, tojson(after));
+assert.gt(after.hits + after.waits, before.hits + before.waits, tojson(after));
+assert.eq(after.failed, before.failed, tojson(after));
+
+// getMores asking for fewer documents than were read ahead are served from the prepared ones.
+assert.eq(drainCursor({find: coll.getName(), sort: {_id: 1}, batchSize: 10}, 7), expectedIds);
+
+// Cursors with a maxTimeMS are not read ahead.
+before = readAheadMetrics();
+assert.eq(drainCursor({find: coll.getName(), sort: {_id: 1}, batchSize: 10, maxTimeMS: 60 * 1000},
+                      100),
+          expectedIds);
+after = readAheadMetrics();
+assert.eq(after.scheduled, before.scheduled, tojson(after));
+
+// A cursor whose next batch is being read ahead can still be killed.
+let res = assert.commandWorked(db.runCommand({find: coll.getName(), batchSize: 10}));
+const cursorId = res.cursor.id;
+assert.commandWorked(
+    db.runCommand({getMore: cursorId, collection: coll.getName(), batchSize: 10}));
+assert.commandWorked(db.runCommand({killCursors: coll.getName(), cursors: [cursorId]}));
+assert.commandFailedWithCode(
+    db.runCommand({getMore: cursorId, collection: coll.getName(), batchSize: 10}),
+    ErrorCodes.CursorNotFound);
+
+// A getMore from another session is rejected before it looks at the read-ahead, which leaves the
+// prepared batch to the session owning the cursor.
+const session = conn.startSession();
+const otherSession = conn.startSession();
+const sessionDb = session.getDatabase("test");
+res = assert.commandWorked(
+    sessionDb.runCommand({find: coll.getName(), sort: {_id: 1}, batchSize: 10}));
+const sessionIds = res.cursor.firstBatch.map((doc) => doc._id);
+res = assert.commandWorked(sessionDb.runCommand(
+    {getMore: res.cursor.id, collection: coll.getName(), batchSize: 100}));
+sessionIds.push(...res.cursor.nextBatch.map((doc) => doc._id));
+assert.commandFailedWithCode(
+    otherSession.getDatabase("test").runCommand(
+        {getMore: res.cursor.id, collection: coll.getName(), batchSize: 100}),
+    50738);
+while (res.cursor.id != 0) {
+    res = assert.commandWorked(sessionDb.runCommand(
+        {getMore: res.cursor.id, collection: coll.getName(), batchSize: 100}));
+    sessionIds.push(...res.cursor.nextBatch.map((doc) => doc._id));
+}
+assert.eq(sessionIds, expectedIds);
+session.endSession();
+otherSession.endSession();
+
+// No read-ahead starts when there is no room left for its documents.
+assert.commandWorked(db.adminCommand({setParameter: 1, getMoreReadAheadMaxBufferedBytes: 0}));
+before = readAheadMetrics();
+assert.eq(drainCursor({find: coll.getName(), sort: {_id: 1}, batchSize: 10}, 100), expectedIds);
+after = readAheadMetrics();
+assert.eq(after.scheduled, before.scheduled, tojson(after));
+assert.gt(after.skipped, before.skipped, tojson(after));
+
+// Disabling read-ahead takes effect immediately.
+assert.commandWorked(db.adminCommand(
+    {setParameter: 1, getMoreReadAheadEnabled: false, getMoreReadAheadMaxBufferedBytes: 1 << 30}));
+before = readAheadMetrics();
+assert.eq(drainCursor({find: coll.getName(), sort: {_id: 1}, batchSize: 10}, 100), expectedIds);
+assert.eq(readAheadMetrics().scheduled, before.scheduled);
+
+MongoRunner.stopMongod(conn);
+})();
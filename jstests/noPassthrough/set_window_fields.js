@@ -0,0 +1,91 @@
+/*
+ * Tests that $setWindowFields computes window functions over sliding windows of each partition, and
+ * that it spills the documents of large windows to disk when allowed to.
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod();
+const db = conn.getDB("test");
+const coll = db.set_window_fields;
+
+const numDocs = 200;
+const docs = [];
+for (let i = 0; i < numDocs; ++i) {
+    docs.push({_id: i, sensor: i % 2, t: Math.floor(i / 2), x: i, padding: "a".repeat(1000)});
+}
+assert.commandWorked(coll.insert(docs));
+
+const pipeline = [
+    {
+        $setWindowFields: {
+            partitionBy: "$sensor",
+            sortBy: {t: 1},
+            output: {
+                runningSum: {$sum: "$x", window: {documents: ["unbounded", "current"]}},
+                movingAvg: {$avg: "$x", window: {documents: [-2, "current"]}},
+                movingMax: {$max: "$x", window: {documents: [-1, 1]}},
+                total: {$sum: "$x"},
+                rank: {$rank: {}},
+            }
+        }
+    },
+    {$project: {padding: 0}}
+];
+
+function checkResults(results) {
+    assert.eq(results.length, numDocs, results);
+    for (let sensor = 0; sensor < 2; ++sensor) {
+        const partition = results.filter(doc => doc.sensor === sensor);
+        const xs = partition.map(doc => doc.x);
+        const total = xs.reduce((a, b) => a + b, 0);
+        let runningSum = 0;
+        partition.forEach((doc, i) => {
+            assert.eq(doc.t, i, doc);
+            runningSum += doc.x;
+            assert.eq(doc.runningSum, runningSum, doc);
+
+            const window = xs.slice(Math.max(i - 2, 0), i + 1);
+            assert.eq(doc.movingAvg, window.reduce((a, b) => a + b, 0) / window.length, doc);
+            assert.eq(doc.movingMax, Math.max(...xs.slice(Math.max(i - 1, 0), i + 2)), doc);
+            assert.eq(doc.total, total, doc);
+            assert.eq(doc.rank, i + 1, doc);
+        });
+    }
+}
+
+checkResults(coll.aggregate(pipeline).toArray());
+
+// Windows which do not fit in memory are spilled to disk, when allowed.
+assert.commandWorked(db.adminCommand(
+    {setParameter: 1, internalDocumentSourceSetWindowFieldsMaxMemoryBytes: 16 * 1024}));
+checkResults(coll.aggregate(pipeline, {allowDiskUse: true}).toArray());
+assert.commandFailedWithCode(
+    db.runCommand(
+        {aggregate: coll.getName(), pipeline: pipeline, cursor: {}, allowDiskUse: false}),
+    ErrorCodes.QueryExceededMemoryLimitNoDiskUseAllowed);
+
+// Only the documents of the current window are held, so bounded windows need no disk.
+assert.eq(numDocs,
+          coll.aggregate(
+                  [
+                      {
+                          $setWindowFields: {
+                              partitionBy: "$sensor",
+                              sortBy: {t: 1},
+                              output: {movingSum: {$sum: "$x", window: {documents: [-1, 1]}}}
+                          }
+                      },
+                  ],
+                  {allowDiskUse: false})
+              .itcount());
+
+assert.commandFailedWithCode(db.runCommand({
+    aggregate: coll.getName(),
+    pipeline: [{$setWindowFields: {output: {rank: {$rank: {}}}}}],
+    cursor: {}
+}),
+                             4918033);
+
+MongoRunner.stopMongod(conn);
+})();
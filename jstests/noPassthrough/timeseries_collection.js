@@ -0,0 +1,108 @@
+/*
+ * Tests that a time-series collection stores its measurements in buckets, returns them unpacked
+ * and filters them with predicates on the time, metadata and measurement fields.
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod({setParameter: {timeseriesBucketMaxCount: 10}});
+const db = conn.getDB("test");
+const coll = db.weather;
+const bucketsColl = db.getCollection("system.buckets." + coll.getName());
+
+assert.commandWorked(
+    db.createCollection(coll.getName(), {timeseries: {timeField: "time", metaField: "sensor"}}));
+assert.commandFailedWithCode(db.createCollection(coll.getName(), {timeseries: {timeField: "time"}}),
+                             ErrorCodes.NamespaceExists);
+assert.commandFailedWithCode(
+    db.createCollection("bad", {timeseries: {timeField: "time", metaField: "time"}}),
+    ErrorCodes.InvalidOptions);
+assert.commandFailedWithCode(
+    db.createCollection("bad", {timeseries: {timeField: "time"}, capped: true, size: 1024}),
+    ErrorCodes.InvalidOptions);
+
+const start = ISODate("2020-09-01T00:00:00Z");
+const numMeasurements = 100;
+const measurements = [];
+for (let i = 0; i < numMeasurements; ++i) {
+    // The metadata comes last, which is where the unpacked measurements have it.
+    measurements.push({
+        _id: i,
+        time: new Date(start.getTime() + i * 1000),
+        temp: i % 10 === 0 ? "error" : i,
+        sensor: {id: i % 2},
+    });
+}
+assert.commandWorked(coll.insert(measurements.slice(0, 50), {ordered: true}));
+assert.commandWorked(coll.insert(measurements.slice(50), {ordered: false}));
+
+// Each sensor has its own buckets, which hold at most 10 measurements.
+assert.eq(numMeasurements / 10, bucketsColl.count());
+bucketsColl.find().forEach(bucket => {
+    assert.eq(1, bucket.control.version, tojson(bucket));
+    assert.lte(bucket.control.min.time, bucket.control.max.time, tojson(bucket));
+    assert.eq(bucket.meta, {id: bucket.data._id["0"] % 2}, tojson(bucket));
+});
+
+function assertFind(filter, predicate) {
+    const expected = measurements.filter(predicate);
+    const actual = coll.find(filter).sort({_id: 1}).toArray();
+    assert.eq(expected, actual, tojson(filter));
+}
+
+assertFind({}, m => true);
+assertFind({sensor: {id: 1}}, m => m.sensor.id === 1);
+assertFind({"sensor.id": 0}, m => m.sensor.id === 0);
+assertFind({time: {$gte: new Date(start.getTime() + 90 * 1000)}},
+           m => m.time >= start.getTime() + 90 * 1000);
+assertFind({temp: {$gt: 95}}, m => typeof m.temp === "number" && m.temp > 95);
+assertFind({temp: "error"}, m => m.temp === "error");
+assertFind({$and: [{"sensor.id": 1}, {temp: {$lt: 5}}]},
+           m => m.sensor.id === 1 && typeof m.temp === "number" && m.temp < 5);
+
+// The predicates on the time field and the metadata are also applied to the buckets.
+const explain = coll.explain().aggregate([{$match: {"sensor.id": 1}}]);
+assert(JSON.stringify(explain).includes('"meta.id"'), tojson(explain));
+
+assert.eq([{_id: 1, count: 50}],
+          coll.aggregate([{$group: {_id: "$sensor.id", count: {$sum: 1}}}, {$match: {_id: 1}}])
+              .toArray());
+
+// Invalid measurements are rejected one by one.
+const res = coll.insert([{time: "now"}, {time: new Date(), "a.b": 1}, {time: new Date()}],
+                        {ordered: false});
+assert.eq(1, res.nInserted, tojson(res));
+assert.eq(2, res.getWriteErrors().length, tojson(res));
+
+// An ordered insert stops at the first measurement which could not be written, even if a later
+// measurement goes to a bucket which was written before the failure.
+const orderedMeasurements = [
+    {_id: "a0", time: start, sensor: {id: 2}},
+    {_id: "b0", time: start, sensor: {id: 3}},
+    {_id: "a1", time: start, sensor: {id: 2}},
+];
+assert.commandWorked(db.adminCommand({configureFailPoint: "failAllUpdates", mode: {skip: 1}}));
+const orderedRes = coll.insert(orderedMeasurements, {ordered: true});
+assert.commandWorked(db.adminCommand({configureFailPoint: "failAllUpdates", mode: "off"}));
+assert.eq(1, orderedRes.nInserted, tojson(orderedRes));
+assert.eq(1, orderedRes.getWriteErrors().length, tojson(orderedRes));
+assert.eq(1, orderedRes.getWriteErrors()[0].index, tojson(orderedRes));
+assert.eq([orderedMeasurements[0]],
+          coll.find({"sensor.id": {$in: [2, 3]}}).sort({_id: 1}).toArray());
+
+// The buckets of the failed and unapplied updates are forgotten, so inserting the measurements
+// again fills every bucket from its first position on.
+assert.commandWorked(coll.insert(orderedMeasurements.slice(1), {ordered: true}));
+assert.eq(orderedMeasurements,
+          coll.find({"sensor.id": {$in: [2, 3]}}).sort({_id: 1}).toArray());
+bucketsColl.find({"meta.id": {$in: [2, 3]}}).forEach(bucket => {
+    const positions = Object.keys(bucket.data._id);
+    assert.eq(positions, positions.map((_, i) => String(i)), tojson(bucket));
+});
+
+// Dropping the time-series collection drops its buckets.
+assert(coll.drop());
+assert.eq(0, db.getCollectionNames().filter(name => name.includes("weather")).length);
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,57 @@
+// Tests that the TTL monitor deletes expired documents in batches from several TTL indexes
+// concurrently, honors ttlMonitorMaxDeletesPerSecond, and reports its per-index progress in the
+// "ttl" serverStatus section.
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod({
+    setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorBatchSize: 7, ttlMonitorWorkerThreads: 2}
+});
+const db = conn.getDB("test");
+
+const numDocs = 100;
+const past = new Date(Date.now() - 60 * 60 * 1000);
+for (let i = 0; i < 3; ++i) {
+    const coll = db["ttl_batched_deletes_" + i];
+    assert.commandWorked(coll.createIndex({x: 1}, {expireAfterSeconds: 0}));
+
+    const docs = [];
+    for (let j = 0; j < numDocs; ++j) {
+        // Half of the documents expire, some of them through an array of dates.
+        docs.push({x: j % 2 ? [past, past] : new Date(Date.now() + 60 * 60 * 1000)});
+    }
+    assert.commandWorked(coll.insert(docs));
+}
+
+assert.soon(function() {
+    for (let i = 0; i < 3; ++i) {
+        if (db["ttl_batched_deletes_" + i].count() != numDocs / 2) {
+            return false;
+        }
+    }
+    return true;
+}, "TTL monitor didn't delete the expired documents");
+
+assert.soon(function() {
+    const indexes = db.serverStatus({ttl: 1}).ttl.indexes;
+    return indexes.length == 3 && indexes.every((index) => index.lastPassDeleted == 0 &&
+                                                     index.lagMillis == 0 &&
+                                                     index.name == "x_1");
+}, () => tojson(db.serverStatus({ttl: 1}).ttl));
+
+// With a budget of 10 deletes per second, deleting 50 documents takes several seconds.
+assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorMaxDeletesPerSecond: 10}));
+const coll = db.ttl_budget;
+assert.commandWorked(coll.createIndex({x: 1}, {expireAfterSeconds: 0}));
+const docs = [];
+for (let j = 0; j < 50; ++j) {
+    docs.push({x: past});
+}
+assert.commandWorked(coll.insert(docs));
+
+const start = Date.now();
+assert.soon(() => coll.count() == 0, "TTL monitor didn't delete the expired documents");
+assert.gte(Date.now() - start, 3 * 1000);
+
+MongoRunner.stopMongod(conn);
+})();
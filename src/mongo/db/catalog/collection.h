@@ -471,6 +471,12 @@ public:
     virtual bool getRecordPreImages() const = 0;
     virtual void setRecordPreImages(OperationContext* opCtx, bool val) = 0;
 
+    /**
+     * Returns true if the documents of this collection are stored keyed by their _id, which then
+     * has no separate index. See clusteredkey::keyForId() for how an _id maps to its RecordId.
+     */
+    virtual bool isClustered() const = 0;
+
     /**
      * Returns true if this is a temporary collection.
      *
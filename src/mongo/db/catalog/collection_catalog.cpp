@@ -32,6 +32,8 @@
 
 #include "collection_catalog.h"
 
+#include <absl/hash/hash.h>
+
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/uncommitted_collections.h"
 #include "mongo/db/concurrency/lock_manager_defs.h"
@@ -39,6 +41,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/uuid.h"
 
@@ -68,8 +71,148 @@ private:
     CollectionUUID _uuid;
 };
 
+/**
+ * Spreads the threads reading the catalog over the reader stripes.
+ */
+size_t getReaderStripe(size_t numStripes) {
+    static AtomicWord<size_t> nextStripe{0};
+    thread_local const size_t stripe = nextStripe.fetchAndAdd(1);
+    return stripe % numStripes;
+}
+
 }  // namespace
 
+/**
+ * Registers the calling thread as a reader of the snapshot partitions of the catalog for its
+ * lifetime. The snapshot partitions loaded within a ReadSection are not freed before it ends.
+ *
+ * Registering never waits for writers: a reader only retries when a writer flips the phase between
+ * the reader loading the phase and registering in it, and a writer flips it once per DDL operation.
+ */
+class CollectionCatalog::ReadSection {
+    ReadSection(const ReadSection&) = delete;
+    ReadSection& operator=(const ReadSection&) = delete;
+
+public:
+    explicit ReadSection(const CollectionCatalog& catalog) {
+        const auto stripe = getReaderStripe(kNumReaderStripes);
+        while (true) {
+            const auto phase = catalog._readPhase.load();
+            _count = &catalog._activeReaders[(phase % 2) * kNumReaderStripes + stripe];
+            _count->fetchAndAdd(1);
+
+            // A writer which flipped the phase in the meantime may not wait for this reader.
+            if (catalog._readPhase.load() == phase) {
+                return;
+            }
+            _count->fetchAndSubtract(1);
+        }
+    }
+
+    ~ReadSection() {
+        _count->fetchAndSubtract(1);
+    }
+
+private:
+    AtomicWord<long long>* _count;
+};
+
+/**
+ * Applies the changes of a DDL operation to copies of the snapshot partitions they affect, and
+ * publishes the copies all at once when destroyed. Must only be used with '_catalogLock' held.
+ */
+class CollectionCatalog::SnapshotWriter {
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+public:
+    SnapshotWriter(WithLock lk, CollectionCatalog* catalog) : _lk(lk), _catalog(catalog) {}
+
+    ~SnapshotWriter() {
+        std::vector<std::unique_ptr<const UUIDSnapshot>> retiredUUIDSnapshots;
+        for (auto&& [partition, copy] : _uuidCopies) {
+            retiredUUIDSnapshots.emplace_back(
+                _catalog->_uuidSnapshots[partition].swap(copy.release()));
+        }
+
+        std::vector<std::unique_ptr<const NamespaceSnapshot>> retiredNssSnapshots;
+        for (auto&& [partition, copy] : _nssCopies) {
+            retiredNssSnapshots.emplace_back(
+                _catalog->_nssSnapshots[partition].swap(copy.release()));
+        }
+
+        if (!retiredUUIDSnapshots.empty() || !retiredNssSnapshots.empty()) {
+            _catalog->_waitForReaders(_lk);
+        }
+    }
+
+    void add(CollectionUUID uuid, Collection* coll, const NamespaceString& nss) {
+        const bool committed = coll->isCommitted();
+        _uuids(uuid).insert_or_assign(uuid, UUIDEntry{coll, nss, committed});
+        _namespaces(nss).insert_or_assign(nss, NamespaceEntry{coll, uuid, committed});
+    }
+
+    void remove(CollectionUUID uuid, const NamespaceString& nss) {
+        invariant(_uuids(uuid).erase(uuid));
+        invariant(_namespaces(nss).erase(nss));
+    }
+
+    void rename(const NamespaceString& fromNss, const NamespaceString& toNss) {
+        auto& fromPartition = _namespaces(fromNss);
+        auto it = fromPartition.find(fromNss);
+        invariant(it != fromPartition.end());
+        const auto entry = it->second;
+        fromPartition.erase(it);
+
+        _namespaces(toNss).insert_or_assign(toNss, entry);
+
+        auto& uuidPartition = _uuids(entry.uuid);
+        auto uuidIt = uuidPartition.find(entry.uuid);
+        invariant(uuidIt != uuidPartition.end());
+        uuidIt->second.nss = toNss;
+    }
+
+    void setCommitted(CollectionUUID uuid, const NamespaceString& nss, bool committed) {
+        auto& uuidPartition = _uuids(uuid);
+        auto uuidIt = uuidPartition.find(uuid);
+        invariant(uuidIt != uuidPartition.end());
+        uuidIt->second.committed = committed;
+
+        auto& nssPartition = _namespaces(nss);
+        auto nssIt = nssPartition.find(nss);
+        invariant(nssIt != nssPartition.end());
+        nssIt->second.committed = committed;
+    }
+
+private:
+    template <typename Snapshot>
+    static Snapshot& _copy(std::map<size_t, std::unique_ptr<Snapshot>>& copies,
+                           const AtomicWord<const Snapshot*>& published,
+                           size_t partition) {
+        auto& copy = copies[partition];
+        if (!copy) {
+            const auto current = published.load();
+            copy = current ? std::make_unique<Snapshot>(*current) : std::make_unique<Snapshot>();
+        }
+        return *copy;
+    }
+
+    UUIDSnapshot& _uuids(const CollectionUUID& uuid) {
+        const auto partition = _partitionOf(uuid);
+        return _copy(_uuidCopies, _catalog->_uuidSnapshots[partition], partition);
+    }
+
+    NamespaceSnapshot& _namespaces(const NamespaceString& nss) {
+        const auto partition = _partitionOf(nss);
+        return _copy(_nssCopies, _catalog->_nssSnapshots[partition], partition);
+    }
+
+    WithLock _lk;
+    CollectionCatalog* _catalog;
+    std::map<size_t, std::unique_ptr<UUIDSnapshot>> _uuidCopies;
+    std::map<size_t, std::unique_ptr<NamespaceSnapshot>> _nssCopies;
+};
+
 CollectionCatalog::iterator::iterator(StringData dbName,
                                       uint64_t genNum,
                                       const CollectionCatalog& catalog)
@@ -182,6 +325,58 @@ bool CollectionCatalog::iterator::_exhausted() {
     return _mapIter == _catalog->_orderedCollections.end() || _mapIter->first.first != _dbName;
 }
 
+CollectionCatalog::CollectionCatalog() : _activeReaders(2 * kNumReaderStripes) {}
+
+CollectionCatalog::~CollectionCatalog() {
+    for (auto&& snapshot : _uuidSnapshots) {
+        delete snapshot.load();
+    }
+    for (auto&& snapshot : _nssSnapshots) {
+        delete snapshot.load();
+    }
+}
+
+size_t CollectionCatalog::_partitionOf(const CollectionUUID& uuid) {
+    // The maps within a partition use the low bits of the hash, so partition by the high ones.
+    return (CollectionUUID::Hash{}(uuid) >> 24) % kNumSnapshotPartitions;
+}
+
+size_t CollectionCatalog::_partitionOf(const NamespaceString& nss) {
+    return (absl::Hash<NamespaceString>{}(nss) >> 56) % kNumSnapshotPartitions;
+}
+
+void CollectionCatalog::_waitForReaders(WithLock) {
+    // Readers which register from now on are counted in the other phase, and can only load the
+    // partitions published before this call.
+    const auto phase = _readPhase.fetchAndAdd(1);
+    for (size_t stripe = 0; stripe < kNumReaderStripes; ++stripe) {
+        const auto& count = _activeReaders[(phase % 2) * kNumReaderStripes + stripe];
+        while (count.load() != 0) {
+            stdx::this_thread::yield();
+        }
+    }
+}
+
+const CollectionCatalog::UUIDEntry* CollectionCatalog::_findEntry(
+    const ReadSection&, const CollectionUUID& uuid) const {
+    const auto snapshot = _uuidSnapshots[_partitionOf(uuid)].load();
+    if (!snapshot) {
+        return nullptr;
+    }
+    auto it = snapshot->find(uuid);
+    return it == snapshot->end() ? nullptr : &it->second;
+}
+
+const CollectionCatalog::NamespaceEntry* CollectionCatalog::_findEntry(
+    const ReadSection&, const NamespaceString& nss) const {
+    const auto snapshot = _nssSnapshots[_partitionOf(nss)].load();
+    if (!snapshot) {
+        return nullptr;
+    }
+    auto it = snapshot->find(nss);
+    return it == snapshot->end() ? nullptr : &it->second;
+}
+
 CollectionCatalog& CollectionCatalog::get(ServiceContext* svcCtx) {
     return getCatalog(svcCtx);
 }
@@ -203,11 +398,13 @@ void CollectionCatalog::setCollectionNamespace(OperationContext* opCtx,
     // Collection's namespace string under '_catalogLock'.
     invariant(coll);
     stdx::lock_guard<Latch> lock(_catalogLock);
+    SnapshotWriter writer(lock, this);
 
     coll->setNs(toCollection);
 
     _collections[toCollection] = _collections[fromCollection];
     _collections.erase(fromCollection);
+    writer.rename(fromCollection, toCollection);
 
     ResourceId oldRid = ResourceId(RESOURCE_COLLECTION, fromCollection.ns());
     ResourceId newRid = ResourceId(RESOURCE_COLLECTION, toCollection.ns());
@@ -217,10 +414,12 @@ void CollectionCatalog::setCollectionNamespace(OperationContext* opCtx,
 
     opCtx->recoveryUnit()->onRollback([this, coll, fromCollection, toCollection] {
         stdx::lock_guard<Latch> lock(_catalogLock);
+        SnapshotWriter writer(lock, this);
         coll->setNs(std::move(fromCollection));
 
         _collections[fromCollection] = _collections[toCollection];
         _collections.erase(toCollection);
+        writer.rename(toCollection, fromCollection);
 
         ResourceId oldRid = ResourceId(RESOURCE_COLLECTION, fromCollection.ns());
         ResourceId newRid = ResourceId(RESOURCE_COLLECTION, toCollection.ns());
@@ -263,15 +462,17 @@ Collection* CollectionCatalog::lookupCollectionByUUID(OperationContext* opCtx,
         return coll;
     }
 
-    stdx::lock_guard<Latch> lock(_catalogLock);
-    auto coll = _lookupCollectionByUUID(lock, uuid);
-    return (coll && coll->isCommitted()) ? coll : nullptr;
+    ReadSection readSection(*this);
+    auto entry = _findEntry(readSection, uuid);
+    return (entry && entry->committed) ? entry->collection : nullptr;
 }
 
 void CollectionCatalog::makeCollectionVisible(CollectionUUID uuid) {
     stdx::lock_guard<Latch> lock(_catalogLock);
+    SnapshotWriter writer(lock, this);
     auto coll = _lookupCollectionByUUID(lock, uuid);
     coll->setCommitted(true);
+    writer.setCommitted(uuid, coll->ns(), true);
 }
 
 bool CollectionCatalog::isCollectionAwaitingVisibility(CollectionUUID uuid) const {
@@ -291,10 +492,9 @@ Collection* CollectionCatalog::lookupCollectionByNamespace(OperationContext* opC
         return coll;
     }
 
-    stdx::lock_guard<Latch> lock(_catalogLock);
-    auto it = _collections.find(nss);
-    auto coll = (it == _collections.end() ? nullptr : it->second);
-    return (coll && coll->isCommitted()) ? coll : nullptr;
+    ReadSection readSection(*this);
+    auto entry = _findEntry(readSection, nss);
+    return (entry && entry->committed) ? entry->collection : nullptr;
 }
 
 boost::optional<NamespaceString> CollectionCatalog::lookupNSSByUUID(OperationContext* opCtx,
@@ -303,17 +503,18 @@ boost::optional<NamespaceString> CollectionCatalog::lookupNSSByUUID(OperationCon
         return coll->ns();
     }
 
-    stdx::lock_guard<Latch> lock(_catalogLock);
-    auto foundIt = _catalog.find(uuid);
-    if (foundIt != _catalog.end()) {
-        boost::optional<NamespaceString> ns = foundIt->second->ns();
-        invariant(!ns.get().isEmpty());
-        return _collections.find(ns.get())->second->isCommitted() ? ns : boost::none;
+    {
+        ReadSection readSection(*this);
+        if (auto entry = _findEntry(readSection, uuid)) {
+            invariant(!entry->nss.isEmpty());
+            return entry->committed ? boost::make_optional(entry->nss) : boost::none;
+        }
     }
 
     // Only in the case that the catalog is closed and a UUID is currently unknown, resolve it
     // using the pre-close state. This ensures that any tasks reloading the catalog can see their
     // own updates.
+    stdx::lock_guard<Latch> lock(_catalogLock);
     if (_shadowCatalog) {
         auto shadowIt = _shadowCatalog->find(uuid);
         if (shadowIt != _shadowCatalog->end())
@@ -328,11 +529,9 @@ boost::optional<CollectionUUID> CollectionCatalog::lookupUUIDByNSS(
         return coll->uuid();
     }
 
-    stdx::lock_guard<Latch> lock(_catalogLock);
-    auto it = _collections.find(nss);
-    if (it != _collections.end()) {
-        boost::optional<CollectionUUID> uuid = it->second->uuid();
-        return it->second->isCommitted() ? uuid : boost::none;
+    ReadSection readSection(*this);
+    if (auto entry = _findEntry(readSection, nss)) {
+        return entry->committed ? boost::make_optional(entry->uuid) : boost::none;
     }
     return boost::none;
 }
@@ -478,6 +677,7 @@ void CollectionCatalog::registerCollection(CollectionUUID uuid, std::unique_ptr<
     _catalog[uuid] = std::move(*coll);
     _collections[ns] = _catalog[uuid].get();
     _orderedCollections[dbIdPair] = _catalog[uuid].get();
+    SnapshotWriter(lock, this).add(uuid, _catalog[uuid].get(), ns);
 
     auto dbRid = ResourceId(RESOURCE_DATABASE, dbName);
     addResource(dbRid, dbName);
@@ -505,6 +705,7 @@ std::unique_ptr<Collection> CollectionCatalog::deregisterCollection(CollectionUU
     _orderedCollections.erase(dbIdPair);
     _collections.erase(ns);
     _catalog.erase(uuid);
+    SnapshotWriter(lock, this).remove(uuid, ns);
 
     auto collRid = ResourceId(RESOURCE_COLLECTION, ns.ns());
     removeResource(collRid, ns.ns());
@@ -541,6 +742,16 @@ void CollectionCatalog::deregisterAllCollections() {
     _orderedCollections.clear();
     _catalog.clear();
 
+    std::vector<std::unique_ptr<const UUIDSnapshot>> retiredUUIDSnapshots;
+    for (auto&& snapshot : _uuidSnapshots) {
+        retiredUUIDSnapshots.emplace_back(snapshot.swap(nullptr));
+    }
+    std::vector<std::unique_ptr<const NamespaceSnapshot>> retiredNssSnapshots;
+    for (auto&& snapshot : _nssSnapshots) {
+        retiredNssSnapshots.emplace_back(snapshot.swap(nullptr));
+    }
+    _waitForReaders(lock);
+
     stdx::lock_guard<Latch> resourceLock(_resourceLock);
     _resourceInformation.clear();
 
@@ -29,20 +29,31 @@
 
 #pragma once
 
+#include <array>
+#include <boost/align/aligned_allocator.hpp>
 #include <functional>
 #include <map>
 #include <set>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/uuid.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
 /**
  * This class comprises a UUID to collection catalog, allowing for efficient
  * collection lookup by UUID.
+ *
+ * The lookups by UUID and by namespace do not take any lock. They read immutable snapshots of the
+ * UUID and namespace maps, which are split into partitions published through atomic pointers.
+ * Registering, renaming and dropping a collection copy the partitions they modify under
+ * '_catalogLock', publish the copies, and wait for the readers which may still be looking at the
+ * previous versions before freeing them (read-copy-update).
  */
 using CollectionUUID = UUID;
 class Database;
@@ -97,7 +108,8 @@ public:
 
     static CollectionCatalog& get(ServiceContext* svcCtx);
     static CollectionCatalog& get(OperationContext* opCtx);
-    CollectionCatalog() = default;
+    CollectionCatalog();
+    ~CollectionCatalog();
 
     /**
      * This function is responsible for safely setting the namespace string inside 'coll' to the
@@ -286,6 +298,44 @@ public:
 private:
     friend class CollectionCatalog::iterator;
 
+    class ReadSection;
+    class SnapshotWriter;
+
+    struct UUIDEntry {
+        Collection* collection;
+        NamespaceString nss;
+        bool committed;
+    };
+
+    struct NamespaceEntry {
+        Collection* collection;
+        CollectionUUID uuid;
+        bool committed;
+    };
+
+    using UUIDSnapshot = stdx::unordered_map<CollectionUUID, UUIDEntry, CollectionUUID::Hash>;
+    using NamespaceSnapshot = stdx::unordered_map<NamespaceString, NamespaceEntry>;
+
+    static constexpr size_t kNumSnapshotPartitions = 256;
+    static constexpr size_t kNumReaderStripes = 64;
+
+    static size_t _partitionOf(const CollectionUUID& uuid);
+    static size_t _partitionOf(const NamespaceString& nss);
+
+    /**
+     * Returns the entry of the published snapshot for 'uuid' or 'nss', or nullptr if there is
+     * none. The entry remains valid until the end of the ReadSection.
+     */
+    const UUIDEntry* _findEntry(const ReadSection&, const CollectionUUID& uuid) const;
+    const NamespaceEntry* _findEntry(const ReadSection&, const NamespaceString& nss) const;
+
+    /**
+     * Waits until no reader can still be looking at a snapshot partition which was replaced
+     * before this call. Writers call this with '_catalogLock' held, so readers must never acquire
+     * '_catalogLock' within a ReadSection.
+     */
+    void _waitForReaders(WithLock);
+
     Collection* _lookupCollectionByUUID(WithLock, CollectionUUID uuid) const;
 
     const std::vector<CollectionUUID>& _getOrdering_inlock(const StringData& db,
@@ -310,6 +360,19 @@ private:
     OrderedCollectionMap _orderedCollections;  // Ordered by <dbName, collUUID> pair
     NamespaceCollectionMap _collections;
 
+    // Immutable copies of the entries of '_catalog' and '_collections', partitioned by hash. A
+    // null partition is empty. Only replaced with '_catalogLock' held.
+    std::array<AtomicWord<const UUIDSnapshot*>, kNumSnapshotPartitions> _uuidSnapshots{};
+    std::array<AtomicWord<const NamespaceSnapshot*>, kNumSnapshotPartitions> _nssSnapshots{};
+
+    // The number of readers inside a ReadSection, for each of the two phases and spread over
+    // stripes to avoid contention. Writers wait for the readers of the previous phase after
+    // flipping '_readPhase'.
+    using ReaderCount = CacheAligned<AtomicWord<long long>>;
+    mutable std::vector<ReaderCount, boost::alignment::aligned_allocator<ReaderCount>>
+        _activeReaders;
+    AtomicWord<uint64_t> _readPhase{0};
+
     /**
      * Generation number to track changes to the catalog that could invalidate iterators.
      */
@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog/collection_mock.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxPerfThreads = 16;
+
+/**
+ * Registers state.range(0) collections spread over 100 databases before the benchmark runs. When
+ * state.range(1) is non-zero, a background thread keeps creating and dropping collections in the
+ * catalog while the lookups are measured.
+ */
+class CollectionCatalogTest : public benchmark::Fixture {
+protected:
+    void setUpCatalog(benchmark::State& state) {
+        catalog = std::make_unique<CollectionCatalog>();
+        collections.clear();
+
+        const auto numCollections = state.range(0);
+        for (int64_t i = 0; i < numCollections; ++i) {
+            NamespaceString nss("db" + std::to_string(i % 100), "coll" + std::to_string(i));
+            auto uuid = CollectionUUID::gen();
+            std::unique_ptr<Collection> collection = std::make_unique<CollectionMock>(nss);
+            catalog->registerCollection(uuid, &collection);
+            collections.emplace_back(nss, uuid);
+        }
+
+        if (state.range(1)) {
+            stopChurn.store(false);
+            churnThread = stdx::thread([this] {
+                NamespaceString nss("churn", "coll");
+                while (!stopChurn.load()) {
+                    auto uuid = CollectionUUID::gen();
+                    std::unique_ptr<Collection> collection = std::make_unique<CollectionMock>(nss);
+                    catalog->registerCollection(uuid, &collection);
+                    catalog->deregisterCollection(uuid);
+                }
+            });
+        }
+    }
+
+    void tearDownCatalog() {
+        if (churnThread.joinable()) {
+            stopChurn.store(true);
+            churnThread.join();
+        }
+        catalog->deregisterAllCollections();
+        catalog.reset();
+    }
+
+    std::unique_ptr<CollectionCatalog> catalog;
+    std::vector<std::pair<NamespaceString, CollectionUUID>> collections;
+
+    stdx::thread churnThread;
+    AtomicWord<bool> stopChurn{false};
+};
+
+BENCHMARK_DEFINE_F(CollectionCatalogTest, BM_LookupCollectionByNamespace)
+(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        setUpCatalog(state);
+    }
+
+    OperationContextNoop opCtx;
+    size_t i = state.thread_index;
+    for (auto keepRunning : state) {
+        const auto& nss = collections[i++ % collections.size()].first;
+        benchmark::DoNotOptimize(catalog->lookupCollectionByNamespace(&opCtx, nss));
+    }
+
+    if (state.thread_index == 0) {
+        tearDownCatalog();
+    }
+}
+
+BENCHMARK_DEFINE_F(CollectionCatalogTest, BM_LookupCollectionByUUID)(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        setUpCatalog(state);
+    }
+
+    OperationContextNoop opCtx;
+    size_t i = state.thread_index;
+    for (auto keepRunning : state) {
+        const auto& uuid = collections[i++ % collections.size()].second;
+        benchmark::DoNotOptimize(catalog->lookupCollectionByUUID(&opCtx, uuid));
+    }
+
+    if (state.thread_index == 0) {
+        tearDownCatalog();
+    }
+}
+
+BENCHMARK_REGISTER_F(CollectionCatalogTest, BM_LookupCollectionByNamespace)
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Args({200000, 0})
+    ->Args({200000, 1})
+    ->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_REGISTER_F(CollectionCatalogTest, BM_LookupCollectionByUUID)
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Args({200000, 0})
+    ->Args({200000, 1})
+    ->ThreadRange(1, kMaxPerfThreads);
+
+}  // namespace
+}  // namespace mongo
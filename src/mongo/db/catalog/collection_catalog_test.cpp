@@ -38,6 +38,7 @@
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/db/storage/durable_catalog.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 
@@ -525,6 +526,67 @@ TEST_F(CollectionCatalogTest, RenameCollection) {
     catalog.setCollectionNamespace(&opCtx, collection, oldNss, newNss);
     ASSERT_EQ(collection->ns(), newNss);
     ASSERT_EQUALS(catalog.lookupCollectionByUUID(&opCtx, uuid), collection);
+    ASSERT_EQUALS(*catalog.lookupNSSByUUID(&opCtx, uuid), newNss);
+    ASSERT_EQUALS(*catalog.lookupUUIDByNSS(&opCtx, newNss), uuid);
+    ASSERT_EQUALS(catalog.lookupCollectionByNamespace(&opCtx, newNss), collection);
+    ASSERT(catalog.lookupCollectionByNamespace(&opCtx, oldNss) == nullptr);
+    ASSERT_EQUALS(catalog.lookupUUIDByNSS(&opCtx, oldNss), boost::none);
+}
+
+TEST_F(CollectionCatalogTest, LookupsIgnoreCollectionsAwaitingVisibility) {
+    auto uuid = CollectionUUID::gen();
+    NamespaceString newNss(nss.db(), "newcol");
+    std::unique_ptr<Collection> collUnique = std::make_unique<CollectionMock>(newNss);
+    auto collection = collUnique.get();
+    collection->setCommitted(false);
+    catalog.registerCollection(uuid, &collUnique);
+
+    ASSERT(catalog.isCollectionAwaitingVisibility(uuid));
+    ASSERT(catalog.lookupCollectionByUUID(&opCtx, uuid) == nullptr);
+    ASSERT(catalog.lookupCollectionByNamespace(&opCtx, newNss) == nullptr);
+    ASSERT_EQUALS(catalog.lookupNSSByUUID(&opCtx, uuid), boost::none);
+    ASSERT_EQUALS(catalog.lookupUUIDByNSS(&opCtx, newNss), boost::none);
+
+    catalog.makeCollectionVisible(uuid);
+    ASSERT_FALSE(catalog.isCollectionAwaitingVisibility(uuid));
+    ASSERT_EQUALS(catalog.lookupCollectionByUUID(&opCtx, uuid), collection);
+    ASSERT_EQUALS(catalog.lookupCollectionByNamespace(&opCtx, newNss), collection);
+    ASSERT_EQUALS(*catalog.lookupNSSByUUID(&opCtx, uuid), newNss);
+    ASSERT_EQUALS(*catalog.lookupUUIDByNSS(&opCtx, newNss), uuid);
+}
+
+TEST_F(CollectionCatalogTest, LookupsDuringConcurrentRegistration) {
+    const int kNumReaders = 4;
+    AtomicWord<bool> done{false};
+
+    std::vector<stdx::thread> readers;
+    for (int i = 0; i < kNumReaders; ++i) {
+        readers.emplace_back([&] {
+            OperationContextNoop readerOpCtx;
+            while (!done.load()) {
+                // The collection registered by the fixture must remain visible throughout.
+                ASSERT_EQUALS(catalog.lookupCollectionByUUID(&readerOpCtx, colUUID), col);
+                ASSERT_EQUALS(catalog.lookupCollectionByNamespace(&readerOpCtx, nss), col);
+                ASSERT_EQUALS(*catalog.lookupNSSByUUID(&readerOpCtx, colUUID), nss);
+            }
+        });
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        auto uuid = CollectionUUID::gen();
+        NamespaceString churnNss(nss.db(), "churn" + std::to_string(i));
+        std::unique_ptr<Collection> collUnique = std::make_unique<CollectionMock>(churnNss);
+        auto collection = collUnique.get();
+        catalog.registerCollection(uuid, &collUnique);
+        ASSERT_EQUALS(catalog.lookupCollectionByNamespace(&opCtx, churnNss), collection);
+        catalog.deregisterCollection(uuid);
+        ASSERT(catalog.lookupCollectionByUUID(&opCtx, uuid) == nullptr);
+    }
+
+    done.store(true);
+    for (auto&& reader : readers) {
+        reader.join();
+    }
 }
 
 TEST_F(CollectionCatalogTest, LookupNSSByUUIDForClosedCatalogReturnsOldNSSIfDropped) {
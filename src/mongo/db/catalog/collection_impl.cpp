@@ -296,6 +296,7 @@ void CollectionImpl::init(OperationContext* opCtx) {
         uassertStatusOK(validatePreImageRecording(opCtx, _ns));
         _recordPreImages = true;
     }
+    _clustered = collectionOptions.clusteredIndex;
 
     // Store the result (OK / error) of parsing the validator, but do not enforce that the result is
     // OK. This is intentional, as users may have validators on disk which were considered well
@@ -335,6 +336,11 @@ bool CollectionImpl::requiresIdIndex() const {
         return false;
     }
 
+    if (_clustered) {
+        // The record store is keyed by _id.
+        return false;
+    }
+
     if (_ns.isSystem()) {
         StringData shortName = _ns.coll().substr(_ns.coll().find('.') + 1);
         if (shortName == "indexes" || shortName == "namespaces" || shortName == "profile") {
@@ -866,6 +872,10 @@ bool CollectionImpl::getRecordPreImages() const {
     return _recordPreImages;
 }
 
+bool CollectionImpl::isClustered() const {
+    return _clustered;
+}
+
 void CollectionImpl::setRecordPreImages(OperationContext* opCtx, bool val) {
     if (val) {
         uassertStatusOK(validatePreImageRecording(opCtx, _ns));
@@ -275,6 +275,8 @@ public:
     bool getRecordPreImages() const final;
     void setRecordPreImages(OperationContext* opCtx, bool val) final;
 
+    bool isClustered() const final;
+
     bool isTemporary(OperationContext* opCtx) const final;
 
     //
@@ -409,6 +411,8 @@ private:
 
     bool _recordPreImages = false;
 
+    bool _clustered = false;
+
     // Notifier object for awaitData. Threads polling a capped collection for new data can wait
     // on this object until notified of the arrival of new data.
     //
@@ -219,6 +219,10 @@ public:
         std::abort();
     }
 
+    bool isClustered() const {
+        return false;
+    }
+
     bool isCapped() const {
         std::abort();
     }
@@ -93,6 +93,16 @@ Status checkStorageEngineOptions(const BSONElement& elem) {
     return Status::OK();
 }
 
+Status checkTimeseriesFieldName(StringData option, StringData fieldName) {
+    if (fieldName.empty() || fieldName.startsWith("$") ||
+        fieldName.find('.') != std::string::npos || fieldName == "_id") {
+        return {ErrorCodes::InvalidOptions,
+                str::stream() << "'timeseries." << option << "' must be the name of a top-level "
+                              << "field other than _id, but found: '" << fieldName << "'"};
+    }
+    return Status::OK();
+}
+
 }  // namespace
 
 bool CollectionOptions::isView() const {
@@ -170,6 +180,8 @@ StatusWith<CollectionOptions> CollectionOptions::parse(const BSONObj& options, P
             collectionOptions.temp = e.trueValue();
         } else if (fieldName == "recordPreImages") {
             collectionOptions.recordPreImages = e.trueValue();
+        } else if (fieldName == "clusteredIndex") {
+            collectionOptions.clusteredIndex = e.trueValue();
         } else if (fieldName == "storageEngine") {
             Status status = checkStorageEngineOptions(e);
             if (!status.isOK()) {
@@ -248,6 +260,17 @@ StatusWith<CollectionOptions> CollectionOptions::parse(const BSONObj& options, P
             }
 
             collectionOptions.idIndex = std::move(tempIdIndex);
+        } else if (fieldName == "timeseries") {
+            if (e.type() != mongo::Object) {
+                return {ErrorCodes::TypeMismatch, "'timeseries' has to be a document."};
+            }
+
+            try {
+                collectionOptions.timeseries =
+                    TimeseriesOptions::parse(IDLParserErrorContext("timeseries"), e.Obj());
+            } catch (const DBException& ex) {
+                return ex.toStatus();
+            }
         } else if (!createdOn24OrEarlier && !mongo::isGenericArgument(fieldName)) {
             return Status(ErrorCodes::InvalidOptions,
                           str::stream()
@@ -260,6 +283,58 @@ StatusWith<CollectionOptions> CollectionOptions::parse(const BSONObj& options, P
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (collectionOptions.clusteredIndex) {
+        if (collectionOptions.capped) {
+            return Status(ErrorCodes::InvalidOptions,
+                          "'clusteredIndex' cannot be specified with 'capped'");
+        }
+        if (collectionOptions.autoIndexId != DEFAULT) {
+            return Status(ErrorCodes::InvalidOptions,
+                          "'clusteredIndex' cannot be specified with 'autoIndexId'");
+        }
+        if (!collectionOptions.viewOn.empty()) {
+            return Status(ErrorCodes::InvalidOptions,
+                          "'clusteredIndex' cannot be specified with 'viewOn'");
+        }
+        // The records are keyed by _id with the simple collation.
+        if (!collectionOptions.collation.isEmpty()) {
+            return Status(ErrorCodes::InvalidOptions,
+                          "'clusteredIndex' cannot be specified with 'collation'");
+        }
+    }
+
+    if (const auto& timeseries = collectionOptions.timeseries) {
+        auto status = checkTimeseriesFieldName("timeField", timeseries->getTimeField());
+        if (!status.isOK()) {
+            return status;
+        }
+        if (auto metaField = timeseries->getMetaField()) {
+            status = checkTimeseriesFieldName("metaField", *metaField);
+            if (!status.isOK()) {
+                return status;
+            }
+            if (*metaField == timeseries->getTimeField()) {
+                return {ErrorCodes::InvalidOptions,
+                        "'timeseries.metaField' cannot be the same as 'timeseries.timeField'"};
+            }
+        }
+
+        // The buckets are written and read by the server, in a format the other options do not
+        // apply to.
+        for (auto option : {"capped"_sd,
+                            "clusteredIndex"_sd,
+                            "autoIndexId"_sd,
+                            "viewOn"_sd,
+                            "validator"_sd,
+                            "collation"_sd}) {
+            if (options.hasField(option)) {
+                return {ErrorCodes::InvalidOptions,
+                        str::stream()
+                            << "'" << option << "' cannot be specified with 'timeseries'"};
+            }
+        }
+    }
+
     return collectionOptions;
 }
 
@@ -292,6 +367,10 @@ void CollectionOptions::appendBSON(BSONObjBuilder* builder) const {
         builder->appendBool("recordPreImages", true);
     }
 
+    if (clusteredIndex) {
+        builder->appendBool("clusteredIndex", true);
+    }
+
     if (!storageEngine.isEmpty()) {
         builder->append("storageEngine", storageEngine);
     }
@@ -327,6 +406,10 @@ void CollectionOptions::appendBSON(BSONObjBuilder* builder) const {
     if (!idIndex.isEmpty()) {
         builder->append("idIndex", idIndex);
     }
+
+    if (timeseries) {
+        builder->append("timeseries", timeseries->toBSON());
+    }
 }
 
 bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
@@ -351,6 +434,10 @@ bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
         return false;
     }
 
+    if (clusteredIndex != other.clusteredIndex) {
+        return false;
+    }
+
     if (temp != other.temp) {
         return false;
     }
@@ -395,6 +482,11 @@ bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
         return false;
     }
 
+    if (bool(timeseries) != bool(other.timeseries) ||
+        (timeseries && timeseries->toBSON().woCompare(other.timeseries->toBSON()) != 0)) {
+        return false;
+    }
+
     return true;
 }
 }  // namespace mongo
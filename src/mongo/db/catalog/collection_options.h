@@ -35,6 +35,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
@@ -121,6 +122,9 @@ struct CollectionOptions {
     bool temp = false;
     bool recordPreImages = false;
 
+    // Documents are stored keyed by their _id, which then needs no separate index.
+    bool clusteredIndex = false;
+
     // Storage engine collection options. Always owned or empty.
     BSONObj storageEngine;
 
@@ -144,5 +148,9 @@ struct CollectionOptions {
     std::string viewOn;
     // The aggregation pipeline that defines this view.
     BSONObj pipeline;
+
+    // Set for a time-series collection, on both the command creating it and the collection holding
+    // its buckets.
+    boost::optional<TimeseriesOptions> timeseries;
 };
 }  // namespace mongo
@@ -248,6 +248,28 @@ TEST(CollectionOptions, PipelineFieldRequiresViewOn) {
     ASSERT_NOT_OK(CollectionOptions::parse(fromjson("{pipeline: [{$match: {}}]}")).getStatus());
 }
 
+TEST(CollectionOptions, ClusteredIndexRoundTrip) {
+    auto options = assertGet(CollectionOptions::parse(fromjson("{clusteredIndex: true}")));
+    ASSERT(options.clusteredIndex);
+    ASSERT_BSONOBJ_EQ(options.toBSON(), fromjson("{clusteredIndex: true}"));
+
+    options = assertGet(CollectionOptions::parse(BSONObj()));
+    ASSERT_FALSE(options.clusteredIndex);
+}
+
+TEST(CollectionOptions, ClusteredIndexIsIncompatibleWithCappedAutoIndexIdAndCollation) {
+    auto statusWith =
+        CollectionOptions::parse(fromjson("{clusteredIndex: true, capped: true, size: 1024}"));
+    ASSERT_EQ(statusWith.getStatus().code(), ErrorCodes::InvalidOptions);
+
+    statusWith = CollectionOptions::parse(fromjson("{clusteredIndex: true, autoIndexId: false}"));
+    ASSERT_EQ(statusWith.getStatus().code(), ErrorCodes::InvalidOptions);
+
+    statusWith =
+        CollectionOptions::parse(fromjson("{clusteredIndex: true, collation: {locale: 'fr'}}"));
+    ASSERT_EQ(statusWith.getStatus().code(), ErrorCodes::InvalidOptions);
+}
+
 TEST(CollectionOptions, UnknownTopLevelOptionFailsToParse) {
     auto statusWith = CollectionOptions::parse(fromjson("{invalidOption: 1}"));
     ASSERT_EQ(statusWith.getStatus().code(), ErrorCodes::InvalidOptions);
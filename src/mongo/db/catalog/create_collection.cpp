@@ -109,6 +109,89 @@ Status _createView(OperationContext* opCtx,
     });
 }
 
+Status _createTimeseries(OperationContext* opCtx,
+                         const NamespaceString& ns,
+                         const CollectionOptions& options) {
+    // The time-series view and its buckets collection are created together, so that no write can
+    // observe one without the other.
+    const auto bucketsNs = ns.makeTimeseriesBucketsNamespace();
+
+    CollectionOptions viewOptions;
+    viewOptions.viewOn = bucketsNs.coll().toString();
+    {
+        BSONObjBuilder unpackSpec;
+        unpackSpec.append("timeField", options.timeseries->getTimeField());
+        if (auto metaField = options.timeseries->getMetaField()) {
+            unpackSpec.append("metaField", *metaField);
+        }
+        viewOptions.pipeline = BSON_ARRAY(BSON("$_internalUnpackBucket" << unpackSpec.obj()));
+    }
+
+    return writeConflictRetry(opCtx, "create", ns.ns(), [&] {
+        AutoGetOrCreateDb autoDb(opCtx, ns.db(), MODE_IX);
+        Lock::CollectionLock viewLock(opCtx, ns, MODE_IX);
+        Lock::CollectionLock bucketsLock(opCtx, bucketsNs, MODE_IX);
+        // Operations all lock system.views in the end to prevent deadlock.
+        Lock::CollectionLock systemViewsLock(
+            opCtx,
+            NamespaceString(ns.db(), NamespaceString::kSystemDotViewsCollectionName),
+            MODE_X);
+
+        Database* db = autoDb.getDb();
+        auto& catalog = CollectionCatalog::get(opCtx);
+        for (auto&& nss : {ns, bucketsNs}) {
+            if (catalog.lookupCollectionByNamespace(opCtx, nss)) {
+                return Status(ErrorCodes::NamespaceExists,
+                              str::stream() << "Collection already exists. NS: " << nss);
+            }
+            if (ViewCatalog::get(db)->lookup(opCtx, nss.ns())) {
+                return Status(ErrorCodes::NamespaceExists,
+                              str::stream() << "A view already exists. NS: " << nss);
+            }
+        }
+
+        if (opCtx->writesAreReplicated() &&
+            !repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, ns)) {
+            return Status(ErrorCodes::NotMaster,
+                          str::stream() << "Not primary while creating collection " << ns);
+        }
+
+        // Create 'system.views' in a separate WUOW if it does not exist.
+        WriteUnitOfWork wuow(opCtx);
+        if (!catalog.lookupCollectionByNamespace(opCtx,
+                                                 NamespaceString(db->getSystemViewsName()))) {
+            invariant(db->createCollection(opCtx, NamespaceString(db->getSystemViewsName())));
+        }
+        wuow.commit();
+
+        WriteUnitOfWork wunit(opCtx);
+
+        AutoStatsTracker statsTracker(opCtx,
+                                      ns,
+                                      Top::LockType::NotLocked,
+                                      AutoStatsTracker::LogMode::kUpdateTopAndCurOp,
+                                      catalog.getDatabaseProfileLevel(ns.db()));
+
+        opCtx->recoveryUnit()->onRollback(
+            [ns, bucketsNs, serviceContext = opCtx->getServiceContext()]() {
+                Top::get(serviceContext).collectionDropped(ns);
+                Top::get(serviceContext).collectionDropped(bucketsNs);
+            });
+
+        Status status = db->userCreateNS(opCtx, bucketsNs, options, true);
+        if (!status.isOK()) {
+            return status;
+        }
+        status = db->userCreateNS(opCtx, ns, viewOptions, true);
+        if (!status.isOK()) {
+            return status;
+        }
+        wunit.commit();
+
+        return Status::OK();
+    });
+}
+
 Status _createCollection(OperationContext* opCtx,
                          const NamespaceString& nss,
                          const CollectionOptions& collectionOptions,
@@ -211,6 +294,12 @@ Status createCollection(OperationContext* opCtx,
                                  "transaction.",
                 !opCtx->inMultiDocumentTransaction());
         return _createView(opCtx, nss, collectionOptions, idIndex);
+    } else if (collectionOptions.timeseries && !nss.isTimeseriesBucketsCollection()) {
+        uassert(ErrorCodes::OperationNotSupportedInTransaction,
+                str::stream() << "Cannot create a time-series collection in a multi-document "
+                                 "transaction.",
+                !opCtx->inMultiDocumentTransaction());
+        return _createTimeseries(opCtx, nss, collectionOptions);
     } else {
         uassert(ErrorCodes::OperationNotSupportedInTransaction,
                 str::stream() << "Cannot create system collection " << nss.toString()
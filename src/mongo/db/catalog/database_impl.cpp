@@ -332,7 +332,8 @@ Status DatabaseImpl::dropCollection(OperationContext* opCtx,
                               "turn off profiling before dropping system.profile collection");
         } else if (!(nss.isSystemDotViews() || nss.isHealthlog() ||
                      nss == NamespaceString::kLogicalSessionsNamespace ||
-                     nss == NamespaceString::kSystemKeysNamespace)) {
+                     nss == NamespaceString::kSystemKeysNamespace ||
+                     nss.isTimeseriesBucketsCollection())) {
             return Status(ErrorCodes::IllegalOperation,
                           str::stream() << "can't drop system collection " << nss);
         }
@@ -576,6 +577,16 @@ void DatabaseImpl::_checkCanCreateCollection(OperationContext* opCtx,
     }
 
     uassert(28838, "cannot create a non-capped oplog collection", options.capped || !nss.isOplog());
+    if (options.clusteredIndex) {
+        uassert(ErrorCodes::InvalidOptions,
+                str::stream() << "Cannot create clustered collection " << nss
+                              << " - the storage engine does not support clustered collections.",
+                opCtx->getServiceContext()->getStorageEngine()->supportsClusteredIdIndex());
+        uassert(ErrorCodes::InvalidOptions,
+                str::stream() << "Cannot create clustered collection " << nss
+                              << " - system collections cannot be clustered.",
+                !nss.isSystem() && !nss.isOnInternalDb());
+    }
     uassert(ErrorCodes::DatabaseDropPending,
             str::stream() << "Cannot create collection " << nss
                           << " - database is in the process of being dropped.",
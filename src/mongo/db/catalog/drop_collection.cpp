@@ -286,7 +286,11 @@ Status dropCollection(OperationContext* opCtx,
     }
 
     try {
-        return writeConflictRetry(opCtx, "drop", collectionName.ns(), [&] {
+        // Dropping the view of a time-series collection also drops its buckets collection.
+        const auto bucketsNs = collectionName.makeTimeseriesBucketsNamespace();
+        bool isTimeseriesView = false;
+
+        auto status = writeConflictRetry(opCtx, "drop", collectionName.ns(), [&] {
             {
                 AutoGetDb autoDb(opCtx, collectionName.db(), MODE_IX);
                 Database* db = autoDb.getDb();
@@ -298,6 +302,9 @@ Status dropCollection(OperationContext* opCtx,
                     opCtx, collectionName);
 
                 if (!coll) {
+                    auto view = ViewCatalog::get(db)->lookupWithoutValidatingDurableViews(
+                        opCtx, collectionName.ns());
+                    isTimeseriesView = view && view->viewOn() == bucketsNs;
                     return _dropView(opCtx, db, collectionName, result);
                 }
             }
@@ -305,6 +312,16 @@ Status dropCollection(OperationContext* opCtx,
             return _abortIndexBuildsAndDropCollection(
                 opCtx, collectionName, systemCollectionMode, result);
         });
+        if (!status.isOK() || !isTimeseriesView) {
+            return status;
+        }
+
+        status = writeConflictRetry(opCtx, "drop", bucketsNs.ns(), [&] {
+            BSONObjBuilder unusedBuilder;
+            return _abortIndexBuildsAndDropCollection(
+                opCtx, bucketsNs, systemCollectionMode, unusedBuilder);
+        });
+        return status == ErrorCodes::NamespaceNotFound ? Status::OK() : status;
     } catch (ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
         // The shell requires that NamespaceNotFound error codes return the "ns not found"
         // string.
@@ -604,6 +604,12 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx, const BSONObj& spec)
     if (nss.isOplog())
         return Status(ErrorCodes::CannotCreateIndex, "cannot have an index on the oplog");
 
+    // Index keys end with the RecordId as a 64-bit integer, which those of clustered collections
+    // are not.
+    if (_collection->isClustered())
+        return Status(ErrorCodes::CannotCreateIndex,
+                      "cannot have an index on a clustered collection");
+
     // logical name of the index
     const BSONElement nameElem = spec["name"];
     if (nameElem.type() != String)
@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/multi_index_block.h"
 
+#include <deque>
 #include <ostream>
 
 #include "mongo/base/error_codes.h"
@@ -55,6 +56,7 @@
 #include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/quick_exit.h"
@@ -333,6 +335,267 @@ void failPointHangDuringBuild(FailPoint* fp, StringData where, const BSONObj& do
         });
 }
 
+namespace {
+
+// The number of documents the collection scan hands over to a key generation thread at a time.
+constexpr size_t kKeyGenerationBatchSize = 256;
+
+}  // namespace
+
+/**
+ * Generates the keys of the documents found by the collection scan phase of an index build on a
+ * pool of threads. Each thread inserts the keys into BulkBuilders of its own, which are merged into
+ * the BulkBuilders of the index build once the collection scan is done.
+ *
+ * The worker threads never access the storage engine, so the collection scan alone holds locks and
+ * yields as it would when generating the keys itself.
+ */
+class MultiIndexBlock::ParallelKeyGenerator {
+public:
+    ParallelKeyGenerator(MultiIndexBlock* indexer, size_t numWorkers);
+    ~ParallelKeyGenerator();
+
+    /**
+     * Queues an owned copy of the document for key generation. Blocks while enough documents are
+     * already waiting for a worker.
+     */
+    Status add(OperationContext* opCtx, const BSONObj& doc, const RecordId& loc);
+
+    /**
+     * Waits for the keys of all queued documents to be generated, then merges the keys generated
+     * by every worker into the BulkBuilders of the index build.
+     */
+    Status finish(OperationContext* opCtx);
+
+private:
+    using Batch = std::vector<std::pair<BSONObj, RecordId>>;
+
+    struct Worker {
+        // One BulkBuilder per index being built.
+        std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>> bulks;
+
+        // The documents whose key generation errors were suppressed, per index being built. They
+        // are recorded in the index build's SkippedRecordTracker by finish(), as doing so requires
+        // locks.
+        std::vector<std::vector<RecordId>> skippedRecords;
+
+        // Only accessed by the worker thread until it has been joined.
+        long long docsProcessed = 0;
+        Milliseconds duration{0};
+    };
+
+    Status _pushBatch(OperationContext* opCtx);
+    boost::optional<Batch> _popBatch();
+    void _runWorker(Worker* worker);
+
+    MultiIndexBlock* const _indexer;
+    const size_t _maxQueuedBatches;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // The batch being filled by add().
+    Batch _batch;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("MultiIndexBlock::ParallelKeyGenerator::_mutex");
+    stdx::condition_variable _cv;
+
+    // Batches waiting for a worker. Guarded by '_mutex'.
+    std::deque<Batch> _queue;
+
+    // Set once no more batches are going to be queued. Guarded by '_mutex'.
+    bool _closed = false;
+
+    // The first error encountered by a worker. Guarded by '_mutex'.
+    Status _workerStatus = Status::OK();
+
+    // Declared last so that the worker threads are joined before anything they use is destroyed.
+    ThreadPool _pool;
+};
+
+MultiIndexBlock::ParallelKeyGenerator::ParallelKeyGenerator(MultiIndexBlock* indexer,
+                                                            size_t numWorkers)
+    : _indexer(indexer), _maxQueuedBatches(2 * numWorkers), _pool([&] {
+          ThreadPool::Options options;
+          options.poolName = "IndexBuildKeyGeneration";
+          options.minThreads = numWorkers;
+          options.maxThreads = numWorkers;
+          options.onCreateThread = [](const std::string& threadName) {
+              Client::initThread(threadName.c_str());
+          };
+          return options;
+      }()) {
+    const auto& indexes = _indexer->_indexes;
+
+    // The workers share the memory budget of the index build.
+    const auto eachBulkMaxMemoryUsageBytes =
+        static_cast<std::size_t>(maxIndexBuildMemoryUsageMegabytes.load()) * 1024 * 1024 /
+        indexes.size() / numWorkers;
+
+    _batch.reserve(kKeyGenerationBatchSize);
+    _workers.reserve(numWorkers);
+    for (size_t i = 0; i < numWorkers; i++) {
+        auto worker = std::make_unique<Worker>();
+        for (const auto& index : indexes) {
+            worker->bulks.push_back(index.real->initiateBulk(eachBulkMaxMemoryUsageBytes));
+        }
+        worker->skippedRecords.resize(indexes.size());
+        _workers.push_back(std::move(worker));
+    }
+
+    _pool.startup();
+    for (auto& worker : _workers) {
+        _pool.schedule([this, worker = worker.get()](Status status) {
+            if (status.isOK()) {
+                _runWorker(worker);
+            }
+        });
+    }
+}
+
+MultiIndexBlock::ParallelKeyGenerator::~ParallelKeyGenerator() {
+    // Unless finish() succeeded, the generated keys are being discarded, so don't bother with the
+    // documents that are still queued.
+    stdx::lock_guard<Latch> lk(_mutex);
+    _closed = true;
+    _queue.clear();
+    _cv.notify_all();
+}
+
+Status MultiIndexBlock::ParallelKeyGenerator::add(OperationContext* opCtx,
+                                                  const BSONObj& doc,
+                                                  const RecordId& loc) {
+    _batch.emplace_back(doc.getOwned(), loc);
+    if (_batch.size() < kKeyGenerationBatchSize) {
+        return Status::OK();
+    }
+
+    return _pushBatch(opCtx);
+}
+
+Status MultiIndexBlock::ParallelKeyGenerator::finish(OperationContext* opCtx) {
+    if (!_batch.empty()) {
+        auto status = _pushBatch(opCtx);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _closed = true;
+        _cv.notify_all();
+    }
+
+    // The workers exit once they have drained the queue.
+    _pool.shutdown();
+    _pool.join();
+
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (!_workerStatus.isOK()) {
+            return _workerStatus;
+        }
+    }
+
+    auto& indexes = _indexer->_indexes;
+    for (size_t workerId = 0; workerId < _workers.size(); workerId++) {
+        auto& worker = *_workers[workerId];
+
+        long long keysInserted = 0;
+        for (size_t i = 0; i < indexes.size(); i++) {
+            auto interceptor = indexes[i].block->getEntry()->indexBuildInterceptor();
+            if (interceptor && interceptor->getSkippedRecordTracker()) {
+                for (const auto& loc : worker.skippedRecords[i]) {
+                    interceptor->getSkippedRecordTracker()->record(opCtx, loc);
+                }
+            }
+
+            keysInserted += worker.bulks[i]->getKeysInserted();
+            indexes[i].bulk->mergeFrom(std::move(worker.bulks[i]));
+        }
+
+        LOGV2(4917600,
+              "Index build: key generation worker done",
+              "buildUUID"_attr = _indexer->_buildUUID,
+              "worker"_attr = workerId,
+              "totalRecords"_attr = worker.docsProcessed,
+              "keysInserted"_attr = keysInserted,
+              "duration"_attr = worker.duration);
+    }
+
+    return Status::OK();
+}
+
+Status MultiIndexBlock::ParallelKeyGenerator::_pushBatch(OperationContext* opCtx) {
+    stdx::unique_lock<Latch> lk(_mutex);
+    opCtx->waitForConditionOrInterrupt(
+        _cv, lk, [&] { return !_workerStatus.isOK() || _queue.size() < _maxQueuedBatches; });
+    if (!_workerStatus.isOK()) {
+        return _workerStatus;
+    }
+
+    _queue.push_back(std::move(_batch));
+    _cv.notify_all();
+
+    _batch = Batch();
+    _batch.reserve(kKeyGenerationBatchSize);
+    return Status::OK();
+}
+
+boost::optional<MultiIndexBlock::ParallelKeyGenerator::Batch>
+MultiIndexBlock::ParallelKeyGenerator::_popBatch() {
+    stdx::unique_lock<Latch> lk(_mutex);
+    _cv.wait(lk, [&] { return _closed || !_queue.empty(); });
+    if (_queue.empty()) {
+        return boost::none;
+    }
+
+    auto batch = std::move(_queue.front());
+    _queue.pop_front();
+
+    // Wake up the collection scan, which may be waiting for room in the queue.
+    _cv.notify_all();
+    return std::move(batch);
+}
+
+void MultiIndexBlock::ParallelKeyGenerator::_runWorker(Worker* worker) {
+    Timer timer;
+    auto opCtx = cc().makeOperationContext();
+    const auto& indexes = _indexer->_indexes;
+
+    try {
+        while (auto batch = _popBatch()) {
+            for (const auto& [doc, loc] : *batch) {
+                for (size_t i = 0; i < indexes.size(); i++) {
+                    if (indexes[i].filterExpression &&
+                        !indexes[i].filterExpression->matchesBSON(doc)) {
+                        continue;
+                    }
+
+                    auto& skippedRecords = worker->skippedRecords[i];
+                    uassertStatusOK(worker->bulks[i]->insert(
+                        opCtx.get(), doc, loc, indexes[i].options, [&](const RecordId& skipped) {
+                            skippedRecords.push_back(skipped);
+                        }));
+                }
+            }
+
+            worker->docsProcessed += batch->size();
+        }
+    } catch (...) {
+        // Stop the other workers and the collection scan.
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_workerStatus.isOK()) {
+            _workerStatus = exceptionToStatus();
+        }
+        _closed = true;
+        _queue.clear();
+        _cv.notify_all();
+    }
+
+    worker->duration = Milliseconds(timer.millis());
+}
+
 Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
                                                        Collection* collection) {
     invariant(!_buildIsCleanedUp);
@@ -400,11 +663,22 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
     bool readOnce = useReadOnceCursorsForIndexBuilds.load();
     opCtx->recoveryUnit()->setReadOnce(readOnce);
 
+    // Generating the keys of each document and sorting them, rather than the collection scan
+    // itself, dominates the cost of building compound and multikey indexes. When allowed to, hand
+    // the documents over to a pool of threads that do so in parallel.
+    std::unique_ptr<ParallelKeyGenerator> keyGenerator;
+    const auto numKeyGenerationThreads = maxIndexBuildKeyGenerationThreads.load();
+
     try {
         invariant(_phase == IndexBuildPhaseEnum::kInitialized,
                   IndexBuildPhase_serializer(_phase).toString());
         _phase = IndexBuildPhaseEnum::kCollectionScan;
 
+        if (numKeyGenerationThreads > 1 && !_indexes.empty()) {
+            keyGenerator = std::make_unique<ParallelKeyGenerator>(this, numKeyGenerationThreads);
+            _generatedKeysInParallel = true;
+        }
+
         BSONObj objToIndex;
         RecordId loc;
         PlanExecutor::ExecState state;
@@ -425,7 +699,9 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
 
             // The external sorter is not part of the storage engine and therefore does not need a
             // WriteUnitOfWork to write keys.
-            Status ret = insertSingleDocumentForInitialSyncOrRecovery(opCtx, objToIndex, loc);
+            Status ret = keyGenerator
+                ? keyGenerator->add(opCtx, objToIndex, loc)
+                : insertSingleDocumentForInitialSyncOrRecovery(opCtx, objToIndex, loc);
             if (!ret.isOK()) {
                 return ret;
             }
@@ -437,6 +713,13 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
             progress->hit();
             n++;
         }
+
+        if (keyGenerator) {
+            Status ret = keyGenerator->finish(opCtx);
+            if (!ret.isOK()) {
+                return ret;
+            }
+        }
     } catch (...) {
         _phase = IndexBuildPhaseEnum::kInitialized;
         return exceptionToStatus();
@@ -754,6 +1037,7 @@ void MultiIndexBlock::_abortWithoutCleanup(OperationContext* opCtx, bool shutdow
 
 bool MultiIndexBlock::_shouldWriteStateToDisk(OperationContext* opCtx, bool shutdown) const {
     return shutdown && _buildUUID && !_buildIsCleanedUp && _method == IndexBuildMethod::kHybrid &&
+        !_generatedKeysInParallel &&
         opCtx->getServiceContext()->getStorageEngine()->supportsResumableIndexBuilds();
 }
 
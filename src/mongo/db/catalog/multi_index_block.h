@@ -288,6 +288,8 @@ public:
     void setIndexBuildMethod(IndexBuildMethod indexBuildMethod);
 
 private:
+    class ParallelKeyGenerator;
+
     struct IndexToBuild {
         std::unique_ptr<IndexBuildBlock> block;
 
@@ -330,5 +332,9 @@ private:
 
     // The current phase of the index build.
     IndexBuildPhaseEnum _phase = IndexBuildPhaseEnum::kInitialized;
+
+    // Set to true when the keys of the collection scan were generated by several threads, which
+    // spreads them across more sorter files than the resumable index build state can describe.
+    bool _generatedKeysInParallel = false;
 };
 }  // namespace mongo
@@ -32,8 +32,10 @@
 #include "mongo/db/catalog/multi_index_block.h"
 
 #include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/catalog/multi_index_block_gen.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/unittest/unittest.h"
 
@@ -182,5 +184,50 @@ TEST_F(MultiIndexBlockTest, InitWriteConflictException) {
     indexer->abortIndexBuild(operationContext(), coll, MultiIndexBlock::kNoopOnCleanUpFn);
 }
 
+TEST_F(MultiIndexBlockTest, ParallelKeyGeneration) {
+    auto indexer = getIndexer();
+
+    const auto originalNumThreads = maxIndexBuildKeyGenerationThreads.load();
+    maxIndexBuildKeyGenerationThreads.store(4);
+    ON_BLOCK_EXIT([&] { maxIndexBuildKeyGenerationThreads.store(originalNumThreads); });
+
+    // Enough documents for every worker to get several batches, and two keys per document so that
+    // each worker's BulkBuilder becomes multikey.
+    const int numDocs = 5000;
+    std::vector<InsertStatement> docs;
+    for (int i = 0; i < numDocs; i++) {
+        docs.emplace_back(BSON("_id" << i << "a" << BSON_ARRAY(i << i + numDocs)));
+    }
+    ASSERT_OK(storageInterface()->insertDocuments(operationContext(), getNSS(), docs));
+
+    AutoGetCollection autoColl(operationContext(), getNSS(), MODE_X);
+    Collection* coll = autoColl.getCollection();
+
+    BSONObj spec = BSON("key" << BSON("a" << 1) << "name"
+                              << "a_1"
+                              << "v" << static_cast<int>(IndexDescriptor::kLatestIndexVersion));
+    ASSERT_OK(indexer->init(operationContext(), coll, {spec}, MultiIndexBlock::kNoopOnInitFn)
+                  .getStatus());
+
+    ASSERT_OK(indexer->insertAllDocumentsInCollection(operationContext(), coll));
+    ASSERT_OK(indexer->checkConstraints(operationContext()));
+
+    {
+        WriteUnitOfWork wunit(operationContext());
+        ASSERT_OK(indexer->commit(operationContext(),
+                                  coll,
+                                  MultiIndexBlock::kNoopOnCreateEachFn,
+                                  MultiIndexBlock::kNoopOnCommitFn));
+        wunit.commit();
+    }
+
+    auto descriptor = coll->getIndexCatalog()->findIndexByName(operationContext(), "a_1");
+    ASSERT(descriptor);
+    ASSERT(descriptor->getEntry()->isMultikey());
+    ASSERT_EQ(2 * numDocs,
+              descriptor->getEntry()->accessMethod()->getSortedDataInterface()->numEntries(
+                  operationContext()));
+}
+
 }  // namespace
 }  // namespace mongo
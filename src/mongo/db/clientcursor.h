@@ -31,6 +31,7 @@
 
 #include <boost/optional.hpp>
 #include <functional>
+#include <memory>
 
 #include "mongo/db/auth/privilege.h"
 #include "mongo/db/auth/user_name.h"
@@ -45,6 +46,7 @@ namespace mongo {
 
 class Collection;
 class CursorManager;
+class QueryShapeStats;
 class RecoveryUnit;
 
 /**
@@ -174,6 +176,10 @@ public:
         return _queryOptions & QueryOption_AwaitData;
     }
 
+    bool isNoTimeout() const {
+        return (_queryOptions & QueryOption_NoCursorTimeout);
+    }
+
     /**
      * Returns the original command object which created this cursor.
      */
@@ -242,6 +248,14 @@ public:
         return StringData(_planSummary);
     }
 
+    /**
+     * Returns the runtime statistics of the shape of the cursor's query, to which its getMores
+     * add, or nullptr if they are not being tracked.
+     */
+    const std::shared_ptr<QueryShapeStats>& getQueryShapeStats() const {
+        return _queryShapeStats;
+    }
+
     /**
      * Returns a generic cursor containing diagnostics about this cursor.
      * The caller must either have this cursor pinned or hold a mutex from the cursor manager.
@@ -335,10 +349,6 @@ private:
      */
     void dispose(OperationContext* opCtx);
 
-    bool isNoTimeout() const {
-        return (_queryOptions & QueryOption_NoCursorTimeout);
-    }
-
     // The ID of the ClientCursor. A value of 0 is used to mean that no cursor id has been assigned.
     const CursorId _cursorid = 0;
 
@@ -409,6 +419,9 @@ private:
     // A string with the plan summary of the cursor's query.
     std::string _planSummary;
 
+    // Inherited from the operation which created the cursor.
+    std::shared_ptr<QueryShapeStats> _queryShapeStats;
+
     // Commit point at the time the last batch was returned. This is only used by internal exhaust
     // oplog fetching. Also see lastKnownCommittedOpTime in GetMoreRequest.
     boost::optional<repl::OpTime> _lastKnownCommittedOpTime;
@@ -0,0 +1,248 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/logv2/log.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/unordered_set.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns the paths of the fields which some index of 'collection' could be used to answer
+ * predicates on, i.e. the fields of its regular (BTREE) indexes.
+ */
+std::vector<std::string> getIndexedPaths(OperationContext* opCtx, Collection* collection) {
+    std::vector<std::string> paths;
+    auto it = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (it->more()) {
+        const auto& keyPattern = it->next()->descriptor()->keyPattern();
+        if (IndexNames::findPluginName(keyPattern) != IndexNames::BTREE) {
+            continue;
+        }
+        for (auto&& elem : keyPattern) {
+            std::string path = elem.fieldName();
+            if (std::find(paths.begin(), paths.end(), path) == paths.end()) {
+                paths.push_back(std::move(path));
+            }
+        }
+    }
+    return paths;
+}
+
+/**
+ * Returns up to 'sampleSize' distinct documents of 'collection' picked at random. Large
+ * collections are sampled with a random cursor when the storage engine provides one; otherwise
+ * the whole collection is scanned.
+ */
+std::vector<BSONObj> sampleCollection(OperationContext* opCtx,
+                                      Collection* collection,
+                                      long long sampleSize) {
+    std::vector<BSONObj> sample;
+    const auto numRecords = collection->numRecords(opCtx);
+
+    if (numRecords > sampleSize) {
+        if (auto cursor = collection->getRecordStore()->getRandomCursor(opCtx)) {
+            // A random cursor may return the same record more than once, so give up after twice
+            // as many attempts as needed rather than looping for a long time on duplicates.
+            stdx::unordered_set<RecordId, RecordId::Hasher> seen;
+            for (long long attempts = 0;
+                 static_cast<long long>(sample.size()) < sampleSize && attempts < 2 * sampleSize;
+                 ++attempts) {
+                auto record = cursor->next();
+                if (!record) {
+                    break;
+                }
+                if (seen.insert(record->id).second) {
+                    sample.push_back(record->data.toBson().getOwned());
+                }
+                opCtx->checkForInterrupt();
+            }
+            return sample;
+        }
+    }
+
+    // Either the whole collection fits in the sample, or the storage engine cannot pick records
+    // at random. Scan the collection, keeping a uniform sample of what has been seen so far.
+    PseudoRandom random(SecureRandom().nextInt64());
+    auto cursor = collection->getCursor(opCtx);
+    long long numSeen = 0;
+    while (auto record = cursor->next()) {
+        ++numSeen;
+        if (static_cast<long long>(sample.size()) < sampleSize) {
+            sample.push_back(record->data.toBson().getOwned());
+        } else {
+            const auto pos = random.nextInt64(numSeen);
+            if (pos < sampleSize) {
+                sample[pos] = record->data.toBson().getOwned();
+            }
+        }
+        opCtx->checkForInterrupt();
+    }
+    return sample;
+}
+
+/**
+ * The 'analyze' command samples a collection and persists statistics about the values of some of
+ * its fields, which the query planner uses to estimate the cost of candidate plans:
+ *
+ *    {
+ *        analyze: <collection>,
+ *        sampleSize: <number of documents to sample>,
+ *        fields: [<dotted field path>, ...]
+ *    }
+ *
+ * Both 'sampleSize' and 'fields' are optional. By default, the fields of the collection's regular
+ * indexes are analyzed. Running the command again replaces the statistics of the collection.
+ */
+class CmdAnalyze final : public BasicCommand {
+public:
+    CmdAnalyze() : BasicCommand("analyze") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kNever;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return true;
+    }
+
+    std::string help() const override {
+        return "{ analyze: <collection>, sampleSize: <n>, fields: [<path>, ...] }\n"
+               "Collects statistics about a collection for the query planner.";
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::find);
+        actions.addAction(ActionType::planCacheWrite);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+        uassert(ErrorCodes::IllegalOperation,
+                str::stream() << "Cannot analyze " << nss,
+                !nss.isSystemDotStatistics());
+
+        long long sampleSize = internalQueryAnalyzeSampleSize.load();
+        if (auto elem = cmdObj["sampleSize"]) {
+            uassert(ErrorCodes::BadValue,
+                    "'sampleSize' must be a positive number",
+                    elem.isNumber() && elem.safeNumberLong() > 0);
+            sampleSize = elem.safeNumberLong();
+        }
+
+        std::vector<std::string> paths;
+        if (auto elem = cmdObj["fields"]) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "'fields' must be an array",
+                    elem.type() == BSONType::Array);
+            for (auto&& field : elem.Obj()) {
+                uassert(ErrorCodes::BadValue,
+                        "'fields' must contain non-empty field paths",
+                        field.type() == BSONType::String && !field.valueStringData().empty() &&
+                            field.valueStringData()[0] != '$');
+                paths.push_back(field.str());
+            }
+        }
+
+        BSONObj statsDoc;
+        size_t sampledDocuments = 0;
+        {
+            AutoGetCollectionForReadCommand ctx(opCtx, nss);
+            auto collection = ctx.getCollection();
+            uassert(ErrorCodes::NamespaceNotFound,
+                    str::stream() << "Collection " << nss << " does not exist",
+                    collection);
+
+            if (paths.empty()) {
+                paths = getIndexedPaths(opCtx, collection);
+            }
+
+            const auto sample = sampleCollection(opCtx, collection, sampleSize);
+            sampledDocuments = sample.size();
+            statsDoc = CollectionStatistics::build(nss,
+                                                   collection->uuid(),
+                                                   collection->numRecords(opCtx),
+                                                   sample,
+                                                   paths,
+                                                   internalQueryAnalyzeHistogramBuckets.load());
+        }
+
+        const auto statsNss = CollectionStatistics::makeStatisticsNss(nss);
+        writeConflictRetry(opCtx, "analyze", statsNss.ns(), [&] {
+            AutoGetCollection autoColl(opCtx, statsNss, MODE_IX);
+            uassert(ErrorCodes::NotMaster,
+                    str::stream() << "Not primary while writing statistics to " << statsNss,
+                    repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, statsNss));
+
+            WriteUnitOfWork wuow(opCtx);
+            Helpers::upsert(opCtx, statsNss.ns(), statsDoc);
+            wuow.commit();
+        });
+
+        LOGV2(4917703,
+              "Analyzed collection",
+              "namespace"_attr = nss,
+              "sampledDocuments"_attr = sampledDocuments,
+              "fields"_attr = paths);
+
+        result.appendNumber("sampledDocuments", static_cast<long long>(sampledDocuments));
+        result.append("fields", paths);
+        return true;
+    }
+} cmdAnalyze;
+
+}  // namespace
+}  // namespace mongo
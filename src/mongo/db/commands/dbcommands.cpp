@@ -359,6 +359,15 @@ public:
                     str::stream() << "'idIndex' is not allowed with 'autoIndexId': " << idIndexSpec,
                     !cmd.getAutoIndexId());
 
+            uassert(ErrorCodes::InvalidOptions,
+                    str::stream() << "'idIndex' is not allowed with 'clusteredIndex': "
+                                  << idIndexSpec,
+                    !cmd.getClusteredIndex());
+
+            uassert(ErrorCodes::InvalidOptions,
+                    str::stream() << "'idIndex' is not allowed with 'timeseries': " << idIndexSpec,
+                    !cmd.getTimeseries());
+
             // Perform index spec validation.
             idIndexSpec = uassertStatusOK(index_key_validate::validateIndexSpec(
                 opCtx, idIndexSpec, serverGlobalParams.featureCompatibility));
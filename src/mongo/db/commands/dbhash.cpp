@@ -362,7 +362,8 @@ private:
                                               PlanYieldPolicy::YieldPolicy::NO_YIELD,
                                               InternalPlanner::FORWARD,
                                               InternalPlanner::IXSCAN_FETCH);
-        } else if (collection->isCapped()) {
+        } else if (collection->isCapped() || collection->isClustered()) {
+            // A clustered collection is scanned in _id order, like its missing _id index.
             exec = InternalPlanner::collectionScan(
                 opCtx, nss.ns(), collection, PlanYieldPolicy::YieldPolicy::NO_YIELD);
         } else {
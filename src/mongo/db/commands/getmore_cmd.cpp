@@ -39,6 +39,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/getmore_read_ahead.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/cursor_manager.h"
@@ -447,6 +448,10 @@ public:
             validateLSID(opCtx, _request, cursorPin.getCursor());
             validateTxnNumber(opCtx, _request, cursorPin.getCursor());
 
+            // The batch prepared ahead of time, if any, is returned from the stash of the
+            // executor. A read-ahead which failed left its error in the executor as well.
+            GetMoreReadAhead::get(opCtx->getServiceContext()).collect(_request.cursorid);
+
             if (_request.nss.isOplog() && MONGO_unlikely(rsStopGetMoreCmd.shouldFail())) {
                 uasserted(ErrorCodes::CommandFailed,
                           str::stream() << "getMore on " << _request.nss.ns()
@@ -524,6 +529,9 @@ public:
                 curOp->setGenericCursor_inlock(cursorPin->toGenericCursor());
             }
 
+            // Add the work done by this getMore to the statistics of the cursor's query shape.
+            curOp->debug().queryShapeStats = cursorPin->getQueryShapeStats();
+
             // If the 'failGetMoreAfterCursorCheckout' failpoint is enabled, throw an exception with
             // the given 'errorCode' value, or ErrorCodes::InternalError if 'errorCode' is omitted.
             failGetMoreAfterCursorCheckout.executeIf(
@@ -678,6 +686,12 @@ public:
                 opCtx->lockState()->skipAcquireTicket();
             }
 
+            // A batch being prepared ahead of time holds the pin of the cursor until it is done.
+            // Its outcome is only looked at once the cursor is pinned and the client is known to
+            // be allowed to use it.
+            auto& readAhead = GetMoreReadAhead::get(opCtx->getServiceContext());
+            readAhead.waitFor(opCtx, _request.cursorid);
+
             auto cursorManager = CursorManager::get(opCtx);
             auto cursorPin = uassertStatusOK(cursorManager->pinCursor(opCtx, _request.cursorid));
 
@@ -707,6 +721,10 @@ public:
                     opCtx,
                     "waitBeforeUnpinningOrDeletingCursorAfterGetMoreBatch");
             }
+
+            if (cursorPin.getCursor()) {
+                readAhead.scheduleOrRelease(opCtx, cursorPin, _request.batchSize);
+            }
         }
 
         const GetMoreRequest _request;
@@ -0,0 +1,341 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/getmore_read_ahead.h"
+
+#include <vector>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/getmore_read_ahead_gen.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/cursor_manager.h"
+#include "mongo/db/cursor_server_params.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const auto getGetMoreReadAhead = ServiceContext::declareDecoration<GetMoreReadAhead>();
+
+Counter64 readAheadScheduled;
+Counter64 readAheadHits;
+Counter64 readAheadWaits;
+Counter64 readAheadSkipped;
+Counter64 readAheadFailed;
+
+ServerStatusMetricField<Counter64> displayReadAheadScheduled("getMore.readAhead.scheduled",
+                                                             &readAheadScheduled);
+ServerStatusMetricField<Counter64> displayReadAheadHits("getMore.readAhead.hits", &readAheadHits);
+ServerStatusMetricField<Counter64> displayReadAheadWaits("getMore.readAhead.waits",
+                                                         &readAheadWaits);
+ServerStatusMetricField<Counter64> displayReadAheadSkipped("getMore.readAhead.skipped",
+                                                           &readAheadSkipped);
+ServerStatusMetricField<Counter64> displayReadAheadFailed("getMore.readAhead.failed",
+                                                          &readAheadFailed);
+
+/**
+ * Moves up to one batch of documents from the plan of the cursor pinned by 'pin' into the stash of
+ * its PlanExecutor. Returns the number of bytes stashed.
+ */
+long long fillStash(OperationContext* opCtx,
+                    ClientCursorPin& pin,
+                    boost::optional<std::int64_t> batchSize) {
+    {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        repl::ReadConcernArgs::get(opCtx) = pin->getReadConcernArgs();
+    }
+
+    PlanExecutor* exec = pin->getExecutor();
+    AutoGetCollectionForRead readLock(opCtx, exec->nss());
+    uassertStatusOK(
+        repl::ReplicationCoordinator::get(opCtx)->checkCanServeReadsFor(opCtx, pin->nss(), true));
+
+    exec->reattachToOperationContext(opCtx);
+    exec->restoreState();
+
+    // The documents are collected before they are stashed, since getNext() returns the documents
+    // of the stash first.
+    std::vector<BSONObj> batch;
+    long long bytes = 0;
+    BSONObj obj;
+    while (!FindCommon::enoughForGetMore(batchSize.value_or(0), batch.size()) &&
+           PlanExecutor::ADVANCED == exec->getNext(&obj, nullptr)) {
+        const bool haveSpace = FindCommon::haveSpaceForNext(obj, batch.size(), bytes);
+        bytes += obj.objsize();
+        batch.push_back(obj.getOwned());
+        if (!haveSpace) {
+            break;
+        }
+    }
+
+    for (auto&& doc : batch) {
+        exec->enqueue(doc);
+    }
+
+    exec->saveState();
+    exec->detachFromOperationContext();
+    return bytes;
+}
+
+}  // namespace
+
+GetMoreReadAhead& GetMoreReadAhead::get(ServiceContext* serviceContext) {
+    return getGetMoreReadAhead(serviceContext);
+}
+
+void GetMoreReadAhead::waitFor(OperationContext* opCtx, CursorId id) {
+    if (_numEntries.load() == 0) {
+        return;
+    }
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    auto it = _entries.find(id);
+    if (it == _entries.end()) {
+        return;
+    }
+
+    if (it->second.done) {
+        readAheadHits.increment();
+        return;
+    }
+
+    readAheadWaits.increment();
+    opCtx->waitForConditionOrInterrupt(_cv, lk, [&] {
+        it = _entries.find(id);
+        return it == _entries.end() || it->second.done;
+    });
+}
+
+void GetMoreReadAhead::collect(CursorId id) {
+    if (_numEntries.load() == 0) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _entries.find(id);
+    if (it == _entries.end()) {
+        return;
+    }
+
+    invariant(it->second.done);
+    _bufferedBytes -= it->second.bytes;
+    _entries.erase(it);
+    _numEntries.store(_entries.size());
+}
+
+void GetMoreReadAhead::scheduleOrRelease(OperationContext* opCtx,
+                                         ClientCursorPin& pin,
+                                         boost::optional<std::int64_t> batchSize) {
+    ON_BLOCK_EXIT([&] { pin.release(); });
+
+    if (!gGetMoreReadAheadEnabled.load() || !_isEligible(opCtx, *pin.getCursor())) {
+        return;
+    }
+
+    const CursorId id = pin->cursorid();
+    const long long reservedBytes = FindCommon::kMaxBytesToReturnToClientAtOnce;
+    ThreadPool* pool;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_inShutdown || _entries.count(id)) {
+            return;
+        }
+
+        const auto maxBufferedBytes = gGetMoreReadAheadMaxBufferedBytes.load();
+        if (_bufferedBytes + reservedBytes > maxBufferedBytes) {
+            _reapAbandoned_inlock(opCtx->getServiceContext()->getFastClockSource()->now());
+        }
+        if (_bufferedBytes + reservedBytes > maxBufferedBytes) {
+            readAheadSkipped.increment();
+            return;
+        }
+
+        // The entry is published before the cursor is unpinned, so that the next getMore waits for
+        // the read-ahead instead of racing it for the pin.
+        _entries[id].bytes = reservedBytes;
+        _bufferedBytes += reservedBytes;
+        _numEntries.store(_entries.size());
+        pool = _getPool_inlock();
+    }
+
+    pin.release();
+    readAheadScheduled.increment();
+    pool->schedule([this, id, batchSize](Status status) {
+        if (!status.isOK()) {
+            _finish(id, false, 0);
+            return;
+        }
+        _readAhead(id, batchSize);
+    });
+}
+
+void GetMoreReadAhead::shutdown() {
+    ThreadPool* pool;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _inShutdown = true;
+        pool = _pool.get();
+    }
+
+    if (pool) {
+        pool->shutdown();
+        pool->join();
+    }
+}
+
+bool GetMoreReadAhead::_isEligible(OperationContext* opCtx, const ClientCursor& cursor) const {
+    // Cursors of a DBDirectClient are used from their originating operation only.
+    if (opCtx->getClient()->isInDirectClient()) {
+        return false;
+    }
+
+    // Aggregation cursors lock internally and may read from several collections.
+    if (cursor.getExecutor()->lockPolicy() != PlanExecutor::LockPolicy::kLockExternally) {
+        return false;
+    }
+
+    // Awaiting data only makes sense on behalf of a client, and the read-ahead could not charge its
+    // time against the maxTimeMS of the cursor.
+    if (cursor.isTailable() || cursor.isNoTimeout() || cursor.getTxnNumber() ||
+        cursor.getLeftoverMaxTimeMicros() < Microseconds::max()) {
+        return false;
+    }
+
+    // Other read concerns read from a snapshot chosen by the operation using the cursor.
+    const auto level = cursor.getReadConcernArgs().getLevel();
+    return level == repl::ReadConcernLevel::kLocalReadConcern ||
+        level == repl::ReadConcernLevel::kAvailableReadConcern;
+}
+
+void GetMoreReadAhead::_readAhead(CursorId id, boost::optional<std::int64_t> batchSize) {
+    auto opCtx = cc().makeOperationContext();
+    Status status = Status::OK();
+    long long bytes = 0;
+
+    try {
+        // The cursor may have been killed or have timed out since it was unpinned, in which case
+        // the next getMore reports it.
+        auto swPin = CursorManager::get(opCtx.get())
+                         ->pinCursor(opCtx.get(), id, CursorManager::kNoCheckSession);
+        if (swPin.isOK()) {
+            auto& pin = swPin.getValue();
+            try {
+                bytes = fillStash(opCtx.get(), pin, batchSize);
+            } catch (const DBException& ex) {
+                // Rather than killing the cursor here, leave the error to the next getMore, which
+                // only reports it once it has checked that its client may use the cursor.
+                status = ex.toStatus();
+                PlanExecutor* exec = pin->getExecutor();
+                exec->markAsKilled(status);
+                if (exec->getOpCtx()) {
+                    exec->saveState();
+                    exec->detachFromOperationContext();
+                }
+            }
+        }
+    } catch (const DBException& ex) {
+        LOGV2_DEBUG(4918000,
+                    2,
+                    "Could not pin cursor for getMore read-ahead",
+                    "cursorId"_attr = id,
+                    "error"_attr = ex.toStatus());
+    }
+
+    if (!status.isOK()) {
+        LOGV2_DEBUG(4918001,
+                    1,
+                    "getMore read-ahead failed",
+                    "cursorId"_attr = id,
+                    "error"_attr = status);
+    }
+
+    // The cursor is unpinned by now, so the getMore waiting for this read-ahead can pin it.
+    _finish(id, !status.isOK(), bytes);
+}
+
+void GetMoreReadAhead::_finish(CursorId id, bool failed, long long bytes) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _entries.find(id);
+    invariant(it != _entries.end());
+
+    auto& entry = it->second;
+    if (failed) {
+        readAheadFailed.increment();
+    }
+    _bufferedBytes += bytes - entry.bytes;
+    entry.bytes = bytes;
+    entry.done = true;
+    entry.doneDate = getGlobalServiceContext()->getFastClockSource()->now();
+    _cv.notify_all();
+}
+
+void GetMoreReadAhead::_reapAbandoned_inlock(Date_t now) {
+    // Eligible cursors always time out, so a finished read-ahead that no getMore collected within
+    // the cursor timeout belongs to a cursor which is gone.
+    const auto cutoff = now - Milliseconds(getCursorTimeoutMillis());
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (it->second.done && it->second.doneDate < cutoff) {
+            _bufferedBytes -= it->second.bytes;
+            _entries.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+    _numEntries.store(_entries.size());
+}
+
+ThreadPool* GetMoreReadAhead::_getPool_inlock() {
+    if (!_pool) {
+        ThreadPool::Options options;
+        options.poolName = "GetMoreReadAhead";
+        options.minThreads = 0;
+        options.maxThreads = gGetMoreReadAheadThreads;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+        _pool = std::make_unique<ThreadPool>(std::move(options));
+        _pool->startup();
+    }
+    return _pool.get();
+}
+
+}  // namespace mongo
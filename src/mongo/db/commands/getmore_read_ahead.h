@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <memory>
+
+#include "mongo/base/status.h"
+#include "mongo/db/clientcursor.h"
+#include "mongo/db/cursor_id.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Prepares the next batch of a find cursor in the background while the client consumes the batch
+ * a getMore just returned, so that the following getMore can be answered without scanning.
+ *
+ * After a getMore leaves an eligible cursor open, it hands the cursor off to a bounded pool of
+ * threads instead of unpinning it. A pool thread pins the cursor with its own operation, takes the
+ * collection lock, and moves up to one batch worth of documents from the plan into the stash of
+ * the cursor's PlanExecutor, which later getMores drain before asking the plan for more. The plan
+ * yields as usual while it runs, and killOp and killCursors interrupt the read-ahead through its
+ * operation like any other user of the cursor. A read-ahead which fails marks the PlanExecutor of
+ * the cursor as killed, so that the next getMore reports the error once it has checked that its
+ * client may use the cursor.
+ *
+ * Only cursors whose results do not depend on which operation produces them are eligible: find
+ * cursors with "local" or "available" read concern, outside transactions, that are neither
+ * tailable, "no timeout" nor subject to maxTimeMS. The documents held by prepared batches which
+ * have not been returned yet are bounded by 'getMoreReadAheadMaxBufferedBytes'.
+ */
+class GetMoreReadAhead {
+public:
+    static GetMoreReadAhead& get(ServiceContext* serviceContext);
+
+    /**
+     * Waits for the read-ahead of cursor 'id', if any, to finish, since it holds the pin of the
+     * cursor until then. Must be called before pinning the cursor for a getMore. The wait is
+     * interruptible.
+     */
+    void waitFor(OperationContext* opCtx, CursorId id);
+
+    /**
+     * Stops charging the documents prepared for cursor 'id' against the buffered bytes, as they
+     * are about to be returned. Must be called once the getMore has pinned the cursor and checked
+     * that its client may use it.
+     */
+    void collect(CursorId id);
+
+    /**
+     * Starts preparing the next batch of the cursor pinned by 'pin', of at most 'batchSize'
+     * documents, if read-ahead is enabled and the cursor is eligible. Releases 'pin' in either
+     * case.
+     */
+    void scheduleOrRelease(OperationContext* opCtx,
+                           ClientCursorPin& pin,
+                           boost::optional<std::int64_t> batchSize);
+
+    /**
+     * Stops accepting read-aheads and waits for the ones in progress to finish.
+     */
+    void shutdown();
+
+private:
+    struct Entry {
+        // Whether the read-ahead finished.
+        bool done = false;
+
+        // The bytes of documents charged against 'getMoreReadAheadMaxBufferedBytes'. This is the
+        // largest possible batch while the read-ahead runs, and the size of the documents it
+        // stashed once it is done.
+        long long bytes = 0;
+
+        Date_t doneDate;
+    };
+
+    bool _isEligible(OperationContext* opCtx, const ClientCursor& cursor) const;
+
+    void _readAhead(CursorId id, boost::optional<std::int64_t> batchSize);
+
+    void _finish(CursorId id, bool failed, long long bytes);
+
+    void _reapAbandoned_inlock(Date_t now);
+
+    ThreadPool* _getPool_inlock();
+
+    Mutex _mutex = MONGO_MAKE_LATCH("GetMoreReadAhead::_mutex");
+    stdx::condition_variable _cv;
+
+    stdx::unordered_map<CursorId, Entry> _entries;
+    long long _bufferedBytes = 0;
+    bool _inShutdown = false;
+
+    // Mirrors _entries.size(), so that getMores do not take the mutex when nothing is read ahead.
+    AtomicWord<size_t> _numEntries{0};
+
+    std::unique_ptr<ThreadPool> _pool;
+};
+
+}  // namespace mongo
@@ -210,10 +210,16 @@ public:
         result.append("extraIndexEntries", validateResults.extraIndexEntries);
         result.append("missingIndexEntries", validateResults.missingIndexEntries);
 
-        // Need to convert RecordId to int64_t to append to BSONObjBuilder
+        // Need to convert RecordId to int64_t, or to BinData for clustered collections, to append
+        // to BSONObjBuilder
         BSONArrayBuilder builder;
-        for (RecordId corruptRecord : validateResults.corruptRecords) {
-            builder.append(corruptRecord.repr());
+        for (const RecordId& corruptRecord : validateResults.corruptRecords) {
+            if (corruptRecord.isStr()) {
+                const auto str = corruptRecord.getStr();
+                builder.appendBinData(str.size(), BinDataGeneral, str.rawData());
+            } else {
+                builder.append(corruptRecord.repr());
+            }
         }
         result.append("corruptRecords", builder.done());
 
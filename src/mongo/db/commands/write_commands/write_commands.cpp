@@ -31,6 +31,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/bson/mutable/element.h"
+#include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/client.h"
@@ -56,8 +57,12 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/storage/duplicate_key_error_info.h"
+#include "mongo/db/storage/durable_catalog.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/db/views/view_catalog.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/s/stale_exception.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -85,6 +90,145 @@ bool shouldSkipOutput(OperationContext* opCtx) {
          writeConcern.syncMode == WriteConcernOptions::SyncMode::UNSET);
 }
 
+/**
+ * Returns the options and the UUID of the buckets collection if 'ns' is the view of a time-series
+ * collection.
+ */
+boost::optional<std::pair<TimeseriesOptions, UUID>> getTimeseriesBuckets(
+    OperationContext* opCtx, const NamespaceString& ns) {
+    // Check the catalog before locking, so that regular inserts do not pay for the lookup.
+    const auto bucketsNs = ns.makeTimeseriesBucketsNamespace();
+    if (!CollectionCatalog::get(opCtx).lookupCollectionByNamespace(opCtx, bucketsNs)) {
+        return boost::none;
+    }
+
+    AutoGetCollection autoColl(opCtx, bucketsNs, MODE_IS);
+    auto coll = autoColl.getCollection();
+    if (!coll) {
+        return boost::none;
+    }
+
+    auto view = ViewCatalog::get(autoColl.getDb())->lookup(opCtx, ns.ns());
+    if (!view || view->viewOn() != bucketsNs) {
+        return boost::none;
+    }
+
+    auto options = DurableCatalog::get(opCtx)->getCollectionOptions(opCtx, coll->getCatalogId());
+    if (!options.timeseries) {
+        return boost::none;
+    }
+    return std::make_pair(*options.timeseries, coll->uuid());
+}
+
+/**
+ * Inserts the measurements of 'batch' into the buckets collection of the time-series collection
+ * 'batch.getNamespace()'. The measurements are assigned to the buckets they belong to, then each
+ * bucket receives all of its measurements from the batch with a single upsert.
+ */
+WriteResult performTimeseriesInserts(OperationContext* opCtx,
+                                     const write_ops::Insert& batch,
+                                     const TimeseriesOptions& options,
+                                     const UUID& bucketsUUID) {
+    uassert(ErrorCodes::OperationNotSupportedInTransaction,
+            str::stream() << "Cannot insert into a time-series collection in a multi-document "
+                             "transaction: "
+                          << batch.getNamespace(),
+            !opCtx->inMultiDocumentTransaction());
+    uassert(ErrorCodes::InvalidOptions,
+            str::stream() << "Retryable writes are not supported on time-series collections: "
+                          << batch.getNamespace(),
+            !opCtx->getTxnNumber());
+
+    const auto& documents = batch.getDocuments();
+    const bool ordered = batch.getWriteCommandBase().getOrdered();
+    auto& bucketCatalog = BucketCatalog::get(opCtx);
+
+    // The bucket update each measurement was added to, or the error which prevented adding it.
+    //
+    // An ordered write must apply the measurements in order and stop at the first failure. Each of
+    // its updates therefore only holds consecutive measurements, so that a failed update never
+    // follows one which wrote a later measurement. An unordered write updates each bucket once.
+    std::vector<StatusWith<size_t>> measurementBuckets;
+    std::vector<BucketCatalog::BucketUpdate> bucketUpdates;
+    stdx::unordered_map<OID, size_t, OID::Hasher> bucketIndexes;
+    for (const auto& measurement : documents) {
+        auto result = bucketCatalog.insert(bucketsUUID, options, measurement);
+        if (!result.isOK()) {
+            measurementBuckets.push_back(result.getStatus());
+            if (ordered) {
+                break;
+            }
+            continue;
+        }
+
+        const auto& [bucketId, index] = result.getValue();
+        auto it = bucketIndexes.find(bucketId);
+        if (it == bucketIndexes.end()) {
+            if (ordered) {
+                // Only the last update of an ordered write may take more measurements.
+                bucketIndexes.clear();
+            }
+            it = bucketIndexes.emplace(bucketId, bucketUpdates.size()).first;
+            auto meta = options.getMetaField() ? measurement[*options.getMetaField()]
+                                               : BSONElement();
+            bucketUpdates.emplace_back(bucketId, meta);
+        }
+        bucketUpdates[it->second].addMeasurement(options, index, measurement);
+        measurementBuckets.push_back(it->second);
+    }
+
+    std::vector<write_ops::UpdateOpEntry> updates;
+    for (auto& bucketUpdate : bucketUpdates) {
+        write_ops::UpdateOpEntry update(bucketUpdate.getQuery(),
+                                        write_ops::UpdateModification(bucketUpdate.getUpdate()));
+        update.setUpsert(true);
+        updates.push_back(std::move(update));
+    }
+
+    // The catalog already counts the measurements of every update, so the buckets of the updates
+    // which fail or are never applied must not take any more measurements.
+    std::vector<StatusWith<SingleWriteResult>> bucketResults;
+    ON_BLOCK_EXIT([&] {
+        for (size_t i = 0; i < bucketUpdates.size(); ++i) {
+            if (i >= bucketResults.size() || !bucketResults[i].isOK()) {
+                bucketCatalog.clear(bucketsUUID, bucketUpdates[i]);
+            }
+        }
+    });
+    if (!updates.empty()) {
+        write_ops::Update updateOp(batch.getNamespace().makeTimeseriesBucketsNamespace(),
+                                   std::move(updates));
+        updateOp.setWriteCommandBase([&] {
+            write_ops::WriteCommandBase base;
+            base.setOrdered(ordered);
+            return base;
+        }());
+        bucketResults = performUpdates(opCtx, updateOp).results;
+    }
+
+    WriteResult result;
+    for (auto&& bucket : measurementBuckets) {
+        if (!bucket.isOK()) {
+            result.results.push_back(bucket.getStatus());
+        } else if (bucket.getValue() >= bucketResults.size()) {
+            // An ordered write stopped before reaching this bucket.
+            break;
+        } else if (!bucketResults[bucket.getValue()].isOK()) {
+            result.results.push_back(bucketResults[bucket.getValue()].getStatus());
+        } else {
+            SingleWriteResult singleResult;
+            singleResult.setN(1);
+            singleResult.setNModified(0);
+            result.results.push_back(std::move(singleResult));
+        }
+
+        if (ordered && !result.results.back().isOK()) {
+            break;
+        }
+    }
+    return result;
+}
+
 enum class ReplyStyle { kUpdate, kNotUpdate };  // update has extra fields.
 void serializeReply(OperationContext* opCtx,
                     ReplyStyle replyStyle,
@@ -302,7 +446,11 @@ private:
         }
 
         void runImpl(OperationContext* opCtx, BSONObjBuilder& result) const override {
-            auto reply = performInserts(opCtx, _batch);
+            const auto& ns = _batch.getNamespace();
+            auto buckets = ns.isSystem() ? boost::none : getTimeseriesBuckets(opCtx, ns);
+            auto reply = buckets
+                ? performTimeseriesInserts(opCtx, _batch, buckets->first, buckets->second)
+                : performInserts(opCtx, _batch);
             serializeReply(opCtx,
                            ReplyStyle::kNotUpdate,
                            !_batch.getWriteCommandBase().getOrdered(),
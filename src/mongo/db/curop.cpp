@@ -49,6 +49,7 @@
 #include "mongo/db/prepare_conflict_tracker.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/stats/query_shape_stats.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
@@ -443,6 +444,16 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
 
     const auto executionTimeMillis = durationCount<Milliseconds>(_debug.executionTime);
 
+    if (_debug.queryShapeStats) {
+        // A getMore continues the execution counted by the operation that created the cursor.
+        _debug.queryShapeStats->record(_debug.logicalOp != LogicalOp::opGetMore,
+                                       _debug.executionTime,
+                                       _debug.additiveMetrics.docsExamined.value_or(0),
+                                       _debug.additiveMetrics.keysExamined.value_or(0),
+                                       std::max(_debug.nreturned, 0LL),
+                                       opCtx->getServiceContext()->getFastClockSource()->now());
+    }
+
     if (_debug.isReplOplogGetMore) {
         oplogGetMoreStats.recordMillis(executionTimeMillis);
     }
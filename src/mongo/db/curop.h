@@ -53,6 +53,7 @@ class Client;
 class CurOp;
 class OperationContext;
 struct PlanSummaryStats;
+class QueryShapeStats;
 
 /* lifespan is different than CurOp because of recursives with DBDirectClient */
 class OpDebug {
@@ -229,6 +230,10 @@ public:
     // The hash of the query's "stable" key. This represents the query's shape.
     boost::optional<uint32_t> queryHash;
 
+    // The runtime statistics of the query's shape, which this operation adds to on completion.
+    // Only the first query planned by the operation is tracked.
+    std::shared_ptr<QueryShapeStats> queryShapeStats;
+
     // Details of any error (whether from an exception or a command returning failure).
     Status errInfo = Status::OK();
 
@@ -138,6 +138,13 @@ bool Helpers::findById(OperationContext* opCtx,
     if (nsFound)
         *nsFound = true;
 
+    if (collection->isClustered()) {
+        // The record store is keyed by _id, and the query plans a scan of just that RecordId.
+        if (indexFound)
+            *indexFound = 1;
+        return findOne(opCtx, collection, query["_id"].wrap(), result);
+    }
+
     IndexCatalog* catalog = collection->getIndexCatalog();
     const IndexDescriptor* desc = catalog->findIdIndex(opCtx);
 
@@ -158,6 +165,11 @@ RecordId Helpers::findById(OperationContext* opCtx,
                            Collection* collection,
                            const BSONObj& idquery) {
     verify(collection);
+    if (collection->isClustered()) {
+        // The record store is keyed by _id, and the query plans a scan of just that RecordId.
+        return findOne(opCtx, collection, idquery["_id"].wrap(), false);
+    }
+
     IndexCatalog* catalog = collection->getIndexCatalog();
     const IndexDescriptor* desc = catalog->findIdIndex(opCtx);
     uassert(13430, "no _id index", desc);
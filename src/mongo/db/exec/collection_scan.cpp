@@ -70,6 +70,8 @@ CollectionScan::CollectionScan(ExpressionContext* expCtx,
     _specificStats.minTs = params.minTs;
     _specificStats.maxTs = params.maxTs;
     _specificStats.tailable = params.tailable;
+    _specificStats.minRecord = params.minRecord;
+    _specificStats.maxRecord = params.maxRecord;
     if (params.minTs || params.maxTs) {
         // The 'minTs' and 'maxTs' parameters are used for a special optimization that
         // applies only to forwards scans of the oplog.
@@ -79,12 +81,25 @@ CollectionScan::CollectionScan(ExpressionContext* expCtx,
     }
     invariant(!_params.shouldTrackLatestOplogTimestamp || collection->ns().isOplog());
 
+    if (params.minRecord || params.maxRecord) {
+        // The 'minRecord' and 'maxRecord' parameters restrict scans of clustered collections to
+        // the RecordIds of the range of _ids the query asks for.
+        invariant(collection->isClustered());
+        invariant(!params.resumeAfterRecordId);
+    }
+
     if (params.resumeAfterRecordId) {
         // The 'resumeAfterRecordId' parameter is used for resumable collection scans, which we
         // only support in the forward direction.
         invariant(params.direction == CollectionScanParams::FORWARD);
     }
 
+    // Resume tokens hold the RecordId as a NumberLong.
+    uassert(ErrorCodes::InvalidOptions,
+            "Resumable scans are not supported on clustered collections",
+            !collection->isClustered() ||
+                (!params.resumeAfterRecordId && !params.requestResumeToken));
+
     // Set early stop condition.
     if (params.maxTs) {
         _endConditionBSON = BSON("$gte"_sd << *(params.maxTs));
@@ -175,6 +190,27 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
             }
         }
 
+        if (_lastSeenId.isNull() && !record) {
+            // Seek to the start of the range of a clustered collection scan.
+            const auto& start = _params.direction == CollectionScanParams::FORWARD
+                ? _params.minRecord
+                : _params.maxRecord;
+            if (start) {
+                boost::optional<RecordId> startLoc =
+                    collection()->getRecordStore()->oplogStartHack(opCtx(), *start);
+                if (startLoc && !startLoc->isNull()) {
+                    record = _cursor->seekExact(*startLoc);
+
+                    // The seek lands on the last record at or before 'minRecord'. A forward scan
+                    // begins with the record after it when it is not an exact match.
+                    if (record && _params.direction == CollectionScanParams::FORWARD &&
+                        record->id < *start) {
+                        record = boost::none;
+                    }
+                }
+            }
+        }
+
         if (!record) {
             record = _cursor->next();
         }
@@ -199,6 +235,11 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (isPastEndOfRange(record->id)) {
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
     _lastSeenId = record->id;
     if (_params.shouldTrackLatestOplogTimestamp) {
         setLatestOplogEntryTimestamp(*record);
@@ -213,6 +254,13 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     return returnIfMatches(member, id, out);
 }
 
+bool CollectionScan::isPastEndOfRange(const RecordId& id) const {
+    if (_params.direction == CollectionScanParams::FORWARD) {
+        return _params.maxRecord && id > *_params.maxRecord;
+    }
+    return _params.minRecord && id < *_params.minRecord;
+}
+
 void CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
     auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
     uassert(ErrorCodes::Error(4382100),
@@ -74,7 +74,14 @@ public:
     }
 
     BSONObj getPostBatchResumeToken() const {
-        return _params.requestResumeToken ? BSON("$recordId" << _lastSeenId.repr()) : BSONObj();
+        if (!_params.requestResumeToken) {
+            return BSONObj();
+        }
+        // Scans of clustered collections, whose RecordIds are strings, refuse to produce resume
+        // tokens, but the token never assumes the RecordId is an integer.
+        BSONObjBuilder builder;
+        _lastSeenId.appendToBSONAs(&builder, "$recordId"_sd);
+        return builder.obj();
     }
 
     std::unique_ptr<PlanStageStats> getStats() final;
@@ -100,6 +107,12 @@ private:
      */
     void setLatestOplogEntryTimestamp(const Record& record);
 
+    /**
+     * Returns true if 'id' lies past the end of the range of RecordIds the scan is restricted to
+     * by 'minRecord' and 'maxRecord', in the direction of the scan.
+     */
+    bool isPastEndOfRange(const RecordId& id) const;
+
     // WorkingSet is not owned by us.
     WorkingSet* _workingSet;
 
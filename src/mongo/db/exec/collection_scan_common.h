@@ -53,6 +53,13 @@ struct CollectionScanParams {
     // This field cannot be used in conjunction with 'resumeAfterRecordId'.
     boost::optional<Timestamp> maxTs;
 
+    // If present, the collection scan will only return records whose RecordIds lie within
+    // ['minRecord', 'maxRecord']: it seeks to the first record in range and returns EOF once it
+    // sees a record past the other end. Must only be set on scans of clustered collections.
+    // These fields cannot be used in conjunction with 'resumeAfterRecordId' or 'tailable'.
+    boost::optional<RecordId> minRecord;
+    boost::optional<RecordId> maxRecord;
+
     // If true, the collection scan will return a token that can be used to resume the scan.
     bool requestResumeToken = false;
 
@@ -38,6 +38,7 @@
 #include "mongo/db/exec/document_value/document_metadata_fields.h"
 #include "mongo/db/exec/document_value/value.h"
 #include "mongo/stdx/variant.h"
+#include "mongo/util/bump_arena.h"
 #include "mongo/util/intrusive_counter.h"
 
 namespace mongo {
@@ -129,7 +130,7 @@ public:
     // Round number or pointer up to N-byte boundary. No change if already aligned.
     template <typename T>
     static T align(T size) {
-        const intmax_t ALIGNMENT = 8;  // must be power of 2 and <= 16 (malloc alignment)
+        const intmax_t ALIGNMENT = 8;  // must be power of 2 and <= BumpArena::kAlignment
         // Can't use c++ cast because of conversion between intmax_t and both ints and pointers
         return (T)(((intmax_t)(size) + (ALIGNMENT - 1)) & ~(ALIGNMENT - 1));
     }
@@ -297,6 +298,15 @@ public:
 
     ~DocumentStorage();
 
+    // The storage and its buffer come from the BumpArena of the thread creating them, if any.
+    static void* operator new(size_t size) {
+        MONGO_STATIC_ASSERT(alignof(DocumentStorage) <= BumpArena::kAlignment);
+        return BumpArena::allocate(size);
+    }
+    static void operator delete(void* ptr) {
+        BumpArena::deallocate(ptr);
+    }
+
     void reset(const BSONObj& bson, bool stripMetadata);
 
     static const DocumentStorage& emptyDoc() {
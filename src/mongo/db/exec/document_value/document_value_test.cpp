@@ -137,6 +137,29 @@ TEST(DocumentConstruction, FromBsonReset) {
     ASSERT_BSONOBJ_EQ(bson, toBson(newDocument));
 }
 
+TEST(DocumentConstruction, FromArenaOutlivesArena) {
+    const auto chunkBytes = mongo::BumpArena::totalChunkBytes();
+    const std::string longString(100, 'x');
+    boost::optional<Document> document;
+    {
+        mongo::BumpArena arena;
+        mongo::BumpArena::Scope scope(&arena);
+        MutableDocument md(fromBson(BSON("a" << 1 << "b" << BSON("c" << 2))));
+        md.setField("s", mongo::Value(longString));
+        md.setField("arr", mongo::Value(std::vector<mongo::Value>{mongo::Value(longString)}));
+        md.setNestedField("b.d", mongo::Value("nested"_sd));
+        document = md.freeze();
+        ASSERT_GT(mongo::BumpArena::totalChunkBytes(), chunkBytes);
+    }
+
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << BSON("c" << 2 << "d"
+                                                         << "nested")
+                               << "s" << longString << "arr" << BSON_ARRAY(longString)),
+                      toBson(*document));
+    document.reset();
+    ASSERT_EQ(mongo::BumpArena::totalChunkBytes(), chunkBytes);
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
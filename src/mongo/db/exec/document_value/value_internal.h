@@ -38,6 +38,7 @@
 #include "mongo/bson/bsontypes.h"
 #include "mongo/bson/oid.h"
 #include "mongo/bson/timestamp.h"
+#include "mongo/util/bump_arena.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/intrusive_counter.h"
 
@@ -53,6 +54,14 @@ class RCVector : public RefCountable {
 public:
     RCVector() {}
     RCVector(std::vector<Value> v) : vec(std::move(v)) {}
+
+    static void* operator new(size_t size) {
+        return BumpArena::allocate(size);
+    }
+    static void operator delete(void* ptr) {
+        BumpArena::deallocate(ptr);
+    }
+
     std::vector<Value> vec;
 };
 
@@ -82,6 +82,7 @@ IndexScan::IndexScan(ExpressionContext* expCtx,
     _specificStats.isUnique = params.indexDescriptor->unique();
     _specificStats.isSparse = params.indexDescriptor->isSparse();
     _specificStats.isPartial = params.indexDescriptor->isPartial();
+    _specificStats.isSkipScan = params.isSkipScan;
     _specificStats.indexVersion = static_cast<int>(params.indexDescriptor->version());
     _specificStats.collation = params.indexDescriptor->infoObj()
                                    .getObjectField(IndexDescriptor::kCollationFieldName)
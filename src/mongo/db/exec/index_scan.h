@@ -80,6 +80,9 @@ struct IndexScanParams {
 
     // Do we want to add the key as metadata?
     bool addKeyMetadata{false};
+
+    // Was this scan planned to skip over the distinct values of the leading index fields?
+    bool isSkipScan{false};
 };
 
 /**
@@ -41,6 +41,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/trial_period_utils.h"
@@ -49,7 +50,12 @@
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -69,6 +75,167 @@ void markShouldCollectTimingInfoOnSubtree(PlanStage* root) {
         markShouldCollectTimingInfoOnSubtree(child.get());
     }
 }
+
+/**
+ * Returns true if the stages built for 'node' and its descendants only use the storage engine
+ * through the OperationContext they are attached to, so that they can be worked on another thread.
+ */
+bool canWorkOnAnyThread(const QuerySolutionNode* node) {
+    switch (node->getType()) {
+        case STAGE_AND_HASH:
+        case STAGE_AND_SORTED:
+        case STAGE_COLLSCAN:
+        case STAGE_COUNT_SCAN:
+        case STAGE_DISTINCT_SCAN:
+        case STAGE_ENSURE_SORTED:
+        case STAGE_FETCH:
+        case STAGE_IXSCAN:
+        case STAGE_LIMIT:
+        case STAGE_OR:
+        case STAGE_PROJECTION_COVERED:
+        case STAGE_PROJECTION_DEFAULT:
+        case STAGE_PROJECTION_SIMPLE:
+        case STAGE_RETURN_KEY:
+        case STAGE_SHARDING_FILTER:
+        case STAGE_SKIP:
+        case STAGE_SORT_DEFAULT:
+        case STAGE_SORT_KEY_GENERATOR:
+        case STAGE_SORT_MERGE:
+        case STAGE_SORT_SIMPLE:
+            break;
+        default:
+            // Notably, geoNear and text stages build parts of their trees as they are worked.
+            return false;
+    }
+
+    return std::all_of(node->children.begin(), node->children.end(), canWorkOnAnyThread);
+}
+
+/**
+ * Returns true if evaluating 'expr' uses the ExpressionContext of the query, whose Variables,
+ * JavaScript scope and OperationContext belong to the operation's thread.
+ */
+bool dependsOnExpressionContext(const MatchExpression* expr) {
+    if (expr->matchType() == MatchExpression::EXPRESSION ||
+        expr->matchType() == MatchExpression::WHERE) {
+        return true;
+    }
+
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (dependsOnExpressionContext(expr->getChild(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ThreadPool& getParallelTrialPool() {
+    // Never destroyed, since operations may still be planning queries when the server shuts down.
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "ParallelPlanEvaluation";
+        options.minThreads = 0;
+        options.maxThreads = internalQueryPlanEvaluationParallelThreads;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+        auto pool = new ThreadPool(std::move(options));
+        pool->startup();
+        return pool;
+    }();
+    return *pool;
+}
+
+/**
+ * What a thread of the parallel trial pool needs to know about the operation whose candidate plans
+ * it works.
+ */
+struct ParallelTrialContext {
+    NamespaceString nss;
+    Timestamp readTimestamp;
+    PrepareConflictBehavior prepareConflictBehavior;
+    bool shouldConflictWithSecondaryBatchApplication;
+    size_t numWorks;
+    size_t numResults;
+
+    // Set once some candidate plan has hit EOF or returned enough results, or the operation has
+    // been interrupted, to stop the other candidate plans.
+    AtomicWord<bool> stop{false};
+};
+
+/**
+ * Works the detached candidate plan 'candidate' on the current thread. Returns true if its trial
+ * period completed, or false if it had to be given up, e.g. because the locks it needs could not
+ * be acquired without waiting. Either way, the candidate plan is saved and detached on return.
+ *
+ * A candidate which did not get to work at all, because another one had already ended the trial
+ * period, also returns false: the ranking needs at least one work() from every candidate, so the
+ * round-robin trial on the operation's thread has to make up for it.
+ */
+bool workCandidatePlan(ParallelTrialContext* trial, plan_ranker::CandidatePlan* candidate) {
+    auto opCtx = cc().makeOperationContext();
+    opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kProvided,
+                                                  trial->readTimestamp);
+    opCtx->recoveryUnit()->setPrepareConflictBehavior(trial->prepareConflictBehavior);
+
+    boost::optional<ShouldNotConflictWithSecondaryBatchApplicationBlock> noPBWMBlock;
+    if (!trial->shouldConflictWithSecondaryBatchApplication) {
+        noPBWMBlock.emplace(opCtx->lockState());
+    }
+
+    // The operation being planned already holds compatible locks, so these can only be unavailable
+    // if a conflicting request is queued behind it. Waiting for them would deadlock.
+    boost::optional<Lock::DBLock> dbLock;
+    boost::optional<Lock::CollectionLock> collLock;
+    try {
+        dbLock.emplace(opCtx.get(), trial->nss.db(), MODE_IS, Date_t::now());
+        collLock.emplace(opCtx.get(), trial->nss, MODE_IS, Date_t::now());
+    } catch (const ExceptionFor<ErrorCodes::LockTimeout>&) {
+        return false;
+    }
+
+    auto root = candidate->root;
+    root->reattachToOperationContext(opCtx.get());
+    auto detachGuard = makeGuard([&] {
+        // The stages must release their storage engine resources before 'opCtx' goes away.
+        try {
+            root->saveState();
+        } catch (...) {
+        }
+        root->detachFromOperationContext();
+    });
+    root->restoreState();
+
+    size_t ix = 0;
+    for (; ix < trial->numWorks && !trial->stop.load(); ++ix) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        try {
+            state = root->work(&id);
+        } catch (const ExceptionFor<ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed>&) {
+            candidate->failed = true;
+            return true;
+        }
+
+        if (PlanStage::ADVANCED == state) {
+            WorkingSetMember* member = candidate->data->get(id);
+            member->makeObjOwnedIfNeeded();
+            candidate->results.push(id);
+
+            if (candidate->results.size() >= trial->numResults) {
+                trial->stop.store(true);
+                return true;
+            }
+        } else if (PlanStage::IS_EOF == state) {
+            trial->stop.store(true);
+            return true;
+        } else if (PlanStage::NEED_YIELD == state) {
+            // Leave the retry to the yield policy of the operation.
+            return false;
+        }
+    }
+    return ix > 0;
+}
 }  // namespace
 
 MultiPlanStage::MultiPlanStage(ExpressionContext* expCtx,
@@ -81,6 +248,11 @@ MultiPlanStage::MultiPlanStage(ExpressionContext* expCtx,
       _bestPlanIdx(kNoSuchPlan),
       _backupPlanIdx(kNoSuchPlan) {}
 
+MultiPlanStage::~MultiPlanStage() {
+    // Destroy the candidate plans' stages before the working sets they may refer to.
+    _children.clear();
+}
+
 void MultiPlanStage::addPlan(std::unique_ptr<QuerySolution> solution,
                              std::unique_ptr<PlanStage> root,
                              WorkingSet* ws) {
@@ -93,6 +265,51 @@ void MultiPlanStage::addPlan(std::unique_ptr<QuerySolution> solution,
     markShouldCollectTimingInfoOnSubtree(newChild);
 }
 
+void MultiPlanStage::addPlan(std::unique_ptr<QuerySolution> solution,
+                             std::unique_ptr<PlanStage> root,
+                             WorkingSet* sharedWs,
+                             std::unique_ptr<WorkingSet> candidateWs) {
+    invariant(candidateWs && candidateWs.get() != sharedWs);
+    _sharedWs = sharedWs;
+    _candidateWorkingSets.push_back(std::move(candidateWs));
+    addPlan(std::move(solution), std::move(root), _candidateWorkingSets.back().get());
+}
+
+bool MultiPlanStage::canWorkPlansInParallel(
+    OperationContext* opCtx,
+    const CanonicalQuery& cq,
+    const std::vector<std::unique_ptr<QuerySolution>>& solutions) {
+    if (internalQueryPlanEvaluationParallelThreads == 0 || solutions.size() < 2) {
+        return false;
+    }
+
+    // The trial period of a write or of a transaction must run in the operation's own storage
+    // transaction.
+    if (opCtx->inMultiDocumentTransaction() || opCtx->lockState()->isWriteLocked()) {
+        return false;
+    }
+
+    if (cq.getQueryRequest().isTailable()) {
+        return false;
+    }
+
+    // The candidate plans share the ExpressionContext of the query, so their filters and
+    // projections must not evaluate expressions with it.
+    if (dependsOnExpressionContext(cq.root()) || (cq.getProj() && cq.getProj()->hasExpressions())) {
+        return false;
+    }
+
+    // The candidate plans can only be ranked against each other if they all read the same data,
+    // which requires a timestamp the threads of the pool can read at.
+    if (!opCtx->recoveryUnit()->getPointInTimeReadTimestamp()) {
+        return false;
+    }
+
+    return std::all_of(solutions.begin(), solutions.end(), [](const auto& solution) {
+        return canWorkOnAnyThread(solution->root.get());
+    });
+}
+
 bool MultiPlanStage::isEOF() {
     // If _bestPlanIdx hasn't been found, can't be at EOF
     if (!bestPlanChosen()) {
@@ -110,7 +327,7 @@ PlanStage::StageState MultiPlanStage::doWork(WorkingSetID* out) {
 
     // Look for an already produced result that provides the data the caller wants.
     if (!bestPlan.results.empty()) {
-        *out = bestPlan.results.front();
+        *out = moveToSharedWorkingSet(bestPlan, bestPlan.results.front());
         bestPlan.results.pop();
         return PlanStage::ADVANCED;
     }
@@ -135,7 +352,16 @@ PlanStage::StageState MultiPlanStage::doWork(WorkingSetID* out) {
 
         _bestPlanIdx = _backupPlanIdx;
         _backupPlanIdx = kNoSuchPlan;
-        return _candidates[_bestPlanIdx].root->work(out);
+        auto& backupPlan = _candidates[_bestPlanIdx];
+        state = backupPlan.root->work(out);
+        if (PlanStage::ADVANCED == state) {
+            *out = moveToSharedWorkingSet(backupPlan, *out);
+        }
+        return state;
+    }
+
+    if (PlanStage::ADVANCED == state) {
+        *out = moveToSharedWorkingSet(bestPlan, *out);
     }
 
     if (hasBackupPlan() && PlanStage::ADVANCED == state) {
@@ -146,6 +372,21 @@ PlanStage::StageState MultiPlanStage::doWork(WorkingSetID* out) {
     return state;
 }
 
+WorkingSetID MultiPlanStage::moveToSharedWorkingSet(const plan_ranker::CandidatePlan& candidate,
+                                                    WorkingSetID id) {
+    if (!_sharedWs || candidate.data == _sharedWs) {
+        return id;
+    }
+
+    // Index key data refers to its index by an id which is only meaningful in its working set.
+    auto member = candidate.data->extract(id);
+    for (auto&& keyDatum : member.keyData) {
+        keyDatum.indexId = _sharedWs->registerIndexAccessMethod(
+            candidate.data->retrieveIndexAccessMethod(keyDatum.indexId));
+    }
+    return _sharedWs->emplace(std::move(member));
+}
+
 void MultiPlanStage::tryYield(PlanYieldPolicy* yieldPolicy) {
     // These are the conditions which can cause us to yield:
     //   1) The yield policy's timer elapsed, or
@@ -167,12 +408,15 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     size_t numResults = trial_period::getTrialPeriodNumToReturn(*_query);
 
     try {
+        bool moreToDo = true;
+        if (!_candidateWorkingSets.empty() &&
+            _candidateWorkingSets.size() == _candidates.size()) {
+            moreToDo = workAllPlansInParallel(numWorks, numResults);
+        }
+
         // Work the plans, stopping when a plan hits EOF or returns some fixed number of results.
-        for (size_t ix = 0; ix < numWorks; ++ix) {
-            bool moreToDo = workAllPlans(numResults, yieldPolicy);
-            if (!moreToDo) {
-                break;
-            }
+        for (size_t ix = 0; moreToDo && ix < numWorks; ++ix) {
+            moreToDo = workAllPlans(numResults, yieldPolicy);
         }
     } catch (DBException& e) {
         return e.toStatus().withContext("error while multiplanner was selecting best plan");
@@ -291,6 +535,92 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
     return !doneWorking;
 }
 
+bool MultiPlanStage::workAllPlansInParallel(size_t numWorks, size_t numResults) {
+    auto opCtx = expCtx()->opCtx;
+
+    ParallelTrialContext trial;
+    trial.nss = collection()->ns();
+    const auto readTimestamp = opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
+    if (!readTimestamp) {
+        // Without a common snapshot, the candidate plans are left to the round-robin trial period.
+        return true;
+    }
+    trial.readTimestamp = *readTimestamp;
+
+    trial.prepareConflictBehavior = opCtx->recoveryUnit()->getPrepareConflictBehavior();
+    trial.shouldConflictWithSecondaryBatchApplication =
+        opCtx->lockState()->shouldConflictWithSecondaryBatchApplication();
+    trial.numWorks = numWorks;
+    trial.numResults = numResults;
+
+    for (auto&& candidate : _candidates) {
+        candidate.root->saveState();
+        candidate.root->detachFromOperationContext();
+    }
+    auto reattachGuard = makeGuard([&] {
+        for (auto&& candidate : _candidates) {
+            candidate.root->reattachToOperationContext(opCtx);
+        }
+    });
+
+    auto mutex = MONGO_MAKE_LATCH("MultiPlanStage::workAllPlansInParallel::mutex");
+    stdx::condition_variable allDone;
+    size_t numRunning = _candidates.size();
+    std::vector<Status> statuses(_candidates.size(), Status::OK());
+    // Not a std::vector<bool>, whose elements cannot be written concurrently.
+    std::vector<char> completed(_candidates.size(), false);
+
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        getParallelTrialPool().schedule([&, ix](Status status) {
+            if (status.isOK()) {
+                try {
+                    completed[ix] = workCandidatePlan(&trial, &_candidates[ix]);
+                } catch (const DBException& ex) {
+                    statuses[ix] = ex.toStatus();
+                    trial.stop.store(true);
+                }
+            }
+
+            stdx::lock_guard<Latch> lk(mutex);
+            if (--numRunning == 0) {
+                allDone.notify_all();
+            }
+        });
+    }
+
+    {
+        stdx::unique_lock<Latch> lk(mutex);
+        try {
+            opCtx->waitForConditionOrInterrupt(allDone, lk, [&] { return numRunning == 0; });
+        } catch (const DBException&) {
+            // The candidate plans and the state of the trial live on this thread's stack.
+            trial.stop.store(true);
+            allDone.wait(lk, [&] { return numRunning == 0; });
+            throw;
+        }
+    }
+
+    reattachGuard.dismiss();
+    for (auto&& candidate : _candidates) {
+        candidate.root->reattachToOperationContext(opCtx);
+        candidate.root->restoreState();
+    }
+
+    for (auto&& status : statuses) {
+        uassertStatusOK(status);
+    }
+
+    _failureCount = std::count_if(_candidates.begin(),
+                                  _candidates.end(),
+                                  [](const auto& candidate) { return candidate.failed; });
+    if (_failureCount == _candidates.size()) {
+        uasserted(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
+                  "all candidate plans exceeded their memory limit during the trial period");
+    }
+
+    return std::find(completed.begin(), completed.end(), false) != completed.end();
+}
+
 bool MultiPlanStage::hasBackupPlan() const {
     return kNoSuchPlan != _backupPlanIdx;
 }
@@ -64,6 +64,8 @@ public:
                    CanonicalQuery* cq,
                    PlanCachingMode cachingMode = PlanCachingMode::AlwaysCache);
 
+    ~MultiPlanStage();
+
     bool isEOF() final;
 
     StageState doWork(WorkingSetID* out) final;
@@ -84,6 +86,28 @@ public:
                  std::unique_ptr<PlanStage> root,
                  WorkingSet* sharedWs);
 
+    /**
+     * Adds a new candidate plan whose stages allocate their working set members in 'candidateWs',
+     * a working set of its own, rather than in 'sharedWs'. If every candidate plan is added this
+     * way, the trial period works them concurrently, and the results of the winning plan are moved
+     * to 'sharedWs' as they are returned.
+     */
+    void addPlan(std::unique_ptr<QuerySolution> solution,
+                 std::unique_ptr<PlanStage> root,
+                 WorkingSet* sharedWs,
+                 std::unique_ptr<WorkingSet> candidateWs);
+
+    /**
+     * Returns true if the candidate plans 'solutions' of 'cq' may be worked concurrently by the
+     * threads of the parallel trial pool, and should therefore be built with working sets of their
+     * own. The threads all read at the point-in-time read timestamp of 'opCtx', so there must be
+     * one, and the plans must not evaluate expressions with the ExpressionContext of 'cq'.
+     */
+    static bool canWorkPlansInParallel(
+        OperationContext* opCtx,
+        const CanonicalQuery& cq,
+        const std::vector<std::unique_ptr<QuerySolution>>& solutions);
+
     /**
      * Runs all plans added by addPlan, ranks them, and picks a best.
      * All further calls to work(...) will return results from the best plan.
@@ -152,6 +176,24 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Works each candidate plan on a thread of the parallel trial pool, with an operation context
+     * of its own reading from the same snapshot as this one. Stops all of the plans once any plan
+     * hits EOF or returns 'numResults' results, or after 'numWorks' calls to work() on each plan.
+     *
+     * Returns true if some plan could not complete its trial period on the pool, in which case
+     * the trial period continues with workAllPlans(). This includes the case where this operation
+     * has no point-in-time read timestamp, and no plan is worked on the pool.
+     */
+    bool workAllPlansInParallel(size_t numWorks, size_t numResults);
+
+    /**
+     * Returns the id in the shared working set of the result 'id' of the candidate plan
+     * 'candidate', moving the result there if the plan has a working set of its own.
+     */
+    WorkingSetID moveToSharedWorkingSet(const plan_ranker::CandidatePlan& candidate,
+                                        WorkingSetID id);
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
@@ -175,6 +217,11 @@ private:
     // one-to-one with _candidates.
     std::vector<plan_ranker::CandidatePlan> _candidates;
 
+    // The working set shared with the PlanExecutor, and the working sets of their own of the
+    // candidate plans which have one. The latter must outlive the candidates' PlanStages.
+    WorkingSet* _sharedWs = nullptr;
+    std::vector<std::unique_ptr<WorkingSet>> _candidateWorkingSets;
+
     // index into _candidates, of the winner of the plan competition
     // uses -1 / kNoSuchPlan when best plan is not (yet) known
     int _bestPlanIdx;
@@ -37,6 +37,7 @@
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/stage_types.h"
+#include "mongo/db/record_id.h"
 #include "mongo/util/container_size_helper.h"
 #include "mongo/util/time_support.h"
 
@@ -249,6 +250,10 @@ struct CollectionScanStats : public SpecificStats {
     // document that does not pass the filter and has a "ts" Timestamp field greater than 'maxTs'.
     // Must only be set on forward oplog scans.
     boost::optional<Timestamp> maxTs;
+
+    // The range of RecordIds the scan of a clustered collection is restricted to.
+    boost::optional<RecordId> minRecord;
+    boost::optional<RecordId> maxRecord;
 };
 
 struct CountStats : public SpecificStats {
@@ -469,6 +474,7 @@ struct IndexScanStats : public SpecificStats {
           isPartial(false),
           isSparse(false),
           isUnique(false),
+          isSkipScan(false),
           dupsTested(0),
           dupsDropped(0),
           keysExamined(0),
@@ -526,6 +532,10 @@ struct IndexScanStats : public SpecificStats {
     bool isSparse;
     bool isUnique;
 
+    // Whether the planner chose this scan to skip over the distinct values of the leading index
+    // fields. The number of skips made is reported in 'seeks'.
+    bool isSkipScan;
+
     size_t dupsTested;
     size_t dupsDropped;
 
@@ -97,6 +97,22 @@ TEST(SBEValues, Hash) {
     ASSERT_EQUALS(value::hashValue(tagInt32, valInt32), value::hashValue(tagDecimal, valDecimal));
 
     value::releaseValue(tagDecimal, valDecimal);
+
+    auto [tagFractionalDecimal, valFractionalDecimal] =
+        value::makeCopyDecimal(mongo::Decimal128(-5.5));
+    auto valFractionalDouble = value::bitcastFrom<double>(-5.5);
+    ASSERT_EQUALS(value::hashValue(tagDouble, valFractionalDouble),
+                  value::hashValue(tagFractionalDecimal, valFractionalDecimal));
+
+    value::releaseValue(tagFractionalDecimal, valFractionalDecimal);
+
+    value::ObjectIdType rawObjectId{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    auto [tagObjectId, valObjectId] = value::makeCopyObjectId(rawObjectId);
+    ASSERT_EQUALS(value::hashValue(tagObjectId, valObjectId),
+                  value::hashValue(value::TypeTags::bsonObjectId,
+                                   value::bitcastFrom(rawObjectId.data())));
+
+    value::releaseValue(tagObjectId, valObjectId);
 }
 
 TEST(SBEVM, Add) {
@@ -159,4 +175,39 @@ TEST(SBEVM, Add) {
     }
 }
 
+TEST(SBEVM, IsMember) {
+    auto arraySet = value::makeNewArraySet();
+    value::ValueGuard setGuard{arraySet.first, arraySet.second};
+    auto set = value::getArraySetView(arraySet.second);
+    set->push_back(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(1));
+    set->push_back(value::TypeTags::NumberInt64, value::bitcastFrom<int64_t>(3));
+
+    auto isMember = [&](value::TypeTags tag, value::Value val) {
+        vm::CodeFragment code;
+        code.appendConstVal(tag, val);
+        code.appendConstVal(arraySet.first, arraySet.second);
+        code.appendFunction(vm::Builtin::isMember, 2);
+
+        vm::ByteCode interpreter;
+        return interpreter.run(&code);
+    };
+
+    {
+        auto [owned, tag, val] =
+            isMember(value::TypeTags::NumberDouble, value::bitcastFrom<double>(3.0));
+        ASSERT_EQUALS(tag, value::TypeTags::Boolean);
+        ASSERT_TRUE(val);
+    }
+    {
+        auto [owned, tag, val] =
+            isMember(value::TypeTags::NumberInt32, value::bitcastFrom<int32_t>(2));
+        ASSERT_EQUALS(tag, value::TypeTags::Boolean);
+        ASSERT_FALSE(val);
+    }
+    {
+        auto [owned, tag, val] = isMember(value::TypeTags::Nothing, 0);
+        ASSERT_EQUALS(tag, value::TypeTags::Nothing);
+    }
+}
+
 }  // namespace mongo::sbe
@@ -370,6 +370,8 @@ BSONType tagToType(TypeTags tag) noexcept {
 }
 
 std::size_t hashValue(TypeTags tag, Value val) noexcept {
+    // Values that compare equal must hash to the same value, regardless of how they are
+    // represented.
     switch (tag) {
         case TypeTags::NumberInt32:
             return absl::Hash<int32_t>{}(bitcastTo<int32_t>(val));
@@ -379,8 +381,9 @@ std::size_t hashValue(TypeTags tag, Value val) noexcept {
             // Force doubles to integers for hashing.
             return absl::Hash<int64_t>{}(bitcastTo<double>(val));
         case TypeTags::NumberDecimal:
-            // Force decimals to integers for hashing.
-            return absl::Hash<int64_t>{}(bitcastTo<Decimal128>(val).toLong());
+            // Force decimals to integers for hashing, truncating them like doubles.
+            return absl::Hash<int64_t>{}(
+                bitcastTo<Decimal128>(val).toLong(Decimal128::kRoundTowardZero));
         case TypeTags::Date:
             return absl::Hash<int64_t>{}(bitcastTo<int64_t>(val));
         case TypeTags::Timestamp:
@@ -395,10 +398,12 @@ std::size_t hashValue(TypeTags tag, Value val) noexcept {
             auto sv = getStringView(tag, val);
             return absl::Hash<std::string_view>{}(sv);
         }
-        case TypeTags::ObjectId: {
-            auto id = getObjectIdView(val);
-            return absl::Hash<uint64_t>{}(readFromMemory<uint64_t>(id->data())) ^
-                absl::Hash<uint32_t>{}(readFromMemory<uint32_t>(id->data() + 8));
+        case TypeTags::ObjectId:
+        case TypeTags::bsonObjectId: {
+            auto id = tag == TypeTags::ObjectId ? getObjectIdView(val)->data()
+                                                : bitcastTo<uint8_t*>(val);
+            return absl::Hash<uint64_t>{}(readFromMemory<uint64_t>(id)) ^
+                absl::Hash<uint32_t>{}(readFromMemory<uint32_t>(id + 8));
         }
         case TypeTags::ksValue: {
             return getKeyStringView(val)->hash();
@@ -897,6 +897,20 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinDoubleDoubleSum
     return {false, value::TypeTags::Nothing, 0};
 }
 
+std::tuple<bool, value::TypeTags, value::Value> ByteCode::builtinIsMember(uint8_t arity) {
+    invariant(arity == 2);
+
+    auto [ownedInput, inputTag, inputVal] = getFromStack(0);
+    auto [ownedSet, setTag, setVal] = getFromStack(1);
+
+    if (inputTag == value::TypeTags::Nothing || setTag != value::TypeTags::ArraySet) {
+        return {false, value::TypeTags::Nothing, 0};
+    }
+
+    auto& values = value::getArraySetView(setVal)->values();
+    return {false, value::TypeTags::Boolean, values.find({inputTag, inputVal}) != values.end()};
+}
+
 /**
  * A helper for the bultinDate method. The formal parameters yearOrWeekYear and monthOrWeek carry
  * values depending on wether the date is a year-month-day or ISOWeekYear.
@@ -1046,6 +1060,8 @@ std::tuple<bool, value::TypeTags, value::Value> ByteCode::dispatchBuiltin(Builti
             return builtinAddToSet(arity);
         case Builtin::doubleDoubleSum:
             return builtinDoubleDoubleSum(arity);
+        case Builtin::isMember:
+            return builtinIsMember(arity);
     }
 
     MONGO_UNREACHABLE;
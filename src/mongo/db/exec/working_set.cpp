@@ -226,7 +226,7 @@ void WorkingSetMember::serialize(BufBuilder& buf) const {
     }
 
     if (hasRecordId()) {
-        buf.appendNum(recordId.repr());
+        recordId.serializeForSorter(buf);
     }
 
     _metadata.serializeForSorter(buf);
@@ -263,7 +263,7 @@ WorkingSetMember WorkingSetMember::deserialize(BufReader& buf) {
     }
 
     if (wsm.hasRecordId()) {
-        wsm.recordId = RecordId{buf.read<LittleEndian<int64_t>>()};
+        wsm.recordId = RecordId::deserializeForSorter(buf, RecordId::SorterDeserializeSettings{});
     }
 
     DocumentMetadataFields::deserializeForSorter(buf, &wsm._metadata);
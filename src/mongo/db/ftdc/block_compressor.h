@@ -70,4 +70,37 @@ private:
     std::vector<std::uint8_t> _buffer;
 };
 
+/**
+ * Compresses and uncompresses a block of buffer using zstd.
+ */
+class ZstdBlockCompressor {
+    ZstdBlockCompressor(const ZstdBlockCompressor&) = delete;
+    ZstdBlockCompressor& operator=(const ZstdBlockCompressor&) = delete;
+
+public:
+    ZstdBlockCompressor() = default;
+
+    /**
+     * Compress a buffer of data.
+     *
+     * Returns a pointer to a buffer that ZstdBlockCompressor owns.
+     * The returned buffer is valid until the next call to compress or uncompress.
+     */
+    StatusWith<ConstDataRange> compress(ConstDataRange source);
+
+    /**
+     * Uncompress a buffer of data.
+     *
+     * uncompressedLength is the exact size of the uncompressed data, it is an error for the data to
+     * uncompress to any other size.
+     *
+     * Returns a pointer to a buffer that ZstdBlockCompressor owns.
+     * The returned buffer is valid until the next call to compress or uncompress.
+     */
+    StatusWith<ConstDataRange> uncompress(ConstDataRange source, size_t uncompressedLength);
+
+private:
+    std::vector<std::uint8_t> _buffer;
+};
+
 }  // namespace mongo
@@ -32,6 +32,7 @@
 #include "mongo/db/ftdc/compressor.h"
 
 #include "mongo/base/data_builder.h"
+#include "mongo/base/data_view.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/ftdc/varint.h"
@@ -117,6 +118,10 @@ FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
 }
 
 StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamples() {
+    if (_metricChunkFormat == FTDCMetricChunkFormat::kColumnar) {
+        return _getColumnarCompressedSamples();
+    }
+
     _uncompressedChunkBuffer.setlen(0);
 
     // Append reference document - BSON Object
@@ -218,6 +223,118 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         _referenceDocDate);
 }
 
+StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::_getColumnarCompressedSamples() {
+    const std::uint32_t blockCount =
+        (_metricsCount + kColumnarMetricsPerBlock - 1) / kColumnarMetricsPerBlock;
+
+    _compressedChunkBuffer.setlen(0);
+
+    // Append reference document - uncompressed length + compressed length + compressed BSON Object
+    auto swRef = _zstdCompressor.compress(
+        ConstDataRange(_referenceDoc.objdata(), _referenceDoc.objsize()));
+    if (!swRef.isOK()) {
+        return swRef.getStatus();
+    }
+
+    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_referenceDoc.objsize()));
+    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(swRef.getValue().length()));
+    _compressedChunkBuffer.appendBuf(swRef.getValue().data(), swRef.getValue().length());
+
+    // Append count of metrics, count of samples and metrics per block - uint32 little endian
+    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_metricsCount));
+    _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_deltaCount));
+    _compressedChunkBuffer.appendNum(kColumnarMetricsPerBlock);
+
+    // Leave room for the index, which is filled in as the blocks are compressed. It consists of
+    // the <uncompressed length, compressed length> of each block, followed by the offset of each
+    // metric column within its uncompressed block - uint32 little endian
+    const auto blockIndexOffset = _compressedChunkBuffer.len();
+    const auto columnIndexOffset = blockIndexOffset + blockCount * 2 * sizeof(std::uint32_t);
+    _compressedChunkBuffer.skip((blockCount * 2 + _metricsCount) * sizeof(std::uint32_t));
+
+    auto writeIndexEntry = [&](std::size_t offset, std::uint32_t value) {
+        DataView(_compressedChunkBuffer.buf() + offset).write<LittleEndian<std::uint32_t>>(value);
+    };
+
+    for (std::uint32_t block = 0; block < blockCount; ++block) {
+        const std::uint32_t firstMetric = block * kColumnarMetricsPerBlock;
+        const std::uint32_t endMetric =
+            std::min(firstMetric + kColumnarMetricsPerBlock, _metricsCount);
+
+        // On average, we do not need all 10 bytes for every sample, worst case, we grow the buffer
+        DataBuilder db((endMetric - firstMetric) * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 4);
+
+        auto writeZeroes = [&](std::uint32_t zeroesCount) -> Status {
+            auto s1 = db.writeAndAdvance(FTDCVarInt(0));
+            if (!s1.isOK()) {
+                return s1;
+            }
+
+            return db.writeAndAdvance(FTDCVarInt(zeroesCount - 1));
+        };
+
+        for (std::uint32_t i = firstMetric; i < endMetric; i++) {
+            writeIndexEntry(columnIndexOffset + i * sizeof(std::uint32_t), db.size());
+
+            std::uint64_t prevDelta = 0;
+            std::uint32_t zeroesCount = 0;
+
+            for (std::uint32_t j = 0; j < _deltaCount; j++) {
+                std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
+                std::uint64_t deltaOfDelta = FTDCVarInt::zigZagEncode(delta - prevDelta);
+                prevDelta = delta;
+
+                if (deltaOfDelta == 0) {
+                    ++zeroesCount;
+                    continue;
+                }
+
+                // If we have a non-zero sample, then write out all the accumulated zero samples.
+                if (zeroesCount > 0) {
+                    auto s = writeZeroes(zeroesCount);
+                    if (!s.isOK()) {
+                        return s;
+                    }
+
+                    zeroesCount = 0;
+                }
+
+                auto s = db.writeAndAdvance(FTDCVarInt(deltaOfDelta));
+                if (!s.isOK()) {
+                    return s;
+                }
+            }
+
+            // Runs of zeroes end with their column so that each column can be decoded on its own.
+            if (zeroesCount > 0) {
+                auto s = writeZeroes(zeroesCount);
+                if (!s.isOK()) {
+                    return s;
+                }
+            }
+        }
+
+        ConstDataRange cdr = db.getCursor();
+        auto swDest = _zstdCompressor.compress(cdr);
+
+        // The only way for compression to fail is if the buffer size calculations are wrong
+        if (!swDest.isOK()) {
+            return swDest.getStatus();
+        }
+
+        const auto blockEntryOffset = blockIndexOffset + block * 2 * sizeof(std::uint32_t);
+        writeIndexEntry(blockEntryOffset, cdr.length());
+        writeIndexEntry(blockEntryOffset + sizeof(std::uint32_t), swDest.getValue().length());
+
+        _compressedChunkBuffer.appendBuf(swDest.getValue().data(), swDest.getValue().length());
+    }
+
+    return std::tuple<ConstDataRange, Date_t>(
+        ConstDataRange(_compressedChunkBuffer.buf(),
+                       static_cast<size_t>(_compressedChunkBuffer.len())),
+        _referenceDocDate);
+}
+
 void FTDCCompressor::reset() {
     _metrics.clear();
     _reset(BSONObj(), Date_t());
@@ -226,6 +343,7 @@ void FTDCCompressor::reset() {
 void FTDCCompressor::_reset(const BSONObj& referenceDoc, Date_t date) {
     _referenceDoc = referenceDoc;
     _referenceDocDate = date;
+    _metricChunkFormat = _config->metricChunkFormat;
 
     _metricsCount = _metrics.size();
     _deltaCount = 0;
@@ -48,7 +48,7 @@ namespace mongo {
  * compressing them into a highly compressed buffer. Metrics are defined as BSON number or number
  * like type (like dates, and timestamps).
  *
- * Compression Method
+ * Compression Method (FTDCMetricChunkFormat::kDelta)
  * 1. For each document after the first, it computes the delta between it and the preceding document
  *    for the number fields
  * 2. It stores the deltas into an array of std::int64_t.
@@ -56,6 +56,16 @@ namespace mongo {
  * 4. Encodes zeros in Run Length Encoded pairs of <Count, Zero>
  * 5. ZLIB compresses the final processed array
  *
+ * Compression Method (FTDCMetricChunkFormat::kColumnar)
+ * 1. Computes the deltas like above, and then the delta between consecutive deltas of each metric,
+ *    which is zero for constants and for counters that grow at a steady rate.
+ * 2. ZigZag and VarInt compresses each delta-of-delta, and encodes zeros in Run Length Encoded
+ *    pairs of <Count, Zero> that never span more than one metric column.
+ * 3. ZSTD compresses the columns in blocks of kColumnarMetricsPerBlock metrics.
+ * 4. Prefixes the blocks with the separately compressed reference document and an index of the
+ *    blocks and of the columns within them, so that readers can decode a single metric by only
+ *    uncompressing the block that contains it. See FTDCDecompressor::uncompressColumnarMetric.
+ *
  * NOTE: This compression ignores non-number data, and assumes the non-number data is constant
  * across all documents in the series of documents.
  */
@@ -80,6 +90,11 @@ public:
         kCompressorFull,
     };
 
+    /**
+     * Number of metric columns compressed together into a block of a kColumnar chunk.
+     */
+    static constexpr std::uint32_t kColumnarMetricsPerBlock = 64;
+
     explicit FTDCCompressor(const FTDCConfig* config) : _config(config) {}
 
     /**
@@ -120,6 +135,15 @@ public:
         return !_referenceDoc.isEmpty();
     }
 
+    /**
+     * Returns the encoding of the chunk returned by the next call to getCompressedSamples(). The
+     * format is taken from the config whenever a new reference document is set, so that all
+     * samples of a chunk share the same encoding.
+     */
+    FTDCMetricChunkFormat getMetricChunkFormat() const {
+        return _metricChunkFormat;
+    }
+
     /**
      * Gets buffer of compressed data contained in the FTDCCompressor.
      *
@@ -150,16 +174,27 @@ private:
      */
     void _reset(const BSONObj& referenceDoc, Date_t date);
 
+    /**
+     * Implementation of getCompressedSamples for FTDCMetricChunkFormat::kColumnar.
+     */
+    StatusWith<std::tuple<ConstDataRange, Date_t>> _getColumnarCompressedSamples();
+
 private:
     // Block Compressor
     BlockCompressor _compressor;
 
+    // Block Compressor for kColumnar chunks
+    ZstdBlockCompressor _zstdCompressor;
+
     // Config
     const FTDCConfig* const _config;
 
     // Reference schema document
     BSONObj _referenceDoc;
 
+    // Encoding of the current chunk
+    FTDCMetricChunkFormat _metricChunkFormat{FTDCMetricChunkFormat::kDelta};
+
     // Time at which reference schema document was collected.
     // Passed in via addSample and returned with each chunk.
     Date_t _referenceDocDate;
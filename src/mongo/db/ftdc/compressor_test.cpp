@@ -122,8 +122,11 @@ TEST_F(FTDCCompressorTest, TestStrings) {
  */
 class TestTie {
 public:
-    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict)
-        : _compressor(&_config), _mode(mode) {}
+    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict,
+            FTDCMetricChunkFormat format = FTDCMetricChunkFormat::kDelta)
+        : _compressor(&_config), _mode(mode) {
+        _config.metricChunkFormat = format;
+    }
 
     ~TestTie() {
         validate(boost::none);
@@ -153,15 +156,21 @@ public:
     }
 
     void validate(boost::optional<ConstDataRange> cdr) {
+        auto uncompress = [&](ConstDataRange buf) {
+            return _config.metricChunkFormat == FTDCMetricChunkFormat::kColumnar
+                ? _decompressor.uncompressColumnar(buf)
+                : _decompressor.uncompress(buf);
+        };
+
         std::vector<BSONObj> list;
         if (cdr.is_initialized()) {
-            auto sw = _decompressor.uncompress(cdr.get());
+            auto sw = uncompress(cdr.get());
             ASSERT_TRUE(sw.isOK());
             list = sw.getValue();
         } else {
             auto swBuf = _compressor.getCompressedSamples();
             ASSERT_TRUE(swBuf.isOK());
-            auto sw = _decompressor.uncompress(std::get<0>(swBuf.getValue()));
+            auto sw = uncompress(std::get<0>(swBuf.getValue()));
             ASSERT_TRUE(sw.isOK());
 
             list = sw.getValue();
@@ -537,4 +546,159 @@ TEST_F(FTDCCompressorTest, TestManyMetrics) {
     }
 }
 
+// Test schema changes and all types in the columnar format
+TEST_F(FTDCCompressorTest, TestColumnarSchemaChanges) {
+    TestTie c(FTDCValidationMode::kStrict, FTDCMetricChunkFormat::kColumnar);
+
+    auto st = c.addSample(BSON("name"
+                               << "joe"
+                               << "key1" << 33 << "key2" << 42));
+    ASSERT_HAS_SPACE(st);
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1" << 34 << "key2" << 45));
+    ASSERT_HAS_SPACE(st);
+
+    // Add Field
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1" << 34 << "key2" << 45 << "key3" << 47));
+    ASSERT_SCHEMA_CHANGED(st);
+
+    st = c.addSample(BSON("ts" << Timestamp(0x556677LL, 0x11223344LL) << "d1" << Date_t()
+                               << "bool" << true << "obj" << BSON("a" << 1.5 << "b" << -12LL)));
+    ASSERT_SCHEMA_CHANGED(st);
+
+    st = c.addSample(BSON("ts" << Timestamp(0x556678LL, 0x11223340LL) << "d1"
+                               << Date_t::fromMillisSinceEpoch(1000) << "bool" << false << "obj"
+                               << BSON("a" << 3.5 << "b" << -24LL)));
+    ASSERT_HAS_SPACE(st);
+}
+
+// Test a full buffer of steady, decreasing and irregular metrics in the columnar format
+TEST_F(FTDCCompressorTest, TestColumnarFull) {
+    for (int j = 0; j < 3; j++) {
+        TestTie c(FTDCValidationMode::kStrict, FTDCMetricChunkFormat::kColumnar);
+
+        auto st = c.addSample(BSON("name"
+                                   << "joe"
+                                   << "key1" << 33 << "key2" << 42 << "key3" << 0));
+        ASSERT_HAS_SPACE(st);
+
+        for (size_t i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 2; i++) {
+            const auto n = static_cast<long long>(i);
+            st = c.addSample(BSON("name"
+                                  << "joe"
+                                  << "key1" << n * j << "key2" << -n * j << "key3"
+                                  << (n * n * j) % 17));
+            ASSERT_HAS_SPACE(st);
+        }
+
+        st = c.addSample(BSON("name"
+                              << "joe"
+                              << "key1" << 34 << "key2" << 45 << "key3" << 0));
+        ASSERT_FULL(st);
+
+        // Add Value
+        st = c.addSample(BSON("name"
+                              << "joe"
+                              << "key1" << 34 << "key2" << 45 << "key3" << 0));
+        ASSERT_HAS_SPACE(st);
+    }
+}
+
+// Test many metrics, spread over many blocks, in the columnar format
+TEST_F(FTDCCompressorTest, TestColumnarManyMetrics) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    std::uniform_int_distribution<long long> genValues(1, std::numeric_limits<long long>::max());
+    const size_t metrics = 1000;
+
+    TestTie c(FTDCValidationMode::kStrict, FTDCMetricChunkFormat::kColumnar);
+
+    auto st = c.addSample(generateSample(rd, genValues, metrics));
+    ASSERT_HAS_SPACE(st);
+
+    for (size_t i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 2; i++) {
+        st = c.addSample(generateSample(rd, genValues, metrics));
+        ASSERT_HAS_SPACE(st);
+    }
+
+    st = c.addSample(generateSample(rd, genValues, metrics));
+    ASSERT_FULL(st);
+}
+
+BSONObj generateCounterSample(size_t sample, size_t count) {
+    BSONObjBuilder builder;
+
+    for (size_t i = 0; i < count; ++i) {
+        // Constants, counters that grow at a steady rate and a few that do not.
+        long long value = i % 3 == 0 ? i : i % 3 == 1 ? sample * i : (sample * sample) % (i + 1);
+        builder.append("key" + std::to_string(i), value);
+    }
+
+    return builder.obj();
+}
+
+// Decode single metrics of a columnar chunk
+TEST_F(FTDCCompressorTest, TestColumnarSingleMetric) {
+    const size_t metrics = 200;
+    const size_t samples = 50;
+
+    FTDCConfig config;
+    config.metricChunkFormat = FTDCMetricChunkFormat::kColumnar;
+    FTDCCompressor c(&config);
+
+    for (size_t i = 0; i < samples; ++i) {
+        auto st = c.addSample(generateCounterSample(i, metrics), Date_t());
+        ASSERT_HAS_SPACE(st);
+    }
+
+    auto swBuf = c.getCompressedSamples();
+    ASSERT_OK(swBuf.getStatus());
+    auto buf = std::get<0>(swBuf.getValue());
+
+    FTDCDecompressor d;
+    auto swRef = d.getColumnarReferenceDocument(buf);
+    ASSERT_OK(swRef.getStatus());
+    ASSERT_BSONOBJ_EQ(swRef.getValue(), generateCounterSample(0, metrics));
+    for (std::uint32_t metric : {0, 1, 2, 63, 64, 65, 150, 199}) {
+        auto swValues = d.uncompressColumnarMetric(buf, metric);
+        ASSERT_OK(swValues.getStatus());
+
+        const auto& values = swValues.getValue();
+        ASSERT_EQ(values.size(), samples);
+        for (size_t i = 0; i < samples; ++i) {
+            auto expected = generateCounterSample(i, metrics)["key" + std::to_string(metric)];
+            ASSERT_EQ(static_cast<long long>(values[i]), expected.numberLong());
+        }
+    }
+
+    ASSERT_NOT_OK(d.uncompressColumnarMetric(buf, metrics).getStatus());
+}
+
+// The columnar format is smaller than the delta format for typical metrics
+TEST_F(FTDCCompressorTest, TestColumnarIsSmaller) {
+    const size_t metrics = 500;
+
+    auto compressedSize = [&](FTDCMetricChunkFormat format) {
+        FTDCConfig config;
+        config.metricChunkFormat = format;
+        FTDCCompressor c(&config);
+
+        for (size_t i = 0; i < FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 1; ++i) {
+            auto st = c.addSample(generateCounterSample(i, metrics), Date_t());
+            ASSERT_HAS_SPACE(st);
+        }
+
+        auto swBuf = c.getCompressedSamples();
+        ASSERT_OK(swBuf.getStatus());
+        return std::get<0>(swBuf.getValue()).length();
+    };
+
+    ASSERT_LT(compressedSize(FTDCMetricChunkFormat::kColumnar),
+              compressedSize(FTDCMetricChunkFormat::kDelta));
+}
+
 }  // namespace mongo
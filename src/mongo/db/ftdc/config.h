@@ -35,6 +35,26 @@
 
 namespace mongo {
 
+/**
+ * Encoding used by FTDCCompressor for metric chunks.
+ */
+enum class FTDCMetricChunkFormat {
+    /**
+     * Deltas of all metrics, varint and zero run-length encoded, compressed as a single zlib block.
+     *
+     * See FTDCCompressor.
+     */
+    kDelta,
+
+    /**
+     * Delta-of-deltas per metric column, zigzag varint and zero run-length encoded, compressed with
+     * zstd in blocks of columns behind a per-chunk metric index.
+     *
+     * See FTDCCompressor.
+     */
+    kColumnar,
+};
+
 /**
  * Configuration settings for full-time diagnostic data capture (FTDC).
  *
@@ -47,7 +67,8 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          metricChunkFormat(FTDCMetricChunkFormat::kDelta) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -84,6 +105,11 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * Encoding of newly written metric chunks. Readers understand both formats.
+     */
+    FTDCMetricChunkFormat metricChunkFormat;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
@@ -42,6 +42,208 @@
 
 namespace mongo {
 
+namespace {
+
+/**
+ * The uncompressed header of a FTDCMetricChunkFormat::kColumnar chunk, see
+ * FTDCCompressor::_getColumnarCompressedSamples.
+ */
+struct ColumnarChunkHeader {
+    BSONObj ref;
+
+    std::uint32_t metricsCount;
+    std::uint32_t sampleCount;
+    std::uint32_t metricsPerBlock;
+
+    // <uncompressed length, compressed length> of each block
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> blocks;
+
+    // Offset of each metric column within its uncompressed block
+    std::vector<std::uint32_t> columnOffsets;
+
+    // The concatenated compressed blocks
+    ConstDataRange blockData{nullptr, nullptr};
+};
+
+/**
+ * Reads and uncompresses the reference document at the start of a kColumnar chunk, and advances
+ * the cursor past it.
+ */
+StatusWith<BSONObj> readColumnarReferenceDocument(ConstDataRangeCursor* cdc,
+                                                  ZstdBlockCompressor* compressor) {
+    auto swUncompressedLength = cdc->readAndAdvanceNoThrow<LittleEndian<std::uint32_t>>();
+    if (!swUncompressedLength.isOK()) {
+        return swUncompressedLength.getStatus();
+    }
+
+    auto swCompressedLength = cdc->readAndAdvanceNoThrow<LittleEndian<std::uint32_t>>();
+    if (!swCompressedLength.isOK()) {
+        return swCompressedLength.getStatus();
+    }
+
+    if (swUncompressedLength.getValue() > 10000000) {
+        return Status(ErrorCodes::InvalidLength,
+                      "Metrics chunk reference document has exceeded the allowable size.");
+    }
+
+    if (swCompressedLength.getValue() > cdc->length()) {
+        return Status(ErrorCodes::InvalidLength,
+                      "Metrics chunk is missing its compressed reference document.");
+    }
+
+    auto swUncompressed =
+        compressor->uncompress(ConstDataRange(cdc->data(), swCompressedLength.getValue()),
+                               swUncompressedLength.getValue());
+    if (!swUncompressed.isOK()) {
+        return swUncompressed.getStatus();
+    }
+
+    auto status = cdc->advanceNoThrow(swCompressedLength.getValue());
+    if (!status.isOK()) {
+        return status;
+    }
+
+    // The document is not part of any checksum so we must validate it is correct
+    ConstDataRangeCursor refCursor(swUncompressed.getValue());
+    auto swRef = refCursor.readAndAdvanceNoThrow<Validated<BSONObj>>();
+    if (!swRef.isOK()) {
+        return swRef.getStatus();
+    }
+
+    // The uncompressed buffer is owned by the compressor and reused by its next call.
+    BSONObj ref = swRef.getValue();
+    return ref.getOwned();
+}
+
+StatusWith<ColumnarChunkHeader> readColumnarChunkHeader(ConstDataRange buf,
+                                                        ZstdBlockCompressor* compressor) {
+    ConstDataRangeCursor cdc(buf);
+    ColumnarChunkHeader header;
+
+    auto swRef = readColumnarReferenceDocument(&cdc, compressor);
+    if (!swRef.isOK()) {
+        return swRef.getStatus();
+    }
+    header.ref = std::move(swRef.getValue());
+
+    for (auto field : {&header.metricsCount, &header.sampleCount, &header.metricsPerBlock}) {
+        auto swValue = cdc.readAndAdvanceNoThrow<LittleEndian<std::uint32_t>>();
+        if (!swValue.isOK()) {
+            return swValue.getStatus();
+        }
+        *field = swValue.getValue();
+    }
+
+    // Limit size of the buffer we need for metrics and samples
+    if (static_cast<std::uint64_t>(header.metricsCount) * header.sampleCount > 1000000) {
+        return Status(ErrorCodes::InvalidLength,
+                      "Metrics Count and Sample Count have exceeded the allowable range.");
+    }
+
+    if (header.metricsPerBlock == 0) {
+        return Status(ErrorCodes::BadValue, "Metrics chunk has no metrics per block.");
+    }
+
+    const std::uint32_t blockCount =
+        (static_cast<std::uint64_t>(header.metricsCount) + header.metricsPerBlock - 1) /
+        header.metricsPerBlock;
+
+    std::uint64_t totalCompressedLength = 0;
+    header.blocks.reserve(blockCount);
+    for (std::uint32_t i = 0; i < blockCount; ++i) {
+        auto swUncompressedLength = cdc.readAndAdvanceNoThrow<LittleEndian<std::uint32_t>>();
+        if (!swUncompressedLength.isOK()) {
+            return swUncompressedLength.getStatus();
+        }
+
+        auto swCompressedLength = cdc.readAndAdvanceNoThrow<LittleEndian<std::uint32_t>>();
+        if (!swCompressedLength.isOK()) {
+            return swCompressedLength.getStatus();
+        }
+
+        if (swUncompressedLength.getValue() > 10000000) {
+            return Status(ErrorCodes::InvalidLength,
+                          "Metrics chunk block has exceeded the allowable size.");
+        }
+
+        totalCompressedLength += swCompressedLength.getValue();
+        header.blocks.emplace_back(swUncompressedLength.getValue(), swCompressedLength.getValue());
+    }
+
+    header.columnOffsets.reserve(header.metricsCount);
+    for (std::uint32_t i = 0; i < header.metricsCount; ++i) {
+        auto swOffset = cdc.readAndAdvanceNoThrow<LittleEndian<std::uint32_t>>();
+        if (!swOffset.isOK()) {
+            return swOffset.getStatus();
+        }
+
+        if (swOffset.getValue() > header.blocks[i / header.metricsPerBlock].first) {
+            return Status(ErrorCodes::BadValue,
+                          "Metric column offset is out of the range of its block.");
+        }
+        header.columnOffsets.push_back(swOffset.getValue());
+    }
+
+    if (totalCompressedLength > cdc.length()) {
+        return Status(ErrorCodes::InvalidLength, "Metrics chunk is missing compressed blocks.");
+    }
+    header.blockData = ConstDataRange(cdc.data(), cdc.length());
+
+    return {std::move(header)};
+}
+
+/**
+ * Decodes the delta-of-deltas of one metric column starting at the given offset of an uncompressed
+ * block, and writes the sampleCount values that follow the reference value into out.
+ */
+Status decodeColumn(ConstDataRange block,
+                    std::uint32_t offset,
+                    std::uint32_t sampleCount,
+                    std::uint64_t referenceValue,
+                    std::uint64_t* out) {
+    ConstDataRangeCursor cdrc(block);
+    auto status = cdrc.advanceNoThrow(offset);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    std::uint64_t zeroesCount = 0;
+    std::uint64_t delta = 0;
+    std::uint64_t value = referenceValue;
+
+    for (std::uint32_t j = 0; j < sampleCount; j++) {
+        std::uint64_t deltaOfDelta = 0;
+
+        if (zeroesCount) {
+            zeroesCount--;
+        } else {
+            auto swDeltaOfDelta = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
+            if (!swDeltaOfDelta.isOK()) {
+                return swDeltaOfDelta.getStatus();
+            }
+
+            if (swDeltaOfDelta.getValue() == 0) {
+                auto swZero = cdrc.readAndAdvanceNoThrow<FTDCVarInt>();
+                if (!swZero.isOK()) {
+                    return swZero.getStatus();
+                }
+
+                zeroesCount = swZero.getValue();
+            } else {
+                deltaOfDelta = FTDCVarInt::zigZagDecode(swDeltaOfDelta.getValue());
+            }
+        }
+
+        delta += deltaOfDelta;
+        value += delta;
+        out[j] = value;
+    }
+
+    return Status::OK();
+}
+
+}  // namespace
+
 StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf) {
     ConstDataRangeCursor compressedDataRange(buf);
 
@@ -182,4 +384,145 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
     return {docs};
 }
 
+StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompressColumnar(ConstDataRange buf) {
+    auto swHeader = readColumnarChunkHeader(buf, &_zstdCompressor);
+    if (!swHeader.isOK()) {
+        return swHeader.getStatus();
+    }
+
+    const auto& header = swHeader.getValue();
+    const auto& ref = header.ref;
+
+    std::vector<std::uint64_t> metrics;
+
+    metrics.reserve(header.metricsCount);
+
+    // We pass the reference document as both the reference document and current document as we only
+    // want the array of metrics.
+    (void)FTDCBSONUtil::extractMetricsFromDocument(ref, ref, &metrics);
+
+    if (metrics.size() != header.metricsCount) {
+        return {ErrorCodes::BadValue,
+                "The metrics in the reference document and metrics count do not match"};
+    }
+
+    std::vector<BSONObj> docs;
+
+    // Allocate space for the reference document + samples
+    docs.reserve(1 + header.sampleCount);
+
+    docs.emplace_back(ref.getOwned());
+
+    // We must always return the reference document
+    if (header.sampleCount == 0) {
+        return {docs};
+    }
+
+    // Decode the samples, one block of metric columns at a time
+    std::vector<std::uint64_t> values(header.metricsCount * header.sampleCount);
+
+    ConstDataRangeCursor blockCursor(header.blockData);
+    for (std::uint32_t block = 0; block < header.blocks.size(); ++block) {
+        const auto [uncompressedLength, compressedLength] = header.blocks[block];
+
+        auto swBlock = _zstdCompressor.uncompress(
+            ConstDataRange(blockCursor.data(), compressedLength), uncompressedLength);
+        if (!swBlock.isOK()) {
+            return swBlock.getStatus();
+        }
+
+        auto status = blockCursor.advanceNoThrow(compressedLength);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        const std::uint32_t firstMetric = block * header.metricsPerBlock;
+        const std::uint32_t endMetric =
+            std::min(firstMetric + header.metricsPerBlock, header.metricsCount);
+        for (std::uint32_t i = firstMetric; i < endMetric; ++i) {
+            auto status = decodeColumn(swBlock.getValue(),
+                                       header.columnOffsets[i],
+                                       header.sampleCount,
+                                       metrics[i],
+                                       &values[FTDCCompressor::getArrayOffset(
+                                           header.sampleCount, 0, i)]);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+    }
+
+    for (std::uint32_t i = 0; i < header.sampleCount; ++i) {
+        for (std::uint32_t j = 0; j < header.metricsCount; ++j) {
+            metrics[j] = values[FTDCCompressor::getArrayOffset(header.sampleCount, i, j)];
+        }
+
+        docs.emplace_back(FTDCBSONUtil::constructDocumentFromMetrics(ref, metrics).getValue());
+    }
+
+    return {docs};
+}
+
+StatusWith<std::vector<std::uint64_t>> FTDCDecompressor::uncompressColumnarMetric(
+    ConstDataRange buf, std::uint32_t metric) {
+    auto swHeader = readColumnarChunkHeader(buf, &_zstdCompressor);
+    if (!swHeader.isOK()) {
+        return swHeader.getStatus();
+    }
+
+    const auto& header = swHeader.getValue();
+    if (metric >= header.metricsCount) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Metric " << metric << " is out of range, chunk only has "
+                              << header.metricsCount << " metrics"};
+    }
+
+    std::vector<std::uint64_t> metrics;
+    metrics.reserve(header.metricsCount);
+    (void)FTDCBSONUtil::extractMetricsFromDocument(header.ref, header.ref, &metrics);
+
+    if (metrics.size() != header.metricsCount) {
+        return {ErrorCodes::BadValue,
+                "The metrics in the reference document and metrics count do not match"};
+    }
+
+    std::vector<std::uint64_t> values(1 + header.sampleCount);
+    values[0] = metrics[metric];
+
+    if (header.sampleCount == 0) {
+        return {values};
+    }
+
+    // Skip over the blocks preceding the one that holds the metric
+    const std::uint32_t block = metric / header.metricsPerBlock;
+    std::size_t blockOffset = 0;
+    for (std::uint32_t i = 0; i < block; ++i) {
+        blockOffset += header.blocks[i].second;
+    }
+
+    const auto [uncompressedLength, compressedLength] = header.blocks[block];
+    auto swBlock = _zstdCompressor.uncompress(
+        ConstDataRange(header.blockData.data() + blockOffset, compressedLength),
+        uncompressedLength);
+    if (!swBlock.isOK()) {
+        return swBlock.getStatus();
+    }
+
+    auto status = decodeColumn(swBlock.getValue(),
+                               header.columnOffsets[metric],
+                               header.sampleCount,
+                               values[0],
+                               &values[1]);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    return {values};
+}
+
+StatusWith<BSONObj> FTDCDecompressor::getColumnarReferenceDocument(ConstDataRange buf) {
+    ConstDataRangeCursor cdc(buf);
+    return readColumnarReferenceDocument(&cdc, &_zstdCompressor);
+}
+
 }  // namespace mongo
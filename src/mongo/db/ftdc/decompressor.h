@@ -57,8 +57,31 @@ public:
      */
     StatusWith<std::vector<BSONObj>> uncompress(ConstDataRange buf);
 
+    /**
+     * Inflates a FTDCMetricChunkFormat::kColumnar chunk of metrics into a vector of owned BSON
+     * documents, like uncompress().
+     */
+    StatusWith<std::vector<BSONObj>> uncompressColumnar(ConstDataRange buf);
+
+    /**
+     * Decodes the values of a single metric from a FTDCMetricChunkFormat::kColumnar chunk without
+     * uncompressing the other blocks of the chunk. Metrics are numbered in the order they are
+     * returned by FTDCBSONUtil::extractMetricsFromDocument for the reference document, which
+     * readers can get without uncompressing any metrics from getColumnarReferenceDocument().
+     *
+     * Returns N values where N = sample count + 1. The 1 is the value in the reference document.
+     */
+    StatusWith<std::vector<std::uint64_t>> uncompressColumnarMetric(ConstDataRange buf,
+                                                                    std::uint32_t metric);
+
+    /**
+     * Returns the reference document of a FTDCMetricChunkFormat::kColumnar chunk.
+     */
+    StatusWith<BSONObj> getColumnarReferenceDocument(ConstDataRange buf);
+
 private:
     BlockCompressor _compressor;
+    ZstdBlockCompressor _zstdCompressor;
 };
 
 }  // namespace mongo
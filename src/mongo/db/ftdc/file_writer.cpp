@@ -169,7 +169,8 @@ Status FTDCFileWriter::writeSample(const BSONObj& sample, Date_t date) {
         }
 
         BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
-                                                                std::get<1>(swBuf.getValue()));
+                                                                std::get<1>(swBuf.getValue()),
+                                                                _compressor.getMetricChunkFormat());
         return writeInterimFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
     }
 
@@ -185,8 +186,10 @@ Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_
                 return swBuf.getStatus();
             }
 
-            BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
-                                                                    std::get<1>(swBuf.getValue()));
+            BSONObj o =
+                FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
+                                                            std::get<1>(swBuf.getValue()),
+                                                            _compressor.getMetricChunkFormat());
             Status s = writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
 
             if (!s.isOK()) {
@@ -194,7 +197,10 @@ Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_
             }
         }
     } else {
-        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(range.get(), date);
+        // The metric chunk format of the writer's config never changes, so the chunk that was just
+        // completed has the same format as the compressor's next one.
+        BSONObj o = FTDCBSONUtil::createBSONMetricChunkDocument(
+            range.get(), date, _compressor.getMetricChunkFormat());
         Status s = writeArchiveFileBuffer({o.objdata(), static_cast<size_t>(o.objsize())});
 
         if (!s.isOK()) {
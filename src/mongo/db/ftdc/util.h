@@ -34,6 +34,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
+#include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/decompressor.h"
 #include "mongo/db/jsobj.h"
 
@@ -63,6 +64,14 @@ enum class FTDCType : std::int32_t {
      * See createBSONMetricChunkDocument
      */
     kMetricChunk = 1,
+
+    /**
+     * A metrics chunk is composed of a header + a FTDCMetricChunkFormat::kColumnar compressed
+     * metric chunk.
+     *
+     * See createBSONMetricChunkDocument
+     */
+    kColumnarMetricChunk = 2,
 };
 
 
@@ -140,6 +149,8 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  * data field in the example above. For the _id field, the date is specified by the caller
  * since the metric chunk usually composed of multiple samples gathered over a period of time.
  *
+ * The type is 1 for FTDCMetricChunkFormat::kDelta chunks, and 2 for kColumnar chunks.
+ *
  * Example:
  * {
  *  "_id" : Date_t
@@ -147,7 +158,8 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  *  "data" : BinData(...)
  * }
  */
-BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t now);
+BSONObj createBSONMetricChunkDocument(
+    ConstDataRange buf, Date_t now, FTDCMetricChunkFormat format = FTDCMetricChunkFormat::kDelta);
 
 /**
  * Get the _id field of a BSON document
@@ -57,6 +57,22 @@ struct FTDCVarInt {
         return _value;
     }
 
+    /**
+     * Map a 64-bit two's complement integer to an unsigned integer so that numbers with a small
+     * absolute value, including negative ones, compress to few bytes: 0, -1, 1, -2, 2, ... are
+     * mapped to 0, 1, 2, 3, 4, ...
+     */
+    static std::uint64_t zigZagEncode(std::uint64_t value) {
+        return (value << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(value) >> 63);
+    }
+
+    /**
+     * Inverse of zigZagEncode.
+     */
+    static std::uint64_t zigZagDecode(std::uint64_t value) {
+        return (value >> 1) ^ (~(value & 1) + 1);
+    }
+
 private:
     std::uint64_t _value{0};
 };
@@ -36,6 +36,7 @@
 #include <utility>
 #include <vector>
 
+#include "mongo/base/checked_cast.h"
 #include "mongo/base/error_codes.h"
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -84,6 +85,27 @@ bool isMultikeyFromPaths(const MultikeyPaths& multikeyPaths) {
                        [](const MultikeyComponents& components) { return !components.empty(); });
 }
 
+/**
+ * Adds the path components in 'multikeyPaths' to those already in 'indexMultikeyPaths'.
+ */
+void mergeMultikeyPaths(MultikeyPaths* indexMultikeyPaths, const MultikeyPaths& multikeyPaths) {
+    if (multikeyPaths.empty()) {
+        return;
+    }
+
+    if (indexMultikeyPaths->empty()) {
+        *indexMultikeyPaths = multikeyPaths;
+        return;
+    }
+
+    invariant(indexMultikeyPaths->size() == multikeyPaths.size());
+    for (size_t i = 0; i < multikeyPaths.size(); ++i) {
+        (*indexMultikeyPaths)[i].insert(boost::container::ordered_unique_range_t(),
+                                        multikeyPaths[i].begin(),
+                                        multikeyPaths[i].end());
+    }
+}
+
 }  // namespace
 
 struct BtreeExternalSortComparison {
@@ -443,7 +465,10 @@ public:
     Status insert(OperationContext* opCtx,
                   const BSONObj& obj,
                   const RecordId& loc,
-                  const InsertDeleteOptions& options) final;
+                  const InsertDeleteOptions& options,
+                  const OnSkippedRecordFn& onSkippedRecord = nullptr) final;
+
+    void mergeFrom(std::unique_ptr<BulkBuilder> other) final;
 
     const MultikeyPaths& getMultikeyPaths() const final;
 
@@ -479,6 +504,10 @@ private:
     // These are inserted into the sorter after all normal data keys have been added, just
     // before the bulk build is committed.
     KeyStringSet _multikeyMetadataKeys;
+
+    // BulkBuilders whose sorted keys are merged with the keys of this one by done(). They own
+    // the Sorters backing the returned iterator, so must outlive it.
+    std::vector<std::unique_ptr<BulkBuilderImpl>> _mergedBuilders;
 };
 
 std::unique_ptr<IndexAccessMethod::BulkBuilder> AbstractIndexAccessMethod::initiateBulk(
@@ -500,10 +529,12 @@ AbstractIndexAccessMethod::BulkBuilderImpl::BulkBuilderImpl(IndexCatalogEntry* i
               {index->accessMethod()->getSortedDataInterface()->getKeyStringVersion()}, {}))),
       _indexCatalogEntry(index) {}
 
-Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCtx,
-                                                          const BSONObj& obj,
-                                                          const RecordId& loc,
-                                                          const InsertDeleteOptions& options) {
+Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(
+    OperationContext* opCtx,
+    const BSONObj& obj,
+    const RecordId& loc,
+    const InsertDeleteOptions& options,
+    const OnSkippedRecordFn& onSkippedRecord) {
     auto& executionCtx = StorageExecutionContext::get(opCtx);
 
     auto keys = executionCtx.keys();
@@ -522,6 +553,11 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
             [&](Status status, const BSONObj&, boost::optional<RecordId>) {
                 // If a key generation error was suppressed, record the document as "skipped" so the
                 // index builder can retry at a point when data is consistent.
+                if (onSkippedRecord) {
+                    onSkippedRecord(loc);
+                    return;
+                }
+
                 auto interceptor = _indexCatalogEntry->indexBuildInterceptor();
                 if (interceptor && interceptor->getSkippedRecordTracker()) {
                     LOGV2_DEBUG(20684,
@@ -538,18 +574,7 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
         return exceptionToStatus();
     }
 
-    if (!multikeyPaths->empty()) {
-        if (_indexMultikeyPaths.empty()) {
-            _indexMultikeyPaths = *multikeyPaths;
-        } else {
-            invariant(_indexMultikeyPaths.size() == multikeyPaths->size());
-            for (size_t i = 0; i < multikeyPaths->size(); ++i) {
-                _indexMultikeyPaths[i].insert(boost::container::ordered_unique_range_t(),
-                                              (*multikeyPaths)[i].begin(),
-                                              (*multikeyPaths)[i].end());
-            }
-        }
-    }
+    mergeMultikeyPaths(&_indexMultikeyPaths, *multikeyPaths);
 
     for (const auto& keyString : *keys) {
         _sorter->add(keyString, mongo::NullValue());
@@ -563,6 +588,29 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
     return Status::OK();
 }
 
+void AbstractIndexAccessMethod::BulkBuilderImpl::mergeFrom(std::unique_ptr<BulkBuilder> other) {
+    auto otherImpl = checked_cast<BulkBuilderImpl*>(other.get());
+    invariant(otherImpl->_indexCatalogEntry == _indexCatalogEntry);
+
+    mergeMultikeyPaths(&_indexMultikeyPaths, otherImpl->_indexMultikeyPaths);
+    _isMultiKey = _isMultiKey || otherImpl->_isMultiKey;
+    _keysInserted += otherImpl->_keysInserted;
+
+    // Multikey metadata keys may have been generated by both builders, but must only be added to
+    // the sorted dataset once.
+    _multikeyMetadataKeys.insert(otherImpl->_multikeyMetadataKeys.begin(),
+                                 otherImpl->_multikeyMetadataKeys.end());
+    otherImpl->_multikeyMetadataKeys.clear();
+
+    for (auto& builder : otherImpl->_mergedBuilders) {
+        _mergedBuilders.push_back(std::move(builder));
+    }
+    otherImpl->_mergedBuilders.clear();
+
+    other.release();
+    _mergedBuilders.emplace_back(otherImpl);
+}
+
 const MultikeyPaths& AbstractIndexAccessMethod::BulkBuilderImpl::getMultikeyPaths() const {
     return _indexMultikeyPaths;
 }
@@ -574,7 +622,20 @@ bool AbstractIndexAccessMethod::BulkBuilderImpl::isMultikey() const {
 IndexAccessMethod::BulkBuilder::Sorter::Iterator*
 AbstractIndexAccessMethod::BulkBuilderImpl::done() {
     _addMultikeyMetadataKeysIntoSorter();
-    return _sorter->done();
+    if (_mergedBuilders.empty()) {
+        return _sorter->done();
+    }
+
+    std::vector<std::shared_ptr<Sorter::Iterator>> iters;
+    iters.reserve(1 + _mergedBuilders.size());
+    iters.emplace_back(_sorter->done());
+    for (auto& builder : _mergedBuilders) {
+        iters.emplace_back(builder->_sorter->done());
+    }
+
+    // Each of the iterators is responsible for the clean up of its own Sorter's file, so the
+    // merging iterator has no file of its own.
+    return Sorter::Iterator::merge(iters, "", SortOptions(), BtreeExternalSortComparison());
 }
 
 int64_t AbstractIndexAccessMethod::BulkBuilderImpl::getKeysInserted() const {
@@ -583,10 +644,12 @@ int64_t AbstractIndexAccessMethod::BulkBuilderImpl::getKeysInserted() const {
 
 AbstractIndexAccessMethod::BulkBuilder::Sorter::State
 AbstractIndexAccessMethod::BulkBuilderImpl::getSorterState() const {
+    invariant(_mergedBuilders.empty());
     return _sorter->getState();
 }
 
 void AbstractIndexAccessMethod::BulkBuilderImpl::persistDataForShutdown() {
+    invariant(_mergedBuilders.empty());
     _addMultikeyMetadataKeysIntoSorter();
     _sorter->persistDataForShutdown();
 }
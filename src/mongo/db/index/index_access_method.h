@@ -207,16 +207,29 @@ public:
     class BulkBuilder {
     public:
         using Sorter = mongo::Sorter<KeyString::Value, mongo::NullValue>;
+        using OnSkippedRecordFn = std::function<void(const RecordId& loc)>;
 
         virtual ~BulkBuilder() = default;
 
         /**
          * Insert into the BulkBuilder as-if inserting into an IndexAccessMethod.
+         *
+         * Documents whose key generation errors are suppressed are recorded in the index build's
+         * SkippedRecordTracker, which requires write locks, unless 'onSkippedRecord' is provided,
+         * in which case it is called instead.
          */
         virtual Status insert(OperationContext* opCtx,
                               const BSONObj& obj,
                               const RecordId& loc,
-                              const InsertDeleteOptions& options) = 0;
+                              const InsertDeleteOptions& options,
+                              const OnSkippedRecordFn& onSkippedRecord = nullptr) = 0;
+
+        /**
+         * Takes over the keys and multikey information of 'other', which must have been created by
+         * the same IndexAccessMethod, so that they are part of the sorted dataset returned by
+         * done(). This allows several BulkBuilders to be filled concurrently and committed as one.
+         */
+        virtual void mergeFrom(std::unique_ptr<BulkBuilder> other) = 0;
 
         virtual const MultikeyPaths& getMultikeyPaths() const = 0;
 
@@ -234,12 +247,14 @@ public:
         virtual int64_t getKeysInserted() const = 0;
 
         /**
-         * Returns the current state of this BulkBuilder's underlying Sorter.
+         * Returns the current state of this BulkBuilder's underlying Sorter. Must not be called
+         * once other BulkBuilders have been merged into this one.
          */
         virtual Sorter::State getSorterState() const = 0;
 
         /**
-         * Persists on disk the keys that have been inserted using this BulkBuilder.
+         * Persists on disk the keys that have been inserted using this BulkBuilder. Must not be
+         * called once other BulkBuilders have been merged into this one.
          */
         virtual void persistDataForShutdown() = 0;
     };
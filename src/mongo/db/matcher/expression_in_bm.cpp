@@ -0,0 +1,101 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/query/query_knobs_gen.h"
+
+namespace mongo {
+namespace {
+
+constexpr size_t kNumProbes = 1024;
+
+/**
+ * Matches elements against an $in over 'state.range(0)' equalities produced by 'makeValue', either
+ * by binary searching the sorted equalities or by looking them up in a hash set. Half of the probed
+ * elements are in the $in list.
+ */
+template <typename MakeValue>
+void runInMatch(benchmark::State& state, bool useHashSet, MakeValue makeValue) {
+    const auto numEqualities = state.range(0);
+
+    BSONArrayBuilder equalitiesBuilder;
+    for (int64_t i = 0; i < numEqualities; ++i) {
+        equalitiesBuilder.append(makeValue(2 * i));
+    }
+    BSONArray equalitiesArr = equalitiesBuilder.arr();
+
+    std::mt19937_64 gen(1234);
+    std::uniform_int_distribution<int64_t> dist(0, 2 * numEqualities - 1);
+    BSONArrayBuilder probesBuilder;
+    for (size_t i = 0; i < kNumProbes; ++i) {
+        probesBuilder.append(makeValue(dist(gen)));
+    }
+    BSONArray probesArr = probesBuilder.arr();
+    std::vector<BSONElement> probes;
+    probesArr.elems(probes);
+
+    const auto oldThreshold = internalQueryInHashSetThreshold.load();
+    internalQueryInHashSetThreshold.store(useHashSet ? 0 : std::numeric_limits<int>::max());
+
+    InMatchExpression in("a");
+    std::vector<BSONElement> equalities;
+    equalitiesArr.elems(equalities);
+    invariant(in.setEqualities(std::move(equalities)));
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(in.matchesSingleElement(probes[i++ % kNumProbes]));
+    }
+
+    internalQueryInHashSetThreshold.store(oldThreshold);
+}
+
+void BM_InMatchInts(benchmark::State& state, bool useHashSet) {
+    runInMatch(state, useHashSet, [](int64_t i) { return static_cast<long long>(i); });
+}
+
+void BM_InMatchStrings(benchmark::State& state, bool useHashSet) {
+    runInMatch(state, useHashSet, [](int64_t i) { return "user-" + std::to_string(i); });
+}
+
+BENCHMARK_CAPTURE(BM_InMatchInts, SortedVector, false)->RangeMultiplier(10)->Range(10, 100'000);
+BENCHMARK_CAPTURE(BM_InMatchInts, HashSet, true)->RangeMultiplier(10)->Range(10, 100'000);
+BENCHMARK_CAPTURE(BM_InMatchStrings, SortedVector, false)->RangeMultiplier(10)->Range(10, 100'000);
+BENCHMARK_CAPTURE(BM_InMatchStrings, HashSet, true)->RangeMultiplier(10)->Range(10, 100'000);
+
+}  // namespace
+}  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/path.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/regex_util.h"
 #include "mongo/util/str.h"
 
@@ -395,9 +396,26 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
 }
 
 bool InMatchExpression::contains(const BSONElement& e) const {
+    if (_equalitySet.size() > static_cast<size_t>(internalQueryInHashSetThreshold.load())) {
+        return _getEqualityHashSet().count(e) > 0;
+    }
     return std::binary_search(_equalitySet.begin(), _equalitySet.end(), e, _eltCmp.makeLessThan());
 }
 
+const BSONEltUnorderedSet& InMatchExpression::_getEqualityHashSet() const {
+    if (!_equalityHashSetBuilt.load()) {
+        stdx::lock_guard<Latch> lk(_equalityHashSetMutex);
+        if (!_equalityHashSet) {
+            auto hashSet = std::make_unique<BSONEltUnorderedSet>(_eltCmp.makeBSONEltUnorderedSet());
+            hashSet->reserve(_equalitySet.size());
+            hashSet->insert(_equalitySet.begin(), _equalitySet.end());
+            _equalityHashSet = std::move(hashSet);
+        }
+        _equalityHashSetBuilt.store(true);
+    }
+    return *_equalityHashSet;
+}
+
 bool InMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails* details) const {
     if (_hasNull && e.eoo()) {
         return true;
@@ -500,12 +518,21 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
     }
 
     // We need to re-compute '_equalitySet', since our set comparator has changed.
+    _buildEqualitySet();
+}
+
+void InMatchExpression::_buildEqualitySet() {
     _equalitySet.clear();
     _equalitySet.reserve(_originalEqualityVector.size());
     std::unique_copy(_originalEqualityVector.begin(),
                      _originalEqualityVector.end(),
                      std::back_inserter(_equalitySet),
                      _eltCmp.makeEqualTo());
+
+    // The hash set, if any, holds the old equalities and may have been built with the old
+    // comparator.
+    _equalityHashSet.reset();
+    _equalityHashSetBuilt.store(false);
 }
 
 Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
@@ -533,12 +560,7 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
             _originalEqualityVector.begin(), _originalEqualityVector.end(), _eltCmp.makeLessThan());
     }
 
-    _equalitySet.clear();
-    _equalitySet.reserve(_originalEqualityVector.size());
-    std::unique_copy(_originalEqualityVector.begin(),
-                     _originalEqualityVector.end(),
-                     std::back_inserter(_equalitySet),
-                     _eltCmp.makeEqualTo());
+    _buildEqualitySet();
 
     return Status::OK();
 }
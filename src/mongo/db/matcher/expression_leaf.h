@@ -38,6 +38,8 @@
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_path.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/stdx/unordered_map.h"
 
 namespace pcrecpp {
@@ -547,6 +549,16 @@ public:
 private:
     ExpressionOptimizerFunc getOptimizer() const final;
 
+    /**
+     * Recomputes '_equalitySet' from '_originalEqualityVector' using the current comparator.
+     */
+    void _buildEqualitySet();
+
+    /**
+     * Returns a hash set of the elements of '_equalitySet', building it on first use.
+     */
+    const BSONEltUnorderedSet& _getEqualityHashSet() const;
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -570,10 +582,18 @@ private:
     // support std::binary_search. Because we need to sort the elements anyway for things like index
     // bounds building, using binary search avoids the overhead of inserting into a hash table which
     // doesn't pay for itself in the common case where lookups are done a few times if ever.
-    // TODO It may be worth dynamically creating a hashset after matchesSingleElement() has been
-    // called "many" times.
     std::vector<BSONElement> _equalitySet;
 
+    // Hash set of the elements in '_equalitySet', which replaces the binary search once the number
+    // of equalities exceeds 'internalQueryInHashSetThreshold'. It hashes and compares elements with
+    // '_eltCmp', so it honors the collation. Built on the first lookup rather than up front since
+    // many $in expressions are only ever used to build index bounds. Match expressions, such as
+    // partial index filters, may be evaluated by several threads at once, hence the mutex.
+    mutable Mutex _equalityHashSetMutex =
+        MONGO_MAKE_LATCH("InMatchExpression::_equalityHashSetMutex");
+    mutable AtomicWord<bool> _equalityHashSetBuilt{false};
+    mutable std::unique_ptr<BSONEltUnorderedSet> _equalityHashSet;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
@@ -1370,6 +1370,56 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.contains(obj2.firstElement()));
 }
 
+TEST(InMatchExpression, LargeEqualityListMatchesNumbersOfAnyType) {
+    BSONArrayBuilder operand;
+    for (int i = 0; i < 1000; i += 2) {
+        operand.append(i);
+    }
+    BSONArray arr = operand.arr();
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    arr.elems(equalities);
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+
+    ASSERT(in.matchesSingleElement(BSON("a" << 10)["a"]));
+    ASSERT(in.matchesSingleElement(BSON("a" << 998LL)["a"]));
+    ASSERT(in.matchesSingleElement(BSON("a" << 500.0)["a"]));
+    ASSERT(in.matchesSingleElement(BSON("a" << Decimal128(4))["a"]));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 11)["a"]));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 10.5)["a"]));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 1000)["a"]));
+    ASSERT(!in.matchesSingleElement(BSON("a"
+                                         << "10")["a"]));
+}
+
+TEST(InMatchExpression, LargeEqualityListRespectsCollation) {
+    BSONArrayBuilder operand;
+    for (int i = 0; i < 1000; ++i) {
+        operand.append("STRING" + std::to_string(i));
+    }
+    BSONArray arr = operand.arr();
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    InMatchExpression in("");
+    in.setCollator(&collator);
+    std::vector<BSONElement> equalities;
+    arr.elems(equalities);
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+
+    ASSERT(in.matchesSingleElement(BSON("a"
+                                        << "string42")["a"]));
+    ASSERT(in.matchesSingleElement(BSON("a"
+                                        << "StRiNg999")["a"]));
+    ASSERT(!in.matchesSingleElement(BSON("a"
+                                         << "string1000")["a"]));
+
+    // Changing the collator after the hash set has been built must take effect.
+    in.setCollator(nullptr);
+    ASSERT(!in.matchesSingleElement(BSON("a"
+                                         << "string42")["a"]));
+    ASSERT(in.matchesSingleElement(BSON("a"
+                                        << "STRING42")["a"]));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
@@ -65,6 +65,12 @@ public:
     // Name for the system views collection
     static constexpr StringData kSystemDotViewsCollectionName = "system.views"_sd;
 
+    // Name for the collection holding the statistics gathered by the "analyze" command.
+    static constexpr StringData kSystemDotStatisticsCollectionName = "system.statistics"_sd;
+
+    // Prefix for the collections holding the buckets of time-series collections.
+    static constexpr StringData kTimeseriesBucketsCollectionPrefix = "system.buckets."_sd;
+
     // Names of privilege document collections
     static constexpr StringData kSystemUsers = "system.users"_sd;
     static constexpr StringData kSystemRoles = "system.roles"_sd;
@@ -241,6 +247,12 @@ public:
     bool isSystemDotViews() const {
         return coll() == kSystemDotViewsCollectionName;
     }
+    bool isSystemDotStatistics() const {
+        return coll() == kSystemDotStatisticsCollectionName;
+    }
+    bool isTimeseriesBucketsCollection() const {
+        return coll().startsWith(kTimeseriesBucketsCollectionPrefix);
+    }
     bool isServerConfigurationCollection() const {
         return (db() == kAdminDb) && (coll() == "system.version");
     }
@@ -269,6 +281,14 @@ public:
         return false;
     }
 
+    /**
+     * Returns the namespace of the collection holding the buckets of the time-series collection
+     * 'this'.
+     */
+    NamespaceString makeTimeseriesBucketsNamespace() const {
+        return {db(), kTimeseriesBucketsCollectionPrefix.toString() + coll().toString()};
+    }
+
     bool isOrphanCollection() const {
         return db() == kOrphanCollectionDb && coll().startsWith(kOrphanCollectionPrefix);
     }
@@ -50,6 +50,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/op_observer_util.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/collection_statistics_cache.h"
 #include "mongo/db/read_write_concern_defaults.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_entry_gen.h"
@@ -486,6 +487,10 @@ void OpObserverImpl::onInserts(OperationContext* opCtx,
         Scope::storedFuncMod(opCtx);
     } else if (nss.coll() == DurableViewCatalog::viewsCollectionName()) {
         DurableViewCatalog::onExternalChange(opCtx, nss);
+    } else if (nss.isSystemDotStatistics()) {
+        for (auto it = first; it != last; it++) {
+            CollectionStatisticsCache::get(opCtx).onWrite(opCtx, nss, it->doc);
+        }
     } else if (nss == NamespaceString::kServerConfigurationNamespace) {
         // We must check server configuration collection writes for featureCompatibilityVersion
         // document changes.
@@ -562,6 +567,8 @@ void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArg
         Scope::storedFuncMod(opCtx);
     } else if (args.nss.coll() == DurableViewCatalog::viewsCollectionName()) {
         DurableViewCatalog::onExternalChange(opCtx, args.nss);
+    } else if (args.nss.isSystemDotStatistics()) {
+        CollectionStatisticsCache::get(opCtx).onWrite(opCtx, args.nss, args.updateArgs.updatedDoc);
     } else if (args.nss == NamespaceString::kServerConfigurationNamespace) {
         // We must check server configuration collection writes for featureCompatibilityVersion
         // document changes.
@@ -632,6 +639,9 @@ void OpObserverImpl::onDelete(OperationContext* opCtx,
         Scope::storedFuncMod(opCtx);
     } else if (nss.coll() == DurableViewCatalog::viewsCollectionName()) {
         DurableViewCatalog::onExternalChange(opCtx, nss);
+    } else if (nss.isSystemDotStatistics()) {
+        CollectionStatisticsCache::get(opCtx).onDelete(
+            opCtx, nss, documentKey.getId().firstElement());
     } else if (nss.isServerConfigurationCollection()) {
         auto _id = documentKey.getId().firstElement();
         if (_id.type() == BSONType::String &&
@@ -776,6 +786,8 @@ repl::OpTime OpObserverImpl::onDropCollection(OperationContext* opCtx,
 
     if (collectionName.coll() == DurableViewCatalog::viewsCollectionName()) {
         DurableViewCatalog::onSystemViewsCollectionDrop(opCtx, collectionName);
+    } else if (collectionName.isSystemDotStatistics()) {
+        CollectionStatisticsCache::get(opCtx).onDrop(opCtx, collectionName);
     } else if (collectionName == NamespaceString::kSessionTransactionsTableNamespace) {
         // Disallow this drop if there are currently prepared transactions.
         const auto sessionCatalog = SessionCatalog::get(opCtx);
@@ -1325,6 +1337,9 @@ void OpObserverImpl::onReplicationRollback(OperationContext* opCtx,
     // document was rolled back.
     ReadWriteConcernDefaults::get(opCtx).invalidate();
 
+    // Forget the cached collection statistics, whose documents may have been rolled back.
+    CollectionStatisticsCache::get(opCtx).clear();
+
     // Make sure the in-memory FCV matches the on-disk FCV.
     FeatureCompatibilityVersion::onReplicationRollback(opCtx);
 }
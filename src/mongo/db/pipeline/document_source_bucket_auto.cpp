@@ -33,6 +33,7 @@
 
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/util/bump_arena.h"
 
 namespace mongo {
 
@@ -89,6 +90,9 @@ const char* DocumentSourceBucketAuto::getSourceName() const {
 
 DocumentSource::GetNextResult DocumentSourceBucketAuto::doGetNext() {
     if (!_populated) {
+        // The sorted input and the buckets are retained until the stage is done, so allocate them
+        // from the heap rather than the pipeline's arena.
+        BumpArena::Scope heapScope(nullptr);
         const auto populationResult = populateSorter();
         if (populationResult.isPaused()) {
             return populationResult;
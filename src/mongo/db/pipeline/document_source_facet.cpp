@@ -31,21 +31,34 @@
 
 #include "mongo/db/pipeline/document_source_facet.h"
 
+#include <algorithm>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
+#include "mongo/db/client.h"
 #include "mongo/db/exec/document_value/document.h"
 #include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/document_source_tee_consumer.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/tee_buffer.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/static_immortal.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -55,15 +68,81 @@ using std::pair;
 using std::string;
 using std::vector;
 
+namespace {
+
+/**
+ * Returns whether the sub-pipelines 'facets' of a $facet stage may run concurrently.
+ */
+bool canRunConcurrently(const std::vector<DocumentSourceFacet::FacetPipeline>& facets,
+                        const intrusive_ptr<ExpressionContext>& expCtx) {
+    if (internalQueryFacetMaxConcurrentBranches.load() <= 1 || facets.size() <= 1) {
+        return false;
+    }
+
+    std::set<const ExpressionContext*> contexts{expCtx.get()};
+    for (auto&& facet : facets) {
+        // Evaluating expressions sets variables, so the sub-pipelines must not share them.
+        if (!contexts.insert(facet.pipeline->getContext().get()).second) {
+            return false;
+        }
+
+        stdx::unordered_set<NamespaceString> involvedNss;
+        for (auto&& source : facet.pipeline->getSources()) {
+            source->addInvolvedCollections(&involvedNss);
+        }
+        if (!involvedNss.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Adds the size of 'doc' to 'resultBytes', the size of the results of all the sub-pipelines of a
+ * $facet stage running concurrently, and throws if it exceeds
+ * 'internalQueryFacetMaxOutputDocSizeBytes'.
+ */
+void addResultBytes(AtomicWord<long long>* resultBytes, const Document& doc) {
+    const auto maxBytes = internalQueryFacetMaxOutputDocSizeBytes.load();
+    const auto bytes = resultBytes->addAndFetch(static_cast<long long>(doc.getApproximateSize()));
+    uassert(4918035,
+            str::stream() << "$facet sub-pipelines produced more than " << maxBytes
+                          << " bytes of results",
+            bytes <= maxBytes);
+}
+
+/**
+ * Returns the pool which runs the sub-pipelines of all the $facet stages of the process that run
+ * concurrently. Its threads have no Client, since they borrow the one of the sub-pipeline they run.
+ */
+ThreadPool& getSubPipelinePool() {
+    static auto& pool = []() -> ThreadPool& {
+        ThreadPool::Options options;
+        options.poolName = "FacetSubPipelines";
+        options.minThreads = 0;
+        options.maxThreads = ProcessInfo::getNumAvailableCores();
+        static StaticImmortal<ThreadPool> pool(std::move(options));
+        pool->startup();
+        return *pool;
+    }();
+    return pool;
+}
+
+}  // namespace
+
 DocumentSourceFacet::DocumentSourceFacet(std::vector<FacetPipeline> facetPipelines,
                                          const intrusive_ptr<ExpressionContext>& expCtx)
     : DocumentSource(kStageName, expCtx),
       _teeBuffer(TeeBuffer::create(facetPipelines.size())),
-      _facets(std::move(facetPipelines)) {
+      _facets(std::move(facetPipelines)),
+      _canRunConcurrently(canRunConcurrently(_facets, expCtx)) {
     for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
         auto& facet = _facets[facetId];
-        facet.pipeline->addInitialSource(
-            DocumentSourceTeeConsumer::create(pExpCtx, facetId, _teeBuffer));
+        facet.pipeline->addInitialSource(DocumentSourceTeeConsumer::create(
+            facet.pipeline->getContext(), facetId, _teeBuffer));
+    }
+    if (_canRunConcurrently) {
+        _teeBuffer->enableConcurrentConsumers();
     }
 }
 
@@ -143,6 +222,18 @@ DocumentSource::GetNextResult DocumentSourceFacet::doGetNext() {
         return GetNextResult::makeEOF();
     }
 
+    auto results = _canRunConcurrently ? _runConcurrently() : _runSequentially();
+
+    MutableDocument resultDoc;
+    for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+        resultDoc[_facets[facetId].name] = Value(std::move(results[facetId]));
+    }
+
+    _done = true;  // We will only ever produce one result.
+    return resultDoc.freeze();
+}
+
+vector<vector<Value>> DocumentSourceFacet::_runSequentially() {
     vector<vector<Value>> results(_facets.size());
     bool allPipelinesEOF = false;
     while (!allPipelinesEOF) {
@@ -156,14 +247,130 @@ DocumentSource::GetNextResult DocumentSourceFacet::doGetNext() {
             allPipelinesEOF = allPipelinesEOF && next.isEOF();
         }
     }
+    return results;
+}
 
-    MutableDocument resultDoc;
-    for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
-        resultDoc[_facets[facetId].name] = Value(std::move(results[facetId]));
+vector<vector<Value>> DocumentSourceFacet::_runConcurrently() {
+    OperationContext* const opCtx = pExpCtx->opCtx;
+
+    // The operation of the $facet may only be used by its own thread, so each sub-pipeline runs on
+    // an operation of its own, under a Client of its own. The pool thread running the sub-pipeline
+    // over a batch borrows that Client for the time of the batch.
+    struct FacetRun {
+        vector<Value> results;
+        bool isEOF = false;
+
+        ServiceContext::UniqueClient client;
+        ServiceContext::UniqueOperationContext opCtx;
+    };
+    vector<FacetRun> runs(_facets.size());
+    AtomicWord<long long> resultBytes{0};
+
+    ON_BLOCK_EXIT([&] {
+        for (size_t facetId = 0; facetId < runs.size(); ++facetId) {
+            _facets[facetId].pipeline->reattachToOperationContext(opCtx);
+            runs[facetId].opCtx.reset();
+        }
+    });
+    for (size_t facetId = 0; facetId < runs.size(); ++facetId) {
+        auto& run = runs[facetId];
+        run.client = opCtx->getServiceContext()->makeClient(str::stream() << "$facet-" << facetId);
+        run.opCtx = run.client->makeOperationContext();
+        _facets[facetId].pipeline->reattachToOperationContext(run.opCtx.get());
     }
 
-    _done = true;  // We will only ever produce one result.
-    return resultDoc.freeze();
+    // Runs sub-pipeline 'facetId' over the current batch of the tee buffer.
+    auto runFacet = [&](size_t facetId) {
+        auto& run = runs[facetId];
+        AlternativeClientRegion acr(run.client);
+
+        const auto& pipeline = _facets[facetId].pipeline;
+        auto next = pipeline->getSources().back()->getNext();
+        for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+            addResultBytes(&resultBytes, next.getDocument());
+            run.results.emplace_back(next.releaseDocument());
+        }
+        run.isEOF = next.isEOF();
+    };
+
+    auto mutex = MONGO_MAKE_LATCH("DocumentSourceFacet::_runConcurrently::mutex");
+    stdx::condition_variable cv;
+    vector<size_t> facetIds;
+    size_t nextFacetId = 0;
+    size_t numRunning = 0;
+    Status firstError = Status::OK();
+
+    // Runs the sub-pipelines of the current round until there are none left, or one of them fails.
+    auto runFacets = [&](Status status) {
+        while (status.isOK()) {
+            size_t facetId;
+            {
+                stdx::lock_guard<Latch> lk(mutex);
+                if (nextFacetId == facetIds.size() || !firstError.isOK()) {
+                    break;
+                }
+                facetId = facetIds[nextFacetId++];
+            }
+
+            try {
+                runFacet(facetId);
+            } catch (const DBException& ex) {
+                status = ex.toStatus();
+            }
+        }
+
+        stdx::lock_guard<Latch> lk(mutex);
+        if (!status.isOK() && firstError.isOK()) {
+            firstError = std::move(status);
+        }
+        if (--numRunning == 0) {
+            cv.notify_all();
+        }
+    };
+
+    // Each round runs all the sub-pipelines which did not reach EOF over the next batch. Once the
+    // input is exhausted, one more round lets them see EOF and return the results they held back.
+    while (std::any_of(runs.begin(), runs.end(), [](const FacetRun& run) { return !run.isEOF; })) {
+        _teeBuffer->loadNextBatchForConcurrentConsumers();
+
+        stdx::unique_lock<Latch> lk(mutex);
+        facetIds.clear();
+        for (size_t facetId = 0; facetId < runs.size(); ++facetId) {
+            if (!runs[facetId].isEOF) {
+                facetIds.push_back(facetId);
+            }
+        }
+        nextFacetId = 0;
+        numRunning = std::min(
+            facetIds.size(), static_cast<size_t>(internalQueryFacetMaxConcurrentBranches.load()));
+        const auto numTasks = numRunning;
+        lk.unlock();
+        for (size_t i = 0; i < numTasks; ++i) {
+            getSubPipelinePool().schedule(runFacets);
+        }
+
+        lk.lock();
+        try {
+            opCtx->waitForConditionOrInterrupt(cv, lk, [&] { return numRunning == 0; });
+        } catch (const DBException& ex) {
+            // The sub-pipelines refer to this stage, so they must stop before it can unwind.
+            for (auto&& run : runs) {
+                auto facetOpCtx = run.opCtx.get();
+                stdx::lock_guard<Client> clientLock(*facetOpCtx->getClient());
+                facetOpCtx->getServiceContext()->killOperation(clientLock, facetOpCtx, ex.code());
+            }
+            cv.wait(lk, [&] { return numRunning == 0; });
+            throw;
+        }
+        uassertStatusOK(firstError);
+    }
+
+    vector<vector<Value>> results;
+    results.reserve(runs.size());
+    for (auto&& run : runs) {
+        results.push_back(std::move(run.results));
+    }
+    return results;
 }
 
 Value DocumentSourceFacet::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
@@ -288,10 +495,16 @@ intrusive_ptr<DocumentSource> DocumentSourceFacet::createFromBson(
     boost::optional<std::string> needsShard;
 
     std::vector<FacetPipeline> facetPipelines;
-    for (auto&& rawFacet : extractRawPipelines(elem)) {
+    const auto rawFacets = extractRawPipelines(elem);
+    for (auto&& rawFacet : rawFacets) {
         const auto facetName = rawFacet.first;
 
-        auto pipeline = Pipeline::parse(rawFacet.second, expCtx, [](const Pipeline& pipeline) {
+        // Sub-pipelines which may run concurrently must not share the variables they set.
+        auto facetExpCtx =
+            internalQueryFacetMaxConcurrentBranches.load() > 1 && rawFacets.size() > 1
+            ? expCtx->copyWith(expCtx->ns, expCtx->uuid)
+            : expCtx;
+        auto pipeline = Pipeline::parse(rawFacet.second, facetExpCtx, [](const Pipeline& pipeline) {
             auto sources = pipeline.getSources();
             std::for_each(sources.begin(), sources.end(), [](auto& stage) {
                 auto stageConstraints = stage->constraints();
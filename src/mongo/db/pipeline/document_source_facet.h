@@ -55,6 +55,14 @@ class NamespaceString;
  * For example, {$facet: {facetA: [{$skip: 1}], facetB: [{$limit: 1}]}} would describe a $facet
  * stage which will produce a document like the following:
  * {facetA: [<all input documents except the first one>], facetB: [<the first document>]}.
+ *
+ * With 'internalQueryFacetMaxConcurrentBranches' above 1, the sub-pipelines run concurrently on a
+ * pool of threads shared by the process, each on an operation of its own, while the stage loads the
+ * input into the tee buffer batch by batch. The results of all the sub-pipelines together are then
+ * limited by 'internalQueryFacetMaxOutputDocSizeBytes'. This requires every sub-pipeline to have an
+ * ExpressionContext of its own, and none of them to read other collections, which needs the locks,
+ * session and read concern of the operation running the $facet. Otherwise the sub-pipelines run one
+ * after the other.
  */
 class DocumentSourceFacet final : public DocumentSource {
 public:
@@ -153,9 +161,19 @@ private:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * Run the sub-pipelines over the whole input and return their results, in the order of
+     * '_facets'.
+     */
+    std::vector<std::vector<Value>> _runSequentially();
+    std::vector<std::vector<Value>> _runConcurrently();
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     std::vector<FacetPipeline> _facets;
 
+    // Set if the sub-pipelines may run concurrently.
+    bool _canRunConcurrently = false;
+
     bool _done = false;
 };
 }  // namespace mongo
@@ -44,8 +44,10 @@
 #include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_skip.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 using std::deque;
@@ -455,6 +457,94 @@ TEST_F(DocumentSourceFacetTest, ShouldBeAbleToEvaluateMultipleStagesWithinOneSub
     ASSERT_DOCUMENT_EQ(output.getDocument(), Document(fromjson("{subPipe: [{_id: 0}, {_id: 1}]}")));
 }
 
+TEST_F(DocumentSourceFacetTest, ShouldRunSubPipelinesConcurrentlyOverSeveralBatches) {
+    const auto maxConcurrentBranches = internalQueryFacetMaxConcurrentBranches.load();
+    const auto bufferSizeBytes = internalQueryFacetBufferSizeBytes.load();
+    ON_BLOCK_EXIT([&] {
+        internalQueryFacetMaxConcurrentBranches.store(maxConcurrentBranches);
+        internalQueryFacetBufferSizeBytes.store(bufferSizeBytes);
+    });
+    internalQueryFacetMaxConcurrentBranches.store(3);
+    internalQueryFacetBufferSizeBytes.store(100);
+
+    auto ctx = getExpCtx();
+    deque<DocumentSource::GetNextResult> inputs;
+    vector<Value> expectedAll;
+    vector<Value> expectedEvens;
+    for (int i = 0; i < 20; ++i) {
+        inputs.push_back(Document{{"_id", i}, {"x", i}});
+        expectedAll.emplace_back(Document{{"_id", i}, {"x", i}});
+        if (i % 2 == 0) {
+            expectedEvens.emplace_back(Document{{"y", i}});
+        }
+    }
+    auto mock = DocumentSourceMock::createForTest(inputs, ctx);
+
+    auto spec = fromjson(
+        "{$facet: {"
+        "all: [],"
+        "total: [{$group: {_id: null, total: {$sum: '$x'}}}],"
+        "first: [{$limit: 2}],"
+        "evens: [{$match: {x: {$mod: [2, 0]}}},"
+        "        {$project: {_id: 0, y: {$let: {vars: {v: '$x'}, in: '$$v'}}}}]}}");
+    auto facetStage = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+    facetStage->setSource(mock.get());
+
+    auto output = facetStage->getNext();
+    ASSERT(output.isAdvanced());
+    ASSERT_VALUE_EQ(output.getDocument()["all"], Value(expectedAll));
+    ASSERT_VALUE_EQ(output.getDocument()["total"],
+                    Value(vector<Value>{Value(Document{{"_id", BSONNULL}, {"total", 190}})}));
+    ASSERT_VALUE_EQ(output.getDocument()["first"],
+                    Value(vector<Value>{expectedAll[0], expectedAll[1]}));
+    ASSERT_VALUE_EQ(output.getDocument()["evens"], Value(expectedEvens));
+
+    // The sub-pipelines are attached to the operation of the $facet again.
+    for (auto&& facet : static_cast<DocumentSourceFacet*>(facetStage.get())->getFacetPipelines()) {
+        ASSERT_EQ(facet.pipeline->getContext()->opCtx, ctx->opCtx);
+    }
+
+    ASSERT(facetStage->getNext().isEOF());
+    ASSERT(facetStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceFacetTest, ShouldLimitTheSizeOfTheResultsOfAllSubPipelines) {
+    const auto maxConcurrentBranches = internalQueryFacetMaxConcurrentBranches.load();
+    const auto maxOutputDocSizeBytes = internalQueryFacetMaxOutputDocSizeBytes.load();
+    ON_BLOCK_EXIT([&] {
+        internalQueryFacetMaxConcurrentBranches.store(maxConcurrentBranches);
+        internalQueryFacetMaxOutputDocSizeBytes.store(maxOutputDocSizeBytes);
+    });
+    internalQueryFacetMaxOutputDocSizeBytes.store(6000);
+
+    const std::string padding(1000, 'a');
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 4; ++i) {
+        inputs.push_back(Document{{"_id", i}, {"padding", padding}});
+    }
+    auto spec = fromjson("{$facet: {a: [], b: []}}");
+
+    auto ctx = getExpCtx();
+
+    // Each sub-pipeline alone stays within the limit, but both together exceed it when they run
+    // concurrently.
+    internalQueryFacetMaxConcurrentBranches.store(2);
+    auto mock = DocumentSourceMock::createForTest(inputs, ctx);
+    auto facetStage = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+    facetStage->setSource(mock.get());
+    ASSERT_THROWS_CODE(facetStage->getNext(), AssertionException, 4918035);
+
+    // The limit does not apply to sub-pipelines running one after the other.
+    internalQueryFacetMaxConcurrentBranches.store(1);
+    mock = DocumentSourceMock::createForTest(inputs, ctx);
+    facetStage = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+    facetStage->setSource(mock.get());
+    auto output = facetStage->getNext();
+    ASSERT(output.isAdvanced());
+    ASSERT_EQ(output.getDocument()["a"].getArray().size(), 4UL);
+    ASSERT_EQ(output.getDocument()["b"].getArray().size(), 4UL);
+}
+
 TEST_F(DocumentSourceFacetTest, ShouldPropagateDisposeThroughToSource) {
     auto ctx = getExpCtx();
 
@@ -44,6 +44,7 @@
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/util/bump_arena.h"
 
 namespace mongo {
 
@@ -91,6 +92,10 @@ const char* DocumentSourceGraphLookUp::getSourceName() const {
 }
 
 DocumentSource::GetNextResult DocumentSourceGraphLookUp::doGetNext() {
+    // The documents visited by a search and the lookup cache outlive individual results and count
+    // against '_maxMemoryUsageBytes', so they are not allocated from the pipeline's arena.
+    BumpArena::Scope heapScope(nullptr);
+
     if (_unwind) {
         return getNextUnwound();
     }
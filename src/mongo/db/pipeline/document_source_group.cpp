@@ -41,6 +41,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/util/bump_arena.h"
 #include "mongo/util/destructor_guard.h"
 
 namespace mongo {
@@ -132,6 +133,10 @@ const char* DocumentSourceGroup::getSourceName() const {
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::doGetNext() {
+    // The groups live until the stage is done and count against '_maxMemoryUsageBytes'. Keep them
+    // and their inputs out of the pipeline's arena, whose chunks they would pin.
+    BumpArena::Scope heapScope(nullptr);
+
     if (!_initialized) {
         const auto initializationResult = initialize();
         if (initializationResult.isPaused()) {
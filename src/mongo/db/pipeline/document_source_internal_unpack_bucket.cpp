@@ -0,0 +1,289 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+
+namespace mongo {
+
+REGISTER_DOCUMENT_SOURCE(_internalUnpackBucket,
+                         LiteParsedDocumentSourceDefault::parse,
+                         DocumentSourceInternalUnpackBucket::createFromBson);
+
+constexpr StringData DocumentSourceInternalUnpackBucket::kStageName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kTimeFieldName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kMetaFieldName;
+
+namespace {
+
+/**
+ * Returns whether a comparison of a field with 'value' can be answered from the minimum and the
+ * maximum of the field. Null also matches missing fields, which the control fields do not track,
+ * and regexes and arrays are not compared by value.
+ */
+bool isComparableWithControlFields(BSONElement value) {
+    switch (value.type()) {
+        case BSONType::jstNULL:
+        case BSONType::Undefined:
+        case BSONType::RegEx:
+        case BSONType::Array:
+            return false;
+        default:
+            return true;
+    }
+}
+
+}  // namespace
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createFromBson(
+    BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    uassert(4918008,
+            str::stream() << kStageName << " must take a nested object but found: " << elem,
+            elem.type() == BSONType::Object);
+
+    boost::optional<std::string> timeField;
+    boost::optional<std::string> metaField;
+    for (auto&& field : elem.embeddedObject()) {
+        const auto fieldName = field.fieldNameStringData();
+        uassert(4918009,
+                str::stream() << kStageName << " field '" << fieldName << "' must be a string",
+                field.type() == BSONType::String);
+        if (fieldName == kTimeFieldName) {
+            timeField = field.str();
+        } else if (fieldName == kMetaFieldName) {
+            metaField = field.str();
+        } else {
+            uasserted(4918010,
+                      str::stream()
+                          << "Unrecognized option to " << kStageName << ": " << fieldName);
+        }
+    }
+    uassert(4918011,
+            str::stream() << kStageName << " requires '" << kTimeFieldName << "'",
+            timeField);
+
+    return new DocumentSourceInternalUnpackBucket(expCtx, std::move(*timeField), metaField);
+}
+
+DocumentSourceInternalUnpackBucket::DocumentSourceInternalUnpackBucket(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::string timeField,
+    boost::optional<std::string> metaField)
+    : DocumentSource(kStageName, expCtx),
+      _timeField(std::move(timeField)),
+      _metaField(std::move(metaField)) {}
+
+void DocumentSourceInternalUnpackBucket::_resetBucket(BSONObj bucket) {
+    _bucket = bucket.getOwned();
+    _meta = _bucket[BucketCatalog::kMetaFieldName];
+    _timeColumn.reset();
+    _columns.clear();
+
+    auto data = _bucket[BucketCatalog::kDataFieldName];
+    uassert(4918012,
+            str::stream() << "Time-series bucket " << _bucket["_id"] << " has no '"
+                          << BucketCatalog::kDataFieldName << "' object",
+            data.type() == BSONType::Object);
+    for (auto&& column : data.embeddedObject()) {
+        if (column.type() != BSONType::Object) {
+            continue;
+        }
+        if (column.fieldNameStringData() == _timeField) {
+            _timeColumn.emplace(column.embeddedObject());
+        }
+        _columns.emplace_back(column.fieldNameStringData(),
+                              BSONObjIterator(column.embeddedObject()));
+    }
+}
+
+DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::doGetNext() {
+    while (!_timeColumn || !_timeColumn->more()) {
+        auto next = pSource->getNext();
+        if (!next.isAdvanced()) {
+            return next;
+        }
+        _resetBucket(next.getDocument().toBson());
+    }
+
+    const auto index = _timeColumn->next().fieldNameStringData();
+    MutableDocument measurement;
+    for (auto&& [fieldName, values] : _columns) {
+        if (values.more() && (*values).fieldNameStringData() == index) {
+            measurement.addField(fieldName, Value(values.next()));
+        }
+    }
+    if (_metaField && !_meta.eoo()) {
+        measurement.addField(*_metaField, Value(_meta));
+    }
+    return measurement.freeze();
+}
+
+void DocumentSourceInternalUnpackBucket::_appendBucketLevelPredicates(
+    const BSONObj& query, BSONArrayBuilder* predicates) const {
+    for (auto&& elem : query) {
+        const auto path = elem.fieldNameStringData();
+        if (path == "$and"_sd && elem.type() == BSONType::Array) {
+            for (auto&& clause : elem.embeddedObject()) {
+                if (clause.type() == BSONType::Object) {
+                    _appendBucketLevelPredicates(clause.embeddedObject(), predicates);
+                }
+            }
+            continue;
+        }
+        if (path.startsWith("$"_sd)) {
+            continue;
+        }
+
+        // All the measurements of a bucket share its metadata, so predicates on the metadata apply
+        // to the bucket as they are.
+        if (_metaField &&
+            (path == *_metaField ||
+             (path.startsWith(*_metaField) && path[_metaField->size()] == '.'))) {
+            predicates->append(BSON(BucketCatalog::kMetaFieldName +
+                                        path.substr(_metaField->size()).toString()
+                                    << elem));
+            continue;
+        }
+        if (path.find('.') != std::string::npos) {
+            continue;
+        }
+
+        std::vector<std::pair<StringData, BSONElement>> comparisons;
+        if (elem.type() == BSONType::Object && !elem.embeddedObject().isEmpty() &&
+            elem.embeddedObject().firstElementFieldNameStringData().startsWith("$"_sd)) {
+            for (auto&& op : elem.embeddedObject()) {
+                comparisons.emplace_back(op.fieldNameStringData(), op);
+            }
+        } else {
+            comparisons.emplace_back("$eq"_sd, elem);
+        }
+
+        const auto minPath = BucketCatalog::kControlMinFieldNamePrefix + path.toString();
+        const auto maxPath = BucketCatalog::kControlMaxFieldNamePrefix + path.toString();
+        for (auto&& [op, value] : comparisons) {
+            if (!isComparableWithControlFields(value)) {
+                continue;
+            }
+
+            // Which of the control fields must compare with the value, and how, for the bucket to
+            // possibly hold a matching measurement.
+            std::vector<std::pair<const std::string*, StringData>> bounds;
+            if (op == "$eq"_sd) {
+                bounds = {{&minPath, "$lte"_sd}, {&maxPath, "$gte"_sd}};
+            } else if (op == "$gt"_sd || op == "$gte"_sd) {
+                bounds = {{&maxPath, op}};
+            } else if (op == "$lt"_sd || op == "$lte"_sd) {
+                bounds = {{&minPath, op}};
+            }
+
+            for (auto&& [controlPath, cmp] : bounds) {
+                if (path == _timeField) {
+                    // The time field always holds dates, so the control fields can be compared
+                    // with a date value directly rather than through $expr. The _id of a bucket
+                    // is not bounded here: its timestamp wraps for times outside of the range of
+                    // ObjectId timestamps, so it does not order every bucket by time.
+                    if (value.type() == BSONType::Date) {
+                        predicates->append(BSON(*controlPath << BSON(cmp << value)));
+                    }
+                    continue;
+                }
+
+                // The minimum and the maximum of the other fields may be of different types than
+                // the value, so compare them using the total order of BSON types rather than the
+                // type bracketing of the match language.
+                BSONObjBuilder expr;
+                {
+                    BSONObjBuilder cmpBuilder(expr.subobjStart("$expr"));
+                    BSONArrayBuilder args(cmpBuilder.subarrayStart(cmp));
+                    args.append("$" + *controlPath);
+                    args.append(BSON("$literal" << value));
+                }
+                predicates->append(expr.obj());
+            }
+        }
+    }
+}
+
+BSONObj DocumentSourceInternalUnpackBucket::createBucketLevelPredicate(const BSONObj& query) const {
+    BSONArrayBuilder predicates;
+    _appendBucketLevelPredicates(query, &predicates);
+    auto arr = predicates.arr();
+    if (arr.isEmpty()) {
+        return BSONObj();
+    }
+    if (arr.nFields() == 1) {
+        return arr.firstElement().Obj().getOwned();
+    }
+    return BSON("$and" << arr);
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextStage = std::next(itr);
+    if (nextStage == container->end() || _triedBucketLevelPredicate) {
+        return nextStage;
+    }
+
+    // The control fields hold the minimum and the maximum with respect to the simple collation.
+    auto nextMatch = dynamic_cast<DocumentSourceMatch*>(nextStage->get());
+    if (!nextMatch || pExpCtx->getCollator()) {
+        return nextStage;
+    }
+
+    _triedBucketLevelPredicate = true;
+    auto predicate = createBucketLevelPredicate(nextMatch->getQuery());
+    if (predicate.isEmpty()) {
+        return nextStage;
+    }
+
+    container->insert(itr, DocumentSourceMatch::create(predicate, pExpCtx));
+
+    // Give the new $match a chance to be pushed down further.
+    return std::prev(itr) == container->begin() ? container->begin() : std::prev(std::prev(itr));
+}
+
+Value DocumentSourceInternalUnpackBucket::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    MutableDocument spec;
+    spec.addField(kTimeFieldName, Value(_timeField));
+    if (_metaField) {
+        spec.addField(kMetaFieldName, Value(*_metaField));
+    }
+    return Value(Document{{getSourceName(), spec.freeze()}});
+}
+
+}  // namespace mongo
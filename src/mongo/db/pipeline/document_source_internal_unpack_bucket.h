@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+
+namespace mongo {
+
+/**
+ * Unpacks the bucket documents of a time-series buckets collection into the measurements they
+ * hold. This is the only stage of the view through which a time-series collection is read.
+ *
+ * A $match which immediately follows this stage is translated into a predicate on the control
+ * fields of the buckets, so that buckets holding no matching measurement are skipped without being
+ * unpacked. The translated predicate only ever matches a superset of the buckets holding matching
+ * measurements, and the original $match still runs on the unpacked measurements.
+ */
+class DocumentSourceInternalUnpackBucket final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalUnpackBucket"_sd;
+    static constexpr StringData kTimeFieldName = "timeField"_sd;
+    static constexpr StringData kMetaFieldName = "metaField"_sd;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    DocumentSourceInternalUnpackBucket(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                       std::string timeField,
+                                       boost::optional<std::string> metaField);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        return {StreamType::kStreaming,
+                PositionRequirement::kNone,
+                HostTypeRequirement::kNone,
+                DiskUseRequirement::kNoDiskUse,
+                FacetRequirement::kAllowed,
+                TransactionRequirement::kAllowed,
+                LookupRequirement::kAllowed,
+                UnionRequirement::kAllowed};
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    /**
+     * Returns a predicate on the bucket documents which holds for every bucket containing a
+     * measurement matching 'query', or an empty object if no part of 'query' can be translated.
+     */
+    BSONObj createBucketLevelPredicate(const BSONObj& query) const;
+
+protected:
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
+private:
+    GetNextResult doGetNext() final;
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    void _resetBucket(BSONObj bucket);
+    void _appendBucketLevelPredicates(const BSONObj& query, BSONArrayBuilder* predicates) const;
+
+    const std::string _timeField;
+    const boost::optional<std::string> _metaField;
+
+    // Set once a bucket-level predicate was derived from the $match following this stage.
+    bool _triedBucketLevelPredicate = false;
+
+    // The bucket being unpacked. The column of the time field has a value for every measurement,
+    // while the other columns skip the measurements missing the field. The bucket updates add the
+    // values of a measurement to all of its columns at once, so the values of every column are in
+    // the same order and the columns can be iterated in lockstep with the time column.
+    BSONObj _bucket;
+    BSONElement _meta;
+    boost::optional<BSONObjIterator> _timeColumn;
+    std::vector<std::pair<StringData, BSONObjIterator>> _columns;
+};
+
+}  // namespace mongo
@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using DocumentSourceInternalUnpackBucketTest = AggregationContextFixture;
+
+boost::intrusive_ptr<DocumentSourceInternalUnpackBucket> makeUnpack(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    auto spec = BSON("$_internalUnpackBucket" << BSON("timeField"
+                                                      << "time"
+                                                      << "metaField"
+                                                      << "tags"));
+    return static_cast<DocumentSourceInternalUnpackBucket*>(
+        DocumentSourceInternalUnpackBucket::createFromBson(spec.firstElement(), expCtx).get());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, UnpacksMeasurementsOfEachBucket) {
+    auto unpack = makeUnpack(getExpCtx());
+    auto t0 = Date_t::fromMillisSinceEpoch(1000);
+    auto t1 = Date_t::fromMillisSinceEpoch(2000);
+    auto source = DocumentSourceMock::createForTest(
+        {Document{BSON("_id" << 0 << "meta" << BSON("a" << 1) << "data"
+                             << BSON("time" << BSON("0" << t0 << "1" << t1) << "x"
+                                            << BSON("1" << 5) << "y"
+                                            << BSON("0" << 6 << "1" << 7)))},
+         Document{BSON("_id" << 1 << "data" << BSON("time" << BSON("0" << t0)))}},
+        getExpCtx());
+    unpack->setSource(source.get());
+
+    auto next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(BSON("time" << t0 << "y" << 6 << "tags" << BSON("a" << 1))),
+                       next.releaseDocument());
+
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        Document(BSON("time" << t1 << "x" << 5 << "y" << 7 << "tags" << BSON("a" << 1))),
+        next.releaseDocument());
+
+    // A bucket without metadata unpacks to measurements without the meta field.
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(BSON("time" << t0)), next.releaseDocument());
+
+    ASSERT_TRUE(unpack->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, RejectsInvalidSpecs) {
+    auto parse = [&](BSONObj spec) {
+        return DocumentSourceInternalUnpackBucket::createFromBson(
+            BSON("$_internalUnpackBucket" << spec).firstElement(), getExpCtx());
+    };
+    ASSERT_THROWS_CODE(parse(BSONObj()), AssertionException, 4918011);
+    ASSERT_THROWS_CODE(parse(BSON("timeField" << 1)), AssertionException, 4918009);
+    ASSERT_THROWS_CODE(parse(BSON("timeField"
+                                  << "time"
+                                  << "foo"
+                                  << "bar")),
+                       AssertionException,
+                       4918010);
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, TranslatesPredicatesToTheControlFields) {
+    auto unpack = makeUnpack(getExpCtx());
+    auto t0 = Date_t::fromMillisSinceEpoch(1000);
+
+    ASSERT_BSONOBJ_EQ(BSON("meta.a" << 1), unpack->createBucketLevelPredicate(BSON("tags.a" << 1)));
+    ASSERT_BSONOBJ_EQ(BSON("control.max.time" << BSON("$gte" << t0)),
+                      unpack->createBucketLevelPredicate(BSON("time" << BSON("$gte" << t0))));
+    auto literal = BSON("$literal" << 5);
+    auto minPredicate =
+        BSON("$expr" << BSON("$lte" << BSON_ARRAY("$control.min.x" << literal)));
+    auto maxPredicate =
+        BSON("$expr" << BSON("$gte" << BSON_ARRAY("$control.max.x" << literal)));
+    ASSERT_BSONOBJ_EQ(BSON("$and" << BSON_ARRAY(minPredicate << maxPredicate)),
+                      unpack->createBucketLevelPredicate(BSON("x" << 5)));
+
+    // Predicates which cannot be answered from the control fields are left out.
+    ASSERT_BSONOBJ_EQ(BSONObj(),
+                      unpack->createBucketLevelPredicate(BSON("x" << BSONNULL << "x.y" << 1 << "z"
+                                                                  << BSON("$ne" << 1))));
+    auto inPredicate = BSON("x" << BSON("$in" << BSON_ARRAY(1)));
+    ASSERT_BSONOBJ_EQ(BSON("meta" << 2),
+                      unpack->createBucketLevelPredicate(
+                          BSON("$and" << BSON_ARRAY(BSON("tags" << 2) << inPredicate))));
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, OptimizationInsertsBucketLevelMatch) {
+    auto expCtx = getExpCtx();
+    auto pipeline = Pipeline::create(
+        {makeUnpack(expCtx), DocumentSourceMatch::create(BSON("tags" << 1), expCtx)}, expCtx);
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(3U, serialized.size());
+    ASSERT_BSONOBJ_EQ(BSON("$match" << BSON("meta" << 1)), serialized[0]);
+    ASSERT_BSONOBJ_EQ(BSON("$match" << BSON("tags" << 1)), serialized[2]);
+}
+
+}  // namespace
+}  // namespace mongo
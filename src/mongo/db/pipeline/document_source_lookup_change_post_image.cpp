@@ -31,7 +31,13 @@
 
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -49,22 +55,145 @@ Value assertFieldHasType(const Document& fullDoc, StringData fieldName, BSONType
             val.getType() == expectedType);
     return val;
 }
+
+bool isUpdate(const Document& input) {
+    auto opTypeVal =
+        assertFieldHasType(input, DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
+    return opTypeVal.getString() == DocumentSourceChangeStream::kUpdateOpType;
+}
+
+Value toPostImage(const boost::optional<Document>& lookedUpDoc) {
+    // Check whether the lookup returned any documents. Even if the lookup itself succeeded, it may
+    // not have returned any results if the document was deleted in the time since the update op.
+    return lookedUpDoc ? Value(*lookedUpDoc) : Value(BSONNULL);
+}
+
+// The number of update events whose post-image was looked up, and the number of lookups issued for
+// them. Several events share a lookup when their post-images are looked up together.
+Counter64 postImageLookupEventsCounter;
+Counter64 postImageLookupsCounter;
+ServerStatusMetricField<Counter64> displayPostImageLookupEvents(
+    "changeStreams.postImageLookup.events", &postImageLookupEventsCounter);
+ServerStatusMetricField<Counter64> displayPostImageLookups(
+    "changeStreams.postImageLookup.lookups", &postImageLookupsCounter);
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::doGetNext() {
-    auto input = pSource->getNext();
-    if (!input.isAdvanced()) {
-        return input;
+    if (_pending.empty()) {
+        uassertStatusOK(std::exchange(_readAheadStatus, Status::OK()));
+
+        auto input = pSource->getNext();
+        if (!input.isAdvanced() || !isUpdate(input.getDocument())) {
+            return input;
+        }
+        _pending.push_back({std::move(input), true});
+
+        // Post-images are looked up together only on mongod: mongos issues each lookup with a read
+        // concern specific to the event.
+        if (!pExpCtx->inMongos && internalChangeStreamPostImageLookupBatchSize.load() > 1) {
+            readAhead();
+        }
+    }
+
+    if (_pending.front().needsLookup) {
+        lookupPendingPostImages();
+    }
+    auto next = std::move(_pending.front().result);
+    _pending.pop_front();
+    return next;
+}
+
+void DocumentSourceLookupChangePostImage::readAhead() {
+    // Only take the events which are already available: waiting for new events here would delay
+    // returning the ones already read.
+    auto& waitState = awaitDataState(pExpCtx->opCtx);
+    const auto shouldWaitForInserts = waitState.shouldWaitForInserts;
+    waitState.shouldWaitForInserts = false;
+    ON_BLOCK_EXIT([&] { waitState.shouldWaitForInserts = shouldWaitForInserts; });
+
+    const size_t batchSize = internalChangeStreamPostImageLookupBatchSize.load();
+    try {
+        while (_pending.size() < batchSize) {
+            auto input = pSource->getNext();
+            if (input.isEOF()) {
+                // The next call asks the source again, once the pending results have been returned.
+                return;
+            }
+            const bool isPause = input.isPaused();
+            const bool needsLookup = input.isAdvanced() && isUpdate(input.getDocument());
+            _pending.push_back({std::move(input), needsLookup});
+            if (isPause) {
+                return;
+            }
+        }
+    } catch (const DBException& ex) {
+        _readAheadStatus = ex.toStatus();
     }
-    auto opTypeVal = assertFieldHasType(
-        input.getDocument(), DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
-    if (opTypeVal.getString() != DocumentSourceChangeStream::kUpdateOpType) {
-        return input;
+}
+
+void DocumentSourceLookupChangePostImage::lookupPendingPostImages() {
+    auto getLookupTarget = [&](const Document& updateOp) {
+        auto nss = assertValidNamespace(updateOp);
+        auto documentKey = assertFieldHasType(updateOp,
+                                              DocumentSourceChangeStream::kDocumentKeyField,
+                                              BSONType::Object)
+                               .getDocument();
+        auto resumeToken =
+            ResumeToken::parse(updateOp[DocumentSourceChangeStream::kIdField].getDocument());
+        invariant(resumeToken.getData().uuid);
+        return std::make_tuple(nss, *resumeToken.getData().uuid, documentKey);
+    };
+
+    auto& head = _pending.front();
+    if (_pending.size() == 1) {
+        MutableDocument output(head.result.releaseDocument());
+        output[kFullDocumentFieldName] = lookupPostImage(output.peek());
+        head = {output.freeze(), false};
+        return;
     }
 
-    MutableDocument output(input.releaseDocument());
-    output[kFullDocumentFieldName] = lookupPostImage(output.peek());
-    return output.freeze();
+    // Errors in the event at the front are thrown right away. An event further back which cannot be
+    // looked up ends the batch instead, so that its error is thrown once it reaches the front.
+    auto [nss, uuid, headKey] = getLookupTarget(head.result.getDocument());
+
+    // Distinct document keys, and the index into them of the key of each event looked up.
+    std::vector<Document> documentKeys{headKey};
+    std::vector<std::pair<PendingResult*, size_t>> lookups{{&head, 0}};
+    auto keyIndexes = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<size_t>();
+    keyIndexes.emplace(headKey.toBson(), 0);
+
+    for (auto it = std::next(_pending.begin()); it != _pending.end() && !it->result.isPaused();
+         ++it) {
+        if (!it->needsLookup) {
+            continue;
+        }
+        boost::optional<std::tuple<NamespaceString, UUID, Document>> target;
+        try {
+            target = getLookupTarget(it->result.getDocument());
+        } catch (const DBException&) {
+            break;
+        }
+        auto& [eventNss, eventUUID, documentKey] = *target;
+        if (eventNss != nss || eventUUID != uuid) {
+            break;
+        }
+        auto keyIndex = keyIndexes.emplace(documentKey.toBson(), documentKeys.size()).first->second;
+        if (keyIndex == documentKeys.size()) {
+            documentKeys.push_back(documentKey);
+        }
+        lookups.emplace_back(&*it, keyIndex);
+    }
+
+    auto lookedUpDocs = pExpCtx->mongoProcessInterface->lookupDocuments(
+        pExpCtx, nss, uuid, documentKeys, boost::none);
+    postImageLookupsCounter.increment();
+    postImageLookupEventsCounter.increment(lookups.size());
+
+    for (auto&& [pending, keyIndex] : lookups) {
+        MutableDocument output(pending->result.releaseDocument());
+        output[kFullDocumentFieldName] = toPostImage(lookedUpDocs[keyIndex]);
+        *pending = {output.freeze(), false};
+    }
 }
 
 NamespaceString DocumentSourceLookupChangePostImage::assertValidNamespace(
@@ -119,10 +248,10 @@ Value DocumentSourceLookupChangePostImage::lookupPostImage(const Document& updat
                                                              documentKey,
                                                              readConcern,
                                                              allowSpeculativeMajorityRead);
+    postImageLookupsCounter.increment();
+    postImageLookupEventsCounter.increment();
 
-    // Check whether the lookup returned any documents. Even if the lookup itself succeeded, it may
-    // not have returned any results if the document was deleted in the time since the update op.
-    return (lookedUpDoc ? Value(*lookedUpDoc) : Value(BSONNULL));
+    return toPostImage(lookedUpDoc);
 }
 
 }  // namespace mongo
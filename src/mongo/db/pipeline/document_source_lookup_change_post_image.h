@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 
@@ -37,6 +39,11 @@ namespace mongo {
 /**
  * Part of the change stream API machinery used to look up the post-image of a document. Uses the
  * "documentKey" field of the input to look up the new version of the document.
+ *
+ * On mongod, the stage reads ahead the events which are already available from its source, and
+ * looks up the post-images of consecutive update events on the same collection with a single query.
+ * The events are still returned one at a time and in order, along with any error raised while
+ * reading ahead once the events preceding it have been returned.
  */
 class DocumentSourceLookupChangePostImage final : public DocumentSource {
 public:
@@ -106,6 +113,13 @@ public:
     }
 
 private:
+    struct PendingResult {
+        GetNextResult result;
+
+        // Whether 'result' is an update event whose post-image has yet to be looked up.
+        bool needsLookup;
+    };
+
     DocumentSourceLookupChangePostImage(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : DocumentSource(kStageName, expCtx) {}
 
@@ -114,6 +128,19 @@ private:
      */
     GetNextResult doGetNext() final;
 
+    /**
+     * Queues the results that the source can return without waiting for new events, up to the
+     * configured batch size or the first pause. An error raised by the source is saved in
+     * '_readAheadStatus' rather than thrown.
+     */
+    void readAhead();
+
+    /**
+     * Looks up the post-image of the update event at the front of '_pending', along with those of
+     * the following update events on the same collection, with a single query.
+     */
+    void lookupPendingPostImages();
+
     /**
      * Uses the "documentKey" field from 'updateOp' to look up the current version of the document.
      * Returns Value(BSONNULL) if the document couldn't be found.
@@ -126,6 +153,12 @@ private:
      * function verifies that the only the database names match.
      */
     NamespaceString assertValidNamespace(const Document& inputDoc) const;
+
+    // Results read ahead from the source which have not been returned yet.
+    std::deque<PendingResult> _pending;
+
+    // The error raised by the source while reading ahead, thrown once '_pending' is empty.
+    Status _readAheadStatus = Status::OK();
 };
 
 }  // namespace mongo
@@ -334,5 +334,75 @@ TEST_F(DocumentSourceLookupChangePostImageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldLookUpConsecutivePostImagesInOrder) {
+    auto expCtx = getExpCtx();
+
+    // Set up the lookup change post image stage.
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    // Mock its input with several updates, one of which was deleted since, followed by an event
+    // without an operation type.
+    auto makeEvent = [&](int id, StringData opType) {
+        return Document{{"_id", makeResumeToken(id)},
+                        {"documentKey", Document{{"_id", id}}},
+                        {"operationType", opType},
+                        {"ns", Document{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}}}};
+    };
+    auto mockLocalSource =
+        DocumentSourceMock::createForTest({makeEvent(0, "update"_sd),
+                                           makeEvent(1, "update"_sd),
+                                           makeEvent(0, "update"_sd),
+                                           makeEvent(2, "insert"_sd),
+                                           makeEvent(3, "update"_sd),
+                                           Document{{"_id", makeResumeToken(4)},
+                                                    {"documentKey", Document{{"_id", 4}}}}},
+                                          expCtx);
+
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    // Mock out the foreign collection.
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document{{"_id", 0}, {"x", 0}}, Document{{"_id", 1}, {"x", 1}}, Document{{"_id", 2}}};
+    getExpCtx()->mongoProcessInterface =
+        std::make_unique<MockMongoInterface>(std::move(mockForeignContents));
+
+    auto withPostImage = [&](Document event, Value postImage) {
+        MutableDocument output(std::move(event));
+        output["fullDocument"] = std::move(postImage);
+        return output.freeze();
+    };
+
+    auto next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        withPostImage(makeEvent(0, "update"_sd), Value(Document{{"_id", 0}, {"x", 0}})));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        withPostImage(makeEvent(1, "update"_sd), Value(Document{{"_id", 1}, {"x", 1}})));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        withPostImage(makeEvent(0, "update"_sd), Value(Document{{"_id", 0}, {"x", 0}})));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), makeEvent(2, "insert"_sd));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       withPostImage(makeEvent(3, "update"_sd), Value(BSONNULL)));
+
+    // The error raised by the last event is only thrown once all the events preceding it have been
+    // returned.
+    ASSERT_THROWS_CODE(lookupChangeStage->getNext(), AssertionException, 40578);
+}
+
 }  // namespace
 }  // namespace mongo
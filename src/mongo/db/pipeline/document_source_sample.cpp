@@ -37,6 +37,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/util/bump_arena.h"
 
 namespace mongo {
 using boost::intrusive_ptr;
@@ -55,7 +56,9 @@ DocumentSource::GetNextResult DocumentSourceSample::doGetNext() {
         return GetNextResult::makeEOF();
 
     if (!_sortStage->isPopulated()) {
-        // Exhaust source stage, add random metadata, and push all into sorter.
+        // Exhaust source stage, add random metadata, and push all into sorter. The sorter retains
+        // the documents, so they are allocated from the heap rather than the pipeline's arena.
+        BumpArena::Scope heapScope(nullptr);
         PseudoRandom& prng = pExpCtx->opCtx->getClient()->getPrng();
         auto nextInput = pSource->getNext();
         for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
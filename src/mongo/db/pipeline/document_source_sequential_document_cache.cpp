@@ -32,6 +32,7 @@
 #include "mongo/db/pipeline/document_source_sequential_document_cache.h"
 
 #include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/util/bump_arena.h"
 
 namespace mongo {
 
@@ -65,6 +66,12 @@ DocumentSource::GetNextResult DocumentSourceSequentialDocumentCache::doGetNext()
         return GetNextResult::makeEOF();
     }
 
+    // The cache retains the documents it is built from, which count against its size limit rather
+    // than pinning chunks of the pipeline's arena.
+    boost::optional<BumpArena::Scope> heapScope;
+    if (!_cache->isAbandoned()) {
+        heapScope.emplace(nullptr);
+    }
     auto nextResult = pSource->getNext();
 
     if (!_cache->isAbandoned()) {
@@ -0,0 +1,534 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_set_window_fields.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/pipeline/document_source_add_fields.h"
+#include "mongo/db/pipeline/document_source_project.h"
+#include "mongo/db/pipeline/document_source_sort.h"
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/util/bump_arena.h"
+
+namespace mongo {
+
+REGISTER_MULTI_STAGE_ALIAS(setWindowFields,
+                           LiteParsedDocumentSourceDefault::parse,
+                           DocumentSourceSetWindowFields::createFromBson);
+
+REGISTER_DOCUMENT_SOURCE(_internalSetWindowFields,
+                         LiteParsedDocumentSourceDefault::parse,
+                         DocumentSourceInternalSetWindowFields::createFromBson);
+
+constexpr StringData DocumentSourceSetWindowFields::kStageName;
+constexpr StringData DocumentSourceInternalSetWindowFields::kStageName;
+constexpr StringData DocumentSourceInternalSetWindowFields::kPartitionByFieldName;
+constexpr StringData DocumentSourceInternalSetWindowFields::kSortByFieldName;
+constexpr StringData DocumentSourceInternalSetWindowFields::kOutputFieldName;
+constexpr StringData DocumentSourceInternalSetWindowFields::kWindowFieldName;
+constexpr StringData DocumentSourceInternalSetWindowFields::kDocumentsFieldName;
+
+namespace {
+
+constexpr StringData kPartitionKeyFieldName = "__internal_setWindowFields_partition_key"_sd;
+
+constexpr StringData kUnboundedBound = "unbounded"_sd;
+constexpr StringData kCurrentBound = "current"_sd;
+
+// The window functions which depend on the position of the document within its partition rather
+// than on a window of documents.
+constexpr StringData kDocumentNumberName = "$documentNumber"_sd;
+constexpr StringData kRankName = "$rank"_sd;
+constexpr StringData kDenseRankName = "$denseRank"_sd;
+
+bool isPositionalFunction(StringData name) {
+    return name == kDocumentNumberName || name == kRankName || name == kDenseRankName;
+}
+
+DocumentSourceInternalSetWindowFields::WindowBound parseWindowBound(BSONElement elem) {
+    if (elem.type() == BSONType::String) {
+        if (elem.valueStringData() == kUnboundedBound) {
+            return boost::none;
+        }
+        if (elem.valueStringData() == kCurrentBound) {
+            return 0LL;
+        }
+    } else if (elem.isNumber()) {
+        const double bound = elem.numberDouble();
+        uassert(4918016,
+                str::stream() << "Window bounds must be whole numbers of documents, but found: "
+                              << elem,
+                std::trunc(bound) == bound && std::abs(bound) < (1LL << 53));
+        return elem.safeNumberLong();
+    }
+    uasserted(4918017,
+              str::stream() << "Window bounds must be '" << kUnboundedBound << "', '"
+                            << kCurrentBound << "' or a number of documents, but found: " << elem);
+}
+
+void serializeWindowBound(const DocumentSourceInternalSetWindowFields::WindowBound& bound,
+                          BSONArrayBuilder* builder) {
+    if (bound) {
+        builder->append(*bound);
+    } else {
+        builder->append(kUnboundedBound);
+    }
+}
+
+}  // namespace
+
+std::list<boost::intrusive_ptr<DocumentSource>> DocumentSourceSetWindowFields::createFromBson(
+    BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    uassert(4918018,
+            str::stream() << kStageName << " must take an object but found: " << elem,
+            elem.type() == BSONType::Object);
+
+    BSONElement partitionBy;
+    BSONObj sortBy;
+    BSONElement output;
+    for (auto&& field : elem.embeddedObject()) {
+        const auto fieldName = field.fieldNameStringData();
+        if (fieldName == DocumentSourceInternalSetWindowFields::kPartitionByFieldName) {
+            partitionBy = field;
+        } else if (fieldName == DocumentSourceInternalSetWindowFields::kSortByFieldName) {
+            uassert(4918019,
+                    str::stream() << kStageName << " 'sortBy' must be an object but found: "
+                                  << field,
+                    field.type() == BSONType::Object);
+            sortBy = field.embeddedObject();
+        } else if (fieldName == DocumentSourceInternalSetWindowFields::kOutputFieldName) {
+            output = field;
+        } else {
+            uasserted(4918020,
+                      str::stream()
+                          << "Unrecognized option to " << kStageName << ": " << fieldName);
+        }
+    }
+
+    std::list<boost::intrusive_ptr<DocumentSource>> stages;
+    BSONObjBuilder internalSpec;
+    BSONObjBuilder sortSpec;
+
+    // Sort by partition first. A partition given as a field path can be sorted on directly.
+    boost::optional<std::string> partitionPath;
+    if (partitionBy) {
+        if (partitionBy.type() == BSONType::String &&
+            partitionBy.valueStringData().startsWith("$"_sd) &&
+            !partitionBy.valueStringData().startsWith("$$"_sd)) {
+            partitionPath = partitionBy.valueStringData().substr(1).toString();
+            internalSpec.append(partitionBy);
+        } else {
+            partitionPath = kPartitionKeyFieldName.toString();
+            stages.push_back(DocumentSourceAddFields::createFromBson(
+                BSON(DocumentSourceAddFields::kStageName << BSON(*partitionPath << partitionBy))
+                    .firstElement(),
+                expCtx));
+            internalSpec.append(DocumentSourceInternalSetWindowFields::kPartitionByFieldName,
+                                "$" + *partitionPath);
+        }
+        sortSpec.append(*partitionPath, 1);
+    }
+    for (auto&& field : sortBy) {
+        // Within a partition, the partition is the same for all documents.
+        if (!partitionPath || field.fieldNameStringData() != *partitionPath) {
+            sortSpec.append(field);
+        }
+    }
+    if (!sortBy.isEmpty()) {
+        internalSpec.append(DocumentSourceInternalSetWindowFields::kSortByFieldName, sortBy);
+    }
+    if (output) {
+        internalSpec.append(output);
+    }
+
+    auto sort = sortSpec.obj();
+    if (!sort.isEmpty()) {
+        stages.push_back(
+            DocumentSourceSort::createFromBson(BSON("$sort" << sort).firstElement(), expCtx));
+    }
+    stages.push_back(DocumentSourceInternalSetWindowFields::createFromBson(
+        BSON(DocumentSourceInternalSetWindowFields::kStageName << internalSpec.obj())
+            .firstElement(),
+        expCtx));
+    if (partitionPath && *partitionPath == kPartitionKeyFieldName) {
+        stages.push_back(DocumentSourceProject::createFromBson(
+            BSON("$project" << BSON(kPartitionKeyFieldName << 0)).firstElement(), expCtx));
+    }
+    return stages;
+}
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceInternalSetWindowFields::createFromBson(
+    BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    uassert(4918021,
+            str::stream() << kStageName << " must take an object but found: " << elem,
+            elem.type() == BSONType::Object);
+
+    boost::intrusive_ptr<Expression> partitionBy;
+    BSONObj sortBy;
+    BSONObj output;
+    for (auto&& field : elem.embeddedObject()) {
+        const auto fieldName = field.fieldNameStringData();
+        if (fieldName == kPartitionByFieldName) {
+            partitionBy =
+                Expression::parseOperand(expCtx.get(), field, expCtx->variablesParseState);
+        } else if (fieldName == kSortByFieldName && field.type() == BSONType::Object) {
+            sortBy = field.embeddedObject().getOwned();
+        } else if (fieldName == kOutputFieldName && field.type() == BSONType::Object) {
+            output = field.embeddedObject();
+        } else {
+            uasserted(4918022,
+                      str::stream() << "Invalid option to " << kStageName << ": " << field);
+        }
+    }
+    uassert(4918023,
+            str::stream() << kStageName << " requires a non-empty '" << kOutputFieldName
+                          << "' object",
+            !output.isEmpty());
+
+    std::vector<OutputField> outputFields;
+    for (auto&& field : output) {
+        uassert(4918024,
+                str::stream() << "The specification of the window function computing '"
+                              << field.fieldNameStringData() << "' must be an object",
+                field.type() == BSONType::Object);
+
+        OutputField outputField{FieldPath(field.fieldName())};
+        bool hasWindow = false;
+        for (auto&& arg : field.embeddedObject()) {
+            const auto argName = arg.fieldNameStringData();
+            if (argName == kWindowFieldName) {
+                uassert(4918025,
+                        str::stream() << "'" << kWindowFieldName << "' must be of the form {"
+                                      << kDocumentsFieldName << ": [<lower>, <upper>]}, but found: "
+                                      << arg,
+                        arg.type() == BSONType::Object && arg.embeddedObject().nFields() == 1 &&
+                            arg.embeddedObject()[kDocumentsFieldName].type() == BSONType::Array);
+                auto bounds = arg.embeddedObject()[kDocumentsFieldName].Array();
+                uassert(4918026,
+                        str::stream() << "'" << kDocumentsFieldName
+                                      << "' must be an array of a lower and an upper bound",
+                        bounds.size() == 2);
+                outputField.lower = parseWindowBound(bounds[0]);
+                outputField.upper = parseWindowBound(bounds[1]);
+                uassert(4918027,
+                        str::stream() << "The lower bound of a window must not be greater than its "
+                                         "upper bound: "
+                                      << arg,
+                        !outputField.lower || !outputField.upper ||
+                            *outputField.lower <= *outputField.upper);
+                hasWindow = true;
+                continue;
+            }
+
+            uassert(4918028,
+                    str::stream() << "The window function computing '"
+                                  << outputField.path.fullPath() << "' must be specified once",
+                    outputField.functionName.empty());
+            outputField.functionName = argName.toString();
+            if (isPositionalFunction(argName) || argName == "$count"_sd) {
+                uassert(4918029,
+                        str::stream() << argName << " takes no argument, pass {} instead",
+                        arg.type() == BSONType::Object && arg.embeddedObject().isEmpty());
+            } else {
+                outputField.input =
+                    Expression::parseOperand(expCtx.get(), arg, expCtx->variablesParseState);
+            }
+            if (!isPositionalFunction(argName)) {
+                outputField.state = WindowFunctionState::create(argName, expCtx.get());
+                uassert(4918030,
+                        str::stream() << "Unrecognized window function: " << argName,
+                        outputField.state);
+            }
+        }
+
+        uassert(4918031,
+                str::stream() << "No window function computes '" << outputField.path.fullPath()
+                              << "'",
+                !outputField.functionName.empty());
+        if (isPositionalFunction(outputField.functionName)) {
+            uassert(4918032,
+                    str::stream() << outputField.functionName << " does not take a window",
+                    !hasWindow);
+            uassert(4918033,
+                    str::stream() << outputField.functionName << " requires '" << kSortByFieldName
+                                  << "'",
+                    outputField.functionName == kDocumentNumberName || !sortBy.isEmpty());
+        }
+        if (outputField.state && !outputField.lower) {
+            outputField.state->setUnboundedBelow();
+        }
+        outputFields.push_back(std::move(outputField));
+    }
+
+    return new DocumentSourceInternalSetWindowFields(
+        expCtx, std::move(partitionBy), std::move(sortBy), std::move(outputFields));
+}
+
+DocumentSourceInternalSetWindowFields::DocumentSourceInternalSetWindowFields(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    boost::intrusive_ptr<Expression> partitionBy,
+    BSONObj sortBy,
+    std::vector<OutputField> outputFields)
+    : DocumentSource(kStageName, expCtx),
+      _partitionBy(std::move(partitionBy)),
+      _sortBy(std::move(sortBy)),
+      _outputFields(std::move(outputFields)),
+      _buffer(expCtx,
+              kStageName,
+              static_cast<size_t>(internalDocumentSourceSetWindowFieldsMaxMemoryBytes.load())),
+      _partitionEnded(true) {
+    for (auto&& field : _sortBy) {
+        _sortByPaths.emplace_back(field.fieldName());
+    }
+}
+
+Value DocumentSourceInternalSetWindowFields::_getPartition(const Document& doc) const {
+    if (!_partitionBy) {
+        return Value();
+    }
+
+    auto partition = _partitionBy->evaluate(doc, &pExpCtx->variables);
+    uassert(4918034,
+            str::stream() << "The partition of a document must not be an array, but found: "
+                          << partition.toString(),
+            !partition.isArray());
+
+    // $sort does not tell null and missing apart, so neither do partitions.
+    return partition.missing() ? Value(BSONNULL) : partition;
+}
+
+std::vector<Value> DocumentSourceInternalSetWindowFields::_getSortKey(const Document& doc) const {
+    std::vector<Value> sortKey;
+    sortKey.reserve(_sortByPaths.size());
+    for (auto&& path : _sortByPaths) {
+        sortKey.push_back(doc.getNestedField(path));
+    }
+    return sortKey;
+}
+
+void DocumentSourceInternalSetWindowFields::_startPartition() {
+    invariant(_nextPartitionFirstDoc);
+    _buffer.clear();
+    _position = 0;
+    _partitionEnded = false;
+
+    _partition = _getPartition(*_nextPartitionFirstDoc);
+    _buffer.push_back(*_nextPartitionFirstDoc);
+    _nextPartitionFirstDoc.reset();
+
+    for (auto&& field : _outputFields) {
+        if (field.state) {
+            field.state->reset();
+        }
+        field.nextToAdd = 0;
+        field.nextToRemove = 0;
+    }
+    _lastSortKey.clear();
+    _rank = 0;
+    _denseRank = 0;
+}
+
+boost::optional<DocumentSource::GetNextResult> DocumentSourceInternalSetWindowFields::_readUpTo(
+    size_t position) {
+    while (!_partitionEnded && _buffer.end() <= position) {
+        auto next = pSource->getNext();
+        if (next.isPaused()) {
+            return next;
+        }
+        if (next.isEOF()) {
+            _partitionEnded = true;
+            _sourceExhausted = true;
+            break;
+        }
+
+        auto doc = next.releaseDocument();
+        if (pExpCtx->getValueComparator().evaluate(_getPartition(doc) == _partition)) {
+            _buffer.push_back(doc);
+        } else {
+            _nextPartitionFirstDoc = std::move(doc);
+            _partitionEnded = true;
+        }
+    }
+    return boost::none;
+}
+
+Value DocumentSourceInternalSetWindowFields::_computeOutput(OutputField& field, size_t position) {
+    if (!field.state) {
+        if (field.functionName == kDocumentNumberName) {
+            return Value::createIntOrLong(position + 1);
+        }
+        return Value::createIntOrLong(field.functionName == kRankName ? _rank : _denseRank);
+    }
+
+    // The window is [windowBegin, windowEnd), clamped to the documents of the partition.
+    const long long numDocs = _buffer.end();
+    const long long pos = position;
+    const long long windowEnd = field.upper ? std::clamp(pos + *field.upper + 1, 0LL, numDocs)
+                                            : numDocs;
+    const long long windowBegin = field.lower ? std::max(pos + *field.lower, 0LL) : 0LL;
+
+    auto evaluate = [&](size_t i) {
+        return field.input ? field.input->evaluate(_buffer.at(i), &pExpCtx->variables) : Value();
+    };
+    for (; static_cast<long long>(field.nextToAdd) < windowEnd; ++field.nextToAdd) {
+        field.state->add(evaluate(field.nextToAdd));
+    }
+    for (; static_cast<long long>(field.nextToRemove) < windowBegin &&
+         field.nextToRemove < field.nextToAdd;
+         ++field.nextToRemove) {
+        field.state->remove(evaluate(field.nextToRemove));
+    }
+    return field.state->getValue();
+}
+
+DocumentSource::GetNextResult DocumentSourceInternalSetWindowFields::doGetNext() {
+    // The buffered partition and the window states are retained across calls and accounted for
+    // against the memory limit, so they are allocated from the heap rather than an arena.
+    BumpArena::Scope heapScope(nullptr);
+
+    if (_partitionEnded && _position == _buffer.end()) {
+        if (!_nextPartitionFirstDoc) {
+            if (_sourceExhausted) {
+                return GetNextResult::makeEOF();
+            }
+            auto next = pSource->getNext();
+            if (next.isEOF()) {
+                _sourceExhausted = true;
+            }
+            if (!next.isAdvanced()) {
+                return next;
+            }
+            _nextPartitionFirstDoc = next.releaseDocument();
+        }
+        _startPartition();
+    }
+
+    // Read the documents up to the furthest upper bound of the windows of the current document.
+    size_t readUpTo = _position;
+    for (auto&& field : _outputFields) {
+        if (!field.state) {
+            continue;
+        }
+        readUpTo = field.upper
+            ? std::max(readUpTo, _position + static_cast<size_t>(std::max(*field.upper, 0LL)))
+            : std::numeric_limits<size_t>::max();
+    }
+    if (auto paused = _readUpTo(readUpTo)) {
+        return std::move(*paused);
+    }
+
+    MutableDocument output(_buffer.at(_position));
+    if (!_sortByPaths.empty()) {
+        auto sortKey = _getSortKey(output.peek());
+        const bool isTie = !_lastSortKey.empty() &&
+            std::equal(sortKey.begin(),
+                       sortKey.end(),
+                       _lastSortKey.begin(),
+                       [&](const Value& lhs, const Value& rhs) {
+                           return pExpCtx->getValueComparator().evaluate(lhs == rhs);
+                       });
+        if (!isTie) {
+            _rank = _position + 1;
+            ++_denseRank;
+        }
+        _lastSortKey = std::move(sortKey);
+    }
+
+    size_t stateMemUsageBytes = 0;
+    size_t releaseBefore = _position + 1;
+    for (auto&& field : _outputFields) {
+        output.setNestedField(field.path, _computeOutput(field, _position));
+        if (field.state) {
+            stateMemUsageBytes += field.state->getApproximateSize();
+            releaseBefore =
+                std::min(releaseBefore, field.lower ? field.nextToRemove : field.nextToAdd);
+        }
+    }
+
+    // Only the buffered documents can spill to disk, so the window states must fit in memory
+    // whether or not the buffer spilled.
+    const auto maxMemoryBytes =
+        static_cast<size_t>(internalDocumentSourceSetWindowFieldsMaxMemoryBytes.load());
+    uassert(ErrorCodes::ExceededMemoryLimit,
+            str::stream() << "Exceeded memory limit for " << kStageName << " of "
+                          << maxMemoryBytes << " bytes",
+            stateMemUsageBytes <= maxMemoryBytes &&
+                (_buffer.getMemUsageBytes() + stateMemUsageBytes <= maxMemoryBytes ||
+                 _buffer.usedDisk()));
+
+    ++_position;
+    _buffer.releaseBefore(releaseBefore);
+    return output.freeze();
+}
+
+void DocumentSourceInternalSetWindowFields::doDispose() {
+    _buffer.clear();
+    _nextPartitionFirstDoc.reset();
+    for (auto&& field : _outputFields) {
+        if (field.state) {
+            field.state->reset();
+        }
+    }
+}
+
+Value DocumentSourceInternalSetWindowFields::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    MutableDocument spec;
+    if (_partitionBy) {
+        spec[kPartitionByFieldName] = _partitionBy->serialize(static_cast<bool>(explain));
+    }
+    if (!_sortBy.isEmpty()) {
+        spec[kSortByFieldName] = Value(_sortBy);
+    }
+
+    MutableDocument output;
+    for (auto&& field : _outputFields) {
+        MutableDocument function;
+        function[field.functionName] = field.input
+            ? field.input->serialize(static_cast<bool>(explain))
+            : Value(Document());
+        if (field.state) {
+            BSONArrayBuilder bounds;
+            serializeWindowBound(field.lower, &bounds);
+            serializeWindowBound(field.upper, &bounds);
+            function[kWindowFieldName] = Value(DOC(kDocumentsFieldName << bounds.arr()));
+        }
+        output.addField(field.path.fullPath(), function.freezeToValue());
+    }
+    spec[kOutputFieldName] = output.freezeToValue();
+
+    return Value(DOC(getSourceName() << spec.freeze()));
+}
+
+}  // namespace mongo
@@ -0,0 +1,202 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/spillable_document_buffer.h"
+#include "mongo/db/pipeline/window_function.h"
+
+namespace mongo {
+
+/**
+ * The $setWindowFields stage is an alias for a $sort stage which orders the documents by partition
+ * and by its 'sortBy' specification, followed by a $_internalSetWindowFields stage:
+ *
+ *    {$setWindowFields: {
+ *        partitionBy: <expression>,
+ *        sortBy: <sort specification>,
+ *        output: {
+ *            <path>: {<window function>: <expression>, window: {documents: [<lower>, <upper>]}},
+ *            ...
+ *        }
+ *    }}
+ *
+ * If 'partitionBy' is not a field path, the partition of each document is computed into a
+ * temporary field before the $sort, and the field is removed afterwards.
+ */
+class DocumentSourceSetWindowFields final {
+public:
+    static constexpr StringData kStageName = "$setWindowFields"_sd;
+
+    static std::list<boost::intrusive_ptr<DocumentSource>> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+private:
+    DocumentSourceSetWindowFields() = default;
+};
+
+/**
+ * Adds to each document the results of window functions over the documents around it within its
+ * partition. The input must be ordered by partition and, within each partition, by 'sortBy'.
+ *
+ * A window is a range of positions relative to the current document, where a bound is either
+ * "unbounded", "current" or a number of documents before (negative) or after (positive) it. The
+ * window functions are evaluated incrementally as the window slides forward, and the stage only
+ * holds the documents from the lower bound of the windows to their upper bound. Holding documents
+ * beyond 'internalDocumentSourceSetWindowFieldsMaxMemoryBytes' spills them to disk, if allowed.
+ */
+class DocumentSourceInternalSetWindowFields final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalSetWindowFields"_sd;
+    static constexpr StringData kPartitionByFieldName = "partitionBy"_sd;
+    static constexpr StringData kSortByFieldName = "sortBy"_sd;
+    static constexpr StringData kOutputFieldName = "output"_sd;
+    static constexpr StringData kWindowFieldName = "window"_sd;
+    static constexpr StringData kDocumentsFieldName = "documents"_sd;
+
+    /**
+     * A bound of a window, as an offset from the current document. boost::none is unbounded.
+     */
+    using WindowBound = boost::optional<long long>;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        return {StreamType::kStreaming,
+                PositionRequirement::kNone,
+                HostTypeRequirement::kNone,
+                DiskUseRequirement::kWritesTmpData,
+                FacetRequirement::kAllowed,
+                TransactionRequirement::kAllowed,
+                LookupRequirement::kAllowed,
+                UnionRequirement::kAllowed};
+    }
+
+    /**
+     * The documents of a partition may come from several shards, so the stage runs on the merger.
+     */
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return DistributedPlanLogic{nullptr, this, boost::none};
+    }
+
+    bool usedDisk() final {
+        return _buffer.usedDisk();
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+protected:
+    void doDispose() final;
+
+private:
+    /**
+     * A window function whose result is set at 'path' in each document.
+     */
+    struct OutputField {
+        FieldPath path;
+        std::string functionName;
+
+        // The input of the window function. Null for the functions which take no input.
+        boost::intrusive_ptr<Expression> input;
+        WindowBound lower;
+        WindowBound upper;
+
+        // Null for the functions which depend on the position of the document rather than on a
+        // window, such as $rank.
+        std::unique_ptr<WindowFunctionState> state;
+
+        // The positions of the next document to add to and to remove from the window.
+        size_t nextToAdd = 0;
+        size_t nextToRemove = 0;
+    };
+
+    DocumentSourceInternalSetWindowFields(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                          boost::intrusive_ptr<Expression> partitionBy,
+                                          BSONObj sortBy,
+                                          std::vector<OutputField> outputFields);
+
+    GetNextResult doGetNext() final;
+
+    /**
+     * Reads documents of the current partition until the document at 'position' is held, or the
+     * partition ends. Returns the result of the source if it is paused.
+     */
+    boost::optional<GetNextResult> _readUpTo(size_t position);
+
+    /**
+     * Returns the value of the partition expression for 'doc'.
+     */
+    Value _getPartition(const Document& doc) const;
+
+    /**
+     * Returns the values of the 'sortBy' fields of 'doc', which rank functions compare.
+     */
+    std::vector<Value> _getSortKey(const Document& doc) const;
+
+    void _startPartition();
+    Value _computeOutput(OutputField& field, size_t position);
+
+    const boost::intrusive_ptr<Expression> _partitionBy;
+    const BSONObj _sortBy;
+    std::vector<FieldPath> _sortByPaths;
+    std::vector<OutputField> _outputFields;
+
+    // The documents of the current partition which are still needed.
+    SpillableDocumentBuffer _buffer;
+
+    Value _partition;
+
+    // The position of the next document to return.
+    size_t _position = 0;
+
+    // Set once the last document of the current partition was read. The first document of the next
+    // partition, if any, is then held in '_nextPartitionFirstDoc'.
+    bool _partitionEnded = false;
+    bool _sourceExhausted = false;
+    boost::optional<Document> _nextPartitionFirstDoc;
+
+    // The sort key of the previous document and its rank, for the rank functions.
+    std::vector<Value> _lastSortKey;
+    long long _rank = 0;
+    long long _denseRank = 0;
+};
+
+}  // namespace mongo
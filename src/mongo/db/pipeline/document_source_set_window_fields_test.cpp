@@ -0,0 +1,338 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <deque>
+#include <vector>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_set_window_fields.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+class DocumentSourceSetWindowFieldsTest : public AggregationContextFixture {
+protected:
+    /**
+     * Runs the $setWindowFields stage 'spec' over 'inputs' and returns its results.
+     */
+    std::vector<Document> runStage(const char* spec,
+                                   std::deque<DocumentSource::GetNextResult> inputs) {
+        auto stages = DocumentSourceSetWindowFields::createFromBson(
+            fromjson(spec).firstElement(), getExpCtx());
+        boost::intrusive_ptr<DocumentSource> last =
+            DocumentSourceMock::createForTest(std::move(inputs), getExpCtx());
+        for (auto&& stage : stages) {
+            stage->setSource(last.get());
+            last = stage;
+        }
+        _stages = std::move(stages);
+        _stages.push_front(last);
+
+        std::vector<Document> results;
+        for (auto next = last->getNext(); !next.isEOF(); next = last->getNext()) {
+            if (next.isAdvanced()) {
+                results.push_back(next.releaseDocument());
+            }
+        }
+        return results;
+    }
+
+    void assertResults(const std::vector<Document>& results,
+                       const std::vector<const char*>& jsons) {
+        ASSERT_EQ(results.size(), jsons.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            ASSERT_DOCUMENT_EQ(results[i], Document(fromjson(jsons[i])));
+        }
+    }
+
+    boost::intrusive_ptr<DocumentSource> parseInternal(const char* spec) {
+        return DocumentSourceInternalSetWindowFields::createFromBson(
+            fromjson(spec).firstElement(), getExpCtx());
+    }
+
+private:
+    // Keeps the stages alive while their results are read.
+    std::list<boost::intrusive_ptr<DocumentSource>> _stages;
+};
+
+TEST_F(DocumentSourceSetWindowFieldsTest, ComputesRunningSum) {
+    auto results = runStage(
+        "{$setWindowFields: {sortBy: {t: 1}, output: {total: {$sum: '$x', "
+        "window: {documents: ['unbounded', 'current']}}}}}",
+        {Document{{"t", 3}, {"x", 3}}, Document{{"t", 1}, {"x", 1}}, Document{{"t", 2}, {"x", 2}}});
+    assertResults(results,
+                  {"{t: 1, x: 1, total: 1}", "{t: 2, x: 2, total: 3}", "{t: 3, x: 3, total: 6}"});
+}
+
+TEST_F(DocumentSourceSetWindowFieldsTest, ComputesMovingAverageMinAndMax) {
+    auto results = runStage(
+        "{$setWindowFields: {sortBy: {t: 1}, output: {"
+        "avg: {$avg: '$x', window: {documents: [-1, 1]}},"
+        "min: {$min: '$x', window: {documents: [-1, 1]}},"
+        "max: {$max: '$x', window: {documents: [-1, 1]}},"
+        "count: {$count: {}, window: {documents: [-1, 1]}}}}}",
+        {Document{{"t", 1}, {"x", 4}},
+         Document{{"t", 2}, {"x", 2}},
+         Document{{"t", 3}, {"x", 6}},
+         Document{{"t", 4}, {"x", 0}}});
+    assertResults(results,
+                  {"{t: 1, x: 4, avg: 3.0, min: 2, max: 4, count: 2}",
+                   "{t: 2, x: 2, avg: 4.0, min: 2, max: 6, count: 3}",
+                   "{t: 3, x: 6, avg: 2.6666666666666665, min: 0, max: 6, count: 3}",
+                   "{t: 4, x: 0, avg: 3.0, min: 0, max: 6, count: 2}"});
+}
+
+TEST_F(DocumentSourceSetWindowFieldsTest, WindowMayExcludeCurrentDocument) {
+    auto results = runStage(
+        "{$setWindowFields: {sortBy: {t: 1}, output: {"
+        "previous: {$sum: '$x', window: {documents: [-1, -1]}},"
+        "rest: {$sum: '$x', window: {documents: [1, 'unbounded']}}}}}",
+        {Document{{"t", 1}, {"x", 1}},
+         Document{{"t", 2}, {"x", 10}},
+         Document{{"t", 3}, {"x", 100}}});
+    assertResults(results,
+                  {"{t: 1, x: 1, previous: 0, rest: 110}",
+                   "{t: 2, x: 10, previous: 1, rest: 100}",
+                   "{t: 3, x: 100, previous: 10, rest: 0}"});
+}
+
+TEST_F(DocumentSourceSetWindowFieldsTest, WindowsDoNotCrossPartitions) {
+    auto results = runStage(
+        "{$setWindowFields: {partitionBy: '$p', sortBy: {t: 1}, output: {"
+        "total: {$sum: '$x'}, n: {$documentNumber: {}}}}}",
+        {Document{{"p", 2}, {"t", 1}, {"x", 10}},
+         Document{{"p", 1}, {"t", 2}, {"x", 2}},
+         Document{{"t", 3}, {"x", 100}},
+         Document{{"p", 1}, {"t", 1}, {"x", 1}}});
+    assertResults(results,
+                  {"{t: 3, x: 100, total: 100, n: 1}",
+                   "{p: 1, t: 1, x: 1, total: 3, n: 1}",
+                   "{p: 1, t: 2, x: 2, total: 3, n: 2}",
+                   "{p: 2, t: 1, x: 10, total: 10, n: 1}"});
+}
+
+TEST_F(DocumentSourceSetWindowFieldsTest, PartitionsByExpression) {
+    auto results = runStage(
+        "{$setWindowFields: {partitionBy: {$mod: ['$x', 2]}, sortBy: {x: 1}, output: {"
+        "total: {$sum: '$x', window: {documents: ['unbounded', 'current']}}}}}",
+        {Document{{"x", 1}}, Document{{"x", 2}}, Document{{"x", 3}}, Document{{"x", 4}}});
+    assertResults(results,
+                  {"{x: 2, total: 2}", "{x: 4, total: 6}", "{x: 1, total: 1}", "{x: 3, total: 4}"});
+}
+
+TEST_F(DocumentSourceSetWindowFieldsTest, ComputesRanks) {
+    auto results = runStage(
+        "{$setWindowFields: {sortBy: {score: -1}, output: {"
+        "rank: {$rank: {}}, denseRank: {$denseRank: {}}, n: {$documentNumber: {}}}}}",
+        {Document{{"score", 5}}, Document{{"score", 9}}, Document{{"score", 5}},
+         Document{{"score", 1}}});
+    assertResults(results,
+                  {"{score: 9, rank: 1, denseRank: 1, n: 1}",
+                   "{score: 5, rank: 2, denseRank: 2, n: 2}",
+                   "{score: 5, rank: 2, denseRank: 2, n: 3}",
+                   "{score: 1, rank: 4, denseRank: 3, n: 4}"});
+}
+
+TEST_F(DocumentSourceSetWindowFieldsTest, PropagatesPauses) {
+    auto stage = parseInternal(
+        "{$_internalSetWindowFields: {output: {total: {$sum: '$x', "
+        "window: {documents: ['current', 1]}}}}}");
+    auto source = DocumentSourceMock::createForTest(
+        {Document{{"x", 1}},
+         DocumentSource::GetNextResult::makePauseExecution(),
+         Document{{"x", 2}},
+         DocumentSource::GetNextResult::makePauseExecution()},
+        getExpCtx());
+    stage->setSource(source.get());
+
+    ASSERT_TRUE(stage->getNext().isPaused());
+    auto next = stage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"x", 1}, {"total", 3}}));
+    ASSERT_TRUE(stage->getNext().isPaused());
+    next = stage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"x", 2}, {"total", 2}}));
+    ASSERT_TRUE(stage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceSetWindowFieldsTest, SpillsWindowToDiskWhenAllowed) {
+    const auto maxMemoryBytes = internalDocumentSourceSetWindowFieldsMaxMemoryBytes.load();
+    internalDocumentSourceSetWindowFieldsMaxMemoryBytes.store(1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceSetWindowFieldsMaxMemoryBytes.store(maxMemoryBytes); });
+
+    unittest::TempDir tempDir("DocumentSourceSetWindowFieldsTest");
+    getExpCtx()->tempDir = tempDir.path();
+    getExpCtx()->allowDiskUse = true;
+
+    const std::string padding(100, 'a');
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 100; ++i) {
+        inputs.push_back(Document{{"x", i}, {"padding", padding}});
+    }
+    auto stage = parseInternal(
+        "{$_internalSetWindowFields: {output: {total: {$sum: '$x'}, "
+        "max: {$max: '$x', window: {documents: [-2, 'current']}}}}}");
+    auto source = DocumentSourceMock::createForTest(std::move(inputs), getExpCtx());
+    stage->setSource(source.get());
+
+    for (int i = 0; i < 100; ++i) {
+        auto next = stage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        auto doc = next.releaseDocument();
+        ASSERT_VALUE_EQ(doc["x"], Value(i));
+        ASSERT_VALUE_EQ(doc["total"], Value(4950));
+        ASSERT_VALUE_EQ(doc["max"], Value(i));
+    }
+    ASSERT_TRUE(stage->getNext().isEOF());
+    ASSERT_TRUE(stage->usedDisk());
+}
+
+TEST_F(DocumentSourceSetWindowFieldsTest, WindowStatesMustFitInMemoryAfterSpilling) {
+    const auto maxMemoryBytes = internalDocumentSourceSetWindowFieldsMaxMemoryBytes.load();
+    internalDocumentSourceSetWindowFieldsMaxMemoryBytes.store(1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceSetWindowFieldsMaxMemoryBytes.store(maxMemoryBytes); });
+
+    unittest::TempDir tempDir("DocumentSourceSetWindowFieldsTest");
+    getExpCtx()->tempDir = tempDir.path();
+    getExpCtx()->allowDiskUse = true;
+
+    // The $sum reads and spills the whole partition. The values decrease, so $max keeps every
+    // value of its window, which does not fit in memory.
+    const std::string padding(100, 'a');
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 300; ++i) {
+        inputs.push_back(Document{{"x", 1000 - i}, {"padding", padding}});
+    }
+    auto stage = parseInternal(
+        "{$_internalSetWindowFields: {output: {total: {$sum: '$x'}, "
+        "max: {$max: '$x', window: {documents: [-100, 'current']}}}}}");
+    auto source = DocumentSourceMock::createForTest(std::move(inputs), getExpCtx());
+    stage->setSource(source.get());
+
+    ASSERT_THROWS_CODE(
+        [&] {
+            while (stage->getNext().isAdvanced()) {
+            }
+        }(),
+        AssertionException,
+        ErrorCodes::ExceededMemoryLimit);
+}
+
+TEST_F(DocumentSourceSetWindowFieldsTest, FailsToSpillWhenDiskUseIsNotAllowed) {
+    const auto maxMemoryBytes = internalDocumentSourceSetWindowFieldsMaxMemoryBytes.load();
+    internalDocumentSourceSetWindowFieldsMaxMemoryBytes.store(1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceSetWindowFieldsMaxMemoryBytes.store(maxMemoryBytes); });
+    getExpCtx()->allowDiskUse = false;
+
+    const std::string padding(100, 'a');
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 100; ++i) {
+        inputs.push_back(Document{{"x", i}, {"padding", padding}});
+    }
+    auto stage = parseInternal("{$_internalSetWindowFields: {output: {total: {$sum: '$x'}}}}");
+    auto source = DocumentSourceMock::createForTest(std::move(inputs), getExpCtx());
+    stage->setSource(source.get());
+
+    ASSERT_THROWS_CODE(
+        stage->getNext(), AssertionException, ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
+}
+
+TEST_F(DocumentSourceSetWindowFieldsTest, SerializesWithDefaultWindow) {
+    auto stage = parseInternal(
+        "{$_internalSetWindowFields: {partitionBy: '$p', sortBy: {t: 1}, output: {"
+        "'a.b': {$sum: '$x'}, n: {$documentNumber: {}}}}}");
+    std::vector<Value> serialized;
+    stage->serializeToArray(serialized);
+    ASSERT_EQ(serialized.size(), 1UL);
+    ASSERT_VALUE_EQ(
+        serialized[0],
+        Value(fromjson("{$_internalSetWindowFields: {partitionBy: '$p', sortBy: {t: 1}, "
+                       "output: {'a.b': {$sum: '$x', window: {documents: "
+                       "['unbounded', 'unbounded']}}, n: {$documentNumber: {}}}}}")));
+}
+
+TEST_F(DocumentSourceSetWindowFieldsTest, RejectsInvalidSpecifications) {
+    ASSERT_THROWS_CODE(parseInternal("{$_internalSetWindowFields: {output: {}}}"),
+                       AssertionException,
+                       4918023);
+    ASSERT_THROWS_CODE(
+        parseInternal("{$_internalSetWindowFields: {output: {a: {$sum: '$x', window: "
+                      "{documents: [1, -1]}}}}}"),
+        AssertionException,
+        4918027);
+    ASSERT_THROWS_CODE(
+        parseInternal("{$_internalSetWindowFields: {output: {a: {$sum: '$x', window: "
+                      "{documents: [0.5, 1]}}}}}"),
+        AssertionException,
+        4918016);
+    ASSERT_THROWS_CODE(
+        parseInternal("{$_internalSetWindowFields: {output: {a: {$sum: '$x', window: "
+                      "{documents: ['previous', 1]}}}}}"),
+        AssertionException,
+        4918017);
+    ASSERT_THROWS_CODE(
+        parseInternal("{$_internalSetWindowFields: {output: {a: {$push: '$x'}}}}"),
+        AssertionException,
+        4918030);
+    ASSERT_THROWS_CODE(parseInternal("{$_internalSetWindowFields: {output: {a: {$rank: {}}}}}"),
+                       AssertionException,
+                       4918033);
+    ASSERT_THROWS_CODE(
+        parseInternal("{$_internalSetWindowFields: {sortBy: {t: 1}, output: {a: {$rank: {}, "
+                      "window: {documents: [-1, 1]}}}}}"),
+        AssertionException,
+        4918032);
+    ASSERT_THROWS_CODE(parseInternal("{$_internalSetWindowFields: {output: {a: {$count: 1}}}}"),
+                       AssertionException,
+                       4918029);
+}
+
+TEST_F(DocumentSourceSetWindowFieldsTest, RejectsArrayPartitions) {
+    ASSERT_THROWS_CODE(
+        runStage("{$setWindowFields: {partitionBy: '$p', output: {total: {$sum: '$x'}}}}",
+                 {Document{{"p", BSON_ARRAY(1 << 2)}, {"x", 1}}}),
+        AssertionException,
+        4918034);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,288 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_shared_oplog_cursor.h"
+
+#include <algorithm>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/curop.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/storage/oplog_hack.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+// Bounds the entries examined per batch, and those read from the oplog under one lock.
+constexpr size_t kMaxBatchEntries = 1000;
+
+Counter64 entriesFromCache;
+Counter64 entriesReadDirectly;
+
+ServerStatusMetricField<Counter64> displayEntriesFromCache(
+    "changeStreams.sharedOplogReader.entriesFromCache", &entriesFromCache);
+ServerStatusMetricField<Counter64> displayEntriesReadDirectly(
+    "changeStreams.sharedOplogReader.entriesReadDirectly", &entriesReadDirectly);
+
+/**
+ * Returns the timestamp right before the earliest entry 'filter' can match, going by the lower
+ * bounds on "ts" at the top level of 'filter'.
+ */
+Timestamp getTsBeforeStart(const MatchExpression* filter) {
+    Timestamp before;
+    auto visit = [&](const MatchExpression* me) {
+        if (!ComparisonMatchExpression::isComparisonMatchExpression(me) ||
+            me->path() != repl::OpTime::kTimestampFieldName) {
+            return;
+        }
+        auto bound = static_cast<const ComparisonMatchExpression*>(me)->getData();
+        if (bound.type() != BSONType::bsonTimestamp) {
+            return;
+        }
+
+        auto ts = bound.timestamp();
+        if (me->matchType() == MatchExpression::GTE && !ts.isNull()) {
+            before = std::max(before, Timestamp(ts.asULL() - 1));
+        } else if (me->matchType() == MatchExpression::GT) {
+            before = std::max(before, ts);
+        }
+    };
+
+    if (filter->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < filter->numChildren(); ++i) {
+            visit(filter->getChild(i));
+        }
+    } else {
+        visit(filter);
+    }
+    return before;
+}
+
+}  // namespace
+
+boost::intrusive_ptr<DocumentSourceSharedOplogCursor> DocumentSourceSharedOplogCursor::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, const BSONObj& filter) {
+    // The oplog is compared against using the simple collation, regardless of the collation of the
+    // change stream.
+    auto simpleExpCtx =
+        expCtx->copyWith(expCtx->ns, expCtx->uuid, std::unique_ptr<CollatorInterface>{});
+    auto matcher = MatchExpression::optimize(
+        uassertStatusOK(MatchExpressionParser::parse(filter, simpleExpCtx)));
+    const auto tsBeforeStart = getTsBeforeStart(matcher.get());
+
+    return new DocumentSourceSharedOplogCursor(
+        expCtx, filter.getOwned(), std::move(matcher), tsBeforeStart);
+}
+
+DocumentSourceSharedOplogCursor::DocumentSourceSharedOplogCursor(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    BSONObj filter,
+    std::unique_ptr<MatchExpression> matcher,
+    Timestamp tsBeforeStart)
+    : DocumentSource(kStageName, expCtx),
+      _filter(std::move(filter)),
+      _matcher(std::move(matcher)),
+      _reader(&SharedOplogReader::get(expCtx->opCtx->getServiceContext())),
+      _lastSeenTs(tsBeforeStart) {
+    _reader->registerStream();
+}
+
+DocumentSourceSharedOplogCursor::~DocumentSourceSharedOplogCursor() {
+    _unregister();
+}
+
+const char* DocumentSourceSharedOplogCursor::getSourceName() const {
+    return kStageName.rawData();
+}
+
+Value DocumentSourceSharedOplogCursor::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    // This stage is never parsed, so it is only serialized for explain.
+    if (!explain) {
+        return Value();
+    }
+    return Value(DOC(getSourceName() << DOC("filter" << _filter)));
+}
+
+DocumentSource::GetNextResult DocumentSourceSharedOplogCursor::doGetNext() {
+    if (_currentBatch.empty()) {
+        _loadBatch();
+    }
+
+    if (_currentBatch.empty()) {
+        if (_examinedAny) {
+            _latestOplogTimestamp = _lastSeenTs;
+        }
+        return GetNextResult::makeEOF();
+    }
+
+    _latestOplogTimestamp =
+        _currentBatch.front().getField(repl::OpTime::kTimestampFieldName).getTimestamp();
+    auto doc = std::move(_currentBatch.front());
+    _currentBatch.pop_front();
+    return doc;
+}
+
+void DocumentSourceSharedOplogCursor::doDispose() {
+    _currentBatch.clear();
+    _unregister();
+}
+
+void DocumentSourceSharedOplogCursor::_unregister() {
+    if (_registered) {
+        _reader->unregisterStream();
+        _registered = false;
+    }
+}
+
+void DocumentSourceSharedOplogCursor::_loadBatch() {
+    auto opCtx = pExpCtx->opCtx;
+    while (_currentBatch.empty()) {
+        opCtx->checkForInterrupt();
+
+        std::vector<SharedOplogReader::Entry> entries;
+        const bool fromCache = _reader->getEntriesAfter(_lastSeenTs, kMaxBatchEntries, &entries);
+        if (fromCache) {
+            entriesFromCache.increment(entries.size());
+            if (!entries.empty()) {
+                _ensureSnapshotIncludes(entries.back().ts);
+            }
+        } else {
+            _readFromOplog(&entries);
+            entriesReadDirectly.increment(entries.size());
+        }
+
+        for (auto&& entry : entries) {
+            _lastSeenTs = entry.ts;
+            _examinedAny = true;
+            if (_matcher->matchesBSON(entry.obj)) {
+                _currentBatch.emplace_back(entry.obj);
+            }
+        }
+
+        if (!entries.empty()) {
+            continue;
+        }
+
+        if (!_shouldWaitForEntries()) {
+            return;
+        }
+
+        if (!fromCache) {
+            // This operation's snapshot holds no more entries. The next read of the oplog must use
+            // a newer one.
+            opCtx->recoveryUnit()->abandonSnapshot();
+        }
+
+        auto curOp = CurOp::get(opCtx);
+        curOp->pauseTimer();
+        ON_BLOCK_EXIT([curOp] { curOp->resumeTimer(); });
+        _reader->waitForEntriesAfter(
+            opCtx, _lastSeenTs, awaitDataState(opCtx).waitForInsertsDeadline);
+    }
+}
+
+void DocumentSourceSharedOplogCursor::_readFromOplog(
+    std::vector<SharedOplogReader::Entry>* out) {
+    auto opCtx = pExpCtx->opCtx;
+    AutoGetCollectionForRead autoColl(opCtx, NamespaceString::kRsOplogNamespace);
+    uassertStatusOK(repl::ReplicationCoordinator::get(opCtx)->checkCanServeReadsFor(
+        opCtx, NamespaceString::kRsOplogNamespace, true));
+    auto oplog = autoColl.getCollection();
+    if (!oplog) {
+        return;
+    }
+
+    auto cursor = oplog->getCursor(opCtx, true);
+    boost::optional<Record> record;
+    auto goal = oploghack::keyForOptime(_lastSeenTs);
+    if (_examinedAny) {
+        // Like a tailable collection scan, fail rather than silently skip the entries which were
+        // removed from the oplog before this change stream examined them.
+        if (goal.isOK()) {
+            record = cursor->seekExact(goal.getValue());
+        }
+        uassert(ErrorCodes::CappedPositionLost,
+                str::stream() << "Change stream fell off the oplog. Last examined timestamp: "
+                              << _lastSeenTs.toString(),
+                record);
+    } else if (goal.isOK()) {
+        auto startLoc = oplog->getRecordStore()->oplogStartHack(opCtx, goal.getValue());
+        if (startLoc && !startLoc->isNull()) {
+            record = cursor->seekExact(*startLoc);
+        }
+    }
+
+    if (!record) {
+        record = cursor->next();
+    }
+
+    for (; record && out->size() < kMaxBatchEntries; record = cursor->next()) {
+        auto entry = SharedOplogReader::makeEntry(record->data.releaseToBson());
+        if (entry.ts > _lastSeenTs) {
+            entry.obj = entry.obj.getOwned();
+            out->push_back(std::move(entry));
+        }
+    }
+}
+
+void DocumentSourceSharedOplogCursor::_ensureSnapshotIncludes(Timestamp ts) {
+    auto recoveryUnit = pExpCtx->opCtx->recoveryUnit();
+    if (recoveryUnit->getTimestampReadSource() != RecoveryUnit::ReadSource::kMajorityCommitted) {
+        return;
+    }
+
+    // The majority commit point only moves forward, so the next snapshot includes every entry
+    // the reader has read.
+    auto readTs = recoveryUnit->getPointInTimeReadTimestamp();
+    if (readTs && *readTs < ts) {
+        recoveryUnit->abandonSnapshot();
+    }
+}
+
+bool DocumentSourceSharedOplogCursor::_shouldWaitForEntries() const {
+    auto opCtx = pExpCtx->opCtx;
+    return awaitDataState(opCtx).shouldWaitForInserts &&
+        opCtx->checkForInterruptNoAssert().isOK() &&
+        awaitDataState(opCtx).waitForInsertsDeadline >
+        opCtx->getServiceContext()->getPreciseClockSource()->now();
+}
+
+}  // namespace mongo
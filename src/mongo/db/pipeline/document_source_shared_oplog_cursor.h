@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/shared_oplog_reader.h"
+
+namespace mongo {
+
+/**
+ * Feeds a change stream with the oplog entries which match its filter, like a $cursor stage over
+ * the oplog would, but takes the entries from the SharedOplogReader's cache whenever it holds them
+ * rather than scanning the oplog. The filter is evaluated against the cached entries themselves,
+ * so examining an entry costs each change stream neither a read from the storage engine nor a
+ * copy of the entry.
+ *
+ * Replaces the DocumentSourceOplogMatch at the front of a change stream pipeline when
+ * 'internalChangeStreamUseSharedOplogReader' is set.
+ */
+class DocumentSourceSharedOplogCursor final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$sharedOplogCursor"_sd;
+
+    /**
+     * Creates a stage producing the oplog entries which match 'filter', the filter of a change
+     * stream's DocumentSourceOplogMatch. The filter is always evaluated with the simple collation.
+     */
+    static boost::intrusive_ptr<DocumentSourceSharedOplogCursor> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx, const BSONObj& filter);
+
+    const char* getSourceName() const final;
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kAnyShard,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed,
+                                     LookupRequirement::kNotAllowed,
+                                     UnionRequirement::kNotAllowed,
+                                     ChangeStreamRequirement::kChangeStreamStage);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    /**
+     * Returns the timestamp of the next entry to be returned or, if there is none, of the last
+     * entry examined, like DocumentSourceCursor::getLatestOplogTimestamp().
+     */
+    Timestamp getLatestOplogTimestamp() const {
+        return _latestOplogTimestamp;
+    }
+
+protected:
+    GetNextResult doGetNext() final;
+
+    void doDispose() final;
+
+private:
+    DocumentSourceSharedOplogCursor(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                    BSONObj filter,
+                                    std::unique_ptr<MatchExpression> matcher,
+                                    Timestamp tsBeforeStart);
+
+    ~DocumentSourceSharedOplogCursor();
+
+    /**
+     * Examines the next entries after '_lastSeenTs', appending the matching ones to
+     * '_currentBatch', until at least one matches or no more entries are available. Waits for new
+     * entries as long as the operation is awaiting data.
+     */
+    void _loadBatch();
+
+    /**
+     * Reads up to one batch of the entries after '_lastSeenTs' from the oplog into 'out'.
+     */
+    void _readFromOplog(std::vector<SharedOplogReader::Entry>* out);
+
+    /**
+     * Makes the later reads of this operation use a majority committed snapshot which includes
+     * the entry at 'ts', so that the later stages see the effects of the entries taken from the
+     * cache.
+     */
+    void _ensureSnapshotIncludes(Timestamp ts);
+
+    bool _shouldWaitForEntries() const;
+
+    void _unregister();
+
+    const BSONObj _filter;
+    const std::unique_ptr<MatchExpression> _matcher;
+
+    SharedOplogReader* _reader;
+    bool _registered = true;
+
+    // Every entry up to '_lastSeenTs' has been examined. Before the first entry is examined, this
+    // is just before the start of the change stream.
+    Timestamp _lastSeenTs;
+    bool _examinedAny = false;
+
+    Timestamp _latestOplogTimestamp;
+
+    std::deque<Document> _currentBatch;
+};
+
+}  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
+#include "mongo/util/bump_arena.h"
 
 namespace mongo {
 
@@ -79,6 +80,9 @@ REGISTER_DOCUMENT_SOURCE(sort,
 
 DocumentSource::GetNextResult DocumentSourceSort::doGetNext() {
     if (!_populated) {
+        // The sorted documents are retained and accounted for by the sorter, so read them into
+        // heap memory rather than the pipeline's arena.
+        BumpArena::Scope heapScope(nullptr);
         const auto populationResult = populate();
         if (populationResult.isPaused()) {
             return populationResult;
@@ -2666,13 +2666,20 @@ Value ExpressionMeta::evaluate(const Document& root, Variables* variables) const
             return metadata.hasGeoNearDistance() ? Value(metadata.getGeoNearDistance()) : Value();
         case MetaType::kGeoNearPoint:
             return metadata.hasGeoNearPoint() ? Value(metadata.getGeoNearPoint()) : Value();
-        case MetaType::kRecordId:
+        case MetaType::kRecordId: {
             // Be sure that a RecordId can be represented by a long long.
             static_assert(RecordId::kMinRepr >= std::numeric_limits<long long>::min());
             static_assert(RecordId::kMaxRepr <= std::numeric_limits<long long>::max());
-            return metadata.hasRecordId()
-                ? Value{static_cast<long long>(metadata.getRecordId().repr())}
-                : Value();
+            if (!metadata.hasRecordId()) {
+                return Value();
+            }
+            const RecordId recordId = metadata.getRecordId();
+            if (recordId.isStr()) {
+                const auto str = recordId.getStr();
+                return Value(BSONBinData(str.rawData(), str.size(), BinDataGeneral));
+            }
+            return Value{static_cast<long long>(recordId.repr())};
+        }
         case MetaType::kIndexKey:
             return metadata.hasIndexKey() ? Value(metadata.getIndexKey()) : Value();
         case MetaType::kSortKey:
@@ -438,6 +438,19 @@ void Pipeline::stitch() {
 
 boost::optional<Document> Pipeline::getNext() {
     invariant(!_sources.empty());
+    if (!_arenaChecked) {
+        // Sub-pipelines, e.g. those of $lookup, share the arena of the pipeline running them, so
+        // that their short-lived results do not each hold a chunk of their own.
+        _arenaChecked = true;
+        if (internalPipelineUseArenaAllocator.load() && !BumpArena::threadHasArena()) {
+            _arena = std::make_unique<BumpArena>();
+        }
+    }
+    boost::optional<BumpArena::Scope> arenaScope;
+    if (_arena) {
+        arenaScope.emplace(_arena.get());
+    }
+
     auto nextResult = _sources.back()->getNext();
     while (nextResult.isPaused()) {
         nextResult = _sources.back()->getNext();
@@ -44,6 +44,7 @@
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
+#include "mongo/util/bump_arena.h"
 #include "mongo/util/intrusive_counter.h"
 #include "mongo/util/timer.h"
 
@@ -257,6 +258,10 @@ public:
 
     /**
      * Returns the next result from the pipeline, or boost::none if there are no more results.
+     *
+     * If 'internalPipelineUseArenaAllocator' is set when the first result is requested, the
+     * documents and values produced while computing results come from an arena owned by the
+     * pipeline.
      */
     boost::optional<Document> getNext();
 
@@ -366,6 +371,10 @@ private:
     SplitState _splitState = SplitState::kUnsplit;
     boost::intrusive_ptr<ExpressionContext> pCtx;
     bool _disposed = false;
+
+    // Serves the allocations made by getNext(), if enabled.
+    std::unique_ptr<BumpArena> _arena;
+    bool _arenaChecked = false;
 };
 
 /**
@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/client.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/bump_arena.h"
+
+namespace mongo {
+namespace {
+
+constexpr int kNumDocuments = 1000;
+
+std::deque<DocumentSource::GetNextResult> makeInput() {
+    std::deque<DocumentSource::GetNextResult> input;
+    for (int i = 0; i < kNumDocuments; ++i) {
+        input.emplace_back(Document(BSON("_id" << i << "user"
+                                               << ("user-" + std::to_string(i % 100)) << "amount"
+                                               << i * 1.5 << "address"
+                                               << BSON("city"
+                                                       << "Springfield"
+                                                       << "zip" << std::to_string(10000 + i))
+                                               << "tags"
+                                               << BSON_ARRAY("red"
+                                                             << "green"
+                                                             << "blue"))));
+    }
+    return input;
+}
+
+/**
+ * Runs 'stages' over kNumDocuments documents read from BSON, with the arena allocator enabled or
+ * disabled.
+ */
+void runPipeline(benchmark::State& state, bool useArena, const std::vector<BSONObj>& stages) {
+    ThreadClient client("pipeline_arena_bm", getGlobalServiceContext());
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    const auto input = makeInput();
+
+    const auto oldUseArena = internalPipelineUseArenaAllocator.load();
+    internalPipelineUseArenaAllocator.store(useArena);
+
+    for (auto _ : state) {
+        auto pipeline = Pipeline::parse(stages, expCtx);
+        pipeline->addInitialSource(DocumentSourceMock::createForTest(input, expCtx));
+        while (auto doc = pipeline->getNext()) {
+            benchmark::DoNotOptimize(doc);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kNumDocuments);
+
+    internalPipelineUseArenaAllocator.store(oldUseArena);
+}
+
+void BM_Project(benchmark::State& state, bool useArena) {
+    runPipeline(state,
+                useArena,
+                {fromjson("{$project: {user: 1, city: '$address.city', "
+                          "label: {$concat: ['$user', '@', '$address.zip']}, "
+                          "tags: {$concatArrays: ['$tags', ['new']]}, "
+                          "total: {$multiply: ['$amount', 2]}}}")});
+}
+
+void BM_AddFields(benchmark::State& state, bool useArena) {
+    runPipeline(state,
+                useArena,
+                {fromjson("{$addFields: {'address.country': 'US', "
+                          "label: {$toUpper: '$user'}, "
+                          "details: {amount: '$amount', zip: '$address.zip'}}}"),
+                 fromjson("{$addFields: {summary: {$concat: ['$label', ' ', '$details.zip']}}}")});
+}
+
+void BM_Group(benchmark::State& state, bool useArena) {
+    runPipeline(state,
+                useArena,
+                {fromjson("{$addFields: {label: {$concat: ['$user', '-', '$address.city']}}}"),
+                 fromjson("{$group: {_id: '$label', total: {$sum: '$amount'}, "
+                          "zips: {$push: '$address.zip'}, first: {$first: '$$ROOT'}}}")});
+}
+
+BENCHMARK_CAPTURE(BM_Project, Heap, false);
+BENCHMARK_CAPTURE(BM_Project, Arena, true);
+BENCHMARK_CAPTURE(BM_AddFields, Heap, false);
+BENCHMARK_CAPTURE(BM_AddFields, Arena, true);
+BENCHMARK_CAPTURE(BM_Group, Heap, false);
+BENCHMARK_CAPTURE(BM_Group, Arena, true);
+
+}  // namespace
+}  // namespace mongo
@@ -65,6 +65,7 @@
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
+#include "mongo/db/pipeline/document_source_shared_oplog_cursor.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/pipeline.h"
@@ -72,6 +73,7 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_executor_factory.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/sort_pattern.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -318,6 +320,19 @@ PipelineD::buildInnerQueryExecutor(Collection* collection,
     // We are going to generate an input cursor, so we need to be holding the collection lock.
     dassert(expCtx->opCtx->lockState()->isCollectionLockedForMode(nss, MODE_IS));
 
+    // Change streams can take the oplog entries they examine from the reader of the oplog shared
+    // by all of them, rather than each scanning the oplog with its own executor.
+    if (internalChangeStreamUseSharedOplogReader.load() && !expCtx->explain &&
+        expCtx->isTailableAwaitData() && nss == NamespaceString::kRsOplogNamespace &&
+        !sources.empty()) {
+        if (auto oplogMatch = dynamic_cast<DocumentSourceOplogMatch*>(sources.front().get())) {
+            auto filter = oplogMatch->getQuery();
+            pipeline->popFront();
+            pipeline->addInitialSource(DocumentSourceSharedOplogCursor::create(expCtx, filter));
+            return {};
+        }
+    }
+
     if (!sources.empty()) {
         auto sampleStage = dynamic_cast<DocumentSourceSample*>(sources.front().get());
         // Optimize an initial $sample stage if possible.
@@ -756,6 +771,10 @@ Timestamp PipelineD::getLatestOplogTimestamp(const Pipeline* pipeline) {
             dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
         return docSourceCursor->getLatestOplogTimestamp();
     }
+    if (auto sharedOplogCursor =
+            dynamic_cast<DocumentSourceSharedOplogCursor*>(pipeline->_sources.front().get())) {
+        return sharedOplogCursor->getLatestOplogTimestamp();
+    }
     return Timestamp();
 }
 
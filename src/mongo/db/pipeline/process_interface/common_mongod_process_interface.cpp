@@ -116,6 +116,21 @@ private:
     bool _yielded = false;
 };
 
+// Sets the speculative read timestamp appropriately after we do a document lookup locally. We set
+// the speculative read timestamp based on the timestamp used by the transaction.
+void setSpeculativeReadTimestampAfterLookup(OperationContext* opCtx) {
+    repl::SpeculativeMajorityReadInfo& speculativeMajorityReadInfo =
+        repl::SpeculativeMajorityReadInfo::get(opCtx);
+    if (speculativeMajorityReadInfo.isSpeculativeRead()) {
+        // Speculative majority reads are required to use the 'kNoOverlap' read source.
+        invariant(opCtx->recoveryUnit()->getTimestampReadSource() ==
+                  RecoveryUnit::ReadSource::kNoOverlap);
+        boost::optional<Timestamp> readTs = opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
+        invariant(readTs);
+        speculativeMajorityReadInfo.setSpeculativeReadTimestampForward(*readTs);
+    }
+}
+
 // Returns true if the field names of 'keyPattern' are exactly those in 'uniqueKeyPaths', and each
 // of the elements of 'keyPattern' is numeric, i.e. not "text", "$**", or any other special type of
 // index.
@@ -352,21 +367,107 @@ boost::optional<Document> CommonMongodProcessInterface::lookupSingleDocument(
                                 << ", " << next->toString() << "]");
     }
 
-    // Set the speculative read timestamp appropriately after we do a document lookup locally. We
-    // set the speculative read timestamp based on the timestamp used by the transaction.
-    repl::SpeculativeMajorityReadInfo& speculativeMajorityReadInfo =
-        repl::SpeculativeMajorityReadInfo::get(expCtx->opCtx);
-    if (speculativeMajorityReadInfo.isSpeculativeRead()) {
-        // Speculative majority reads are required to use the 'kNoOverlap' read source.
-        invariant(expCtx->opCtx->recoveryUnit()->getTimestampReadSource() ==
-                  RecoveryUnit::ReadSource::kNoOverlap);
-        boost::optional<Timestamp> readTs =
-            expCtx->opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
-        invariant(readTs);
-        speculativeMajorityReadInfo.setSpeculativeReadTimestampForward(*readTs);
+    setSpeculativeReadTimestampAfterLookup(expCtx->opCtx);
+    return lookedUpDocument;
+}
+
+std::vector<boost::optional<Document>> CommonMongodProcessInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern,
+    bool allowSpeculativeMajorityRead) {
+    invariant(!readConcern);
+    invariant(!allowSpeculativeMajorityRead);
+
+    if (documentKeys.size() < 2) {
+        return MongoProcessInterface::lookupDocuments(
+            expCtx, nss, collectionUUID, documentKeys, readConcern, allowSpeculativeMajorityRead);
     }
 
-    return lookedUpDocument;
+    // The keys are looked up with a single query: an $in on _id when they hold only the _id, as
+    // they do unless the collection is sharded, and an $or of the keys otherwise.
+    const bool idOnly = std::all_of(documentKeys.begin(), documentKeys.end(), [](auto&& key) {
+        return key.computeSize() == 1 && !key["_id"].missing();
+    });
+    BSONObj filter;
+    if (idOnly) {
+        BSONArrayBuilder ids;
+        for (auto&& documentKey : documentKeys) {
+            documentKey["_id"].addToBsonArray(&ids);
+        }
+        filter = BSON("_id" << BSON("$in" << ids.arr()));
+    } else {
+        BSONArrayBuilder keys;
+        for (auto&& documentKey : documentKeys) {
+            keys.append(documentKey.toBson());
+        }
+        filter = BSON("$or" << keys.arr());
+    }
+
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    try {
+        auto foreignExpCtx = expCtx->copyWith(
+            nss,
+            collectionUUID,
+            _getCollectionDefaultCollator(expCtx->opCtx, nss.db(), collectionUUID));
+        MakePipelineOptions opts;
+        opts.allowTargetingShards = false;
+        pipeline = Pipeline::makePipeline({BSON("$match" << filter)}, foreignExpCtx, opts);
+    } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return std::vector<boost::optional<Document>>(documentKeys.size());
+    }
+
+    // Each document found is matched back to its key with the collation of the collection. If a
+    // document does not match exactly one key, the keys are looked up separately instead.
+    const auto& comparator = pipeline->getContext()->getValueComparator();
+    auto matchesKey = [&](const Document& doc, const Document& documentKey) {
+        auto it = documentKey.fieldIterator();
+        while (it.more()) {
+            auto field = it.next();
+            if (comparator.evaluate(doc.getNestedField(FieldPath(field.first)) != field.second)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<boost::optional<Document>> lookedUpDocuments(documentKeys.size());
+    while (auto doc = pipeline->getNext()) {
+        boost::optional<size_t> keyIndex;
+        for (size_t i = 0; i < documentKeys.size(); ++i) {
+            if (!matchesKey(*doc, documentKeys[i])) {
+                continue;
+            }
+            if (keyIndex) {
+                keyIndex = boost::none;
+                break;
+            }
+            keyIndex = i;
+        }
+
+        if (!keyIndex) {
+            pipeline.reset();
+            return MongoProcessInterface::lookupDocuments(expCtx,
+                                                          nss,
+                                                          collectionUUID,
+                                                          documentKeys,
+                                                          readConcern,
+                                                          allowSpeculativeMajorityRead);
+        }
+
+        auto& lookedUpDocument = lookedUpDocuments[*keyIndex];
+        uassert(ErrorCodes::ChangeStreamFatalError,
+                str::stream() << "found more than one document with document key "
+                              << documentKeys[*keyIndex].toString() << " ["
+                              << lookedUpDocument->toString() << ", " << doc->toString() << "]",
+                !lookedUpDocument);
+        lookedUpDocument = std::move(doc);
+    }
+
+    setSpeculativeReadTimestampAfterLookup(expCtx->opCtx);
+    return lookedUpDocuments;
 }
 
 BackupCursorState CommonMongodProcessInterface::openBackupCursor(
@@ -40,4 +40,20 @@ std::shared_ptr<MongoProcessInterface> MongoProcessInterface::create(OperationCo
     return w(opCtx);
 }
 
+std::vector<boost::optional<Document>> MongoProcessInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern,
+    bool allowSpeculativeMajorityRead) {
+    std::vector<boost::optional<Document>> lookedUpDocuments;
+    lookedUpDocuments.reserve(documentKeys.size());
+    for (auto&& documentKey : documentKeys) {
+        lookedUpDocuments.push_back(lookupSingleDocument(
+            expCtx, nss, collectionUUID, documentKey, readConcern, allowSpeculativeMajorityRead));
+    }
+    return lookedUpDocuments;
+}
+
 }  // namespace mongo
@@ -358,6 +358,22 @@ public:
         boost::optional<BSONObj> readConcern,
         bool allowSpeculativeMajorityRead = false) = 0;
 
+    /**
+     * Looks up the document matching each of 'documentKeys', which must be distinct, like
+     * lookupSingleDocument() does for one document key. Returns the documents in the order of
+     * 'documentKeys', with boost::none for each key no document was found for. Throws if more than
+     * one document matches a key.
+     *
+     * The default implementation looks up each document separately.
+     */
+    virtual std::vector<boost::optional<Document>> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID collectionUUID,
+        const std::vector<Document>& documentKeys,
+        boost::optional<BSONObj> readConcern,
+        bool allowSpeculativeMajorityRead = false);
+
     /**
      * Returns a vector of all idle (non-pinned) local cursors.
      */
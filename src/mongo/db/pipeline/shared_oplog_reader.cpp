@@ -0,0 +1,298 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/shared_oplog_reader.h"
+
+#include <algorithm>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/oplog_hack.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/logv2/log.h"
+
+namespace mongo {
+namespace {
+
+const auto getSharedOplogReader = ServiceContext::declareDecoration<SharedOplogReader>();
+
+// Bounds the entries read while holding the oplog lock and a single snapshot.
+constexpr size_t kMaxBatchEntries = 1000;
+constexpr size_t kMaxBatchBytes = 16 * 1024 * 1024;
+
+// How long the reader waits for the majority commit point to move before looking again.
+constexpr Milliseconds kIdleWait{1000};
+
+Counter64 entriesRead;
+
+ServerStatusMetricField<Counter64> displayEntriesRead("changeStreams.sharedOplogReader.entriesRead",
+                                                      &entriesRead);
+
+}  // namespace
+
+SharedOplogReader& SharedOplogReader::get(ServiceContext* serviceContext) {
+    return getSharedOplogReader(serviceContext);
+}
+
+SharedOplogReader::Entry SharedOplogReader::makeEntry(BSONObj obj) {
+    auto tsElem = obj[repl::OpTime::kTimestampFieldName];
+    uassert(ErrorCodes::Error(4918004),
+            str::stream() << "Oplog entry without a valid 'ts' field: " << obj.toString(),
+            tsElem.type() == BSONType::bsonTimestamp);
+    return {tsElem.timestamp(), std::move(obj)};
+}
+
+SharedOplogReader::~SharedOplogReader() {
+    shutdown();
+}
+
+void SharedOplogReader::registerStream() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    ++_numStreams;
+    if (!_inShutdown && !_thread.joinable()) {
+        _thread = stdx::thread([this] { _run(); });
+    }
+    _cv.notify_all();
+}
+
+void SharedOplogReader::unregisterStream() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    invariant(_numStreams > 0);
+    if (--_numStreams == 0) {
+        _reset_inlock();
+    }
+}
+
+bool SharedOplogReader::getEntriesAfter(Timestamp after,
+                                        size_t maxEntries,
+                                        std::vector<Entry>* out) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (!_positioned || after < _cacheFloor) {
+        return false;
+    }
+
+    auto it = std::upper_bound(
+        _cache.begin(), _cache.end(), after, [](const Timestamp& ts, const Entry& entry) {
+            return ts < entry.ts;
+        });
+    for (; it != _cache.end() && maxEntries > 0; ++it, --maxEntries) {
+        out->push_back(*it);
+    }
+    return true;
+}
+
+void SharedOplogReader::waitForEntriesAfter(OperationContext* opCtx,
+                                            Timestamp after,
+                                            Date_t deadline) const {
+    stdx::unique_lock<Latch> lk(_mutex);
+    opCtx->waitForConditionOrInterruptUntil(
+        _cv, lk, deadline, [&] { return _inShutdown || (_positioned && _lastReadTs > after); });
+}
+
+void SharedOplogReader::shutdown() {
+    stdx::thread thread;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _inShutdown = true;
+        _reset_inlock();
+        thread = std::move(_thread);
+        _cv.notify_all();
+    }
+
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void SharedOplogReader::_run() {
+    ThreadClient tc("SharedOplogReader", getGlobalServiceContext());
+    {
+        stdx::lock_guard<Client> lk(*tc.get());
+        tc.get()->setSystemOperationKillable(lk);
+    }
+
+    while (true) {
+        {
+            stdx::unique_lock<Latch> lk(_mutex);
+            _cv.wait(lk, [&] { return _inShutdown || _numStreams > 0; });
+            if (_inShutdown) {
+                return;
+            }
+        }
+
+        std::shared_ptr<CappedInsertNotifier> notifier;
+        uint64_t notifierVersion = 0;
+        bool moreAvailable = false;
+        try {
+            auto opCtx = tc->makeOperationContext();
+            moreAvailable = _readBatch(opCtx.get(), &notifier, &notifierVersion);
+        } catch (const DBException& ex) {
+            LOGV2_DEBUG(4918005,
+                        1,
+                        "The shared oplog reader failed to read the oplog",
+                        "error"_attr = ex.toStatus());
+        }
+
+        if (moreAvailable) {
+            continue;
+        }
+
+        // The majority commit point moving wakes up the waiters of the oplog's capped insert
+        // notifier. The wait is bounded so that shutdown is noticed promptly.
+        const auto deadline = Date_t::now() + kIdleWait;
+        if (notifier) {
+            notifier->waitUntil(notifierVersion, deadline);
+        } else {
+            sleepFor(kIdleWait);
+        }
+    }
+}
+
+bool SharedOplogReader::_readBatch(OperationContext* opCtx,
+                                   std::shared_ptr<CappedInsertNotifier>* notifier,
+                                   uint64_t* notifierVersion) {
+    bool positioned;
+    Timestamp lastReadTs;
+    uint64_t generation;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        positioned = _positioned;
+        lastReadTs = _lastReadTs;
+        generation = _generation;
+    }
+
+    AutoGetOplog oplogRead(opCtx, OplogAccessMode::kRead);
+    auto oplog = oplogRead.getCollection();
+    if (!oplog) {
+        return false;
+    }
+
+    // The notifier version is taken before the snapshot is, so that the wait after an empty batch
+    // ends as soon as the majority commit point moves past the snapshot.
+    *notifier = oplog->getCappedInsertNotifier();
+    *notifierVersion = (*notifier)->getVersion();
+
+    opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kMajorityCommitted);
+    if (!opCtx->recoveryUnit()->obtainMajorityCommittedSnapshot().isOK()) {
+        return false;
+    }
+
+    std::vector<Entry> entries;
+    bool batchFull = false;
+    if (!positioned) {
+        // Start after the newest majority committed entry. Change streams which start earlier read
+        // the entries up to it from the oplog themselves.
+        auto record = oplog->getCursor(opCtx, false)->next();
+        lastReadTs = record ? makeEntry(record->data.toBson()).ts : Timestamp();
+    } else {
+        auto cursor = oplog->getCursor(opCtx, true);
+        auto goal = oploghack::keyForOptime(lastReadTs);
+        if (goal.isOK() && !cursor->seekExact(goal.getValue())) {
+            // The oplog was truncated past the last entry read, so the entries right after it are
+            // lost. Start over from the newest entry.
+            LOGV2(4918006,
+                  "The shared oplog reader fell off the oplog, dropping its cache",
+                  "lastReadTimestamp"_attr = lastReadTs);
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (generation == _generation) {
+                _reset_inlock();
+            }
+            return true;
+        }
+
+        size_t bytes = 0;
+        while (entries.size() < kMaxBatchEntries && bytes < kMaxBatchBytes) {
+            auto record = cursor->next();
+            if (!record) {
+                break;
+            }
+            entries.push_back(makeEntry(record->data.releaseToBson().getOwned()));
+            bytes += entries.back().obj.objsize();
+        }
+        batchFull = entries.size() >= kMaxBatchEntries || bytes >= kMaxBatchBytes;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (generation != _generation) {
+        return true;
+    }
+
+    if (!positioned) {
+        _positioned = true;
+        _cacheFloor = lastReadTs;
+        _lastReadTs = lastReadTs;
+        _cv.notify_all();
+        return true;
+    }
+
+    if (entries.empty()) {
+        return false;
+    }
+
+    entriesRead.increment(entries.size());
+    _lastReadTs = entries.back().ts;
+    for (auto&& entry : entries) {
+        _cacheBytes += entry.obj.objsize();
+        _cache.push_back(std::move(entry));
+    }
+
+    const auto maxBytes =
+        static_cast<size_t>(internalChangeStreamSharedOplogCacheMaxBytes.load());
+    while (_cacheBytes > maxBytes && !_cache.empty()) {
+        _cacheBytes -= _cache.front().obj.objsize();
+        _cacheFloor = _cache.front().ts;
+        _cache.pop_front();
+    }
+
+    _cv.notify_all();
+    return batchFull;
+}
+
+void SharedOplogReader::_reset_inlock() {
+    _positioned = false;
+    _cacheFloor = Timestamp();
+    _lastReadTs = Timestamp();
+    _cache.clear();
+    _cacheBytes = 0;
+    ++_generation;
+    _cv.notify_all();
+}
+
+}  // namespace mongo
@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class CappedInsertNotifier;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Tails the oplog once on behalf of all the change streams open on this node.
+ *
+ * While at least one change stream is registered, a background thread reads the majority committed
+ * oplog entries in order and keeps the most recent of them in a cache, which holds at most
+ * 'internalChangeStreamSharedOplogCacheMaxBytes' of entries. Change streams take the entries they
+ * have not examined yet from the cache, sharing the buffers of the entries, instead of each
+ * scanning and copying them out of the oplog on its own.
+ *
+ * The cache holds every entry after its floor, so a change stream can tell whether all the entries
+ * it needs are cached. A change stream which starts or falls behind the floor reads the entries it
+ * is missing from the oplog itself until it catches up with the cache.
+ */
+class SharedOplogReader {
+public:
+    struct Entry {
+        Timestamp ts;
+        BSONObj obj;
+    };
+
+    static SharedOplogReader& get(ServiceContext* serviceContext);
+
+    /**
+     * Returns an entry holding the owned oplog entry 'obj'. Throws if 'obj' has no valid "ts".
+     */
+    static Entry makeEntry(BSONObj obj);
+
+    ~SharedOplogReader();
+
+    /**
+     * Registers a change stream, starting the reader thread if it is not running. The cache is
+     * only maintained while at least one change stream is registered, and is dropped once the last
+     * one unregisters. Every call to registerStream() must be paired with a call to
+     * unregisterStream().
+     */
+    void registerStream();
+    void unregisterStream();
+
+    /**
+     * Appends to 'out', in order, up to 'maxEntries' of the cached entries which come after
+     * 'after'. Returns false without appending anything if the cache may not hold all of the
+     * entries after 'after'.
+     */
+    bool getEntriesAfter(Timestamp after, size_t maxEntries, std::vector<Entry>* out) const;
+
+    /**
+     * Waits until the reader has read past 'after', 'deadline' passes or the reader shuts down.
+     * Throws if 'opCtx' is interrupted.
+     */
+    void waitForEntriesAfter(OperationContext* opCtx, Timestamp after, Date_t deadline) const;
+
+    /**
+     * Stops the reader thread and waits for it to exit. Change streams which are still open read
+     * the oplog themselves from then on.
+     */
+    void shutdown();
+
+private:
+    void _run();
+
+    /**
+     * Reads the next batch of majority committed entries into the cache. Returns whether more
+     * entries may be readable right away. Otherwise, 'notifier' and 'notifierVersion' are set to
+     * wait on for the majority commit point to move, if the oplog exists.
+     */
+    bool _readBatch(OperationContext* opCtx,
+                    std::shared_ptr<CappedInsertNotifier>* notifier,
+                    uint64_t* notifierVersion);
+
+    void _reset_inlock();
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("SharedOplogReader::_mutex");
+
+    // Notified whenever entries are added to the cache, streams register or the reader shuts down.
+    mutable stdx::condition_variable _cv;
+
+    size_t _numStreams = 0;
+    bool _inShutdown = false;
+    stdx::thread _thread;
+
+    // Whether the reader has picked the point of the oplog to read from, which is the first
+    // '_cacheFloor'. The cache holds every entry after '_cacheFloor' up to '_lastReadTs'.
+    bool _positioned = false;
+    Timestamp _cacheFloor;
+    Timestamp _lastReadTs;
+    std::deque<Entry> _cache;
+    size_t _cacheBytes = 0;
+
+    // Incremented whenever the cache is dropped, so that the reader discards the batch it was
+    // reading at the time.
+    uint64_t _generation = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/spillable_document_buffer.h"
+
+#include <boost/filesystem/operations.hpp>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/destructor_guard.h"
+#include "mongo/util/errno_util.h"
+
+namespace mongo {
+namespace {
+
+std::string nextFileName() {
+    static AtomicWord<unsigned> spillableDocumentBufferFileCounter;
+    return "extsort-doc-buffer." +
+        std::to_string(spillableDocumentBufferFileCounter.fetchAndAdd(1));
+}
+
+}  // namespace
+
+SpillableDocumentBuffer::SpillableDocumentBuffer(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    StringData stageName,
+    size_t maxMemoryBytes)
+    : _expCtx(expCtx),
+      _stageName(stageName.toString()),
+      _maxMemoryBytes(maxMemoryBytes),
+      _allowDiskUse(expCtx->allowDiskUse && !expCtx->inMongos && !expCtx->tempDir.empty()) {}
+
+SpillableDocumentBuffer::~SpillableDocumentBuffer() {
+    if (_usedDisk) {
+        DESTRUCTOR_GUARD(_file.close(); boost::filesystem::remove(_fileName));
+    }
+}
+
+void SpillableDocumentBuffer::push_back(const Document& doc) {
+    // Once documents were spilled, the following ones are spilled too, to keep them in order.
+    if (_spilledOffsets.size() > _spilledBegin) {
+        _spill(doc);
+        return;
+    }
+
+    const auto size = doc.getApproximateSize();
+    if (_memUsageBytes + size > _maxMemoryBytes && !_memory.empty()) {
+        uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
+                str::stream() << "Exceeded memory limit for " << _stageName
+                              << ", but didn't allow external sort. Pass allowDiskUse:true to "
+                                 "opt in.",
+                _allowDiskUse);
+        _spill(doc);
+        return;
+    }
+
+    _memory.push_back(doc);
+    _memUsageBytes += size;
+}
+
+void SpillableDocumentBuffer::_spill(const Document& doc) {
+    if (!_usedDisk) {
+        boost::filesystem::create_directories(_expCtx->tempDir);
+        _fileName = _expCtx->tempDir + "/" + nextFileName();
+        _file.open(_fileName.c_str(),
+                   std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+        uassert(4918013,
+                str::stream() << "error opening file \"" << _fileName
+                              << "\": " << errnoWithDescription(),
+                _file.good());
+        _usedDisk = true;
+    }
+
+    const auto bson = doc.toBsonWithMetaData();
+    _file.seekp(_fileEnd);
+    _file.write(bson.objdata(), bson.objsize());
+    uassert(4918014,
+            str::stream() << "error writing to file \"" << _fileName
+                          << "\": " << errnoWithDescription(),
+            _file.good());
+
+    _spilledOffsets.push_back(_fileEnd);
+    _fileEnd += bson.objsize();
+}
+
+Document SpillableDocumentBuffer::at(size_t position) {
+    invariant(position >= _begin && position < end());
+    if (position - _begin < _memory.size()) {
+        return _memory[position - _begin];
+    }
+
+    const auto offset = _spilledOffsets[_spilledBegin + position - _begin - _memory.size()];
+    int32_t size;
+    _file.seekg(offset);
+    _file.read(reinterpret_cast<char*>(&size), sizeof(size));
+    auto buffer = SharedBuffer::allocate(size);
+    std::memcpy(buffer.get(), &size, sizeof(size));
+    _file.read(buffer.get() + sizeof(size), size - sizeof(size));
+    uassert(4918015,
+            str::stream() << "error reading file \"" << _fileName
+                          << "\": " << errnoWithDescription(),
+            _file.good());
+    return Document::fromBsonWithMetaData(BSONObj(std::move(buffer)));
+}
+
+void SpillableDocumentBuffer::releaseBefore(size_t position) {
+    invariant(position <= end());
+    for (; _begin < position; ++_begin) {
+        if (!_memory.empty()) {
+            _memUsageBytes -= _memory.front().getApproximateSize();
+            _memory.pop_front();
+        } else {
+            ++_spilledBegin;
+        }
+    }
+
+    if (_spilledBegin == _spilledOffsets.size()) {
+        // Start writing the file over once none of its documents are needed anymore.
+        _spilledOffsets.clear();
+        _spilledBegin = 0;
+        _fileEnd = 0;
+    }
+}
+
+void SpillableDocumentBuffer::clear() {
+    _memory.clear();
+    _memUsageBytes = 0;
+    _spilledOffsets.clear();
+    _spilledBegin = 0;
+    _fileEnd = 0;
+    _begin = 0;
+}
+
+}  // namespace mongo
@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+
+namespace mongo {
+
+/**
+ * A queue of documents which are addressed by their position since the queue was last cleared,
+ * for stages which need to look back and ahead of the document they are processing. Documents are
+ * appended at the back and released from the front.
+ *
+ * Once the documents held in memory exceed 'maxMemoryBytes', the documents appended next are
+ * written to a file in the temporary directory and read back from it on access, until the queue is
+ * cleared. If the expression context does not allow using the disk, exceeding the memory limit is
+ * an error instead.
+ */
+class SpillableDocumentBuffer {
+public:
+    SpillableDocumentBuffer(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                            StringData stageName,
+                            size_t maxMemoryBytes);
+    ~SpillableDocumentBuffer();
+
+    /**
+     * The position of the first document held, and the position after the last document held.
+     */
+    size_t begin() const {
+        return _begin;
+    }
+    size_t end() const {
+        return _begin + _memory.size() + _spilledOffsets.size() - _spilledBegin;
+    }
+
+    void push_back(const Document& doc);
+
+    /**
+     * Returns the document at 'position', which must be held.
+     */
+    Document at(size_t position);
+
+    /**
+     * Releases the documents before 'position'.
+     */
+    void releaseBefore(size_t position);
+
+    /**
+     * Releases all the documents and starts over from position 0.
+     */
+    void clear();
+
+    bool usedDisk() const {
+        return _usedDisk;
+    }
+
+    size_t getMemUsageBytes() const {
+        return _memUsageBytes;
+    }
+
+private:
+    void _spill(const Document& doc);
+
+    const boost::intrusive_ptr<ExpressionContext> _expCtx;
+    const std::string _stageName;
+    const size_t _maxMemoryBytes;
+    const bool _allowDiskUse;
+
+    size_t _begin = 0;
+
+    // The documents from '_begin' on which are held in memory.
+    std::deque<Document> _memory;
+    size_t _memUsageBytes = 0;
+
+    // The file offsets of the documents following the ones held in memory. The first '_spilledBegin'
+    // of them were released already.
+    std::vector<std::streamoff> _spilledOffsets;
+    size_t _spilledBegin = 0;
+
+    std::string _fileName;
+    std::fstream _file;
+    std::streamoff _fileEnd = 0;
+    bool _usedDisk = false;
+};
+
+}  // namespace mongo
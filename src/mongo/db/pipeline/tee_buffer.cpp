@@ -50,6 +50,17 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferS
 }
 
 DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
+    if (_concurrentConsumers) {
+        auto& consumer = _consumers[consumerId];
+        if (consumer.nLeftToReturn == 0) {
+            return _exhausted ? DocumentSource::GetNextResult::makeEOF()
+                              : DocumentSource::GetNextResult::makePauseExecution();
+        }
+        const size_t bufferIndex = _bsonBuffer.size() - consumer.nLeftToReturn;
+        --consumer.nLeftToReturn;
+        return Document::fromBsonWithMetaData(_bsonBuffer[bufferIndex]);
+    }
+
     size_t nConsumersStillProcessingThisBatch =
         std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
             return info.nLeftToReturn > 0;
@@ -104,4 +115,47 @@ void TeeBuffer::loadNextBatch() {
     }
 }
 
+bool TeeBuffer::loadNextBatchForConcurrentConsumers() {
+    invariant(_concurrentConsumers);
+    _bsonBuffer.clear();
+    if (_exhausted) {
+        return false;
+    }
+
+    if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+            return info.stillInUse;
+        })) {
+        _exhausted = true;
+        if (_source) {
+            _source->dispose();
+        }
+        return false;
+    }
+
+    size_t bytesInBuffer = 0;
+    auto input = _source->getNext();
+    for (; input.isAdvanced(); input = _source->getNext()) {
+        const auto& doc = input.getDocument();
+        _bsonBuffer.push_back(
+            (doc.metadata() ? doc.toBsonWithMetaData() : doc.toBson()).getOwned());
+        bytesInBuffer += _bsonBuffer.back().objsize();
+
+        if (bytesInBuffer >= _bufferSizeBytes) {
+            break;
+        }
+    }
+    invariant(!input.isPaused());
+
+    if (_bsonBuffer.empty()) {
+        _exhausted = true;
+        return false;
+    }
+    for (auto&& consumer : _consumers) {
+        if (consumer.stillInUse) {
+            consumer.nLeftToReturn = _bsonBuffer.size();
+        }
+    }
+    return true;
+}
+
 }  // namespace mongo
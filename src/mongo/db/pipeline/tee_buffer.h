@@ -59,6 +59,26 @@ public:
         _source = source;
     }
 
+    /**
+     * Makes the buffer serve consumers which run concurrently, each on its own thread. Batches are
+     * then only loaded by loadNextBatchForConcurrentConsumers(), from the thread which owns the
+     * buffer while no consumer runs, and getNext() and dispose() only access the state of the
+     * consumer they are called for.
+     *
+     * Reading a document may populate its cache of fields, so each consumer gets its own Document
+     * for each input, all of them backed by the same BSON.
+     */
+    void enableConcurrentConsumers() {
+        _concurrentConsumers = true;
+    }
+
+    /**
+     * Loads the next batch for concurrent consumers. Must only be called once every consumer
+     * paused or reached the end of the input. Returns false once the input is exhausted, or no
+     * consumer is still in use, in which case the consumers get EOF.
+     */
+    bool loadNextBatchForConcurrentConsumers();
+
     /**
      * Removes 'consumerId' as a consumer of this buffer. This is required to be called if a
      * consumer will not consume all input.
@@ -66,6 +86,10 @@ public:
     void dispose(size_t consumerId) {
         _consumers[consumerId].stillInUse = false;
         _consumers[consumerId].nLeftToReturn = 0;
+        if (_concurrentConsumers) {
+            // The source is disposed of by the next load, from the thread owning the buffer.
+            return;
+        }
         if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
                 return info.stillInUse;
             })) {
@@ -98,6 +122,11 @@ private:
     const size_t _bufferSizeBytes;
     std::vector<DocumentSource::GetNextResult> _buffer;
 
+    // With concurrent consumers, the batch is held as BSON instead of in '_buffer'.
+    bool _concurrentConsumers = false;
+    std::vector<BSONObj> _bsonBuffer;
+    bool _exhausted = false;
+
     struct ConsumerInfo {
         bool stillInUse = true;
         int nLeftToReturn = 0;
@@ -170,5 +170,39 @@ TEST_F(TeeBufferTest, ShouldAllowOtherConsumersToAdvanceOnceTrailingConsumerIsDi
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
 }
+
+TEST_F(TeeBufferTest, ConcurrentConsumersShouldOnlyAdvanceOnceTheOwnerLoadsTheNextBatch) {
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"a", 1}}, Document{{"a", 2}}};
+    auto mock = DocumentSourceMock::createForTest(inputs, getExpCtx());
+
+    const size_t bufferBytes = 1;  // Both docs won't fit in a single batch.
+    auto teeBuffer = TeeBuffer::create(2, bufferBytes);
+    teeBuffer->setSource(mock.get());
+    teeBuffer->enableConcurrentConsumers();
+
+    // Consumers do not load batches themselves.
+    ASSERT_TRUE(teeBuffer->getNext(0).isPaused());
+
+    ASSERT_TRUE(teeBuffer->loadNextBatchForConcurrentConsumers());
+    for (size_t consumerId = 0; consumerId < 2; ++consumerId) {
+        auto next = teeBuffer->getNext(consumerId);
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.getDocument(), inputs.front().getDocument());
+        ASSERT_TRUE(teeBuffer->getNext(consumerId).isPaused());
+    }
+
+    // A disposed consumer gets no more documents, and does not dispose of the source.
+    teeBuffer->dispose(1);
+    ASSERT_TRUE(teeBuffer->loadNextBatchForConcurrentConsumers());
+    auto next = teeBuffer->getNext(0);
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.getDocument(), inputs.back().getDocument());
+    ASSERT_TRUE(teeBuffer->getNext(1).isPaused());
+    ASSERT_FALSE(mock->isDisposed);
+
+    ASSERT_FALSE(teeBuffer->loadNextBatchForConcurrentConsumers());
+    ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
+    ASSERT_TRUE(teeBuffer->getNext(1).isEOF());
+}
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/window_function.h"
+
+#include <cmath>
+#include <limits>
+
+#include "mongo/db/pipeline/expression_context.h"
+
+namespace mongo {
+
+std::unique_ptr<WindowFunctionState> WindowFunctionState::create(StringData name,
+                                                                 ExpressionContext* expCtx) {
+    if (name == "$sum"_sd) {
+        return std::make_unique<WindowFunctionSum>();
+    } else if (name == "$avg"_sd) {
+        return std::make_unique<WindowFunctionAvg>();
+    } else if (name == "$count"_sd) {
+        return std::make_unique<WindowFunctionCount>();
+    } else if (name == "$min"_sd) {
+        return std::make_unique<WindowFunctionMinMax>(WindowFunctionMinMax::Sense::kMin,
+                                                      expCtx->getValueComparator());
+    } else if (name == "$max"_sd) {
+        return std::make_unique<WindowFunctionMinMax>(WindowFunctionMinMax::Sense::kMax,
+                                                      expCtx->getValueComparator());
+    }
+    return nullptr;
+}
+
+void WindowFunctionSum::add(const Value& value) {
+    _update(value, 1);
+}
+
+void WindowFunctionSum::remove(const Value& value) {
+    _update(value, -1);
+}
+
+void WindowFunctionSum::_update(const Value& value, int sign) {
+    if (!value.numeric()) {
+        return;
+    }
+
+    _count += sign;
+    switch (value.getType()) {
+        case NumberInt:
+            _nonDecimalTotal.addLong(sign * static_cast<long long>(value.getInt()));
+            break;
+        case NumberLong:
+            _numLongs += sign;
+            // Negating the smallest long would overflow.
+            if (sign < 0 && value.getLong() == std::numeric_limits<long long>::min()) {
+                _nonDecimalTotal.addDouble(-static_cast<double>(value.getLong()));
+            } else {
+                _nonDecimalTotal.addLong(sign * value.getLong());
+            }
+            break;
+        case NumberDouble: {
+            _numDoubles += sign;
+            const double d = value.getDouble();
+            if (std::isnan(d)) {
+                _numNaNs += sign;
+            } else if (std::isinf(d)) {
+                (d > 0 ? _numPosInfs : _numNegInfs) += sign;
+            } else {
+                _nonDecimalTotal.addDouble(sign * d);
+            }
+            break;
+        }
+        case NumberDecimal: {
+            _numDecimals += sign;
+            const auto decimal = value.getDecimal();
+            if (decimal.isNaN()) {
+                _numNaNs += sign;
+            } else if (decimal.isInfinite()) {
+                (decimal.isNegative() ? _numNegInfs : _numPosInfs) += sign;
+            } else {
+                _decimalTotal =
+                    sign > 0 ? _decimalTotal.add(decimal) : _decimalTotal.subtract(decimal);
+            }
+            break;
+        }
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+Value WindowFunctionSum::getValue() const {
+    if (_numNaNs > 0 || (_numPosInfs > 0 && _numNegInfs > 0)) {
+        return _numDecimals > 0 ? Value(Decimal128::kPositiveNaN)
+                                : Value(std::numeric_limits<double>::quiet_NaN());
+    }
+    if (_numPosInfs > 0 || _numNegInfs > 0) {
+        if (_numDecimals > 0) {
+            return Value(_numPosInfs > 0 ? Decimal128::kPositiveInfinity
+                                         : Decimal128::kNegativeInfinity);
+        }
+        return Value(_numPosInfs > 0 ? std::numeric_limits<double>::infinity()
+                                     : -std::numeric_limits<double>::infinity());
+    }
+
+    if (_numDecimals > 0) {
+        return Value(_decimalTotal.add(_nonDecimalTotal.getDecimal()));
+    }
+    if (_numDoubles > 0 || !_nonDecimalTotal.fitsLong()) {
+        return Value(_nonDecimalTotal.getDouble());
+    }
+    if (_numLongs > 0) {
+        return Value(_nonDecimalTotal.getLong());
+    }
+    return Value::createIntOrLong(_nonDecimalTotal.getLong());
+}
+
+void WindowFunctionSum::reset() {
+    *this = WindowFunctionSum();
+}
+
+Value WindowFunctionAvg::getValue() const {
+    if (_count == 0) {
+        return Value(BSONNULL);
+    }
+
+    auto total = WindowFunctionSum::getValue();
+    if (total.getType() == NumberDecimal) {
+        return Value(total.getDecimal().divide(Decimal128(static_cast<int64_t>(_count))));
+    }
+    return Value(total.coerceToDouble() / static_cast<double>(_count));
+}
+
+void WindowFunctionMinMax::add(const Value& value) {
+    if (value.nullish()) {
+        return;
+    }
+
+    if (_unboundedBelow) {
+        if (_candidates.empty()) {
+            _candidates.push_back(value);
+        } else if (_isWorse(_candidates.front(), value)) {
+            _memUsageBytes -= _candidates.front().getApproximateSize();
+            _candidates.front() = value;
+        } else {
+            return;
+        }
+        _memUsageBytes += value.getApproximateSize();
+        return;
+    }
+
+    while (!_candidates.empty() && _isWorse(_candidates.back(), value)) {
+        _memUsageBytes -= _candidates.back().getApproximateSize();
+        _candidates.pop_back();
+    }
+    _candidates.push_back(value);
+    _memUsageBytes += value.getApproximateSize();
+}
+
+void WindowFunctionMinMax::remove(const Value& value) {
+    if (value.nullish()) {
+        return;
+    }
+
+    // The value was dropped already unless it is still the result.
+    if (!_candidates.empty() && _comparator.evaluate(_candidates.front() == value)) {
+        _memUsageBytes -= _candidates.front().getApproximateSize();
+        _candidates.pop_front();
+    }
+}
+
+Value WindowFunctionMinMax::getValue() const {
+    return _candidates.empty() ? Value(BSONNULL) : _candidates.front();
+}
+
+void WindowFunctionMinMax::reset() {
+    _candidates.clear();
+    _memUsageBytes = 0;
+}
+
+}  // namespace mongo
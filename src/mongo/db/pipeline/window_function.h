@@ -0,0 +1,191 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+
+#include "mongo/base/string_data.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/exec/document_value/value_comparator.h"
+#include "mongo/util/summation.h"
+
+namespace mongo {
+
+class ExpressionContext;
+
+/**
+ * The state of a window function over a window of documents which slides forward: values enter
+ * the window at its upper bound with add(), and leave it at its lower bound with remove(), in the
+ * order they were added. Each function updates its result incrementally rather than recomputing it
+ * over the whole window.
+ */
+class WindowFunctionState {
+public:
+    /**
+     * Returns a new state for the window function 'name' (e.g., "$sum"), or nullptr if there is no
+     * such window function.
+     */
+    static std::unique_ptr<WindowFunctionState> create(StringData name,
+                                                       ExpressionContext* expCtx);
+
+    virtual ~WindowFunctionState() = default;
+
+    virtual void add(const Value& value) = 0;
+
+    /**
+     * Removes 'value' from the window. It must be the oldest value added and not yet removed.
+     */
+    virtual void remove(const Value& value) = 0;
+
+    virtual Value getValue() const = 0;
+
+    virtual void reset() = 0;
+
+    /**
+     * Returns the memory used by the state, in bytes.
+     */
+    virtual size_t getApproximateSize() const {
+        return 0;
+    }
+
+    /**
+     * Tells the state that the window has no lower bound, so remove() is never called until the
+     * next reset(). States may then keep less of the values they were given.
+     */
+    void setUnboundedBelow() {
+        _unboundedBelow = true;
+    }
+
+protected:
+    bool _unboundedBelow = false;
+};
+
+/**
+ * $sum over the numeric values of the window. Like the $sum accumulator, the result has the widest
+ * numeric type of the values in the window. Infinities and NaNs are counted rather than added, so
+ * that they do not poison the sum once they leave the window.
+ */
+class WindowFunctionSum : public WindowFunctionState {
+public:
+    void add(const Value& value) override;
+    void remove(const Value& value) override;
+    Value getValue() const override;
+    void reset() override;
+
+protected:
+    // The number of numeric values in the window.
+    long long _count = 0;
+
+private:
+    void _update(const Value& value, int sign);
+
+    long long _numLongs = 0;
+    long long _numDoubles = 0;
+    long long _numDecimals = 0;
+    long long _numNaNs = 0;
+    long long _numPosInfs = 0;
+    long long _numNegInfs = 0;
+
+    DoubleDoubleSummation _nonDecimalTotal;
+    Decimal128 _decimalTotal;
+};
+
+/**
+ * $avg over the numeric values of the window, or null if there are none.
+ */
+class WindowFunctionAvg final : public WindowFunctionSum {
+public:
+    Value getValue() const final;
+};
+
+/**
+ * $count of the documents in the window, whatever their value.
+ */
+class WindowFunctionCount final : public WindowFunctionState {
+public:
+    void add(const Value& value) final {
+        ++_count;
+    }
+
+    void remove(const Value& value) final {
+        --_count;
+    }
+
+    Value getValue() const final {
+        return Value::createIntOrLong(_count);
+    }
+
+    void reset() final {
+        _count = 0;
+    }
+
+private:
+    long long _count = 0;
+};
+
+/**
+ * $min or $max over the non-null values of the window, or null if there are none.
+ *
+ * Keeps a monotonic deque of the values which can still become the result as the window slides:
+ * a value is dropped as soon as a better one is added after it, since the better one stays in the
+ * window for longer. The result is always at the front of the deque. A window without a lower
+ * bound never drops its result, so only the best value is kept.
+ */
+class WindowFunctionMinMax final : public WindowFunctionState {
+public:
+    enum class Sense : int { kMin = 1, kMax = -1 };
+
+    WindowFunctionMinMax(Sense sense, const ValueComparator& comparator)
+        : _sense(sense), _comparator(comparator) {}
+
+    void add(const Value& value) final;
+    void remove(const Value& value) final;
+    Value getValue() const final;
+    void reset() final;
+
+    size_t getApproximateSize() const final {
+        return _memUsageBytes;
+    }
+
+private:
+    // Returns whether 'lhs' is a strictly worse result than 'rhs'.
+    bool _isWorse(const Value& lhs, const Value& rhs) const {
+        return _comparator.compare(lhs, rhs) * static_cast<int>(_sense) > 0;
+    }
+
+    const Sense _sense;
+    const ValueComparator _comparator;
+
+    std::deque<Value> _candidates;
+    size_t _memUsageBytes = 0;
+};
+
+}  // namespace mongo
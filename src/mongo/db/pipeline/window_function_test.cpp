@@ -0,0 +1,202 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/window_function.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class WindowFunctionTest : public AggregationContextFixture {
+protected:
+    std::unique_ptr<WindowFunctionState> create(StringData name) {
+        auto state = WindowFunctionState::create(name, getExpCtx().get());
+        ASSERT(state);
+        return state;
+    }
+};
+
+TEST_F(WindowFunctionTest, UnknownFunctionIsNotCreated) {
+    ASSERT_FALSE(WindowFunctionState::create("$push", getExpCtx().get()));
+}
+
+TEST_F(WindowFunctionTest, SumSlidesOverWindow) {
+    auto sum = create("$sum");
+    ASSERT_VALUE_EQ(sum->getValue(), Value(0));
+
+    sum->add(Value(1));
+    sum->add(Value(2));
+    sum->add(Value("not a number"_sd));
+    ASSERT_VALUE_EQ(sum->getValue(), Value(3));
+
+    sum->remove(Value(1));
+    sum->add(Value(4));
+    ASSERT_VALUE_EQ(sum->getValue(), Value(6));
+    ASSERT_EQ(sum->getValue().getType(), NumberInt);
+}
+
+TEST_F(WindowFunctionTest, SumNarrowsBackOnceWiderValuesLeaveWindow) {
+    auto sum = create("$sum");
+    sum->add(Value(1.5));
+    sum->add(Value(2));
+    ASSERT_VALUE_EQ(sum->getValue(), Value(3.5));
+    ASSERT_EQ(sum->getValue().getType(), NumberDouble);
+
+    sum->remove(Value(1.5));
+    ASSERT_VALUE_EQ(sum->getValue(), Value(2));
+    ASSERT_EQ(sum->getValue().getType(), NumberInt);
+}
+
+TEST_F(WindowFunctionTest, SumRecoversOnceNonFiniteValuesLeaveWindow) {
+    auto sum = create("$sum");
+    sum->add(Value(std::numeric_limits<double>::infinity()));
+    sum->add(Value(1.0));
+    ASSERT_VALUE_EQ(sum->getValue(), Value(std::numeric_limits<double>::infinity()));
+
+    sum->add(Value(-std::numeric_limits<double>::infinity()));
+    ASSERT_TRUE(std::isnan(sum->getValue().getDouble()));
+
+    sum->remove(Value(std::numeric_limits<double>::infinity()));
+    sum->remove(Value(1.0));
+    sum->remove(Value(-std::numeric_limits<double>::infinity()));
+    sum->add(Value(2.0));
+    ASSERT_VALUE_EQ(sum->getValue(), Value(2.0));
+}
+
+TEST_F(WindowFunctionTest, SumOfDecimals) {
+    auto sum = create("$sum");
+    sum->add(Value(Decimal128("0.1")));
+    sum->add(Value(1));
+    ASSERT_VALUE_EQ(sum->getValue(), Value(Decimal128("1.1")));
+
+    sum->remove(Value(Decimal128("0.1")));
+    ASSERT_VALUE_EQ(sum->getValue(), Value(1));
+}
+
+TEST_F(WindowFunctionTest, AvgIgnoresNonNumericValues) {
+    auto avg = create("$avg");
+    ASSERT_VALUE_EQ(avg->getValue(), Value(BSONNULL));
+
+    avg->add(Value(1));
+    avg->add(Value(BSONNULL));
+    avg->add(Value(4));
+    ASSERT_VALUE_EQ(avg->getValue(), Value(2.5));
+
+    avg->remove(Value(1));
+    avg->remove(Value(BSONNULL));
+    ASSERT_VALUE_EQ(avg->getValue(), Value(4.0));
+
+    avg->reset();
+    ASSERT_VALUE_EQ(avg->getValue(), Value(BSONNULL));
+}
+
+TEST_F(WindowFunctionTest, CountCountsEveryValue) {
+    auto count = create("$count");
+    count->add(Value());
+    count->add(Value("a"_sd));
+    ASSERT_VALUE_EQ(count->getValue(), Value(2));
+
+    count->remove(Value());
+    ASSERT_VALUE_EQ(count->getValue(), Value(1));
+}
+
+TEST_F(WindowFunctionTest, MinMaxSlideOverWindow) {
+    auto min = create("$min");
+    auto max = create("$max");
+    std::vector<Value> values{Value(3), Value(1), Value(4), Value(1), Value(5), Value(2)};
+
+    // A window of three values.
+    std::vector<int> expectedMins{3, 1, 1, 1, 1, 1};
+    std::vector<int> expectedMaxs{3, 3, 4, 4, 5, 5};
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i >= 3) {
+            min->remove(values[i - 3]);
+            max->remove(values[i - 3]);
+        }
+        min->add(values[i]);
+        max->add(values[i]);
+        ASSERT_VALUE_EQ(min->getValue(), Value(expectedMins[i]));
+        ASSERT_VALUE_EQ(max->getValue(), Value(expectedMaxs[i]));
+    }
+
+    // Only the last value remains.
+    min->remove(values[3]);
+    min->remove(values[4]);
+    max->remove(values[3]);
+    max->remove(values[4]);
+    ASSERT_VALUE_EQ(min->getValue(), Value(2));
+    ASSERT_VALUE_EQ(max->getValue(), Value(2));
+}
+
+TEST_F(WindowFunctionTest, MinMaxKeepEqualValuesUntilEachLeavesWindow) {
+    auto min = create("$min");
+    min->add(Value(1));
+    min->add(Value(1));
+    min->add(Value(2));
+
+    min->remove(Value(1));
+    ASSERT_VALUE_EQ(min->getValue(), Value(1));
+    min->remove(Value(1));
+    ASSERT_VALUE_EQ(min->getValue(), Value(2));
+}
+
+TEST_F(WindowFunctionTest, MinMaxOnlyKeepTheResultWithoutLowerBound) {
+    auto max = create("$max");
+    max->setUnboundedBelow();
+    const Value best(std::string(100, 'z'));
+    max->add(best);
+    for (char c = 'y'; c >= 'a'; --c) {
+        max->add(Value(std::string(100, c)));
+        ASSERT_VALUE_EQ(max->getValue(), best);
+    }
+    ASSERT_EQ(max->getApproximateSize(), best.getApproximateSize());
+
+    max->add(Value(std::string(101, 'z')));
+    ASSERT_VALUE_EQ(max->getValue(), Value(std::string(101, 'z')));
+    ASSERT_EQ(max->getApproximateSize(), Value(std::string(101, 'z')).getApproximateSize());
+}
+
+TEST_F(WindowFunctionTest, MinMaxIgnoreNullishValues) {
+    auto max = create("$max");
+    max->add(Value(BSONNULL));
+    max->add(Value());
+    ASSERT_VALUE_EQ(max->getValue(), Value(BSONNULL));
+
+    max->add(Value(-1));
+    max->remove(Value(BSONNULL));
+    max->remove(Value());
+    ASSERT_VALUE_EQ(max->getValue(), Value(-1));
+}
+
+}  // namespace
+}  // namespace mongo
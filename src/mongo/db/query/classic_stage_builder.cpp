@@ -81,6 +81,8 @@ std::unique_ptr<PlanStage> ClassicStageBuilder::build(const QuerySolutionNode* r
             params.shouldWaitForOplogVisibility = csn->shouldWaitForOplogVisibility;
             params.minTs = csn->minTs;
             params.maxTs = csn->maxTs;
+            params.minRecord = csn->minRecord;
+            params.maxRecord = csn->maxRecord;
             params.requestResumeToken = csn->requestResumeToken;
             params.resumeAfterRecordId = csn->resumeAfterRecordId;
             params.stopApplyingFilterAfterFirstMatch = csn->stopApplyingFilterAfterFirstMatch;
@@ -109,6 +111,7 @@ std::unique_ptr<PlanStage> ClassicStageBuilder::build(const QuerySolutionNode* r
             params.direction = ixn->direction;
             params.addKeyMetadata = ixn->addKeyMetadata;
             params.shouldDedup = ixn->shouldDedup;
+            params.isSkipScan = ixn->isSkipScan;
             return std::make_unique<IndexScan>(
                 expCtx, _collection, std::move(params), _ws, ixn->filter.get());
         }
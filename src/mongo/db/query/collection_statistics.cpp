@@ -0,0 +1,331 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/util/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+// A missing field is indexed as null, so it is sampled as one.
+const BSONObj kNullValue = BSON("" << BSONNULL);
+
+int compareValues(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false);
+}
+
+/**
+ * Appends to 'out' the values of 'path' in 'doc' which an index over 'path' would hold keys for.
+ */
+void extractValues(const BSONObj& doc, StringData path, std::vector<BSONElement>* out) {
+    BSONElementSet elements;
+    dotted_path_support::extractAllElementsAlongPath(doc, path, elements);
+    if (elements.empty()) {
+        out->push_back(kNullValue.firstElement());
+        return;
+    }
+    out->insert(out->end(), elements.begin(), elements.end());
+}
+
+/**
+ * Appends the statistics document of the field 'path' to 'builder'.
+ */
+void buildFieldStatistics(const std::vector<BSONObj>& sample,
+                          const std::string& path,
+                          int numBuckets,
+                          BSONObjBuilder* builder) {
+    std::vector<BSONElement> values;
+    values.reserve(sample.size());
+    for (auto&& doc : sample) {
+        extractValues(doc, path, &values);
+    }
+    std::sort(values.begin(), values.end(), [](const BSONElement& lhs, const BSONElement& rhs) {
+        return compareValues(lhs, rhs) < 0;
+    });
+
+    const double depth =
+        std::max(1.0, std::ceil(static_cast<double>(values.size()) / std::max(numBuckets, 1)));
+
+    long long numDistinct = 0;
+    long long rangeCount = 0;
+    long long rangeDistinct = 0;
+    BSONArrayBuilder buckets(builder->subarrayStart(CollectionStatistics::kBucketsFieldName));
+    for (size_t groupStart = 0; groupStart < values.size();) {
+        size_t groupEnd = groupStart + 1;
+        while (groupEnd < values.size() &&
+               compareValues(values[groupStart], values[groupEnd]) == 0) {
+            ++groupEnd;
+        }
+        const long long groupCount = groupEnd - groupStart;
+        ++numDistinct;
+
+        // A run of equal values never straddles two buckets. It becomes the upper bound of the
+        // current bucket once the bucket holds enough values.
+        if (rangeCount + groupCount >= depth || groupEnd == values.size()) {
+            BSONObjBuilder bucket(buckets.subobjStart());
+            bucket.appendAs(values[groupStart], CollectionStatistics::kUpperBoundFieldName);
+            bucket.append(CollectionStatistics::kEqualCountFieldName, groupCount);
+            bucket.append(CollectionStatistics::kRangeCountFieldName, rangeCount);
+            bucket.append(CollectionStatistics::kRangeDistinctFieldName, rangeDistinct);
+            rangeCount = 0;
+            rangeDistinct = 0;
+        } else {
+            rangeCount += groupCount;
+            ++rangeDistinct;
+        }
+        groupStart = groupEnd;
+    }
+    buckets.doneFast();
+
+    builder->append(CollectionStatistics::kPathFieldName, path);
+    builder->append(CollectionStatistics::kNumValuesFieldName,
+                    static_cast<long long>(values.size()));
+    builder->append(CollectionStatistics::kNumDistinctFieldName, numDistinct);
+}
+
+/**
+ * Returns the fraction of the values strictly between 'lower' and 'upper' which fall within
+ * 'interval', whose start is not greater than its end. An EOO 'lower' stands for the start of the
+ * first bucket.
+ */
+double estimateRangeOverlap(const BSONElement& lower,
+                            const BSONElement& upper,
+                            double rangeDistinct,
+                            const Interval& interval) {
+    if (!lower.eoo() && compareValues(interval.end, lower) <= 0) {
+        return 0;
+    }
+    if (compareValues(interval.start, upper) >= 0) {
+        return 0;
+    }
+
+    const bool coversLower = lower.eoo() ? interval.start.type() == MinKey
+                                         : compareValues(interval.start, lower) <= 0;
+    if (coversLower && compareValues(interval.end, upper) >= 0) {
+        return 1;
+    }
+
+    if (interval.isPoint()) {
+        return 1 / std::max(rangeDistinct, 1.0);
+    }
+
+    // Numbers are spread out evenly between the bounds of the bucket.
+    if (!lower.eoo() && lower.isNumber() && upper.isNumber()) {
+        const double width = upper.numberDouble() - lower.numberDouble();
+        if (width > 0) {
+            const double start =
+                coversLower ? lower.numberDouble() : interval.start.numberDouble();
+            const double end = compareValues(interval.end, upper) >= 0
+                ? upper.numberDouble()
+                : interval.end.numberDouble();
+            return std::min(1.0, std::max(0.0, (end - start) / width));
+        }
+    }
+
+    return 0.5;
+}
+
+Status invalidStatistics(StringData reason) {
+    return Status(ErrorCodes::BadValue,
+                  str::stream() << "Invalid collection statistics document: " << reason);
+}
+
+}  // namespace
+
+constexpr StringData CollectionStatistics::kIdFieldName;
+constexpr StringData CollectionStatistics::kUUIDFieldName;
+constexpr StringData CollectionStatistics::kAnalyzedAtFieldName;
+constexpr StringData CollectionStatistics::kNumRecordsFieldName;
+constexpr StringData CollectionStatistics::kSampleSizeFieldName;
+constexpr StringData CollectionStatistics::kFieldsFieldName;
+constexpr StringData CollectionStatistics::kPathFieldName;
+constexpr StringData CollectionStatistics::kNumValuesFieldName;
+constexpr StringData CollectionStatistics::kNumDistinctFieldName;
+constexpr StringData CollectionStatistics::kBucketsFieldName;
+constexpr StringData CollectionStatistics::kUpperBoundFieldName;
+constexpr StringData CollectionStatistics::kEqualCountFieldName;
+constexpr StringData CollectionStatistics::kRangeCountFieldName;
+constexpr StringData CollectionStatistics::kRangeDistinctFieldName;
+
+double Histogram::estimateCount(const Interval& interval) const {
+    // The intervals over a descending index field run from the greatest to the smallest value.
+    Interval ascending = interval;
+    if (compareValues(ascending.start, ascending.end) > 0) {
+        ascending.reverse();
+    }
+
+    auto contains = [&](const BSONElement& value) {
+        const int startCmp = compareValues(value, ascending.start);
+        const int endCmp = compareValues(value, ascending.end);
+        return (startCmp > 0 || (startCmp == 0 && ascending.startInclusive)) &&
+            (endCmp < 0 || (endCmp == 0 && ascending.endInclusive));
+    };
+
+    double count = 0;
+    BSONElement lower;
+    for (auto&& bucket : buckets) {
+        if (contains(bucket.upperBound)) {
+            count += bucket.equalCount;
+        }
+        if (bucket.rangeCount > 0) {
+            count += bucket.rangeCount *
+                estimateRangeOverlap(lower, bucket.upperBound, bucket.rangeDistinct, ascending);
+        }
+        lower = bucket.upperBound;
+    }
+    return count;
+}
+
+double FieldStatistics::estimateSelectivity(const OrderedIntervalList& oil) const {
+    if (numValues <= 0) {
+        return 1;
+    }
+
+    double count = 0;
+    for (auto&& interval : oil.intervals) {
+        count += histogram.estimateCount(interval);
+    }
+    return std::min(1.0, count / numValues);
+}
+
+NamespaceString CollectionStatistics::makeStatisticsNss(const NamespaceString& nss) {
+    return NamespaceString(nss.db(), NamespaceString::kSystemDotStatisticsCollectionName);
+}
+
+BSONObj CollectionStatistics::build(const NamespaceString& nss,
+                                    const UUID& uuid,
+                                    long long numRecords,
+                                    const std::vector<BSONObj>& sample,
+                                    const std::vector<std::string>& paths,
+                                    int numBuckets) {
+    BSONObjBuilder builder;
+    builder.append(kIdFieldName, nss.coll());
+    uuid.appendToBuilder(&builder, kUUIDFieldName);
+    builder.append(kAnalyzedAtFieldName, jsTime());
+    builder.append(kNumRecordsFieldName, numRecords);
+    builder.append(kSampleSizeFieldName, static_cast<long long>(sample.size()));
+
+    BSONArrayBuilder fields(builder.subarrayStart(kFieldsFieldName));
+    for (auto&& path : paths) {
+        BSONObjBuilder field(fields.subobjStart());
+        buildFieldStatistics(sample, path, numBuckets, &field);
+    }
+    fields.doneFast();
+
+    return builder.obj();
+}
+
+StatusWith<std::shared_ptr<const CollectionStatistics>> CollectionStatistics::parse(
+    const BSONObj& obj) {
+    std::shared_ptr<CollectionStatistics> stats(new CollectionStatistics(obj.getOwned()));
+
+    auto uuid = UUID::parse(stats->_obj[kUUIDFieldName]);
+    if (!uuid.isOK()) {
+        return uuid.getStatus();
+    }
+    stats->_uuid = uuid.getValue();
+
+    const auto numRecords = stats->_obj[kNumRecordsFieldName];
+    if (!numRecords.isNumber()) {
+        return invalidStatistics("'numRecords' must be a number");
+    }
+    stats->_numRecords = numRecords.safeNumberLong();
+
+    const auto fields = stats->_obj[kFieldsFieldName];
+    if (fields.type() != Array) {
+        return invalidStatistics("'fields' must be an array");
+    }
+
+    for (auto&& fieldElt : fields.Obj()) {
+        if (fieldElt.type() != Object) {
+            return invalidStatistics("field statistics must be objects");
+        }
+        const auto fieldObj = fieldElt.Obj();
+
+        FieldStatistics field;
+        const auto path = fieldObj[kPathFieldName];
+        const auto numValues = fieldObj[kNumValuesFieldName];
+        const auto numDistinct = fieldObj[kNumDistinctFieldName];
+        const auto buckets = fieldObj[kBucketsFieldName];
+        if (path.type() != String || !numValues.isNumber() || !numDistinct.isNumber() ||
+            buckets.type() != Array) {
+            return invalidStatistics(str::stream() << "malformed field statistics " << fieldObj);
+        }
+        field.path = path.str();
+        field.numValues = numValues.numberDouble();
+        field.numDistinct = numDistinct.numberDouble();
+
+        for (auto&& bucketElt : buckets.Obj()) {
+            if (bucketElt.type() != Object) {
+                return invalidStatistics("histogram buckets must be objects");
+            }
+            const auto bucketObj = bucketElt.Obj();
+
+            Histogram::Bucket bucket;
+            bucket.upperBound = bucketObj[kUpperBoundFieldName];
+            const auto equalCount = bucketObj[kEqualCountFieldName];
+            const auto rangeCount = bucketObj[kRangeCountFieldName];
+            const auto rangeDistinct = bucketObj[kRangeDistinctFieldName];
+            if (bucket.upperBound.eoo() || !equalCount.isNumber() || !rangeCount.isNumber() ||
+                !rangeDistinct.isNumber()) {
+                return invalidStatistics(str::stream() << "malformed histogram bucket "
+                                                       << bucketObj << " of " << field.path);
+            }
+            if (!field.histogram.buckets.empty() &&
+                compareValues(field.histogram.buckets.back().upperBound, bucket.upperBound) >= 0) {
+                return invalidStatistics(str::stream() << "histogram buckets of " << field.path
+                                                       << " are out of order");
+            }
+            bucket.equalCount = equalCount.numberDouble();
+            bucket.rangeCount = rangeCount.numberDouble();
+            bucket.rangeDistinct = rangeDistinct.numberDouble();
+            field.histogram.buckets.push_back(bucket);
+        }
+
+        stats->_fields[field.path] = std::move(field);
+    }
+
+    return {std::move(stats)};
+}
+
+const FieldStatistics* CollectionStatistics::getField(StringData path) const {
+    auto it = _fields.find(path);
+    return it == _fields.end() ? nullptr : &it->second;
+}
+
+}  // namespace mongo
@@ -0,0 +1,187 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+/**
+ * An equi-depth histogram over the values of one field, built from a sample of the collection.
+ *
+ * Each bucket covers the values greater than the upper bound of the previous bucket and less than
+ * or equal to its own upper bound. The values equal to the upper bound are counted separately from
+ * the ones strictly inside the bucket, so that frequent values are estimated precisely. Values are
+ * ordered by the BSON canonical order using the simple collation.
+ */
+class Histogram {
+public:
+    struct Bucket {
+        // Points into the BSON the histogram was parsed from.
+        BSONElement upperBound;
+
+        // The number of sampled values equal to 'upperBound'.
+        double equalCount = 0;
+
+        // The number and the number of distinct sampled values strictly between the upper bound of
+        // the previous bucket and 'upperBound'.
+        double rangeCount = 0;
+        double rangeDistinct = 0;
+    };
+
+    /**
+     * Returns an estimate of the number of sampled values which fall within 'interval'.
+     */
+    double estimateCount(const Interval& interval) const;
+
+    std::vector<Bucket> buckets;
+};
+
+/**
+ * Statistics about the values of one field of a collection.
+ */
+struct FieldStatistics {
+    /**
+     * Returns the estimated fraction of the field's values which fall within the intervals of
+     * 'oil', between 0 and 1.
+     */
+    double estimateSelectivity(const OrderedIntervalList& oil) const;
+
+    std::string path;
+
+    // The number of values sampled. A missing field counts as a null value, and each element of an
+    // array counts as a separate value, mirroring the keys an index over the field would hold.
+    double numValues = 0;
+
+    // The estimated number of distinct values of the field.
+    double numDistinct = 0;
+
+    Histogram histogram;
+};
+
+/**
+ * The statistics gathered about a collection by the "analyze" command, which the planner uses to
+ * estimate the cost of its candidate plans. They are persisted as one document per collection in
+ * the "system.statistics" collection of the database, of the form:
+ *
+ *    {
+ *        _id: <collection name>,
+ *        uuid: <collection UUID>,
+ *        analyzedAt: <date>,
+ *        numRecords: <number of documents in the collection>,
+ *        sampleSize: <number of documents sampled>,
+ *        fields: [
+ *            {
+ *                path: <dotted field path>,
+ *                numValues: <count>,
+ *                numDistinct: <count>,
+ *                buckets: [{upperBound: <value>, equalCount: <n>, rangeCount: <n>,
+ *                           rangeDistinct: <n>}, ...]
+ *            },
+ *            ...
+ *        ]
+ *    }
+ */
+class CollectionStatistics {
+public:
+    static constexpr StringData kIdFieldName = "_id"_sd;
+    static constexpr StringData kUUIDFieldName = "uuid"_sd;
+    static constexpr StringData kAnalyzedAtFieldName = "analyzedAt"_sd;
+    static constexpr StringData kNumRecordsFieldName = "numRecords"_sd;
+    static constexpr StringData kSampleSizeFieldName = "sampleSize"_sd;
+    static constexpr StringData kFieldsFieldName = "fields"_sd;
+    static constexpr StringData kPathFieldName = "path"_sd;
+    static constexpr StringData kNumValuesFieldName = "numValues"_sd;
+    static constexpr StringData kNumDistinctFieldName = "numDistinct"_sd;
+    static constexpr StringData kBucketsFieldName = "buckets"_sd;
+    static constexpr StringData kUpperBoundFieldName = "upperBound"_sd;
+    static constexpr StringData kEqualCountFieldName = "equalCount"_sd;
+    static constexpr StringData kRangeCountFieldName = "rangeCount"_sd;
+    static constexpr StringData kRangeDistinctFieldName = "rangeDistinct"_sd;
+
+    /**
+     * Returns the namespace of the collection holding the statistics of the collections of 'nss's
+     * database.
+     */
+    static NamespaceString makeStatisticsNss(const NamespaceString& nss);
+
+    /**
+     * Builds the statistics document for the collection 'nss', which holds 'numRecords' documents,
+     * out of the documents in 'sample'. Each of 'paths' gets a histogram with at most 'numBuckets'
+     * buckets.
+     */
+    static BSONObj build(const NamespaceString& nss,
+                         const UUID& uuid,
+                         long long numRecords,
+                         const std::vector<BSONObj>& sample,
+                         const std::vector<std::string>& paths,
+                         int numBuckets);
+
+    /**
+     * Parses a statistics document produced by build().
+     */
+    static StatusWith<std::shared_ptr<const CollectionStatistics>> parse(const BSONObj& obj);
+
+    const UUID& uuid() const {
+        return *_uuid;
+    }
+
+    long long numRecords() const {
+        return _numRecords;
+    }
+
+    /**
+     * Returns the statistics for the field 'path', or nullptr if it was not analyzed.
+     */
+    const FieldStatistics* getField(StringData path) const;
+
+private:
+    explicit CollectionStatistics(BSONObj obj) : _obj(std::move(obj)) {}
+
+    // Owns the memory which the histogram bounds point into.
+    BSONObj _obj;
+
+    boost::optional<UUID> _uuid;
+    long long _numRecords = 0;
+    StringMap<FieldStatistics> _fields;
+};
+
+}  // namespace mongo
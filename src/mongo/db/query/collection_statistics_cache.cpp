@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics_cache.h"
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/service_context.h"
+#include "mongo/logv2/log.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getCollectionStatisticsCache =
+    ServiceContext::declareDecoration<CollectionStatisticsCache>();
+
+}  // namespace
+
+CollectionStatisticsCache& CollectionStatisticsCache::get(ServiceContext* serviceContext) {
+    return getCollectionStatisticsCache(serviceContext);
+}
+
+CollectionStatisticsCache& CollectionStatisticsCache::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+std::shared_ptr<const CollectionStatistics> CollectionStatisticsCache::get(
+    const NamespaceString& nss, const UUID& uuid) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _entries.find(nss);
+    if (it == _entries.end() || !it->second.stats || it->second.stats->uuid() != uuid) {
+        return nullptr;
+    }
+    return it->second.stats;
+}
+
+void CollectionStatisticsCache::onWrite(OperationContext* opCtx,
+                                        const NamespaceString& statsNss,
+                                        const BSONObj& statsDoc) {
+    auto idElem = statsDoc[CollectionStatistics::kIdFieldName];
+    if (idElem.type() != BSONType::String ||
+        !NamespaceString::validCollectionName(idElem.valueStringData())) {
+        return;
+    }
+    NamespaceString nss(statsNss.db(), idElem.valueStringData());
+
+    // Parse now rather than on commit, as the document is only guaranteed to be valid until then.
+    auto swStats = CollectionStatistics::parse(statsDoc.getOwned());
+    std::shared_ptr<const CollectionStatistics> stats;
+    if (swStats.isOK()) {
+        stats = std::move(swStats.getValue());
+    } else {
+        LOGV2_WARNING(4917701,
+                      "Ignoring invalid collection statistics",
+                      "namespace"_attr = nss,
+                      "error"_attr = swStats.getStatus());
+    }
+
+    opCtx->recoveryUnit()->onCommit(
+        [this, nss = std::move(nss), stats = std::move(stats)](boost::optional<Timestamp> ts) {
+            _set(nss, std::move(stats), ts);
+        });
+}
+
+void CollectionStatisticsCache::onDelete(OperationContext* opCtx,
+                                         const NamespaceString& statsNss,
+                                         const BSONElement& statsId) {
+    if (statsId.type() != BSONType::String ||
+        !NamespaceString::validCollectionName(statsId.valueStringData())) {
+        return;
+    }
+    opCtx->recoveryUnit()->onCommit(
+        [this, nss = NamespaceString(statsNss.db(), statsId.valueStringData())](
+            boost::optional<Timestamp> ts) { _set(nss, nullptr, ts); });
+}
+
+void CollectionStatisticsCache::onDrop(OperationContext* opCtx, const NamespaceString& statsNss) {
+    opCtx->recoveryUnit()->onCommit([this, db = statsNss.db().toString()](auto) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        auto it = _entries.lower_bound(NamespaceString(db, ""));
+        while (it != _entries.end() && it->first.db() == db) {
+            it = _entries.erase(it);
+        }
+    });
+}
+
+void CollectionStatisticsCache::clear() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _entries.clear();
+}
+
+void CollectionStatisticsCache::_set(const NamespaceString& nss,
+                                     std::shared_ptr<const CollectionStatistics> stats,
+                                     boost::optional<Timestamp> commitTime) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto& entry = _entries[nss];
+    if (commitTime) {
+        if (*commitTime < entry.commitTime) {
+            return;
+        }
+        entry.commitTime = *commitTime;
+    }
+    entry.stats = std::move(stats);
+}
+
+}  // namespace mongo
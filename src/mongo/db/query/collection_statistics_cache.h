@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <map>
+#include <memory>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class CollectionStatistics;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Holds in memory the statistics persisted by the "analyze" command, so that the planner never
+ * reads the "system.statistics" collections. The op observer keeps it up to date with every write
+ * to those collections, including the ones which oplog application performs on secondaries.
+ *
+ * The cache starts empty: after a restart, a collection is planned without statistics until its
+ * statistics document is written again, for example by running "analyze" once more.
+ */
+class CollectionStatisticsCache {
+public:
+    static CollectionStatisticsCache& get(ServiceContext* serviceContext);
+    static CollectionStatisticsCache& get(OperationContext* opCtx);
+
+    /**
+     * Returns the statistics of 'nss', or nullptr if there are none for the collection 'uuid'.
+     * Statistics left behind by a dropped collection of the same name are ignored.
+     */
+    std::shared_ptr<const CollectionStatistics> get(const NamespaceString& nss,
+                                                    const UUID& uuid) const;
+
+    /**
+     * Caches the statistics document 'statsDoc', inserted or updated in 'statsNss', once the
+     * current write commits.
+     */
+    void onWrite(OperationContext* opCtx,
+                 const NamespaceString& statsNss,
+                 const BSONObj& statsDoc);
+
+    /**
+     * Forgets the statistics whose document, of _id 'statsId', is deleted from 'statsNss', once
+     * the current write commits.
+     */
+    void onDelete(OperationContext* opCtx,
+                  const NamespaceString& statsNss,
+                  const BSONElement& statsId);
+
+    /**
+     * Forgets the statistics of every collection of the database of 'statsNss' once its drop
+     * commits.
+     */
+    void onDrop(OperationContext* opCtx, const NamespaceString& statsNss);
+
+    /**
+     * Forgets all statistics, which a rollback may have changed.
+     */
+    void clear();
+
+private:
+    struct Entry {
+        // nullptr once the statistics document is deleted or turns out to be invalid.
+        std::shared_ptr<const CollectionStatistics> stats;
+
+        // The commit time of the write which produced 'stats', so that writes whose commit
+        // handlers run out of order cannot install older statistics over newer ones.
+        Timestamp commitTime;
+    };
+
+    void _set(const NamespaceString& nss,
+              std::shared_ptr<const CollectionStatistics> stats,
+              boost::optional<Timestamp> commitTime);
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("CollectionStatisticsCache::_mutex");
+
+    // Ordered so that the entries of a database are contiguous.
+    std::map<NamespaceString, Entry> _entries;
+};
+
+}  // namespace mongo
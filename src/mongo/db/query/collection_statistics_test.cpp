@@ -0,0 +1,222 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/collection_statistics_cache.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.coll");
+
+std::shared_ptr<const CollectionStatistics> buildStatistics(const std::vector<BSONObj>& sample,
+                                                            const std::vector<std::string>& paths,
+                                                            int numBuckets) {
+    auto obj = CollectionStatistics::build(
+        kNss, UUID::gen(), static_cast<long long>(sample.size()), sample, paths, numBuckets);
+    return uassertStatusOK(CollectionStatistics::parse(obj));
+}
+
+std::vector<BSONObj> makeSequence(int count) {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < count; ++i) {
+        sample.push_back(BSON("a" << i));
+    }
+    return sample;
+}
+
+OrderedIntervalList makeOil(StringData field, std::vector<Interval> intervals) {
+    OrderedIntervalList oil(field.toString());
+    oil.intervals = std::move(intervals);
+    return oil;
+}
+
+TEST(CollectionStatisticsTest, StatisticsNamespaceIsInSameDatabase) {
+    auto statsNss = CollectionStatistics::makeStatisticsNss(kNss);
+    ASSERT_EQ(statsNss.ns(), "test.system.statistics");
+    ASSERT_TRUE(statsNss.isSystemDotStatistics());
+    ASSERT_FALSE(kNss.isSystemDotStatistics());
+}
+
+TEST(CollectionStatisticsTest, BuildRecordsCollectionAndFieldCounts) {
+    auto uuid = UUID::gen();
+    auto obj = CollectionStatistics::build(kNss, uuid, 1000, makeSequence(100), {"a"}, 10);
+    ASSERT_EQ(obj["_id"].str(), "coll");
+    ASSERT_EQ(obj["numRecords"].numberLong(), 1000);
+    ASSERT_EQ(obj["sampleSize"].numberLong(), 100);
+
+    auto stats = uassertStatusOK(CollectionStatistics::parse(obj));
+    ASSERT_EQ(stats->uuid(), uuid);
+    ASSERT_EQ(stats->numRecords(), 1000);
+    ASSERT_FALSE(stats->getField("b"));
+
+    auto field = stats->getField("a");
+    ASSERT(field);
+    ASSERT_EQ(field->numValues, 100);
+    ASSERT_EQ(field->numDistinct, 100);
+    ASSERT_EQ(field->histogram.buckets.size(), 10U);
+    ASSERT_EQ(field->histogram.buckets.back().upperBound.numberInt(), 99);
+}
+
+TEST(CollectionStatisticsTest, EstimatesPointInterval) {
+    auto stats = buildStatistics(makeSequence(100), {"a"}, 10);
+    auto field = stats->getField("a");
+    Interval point(BSON("" << 5 << "" << 5), true, true);
+    ASSERT_APPROX_EQUAL(field->histogram.estimateCount(point), 1, 0.01);
+    ASSERT_APPROX_EQUAL(field->estimateSelectivity(makeOil("a", {point})), 0.01, 0.001);
+}
+
+TEST(CollectionStatisticsTest, EstimatesNumericRange) {
+    auto stats = buildStatistics(makeSequence(100), {"a"}, 10);
+    auto field = stats->getField("a");
+    Interval range(BSON("" << 10 << "" << 30), true, false);
+    ASSERT_APPROX_EQUAL(field->histogram.estimateCount(range), 20, 1);
+
+    // A descending index scans the same interval from its end to its start.
+    Interval reversed(BSON("" << 30 << "" << 10), false, true);
+    ASSERT_APPROX_EQUAL(field->histogram.estimateCount(reversed), 20, 1);
+}
+
+TEST(CollectionStatisticsTest, EstimatesAllValues) {
+    auto stats = buildStatistics(makeSequence(100), {"a"}, 10);
+    auto field = stats->getField("a");
+    BSONObjBuilder bob;
+    bob.appendMinKey("");
+    bob.appendMaxKey("");
+    auto oil = makeOil("a", {Interval(bob.obj(), true, true)});
+    ASSERT_APPROX_EQUAL(field->estimateSelectivity(oil), 1, 0.001);
+}
+
+TEST(CollectionStatisticsTest, EstimatesFrequentValueExactly) {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < 50; ++i) {
+        sample.push_back(BSON("a" << 7));
+        sample.push_back(BSON("a" << 100 + i));
+    }
+    auto stats = buildStatistics(sample, {"a"}, 10);
+    auto field = stats->getField("a");
+    ASSERT_EQ(field->numDistinct, 51);
+    ASSERT_EQ(field->histogram.estimateCount(Interval(BSON("" << 7 << "" << 7), true, true)), 50);
+}
+
+TEST(CollectionStatisticsTest, MissingFieldCountsAsNull) {
+    std::vector<BSONObj> sample = {BSONObj(), BSON("b" << 1), BSON("a" << 1)};
+    auto stats = buildStatistics(sample, {"a"}, 10);
+    auto field = stats->getField("a");
+    ASSERT_EQ(field->numValues, 3);
+    ASSERT_EQ(field->numDistinct, 2);
+    Interval null(BSON("" << BSONNULL << "" << BSONNULL), true, true);
+    ASSERT_EQ(field->histogram.estimateCount(null), 2);
+}
+
+TEST(CollectionStatisticsTest, ArrayElementsCountSeparately) {
+    std::vector<BSONObj> sample = {BSON("a" << BSON_ARRAY(1 << 2 << 3)),
+                                   BSON("a" << BSON_ARRAY(BSON("b" << 4) << BSON("b" << 4)))};
+    auto stats = buildStatistics(sample, {"a", "a.b"}, 10);
+    ASSERT_EQ(stats->getField("a")->numValues, 5);
+    ASSERT_EQ(stats->getField("a.b")->numValues, 1);
+}
+
+TEST(CollectionStatisticsTest, ParseRejectsMalformedDocuments) {
+    auto obj = CollectionStatistics::build(kNss, UUID::gen(), 100, makeSequence(100), {"a"}, 10);
+    ASSERT_OK(CollectionStatistics::parse(obj).getStatus());
+
+    ASSERT_NOT_OK(CollectionStatistics::parse(obj.removeField("uuid")).getStatus());
+    ASSERT_NOT_OK(CollectionStatistics::parse(obj.removeField("numRecords")).getStatus());
+    ASSERT_NOT_OK(CollectionStatistics::parse(obj.removeField("fields")).getStatus());
+
+    BSONObjBuilder outOfOrder;
+    outOfOrder.appendElements(obj.removeField("fields"));
+    outOfOrder.append("fields",
+                      BSON_ARRAY(BSON("path"
+                                      << "a"
+                                      << "numValues" << 2 << "numDistinct" << 2 << "buckets"
+                                      << BSON_ARRAY(BSON("upperBound" << 2 << "equalCount" << 1
+                                                                      << "rangeCount" << 0
+                                                                      << "rangeDistinct" << 0)
+                                                    << BSON("upperBound" << 1 << "equalCount" << 1
+                                                                         << "rangeCount" << 0
+                                                                         << "rangeDistinct"
+                                                                         << 0)))));
+    ASSERT_NOT_OK(CollectionStatistics::parse(outOfOrder.obj()).getStatus());
+}
+
+TEST(CollectionStatisticsCacheTest, FollowsCommittedWritesToStatistics) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto& cache = CollectionStatisticsCache::get(opCtx.get());
+    const auto statsNss = CollectionStatistics::makeStatisticsNss(kNss);
+    const auto uuid = UUID::gen();
+    const auto obj = CollectionStatistics::build(kNss, uuid, 10, makeSequence(10), {"a"}, 4);
+
+    // Nothing is cached until the write commits.
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        cache.onWrite(opCtx.get(), statsNss, obj);
+        ASSERT_FALSE(cache.get(kNss, uuid));
+    }
+    ASSERT_FALSE(cache.get(kNss, uuid));
+
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        cache.onWrite(opCtx.get(), statsNss, obj);
+        wuow.commit();
+    }
+    auto stats = cache.get(kNss, uuid);
+    ASSERT(stats);
+    ASSERT_EQ(stats->numRecords(), 10);
+
+    // Statistics of a dropped collection of the same name are ignored.
+    ASSERT_FALSE(cache.get(kNss, UUID::gen()));
+
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        cache.onDelete(opCtx.get(), statsNss, obj[CollectionStatistics::kIdFieldName]);
+        wuow.commit();
+    }
+    ASSERT_FALSE(cache.get(kNss, uuid));
+
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        cache.onWrite(opCtx.get(), statsNss, obj);
+        cache.onDrop(opCtx.get(), statsNss);
+        wuow.commit();
+    }
+    ASSERT_FALSE(cache.get(kNss, uuid));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -313,6 +313,12 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (spec->maxTs) {
             bob->append("maxTs", *(spec->maxTs));
         }
+        if (spec->minRecord) {
+            bob->append("minRecord", spec->minRecord->repr());
+        }
+        if (spec->maxRecord) {
+            bob->append("maxRecord", spec->maxRecord->repr());
+        }
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsTested);
         }
@@ -439,6 +445,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         bob->appendBool("isPartial", spec->isPartial);
         bob->append("indexVersion", spec->indexVersion);
         bob->append("direction", spec->direction > 0 ? "forward" : "backward");
+        if (spec->isSkipScan) {
+            bob->appendBool("isSkipScan", true);
+        }
 
         if ((topLevelBob->len() + spec->indexBounds.objsize()) > kMaxStatsBSONSize) {
             bob->append("warning", "index bounds omitted due to BSON size limit");
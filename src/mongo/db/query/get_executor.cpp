@@ -67,10 +67,13 @@
 #include "mongo/db/query/canonical_query_encoder.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/collection_query_info.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/collection_statistics_cache.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cost_model.h"
 #include "mongo/db/query/plan_executor_factory.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
@@ -94,6 +97,7 @@
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/query_shape_stats.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/logv2/log.h"
 #include "mongo/scripting/engine.h"
@@ -323,12 +327,20 @@ void fillOutPlannerParams(OperationContext* opCtx,
         plannerParams->options |= QueryPlannerParams::GENERATE_COVERED_IXSCANS;
     }
 
+    if (internalQueryPlannerGenerateIndexSkipScans.load()) {
+        plannerParams->options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    }
+
     plannerParams->options |= QueryPlannerParams::SPLIT_LIMITED_SORT;
 
     if (shouldWaitForOplogVisibility(
             opCtx, collection, canonicalQuery->getQueryRequest().isTailable())) {
         plannerParams->options |= QueryPlannerParams::OPLOG_SCAN_WAIT_FOR_VISIBLE;
     }
+
+    if (collection->isClustered()) {
+        plannerParams->options |= QueryPlannerParams::CLUSTERED_COLLECTION;
+    }
 }
 
 bool shouldWaitForOplogVisibility(OperationContext* opCtx,
@@ -577,6 +589,7 @@ public:
                 canonical_query_encoder::computeHash(planCacheKey.getStableKeyStringData());
             CurOp::get(_opCtx)->debug().planCacheKey =
                 canonical_query_encoder::computeHash(planCacheKey.toString());
+            registerQueryShape(planCacheKey);
 
             // Try to look up a cached solution for the query.
             if (auto cs = CollectionQueryInfo::get(_collection)
@@ -642,6 +655,26 @@ public:
             }
         }
 
+        // Discard the candidates which the collection statistics show to be far more expensive than
+        // the best one, so that the trial period does not have to run them. The statistics are
+        // ordered by the simple collation, so they cannot be used with any other.
+        if (solutions.size() > 1 && internalQueryPlannerEnableCostBasedPruning.load() &&
+            !_cq->getCollator()) {
+            if (auto stats = CollectionStatisticsCache::get(_opCtx).get(_collection->ns(),
+                                                                        _collection->uuid())) {
+                const auto numPruned = plan_cost_model::pruneSolutions(
+                    *stats, internalQueryPlannerCostPruningRatio.load(), &solutions);
+                if (numPruned > 0) {
+                    LOGV2_DEBUG(4917702,
+                                2,
+                                "Pruned candidate plans using collection statistics",
+                                "query"_attr = redact(_cq->toStringShort()),
+                                "numPruned"_attr = numPruned,
+                                "numRemaining"_attr = solutions.size());
+                }
+            }
+        }
+
         if (1 == solutions.size()) {
             auto result = makeResult();
             // Only one possible plan. Run it. Build the stages from the solution.
@@ -672,6 +705,28 @@ protected:
         return std::make_unique<ResultType>();
     }
 
+    /**
+     * Attaches the runtime statistics of the shape identified by 'planCacheKey' to the operation,
+     * unless it already tracks the shape of another query, e.g. the outer query of a $lookup. Must
+     * be called after the operation's 'queryHash' is filled in.
+     */
+    void registerQueryShape(const PlanCacheKey& planCacheKey) {
+        auto& opDebug = CurOp::get(_opCtx)->debug();
+        if (!internalQueryShapeStatsEnabled.load() || opDebug.queryShapeStats) {
+            return;
+        }
+
+        const auto& qr = _cq->getQueryRequest();
+        opDebug.queryShapeStats =
+            QueryShapeStatsStore::get(_opCtx->getServiceContext())
+                .getOrCreate(_cq->nss(),
+                             planCacheKey.getStableKeyStringData(),
+                             *opDebug.queryHash,
+                             qr.getFilter(),
+                             qr.getSort(),
+                             qr.getProj());
+    }
+
     /**
      * Constructs a PlanStage tree from the given query 'solution'.
      */
@@ -854,15 +909,29 @@ protected:
         std::vector<std::unique_ptr<QuerySolution>> solutions,
         const QueryPlannerParams& plannerParams) final {
         // Many solutions. Create a MultiPlanStage to pick the best, update the cache,
-        // and so on. The working set will be shared by all candidate plans.
+        // and so on. The working set will be shared by all candidate plans, unless they are to be
+        // worked concurrently, in which case each gets a working set of its own.
         auto multiPlanStage =
             std::make_unique<MultiPlanStage>(_cq->getExpCtxRaw(), _collection, _cq);
+        const bool workPlansInParallel =
+            MultiPlanStage::canWorkPlansInParallel(_opCtx, *_cq, solutions);
 
         for (size_t ix = 0; ix < solutions.size(); ++ix) {
             if (solutions[ix]->cacheData.get()) {
                 solutions[ix]->cacheData->indexFilterApplied = plannerParams.indexFiltersApplied;
             }
 
+            if (workPlansInParallel) {
+                auto candidateWs = std::make_unique<WorkingSet>();
+                auto nextPlanRoot = stage_builder::buildClassicExecutableTree(
+                    _opCtx, _collection, *_cq, *solutions[ix], candidateWs.get());
+                multiPlanStage->addPlan(std::move(solutions[ix]),
+                                        std::move(nextPlanRoot),
+                                        _ws,
+                                        std::move(candidateWs));
+                continue;
+            }
+
             auto&& nextPlanRoot = buildExecutableTree(*solutions[ix]);
 
             // Takes ownership of 'nextPlanRoot'.
@@ -1088,7 +1157,9 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutor(
     std::unique_ptr<CanonicalQuery> canonicalQuery,
     PlanYieldPolicy::YieldPolicy yieldPolicy,
     size_t plannerOptions) {
-    return internalQueryEnableSlotBasedExecutionEngine.load()
+    // SBE scans carry RecordIds as 64-bit integers, which those of clustered collections are not.
+    return internalQueryEnableSlotBasedExecutionEngine.load() &&
+            !(collection && collection->isClustered())
         ? getSlotBasedExecutor(
               opCtx, collection, std::move(canonicalQuery), yieldPolicy, plannerOptions)
         : getClassicExecutor(
@@ -0,0 +1,239 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cost_model.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/query/collection_statistics.h"
+
+namespace mongo {
+namespace plan_cost_model {
+namespace {
+
+// The cost of positioning an index cursor on a new key.
+constexpr double kSeekCost = 1.0;
+
+// The cost of examining the next index key.
+constexpr double kIndexKeyCost = 0.5;
+
+// The cost of fetching a document by its RecordId, which is a random read.
+constexpr double kFetchCost = 2.0;
+
+// The cost of one comparison made by a blocking sort.
+constexpr double kSortComparisonCost = 0.1;
+
+struct Estimate {
+    double cost = 0;
+
+    // The number of results the subtree produces.
+    double numOutput = 0;
+
+    // Whether the subtree has to consume all of its input before producing its first result.
+    bool blocking = false;
+};
+
+bool isAllValues(const OrderedIntervalList& oil) {
+    return oil.intervals.size() == 1 &&
+        (oil.intervals[0].isMinToMax() || oil.intervals[0].isMaxToMin());
+}
+
+bool isPointList(const OrderedIntervalList& oil) {
+    return std::all_of(oil.intervals.begin(), oil.intervals.end(), [](const Interval& interval) {
+        return interval.isPoint();
+    });
+}
+
+boost::optional<Estimate> estimateIndexScan(const IndexScanNode* node,
+                                            const CollectionStatistics& stats) {
+    // Index keys are compared using the index's collation, but the histograms use the simple one.
+    if (node->index.collator || node->bounds.isSimpleRange) {
+        return boost::none;
+    }
+
+    const double numRecords = stats.numRecords();
+    double keysSelectivity = 1;
+    double outputSelectivity = 1;
+    double numSeeks = 1;
+    bool pastPointPrefix = false;
+    for (auto&& oil : node->bounds.fields) {
+        if (isAllValues(oil)) {
+            pastPointPrefix = true;
+            continue;
+        }
+
+        const auto* field = stats.getField(oil.name);
+        if (!field) {
+            return boost::none;
+        }
+
+        const double selectivity = field->estimateSelectivity(oil);
+        outputSelectivity *= selectivity;
+        if (!pastPointPrefix) {
+            // The keys within the bounds of a prefix of point intervals are contiguous, so each
+            // combination of the intervals costs one seek.
+            keysSelectivity *= selectivity;
+            numSeeks *= oil.intervals.size();
+            pastPointPrefix = !isPointList(oil);
+        }
+    }
+
+    if (node->isSkipScan) {
+        // A skip scan seeks once per distinct value of its leading field and only examines the keys
+        // within the bounds of the later fields.
+        const auto* leading = stats.getField(node->bounds.fields[0].name);
+        if (!leading) {
+            return boost::none;
+        }
+        keysSelectivity = outputSelectivity;
+        numSeeks = std::max(leading->numDistinct, 1.0);
+    }
+
+    Estimate estimate;
+    estimate.numOutput = numRecords * outputSelectivity;
+    estimate.cost = numSeeks * kSeekCost + numRecords * keysSelectivity * kIndexKeyCost;
+    return estimate;
+}
+
+boost::optional<Estimate> estimate(const QuerySolutionNode* node,
+                                   const CollectionStatistics& stats) {
+    std::vector<Estimate> children;
+    for (auto&& child : node->children) {
+        auto childEstimate = estimate(child, stats);
+        if (!childEstimate) {
+            return boost::none;
+        }
+        children.push_back(*childEstimate);
+    }
+
+    switch (node->getType()) {
+        case STAGE_COLLSCAN: {
+            Estimate result;
+            result.numOutput = stats.numRecords();
+            result.cost = result.numOutput;
+            return result;
+        }
+        case STAGE_IXSCAN:
+            return estimateIndexScan(static_cast<const IndexScanNode*>(node), stats);
+        case STAGE_FETCH: {
+            Estimate result = children[0];
+            result.cost += result.numOutput * kFetchCost;
+            return result;
+        }
+        case STAGE_SORT_DEFAULT:
+        case STAGE_SORT_SIMPLE: {
+            Estimate result = children[0];
+            result.cost += result.numOutput * std::log2(result.numOutput + 1) * kSortComparisonCost;
+            result.blocking = true;
+            if (const auto limit = static_cast<const SortNode*>(node)->limit) {
+                result.numOutput = std::min(result.numOutput, static_cast<double>(limit));
+            }
+            return result;
+        }
+        case STAGE_LIMIT: {
+            Estimate result = children[0];
+            const double limit = static_cast<const LimitNode*>(node)->limit;
+            if (!result.blocking && result.numOutput > limit) {
+                // A streaming plan stops doing work once it has produced enough results.
+                result.cost *= limit / result.numOutput;
+            }
+            result.numOutput = std::min(result.numOutput, limit);
+            return result;
+        }
+        case STAGE_AND_HASH:
+        case STAGE_AND_SORTED: {
+            Estimate result;
+            result.numOutput = children[0].numOutput;
+            for (auto&& child : children) {
+                result.cost += child.cost;
+                result.numOutput = std::min(result.numOutput, child.numOutput);
+            }
+            result.blocking = node->getType() == STAGE_AND_HASH;
+            return result;
+        }
+        case STAGE_OR:
+        case STAGE_SORT_MERGE: {
+            Estimate result;
+            for (auto&& child : children) {
+                result.cost += child.cost;
+                result.numOutput += child.numOutput;
+                result.blocking = result.blocking || child.blocking;
+            }
+            return result;
+        }
+        default:
+            // Stages such as projections and shard filters do negligible work per result, but
+            // the work of other leaf stages cannot be estimated from the statistics.
+            if (children.size() == 1) {
+                return children[0];
+            }
+            return boost::none;
+    }
+}
+
+}  // namespace
+
+boost::optional<double> estimateCost(const QuerySolution& solution,
+                                     const CollectionStatistics& stats) {
+    if (auto result = estimate(solution.root.get(), stats)) {
+        return result->cost;
+    }
+    return boost::none;
+}
+
+size_t pruneSolutions(const CollectionStatistics& stats,
+                      double maxCostRatio,
+                      std::vector<std::unique_ptr<QuerySolution>>* solutions) {
+    std::vector<double> costs;
+    for (auto&& solution : *solutions) {
+        auto cost = estimateCost(*solution, stats);
+        if (!cost) {
+            return 0;
+        }
+        costs.push_back(*cost);
+    }
+
+    const double maxCost = *std::min_element(costs.begin(), costs.end()) * maxCostRatio;
+    size_t numKept = 0;
+    for (size_t i = 0; i < solutions->size(); ++i) {
+        if (costs[i] <= maxCost) {
+            (*solutions)[numKept++] = std::move((*solutions)[i]);
+        }
+    }
+
+    const size_t numPruned = solutions->size() - numKept;
+    solutions->resize(numKept);
+    return numPruned;
+}
+
+}  // namespace plan_cost_model
+}  // namespace mongo
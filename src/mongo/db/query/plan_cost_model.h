@@ -0,0 +1,68 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+
+class CollectionStatistics;
+
+/**
+ * A cost model which estimates the work a candidate plan does from the statistics gathered by the
+ * "analyze" command, so that plans which are clearly worse than another candidate can be discarded
+ * without trial running them.
+ *
+ * The cost is expressed in units of reading one document during a collection scan.
+ */
+namespace plan_cost_model {
+
+/**
+ * Returns the estimated cost of executing 'solution', or boost::none if it cannot be estimated,
+ * e.g. because 'stats' do not cover the fields its index bounds constrain.
+ */
+boost::optional<double> estimateCost(const QuerySolution& solution,
+                                     const CollectionStatistics& stats);
+
+/**
+ * Removes the solutions whose estimated cost is more than 'maxCostRatio' times the cost of the
+ * cheapest solution from 'solutions', and returns how many were removed. Keeps all of the
+ * solutions if the cost of any of them cannot be estimated.
+ */
+size_t pruneSolutions(const CollectionStatistics& stats,
+                      double maxCostRatio,
+                      std::vector<std::unique_ptr<QuerySolution>>* solutions);
+
+}  // namespace plan_cost_model
+}  // namespace mongo
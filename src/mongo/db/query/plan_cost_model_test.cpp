@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cost_model.h"
+
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/index_entry.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+IndexEntry buildSimpleIndexEntry(const BSONObj& kp, const CollatorInterface* collator = nullptr) {
+    return {kp,
+            IndexNames::nameToType(IndexNames::findPluginName(kp)),
+            false,
+            {},
+            {},
+            false,
+            false,
+            CoreIndexInfo::Identifier("test_foo"),
+            nullptr,
+            {},
+            collator,
+            nullptr};
+}
+
+/**
+ * Returns statistics for a collection of 1000 documents where 'a' is unique and 'b' takes two
+ * values.
+ */
+std::shared_ptr<const CollectionStatistics> makeStatistics() {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < 1000; ++i) {
+        sample.push_back(BSON("a" << i << "b" << i % 2));
+    }
+    auto obj = CollectionStatistics::build(
+        NamespaceString("test.coll"), UUID::gen(), 1000, sample, {"a", "b"}, 100);
+    return uassertStatusOK(CollectionStatistics::parse(obj));
+}
+
+std::unique_ptr<IndexScanNode> makePointScan(StringData field,
+                                             int value,
+                                             const CollatorInterface* collator = nullptr) {
+    auto ixscan =
+        std::make_unique<IndexScanNode>(buildSimpleIndexEntry(BSON(field << 1), collator));
+    OrderedIntervalList oil(field.toString());
+    oil.intervals.push_back(Interval(BSON("" << value << "" << value), true, true));
+    ixscan->bounds.fields.push_back(oil);
+    return ixscan;
+}
+
+std::unique_ptr<QuerySolution> makeSolution(std::unique_ptr<QuerySolutionNode> root) {
+    auto soln = std::make_unique<QuerySolution>();
+    soln->root = std::move(root);
+    return soln;
+}
+
+std::unique_ptr<QuerySolution> makeFetchSolution(std::unique_ptr<QuerySolutionNode> child) {
+    auto fetch = std::make_unique<FetchNode>();
+    fetch->children.push_back(child.release());
+    return makeSolution(std::move(fetch));
+}
+
+TEST(PlanCostModelTest, SelectiveIndexScanIsCheaperThanCollectionScan) {
+    auto stats = makeStatistics();
+    auto ixscanCost = plan_cost_model::estimateCost(*makeFetchSolution(makePointScan("a", 5)),
+                                                    *stats);
+    auto collscanCost = plan_cost_model::estimateCost(
+        *makeSolution(std::make_unique<CollectionScanNode>()), *stats);
+    ASSERT(ixscanCost);
+    ASSERT(collscanCost);
+    ASSERT_EQ(*collscanCost, 1000);
+    ASSERT_LT(*ixscanCost, 10);
+}
+
+TEST(PlanCostModelTest, UnselectiveIndexScanIsMoreExpensiveThanCollectionScan) {
+    auto stats = makeStatistics();
+    auto ixscanCost = plan_cost_model::estimateCost(*makeFetchSolution(makePointScan("b", 1)),
+                                                    *stats);
+    ASSERT(ixscanCost);
+    ASSERT_GT(*ixscanCost, 1000);
+}
+
+TEST(PlanCostModelTest, LimitReducesCostOfStreamingPlan) {
+    auto stats = makeStatistics();
+    auto limit = std::make_unique<LimitNode>();
+    limit->limit = 10;
+    limit->children.push_back(new CollectionScanNode());
+    auto cost = plan_cost_model::estimateCost(*makeSolution(std::move(limit)), *stats);
+    ASSERT(cost);
+    ASSERT_EQ(*cost, 10);
+}
+
+TEST(PlanCostModelTest, CannotEstimateFieldWithoutStatistics) {
+    auto stats = makeStatistics();
+    ASSERT_FALSE(
+        plan_cost_model::estimateCost(*makeFetchSolution(makePointScan("c", 1)), *stats));
+}
+
+TEST(PlanCostModelTest, CannotEstimateIndexWithCollation) {
+    auto stats = makeStatistics();
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    ASSERT_FALSE(plan_cost_model::estimateCost(
+        *makeFetchSolution(makePointScan("a", 5, &collator)), *stats));
+}
+
+TEST(PlanCostModelTest, PrunesSolutionsMuchMoreExpensiveThanCheapest) {
+    auto stats = makeStatistics();
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeFetchSolution(makePointScan("b", 1)));
+    solutions.push_back(makeFetchSolution(makePointScan("a", 5)));
+    solutions.push_back(makeSolution(std::make_unique<CollectionScanNode>()));
+
+    ASSERT_EQ(plan_cost_model::pruneSolutions(*stats, 10.0, &solutions), 2U);
+    ASSERT_EQ(solutions.size(), 1U);
+    auto ixscan = static_cast<const IndexScanNode*>(solutions[0]->root->children[0]);
+    ASSERT_BSONOBJ_EQ(ixscan->index.keyPattern, BSON("a" << 1));
+}
+
+TEST(PlanCostModelTest, KeepsAllSolutionsIfAnyCostIsUnknown) {
+    auto stats = makeStatistics();
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeFetchSolution(makePointScan("a", 5)));
+    solutions.push_back(makeFetchSolution(makePointScan("c", 1)));
+    solutions.push_back(makeSolution(std::make_unique<CollectionScanNode>()));
+
+    ASSERT_EQ(plan_cost_model::pruneSolutions(*stats, 10.0, &solutions), 0U);
+    ASSERT_EQ(solutions.size(), 3U);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -43,6 +43,7 @@
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_text.h"
+#include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
@@ -50,6 +51,7 @@
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/storage/clustered_key.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/transitional_tools_do_not_use/vector_spooling.h"
 
@@ -195,6 +197,63 @@ std::pair<boost::optional<Timestamp>, boost::optional<Timestamp>> extractTsRange
     }
 }
 
+/**
+ * Extracts the range of RecordIds that documents matching 'me' can have in a clustered collection,
+ * from the comparisons of "_id" at the top level or inside a top-level $and. The range may hold
+ * documents which do not match, such as those whose _id is of another type than the one it is
+ * compared to, so the collection scan must still filter them.
+ */
+std::pair<boost::optional<RecordId>, boost::optional<RecordId>> extractIdRange(
+    const MatchExpression* me, const CollatorInterface* collator, bool topLevel = true) {
+    boost::optional<RecordId> min;
+    boost::optional<RecordId> max;
+
+    if (me->matchType() == MatchExpression::AND && topLevel) {
+        for (size_t i = 0; i < me->numChildren(); ++i) {
+            boost::optional<RecordId> childMin;
+            boost::optional<RecordId> childMax;
+            std::tie(childMin, childMax) = extractIdRange(me->getChild(i), collator, false);
+            if (childMin && (!min || childMin.get() > min.get())) {
+                min = childMin;
+            }
+            if (childMax && (!max || childMax.get() < max.get())) {
+                max = childMax;
+            }
+        }
+        return {min, max};
+    }
+
+    if (!ComparisonMatchExpression::isComparisonMatchExpression(me) || me->path() != "_id") {
+        return {min, max};
+    }
+
+    // The RecordIds compare _ids with the simple collation. Arrays also match their elements, but
+    // no _id is an array.
+    const BSONElement data = static_cast<const ComparisonMatchExpression*>(me)->getData();
+    if ((collator && CollationIndexKey::isCollatableType(data.type())) || data.type() == Array ||
+        data.type() == Undefined) {
+        return {min, max};
+    }
+
+    const RecordId key = clusteredkey::keyForId(data);
+    switch (me->matchType()) {
+        case MatchExpression::EQ:
+            min = key;
+            max = key;
+            return {min, max};
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            min = key;
+            return {min, max};
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+            max = key;
+            return {min, max};
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
 /**
  * Returns true if 'me' is a GTE or GE predicate over the "ts" field.
  */
@@ -254,6 +313,11 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeCollectionScan(
         }
     }
 
+    if ((params.options & QueryPlannerParams::CLUSTERED_COLLECTION) && resumeAfterObj.isEmpty()) {
+        std::tie(csn->minRecord, csn->maxRecord) =
+            extractIdRange(query.root(), query.getCollator());
+    }
+
     return std::move(csn);
 }
 
@@ -1369,6 +1433,95 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::scanWholeIndex(
     return solnRoot;
 }
 
+std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeIndexSkipScan(
+    const IndexEntry& index, const CanonicalQuery& query, const QueryPlannerParams& params) {
+    // Only the top-level predicates are known to hold for every document the query returns.
+    std::vector<const MatchExpression*> predicates;
+    const MatchExpression* root = query.root();
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            predicates.push_back(root->getChild(i));
+        }
+    } else {
+        predicates.push_back(root);
+    }
+
+    auto canBoundSkipField = [](const MatchExpression* expr) {
+        switch (expr->matchType()) {
+            case MatchExpression::EQ:
+            case MatchExpression::LT:
+            case MatchExpression::LTE:
+            case MatchExpression::GT:
+            case MatchExpression::GTE:
+            case MatchExpression::MATCH_IN:
+                return true;
+            default:
+                return false;
+        }
+    };
+
+    const size_t maxPrefixFields = internalQueryPlannerMaxSkipScanPrefixFields.load();
+
+    auto isn = std::make_unique<IndexScanNode>(index);
+    isn->addKeyMetadata = query.metadataDeps()[DocumentMetadataFields::kIndexKey];
+    isn->queryCollator = query.getCollator();
+    isn->isSkipScan = true;
+    isn->bounds.fields.resize(index.keyPattern.nFields());
+
+    // The bounds cover all values of the leading fields and of the fields following the first
+    // field with predicates, which only the predicates on that field narrow down. The index scan
+    // then seeks past every key prefix whose value for that field falls outside of its bounds.
+    bool foundSkipField = false;
+    size_t fieldNo = 0;
+    for (auto&& elt : index.keyPattern) {
+        OrderedIntervalList* oil = &isn->bounds.fields[fieldNo];
+
+        bool hasBounds = false;
+        if (!foundSkipField) {
+            for (auto&& pred : predicates) {
+                if (!canBoundSkipField(pred) || pred->path() != elt.fieldNameStringData()) {
+                    continue;
+                }
+
+                IndexBoundsBuilder::BoundsTightness tightness;
+                if (hasBounds) {
+                    IndexBoundsBuilder::translateAndIntersect(pred, elt, index, oil, &tightness);
+                } else {
+                    IndexBoundsBuilder::translate(pred, elt, index, oil, &tightness);
+                    hasBounds = true;
+                }
+            }
+        }
+
+        if (hasBounds) {
+            if (0 == fieldNo) {
+                // There is nothing to skip over; the index is used by the regular planner.
+                return nullptr;
+            }
+            foundSkipField = true;
+        } else {
+            if (!foundSkipField && fieldNo + 1 > maxPrefixFields) {
+                return nullptr;
+            }
+            IndexBoundsBuilder::allValuesForField(elt, oil);
+        }
+        ++fieldNo;
+    }
+
+    if (!foundSkipField) {
+        return nullptr;
+    }
+
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    // The bounds are not necessarily exact, so the whole query is applied to the fetched
+    // documents.
+    auto fetch = std::make_unique<FetchNode>();
+    fetch->filter = query.root()->shallowClone();
+    fetch->children.push_back(isn.release());
+    return fetch;
+}
+
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
                                                  MatchExpression::MatchType type) {
@@ -110,6 +110,16 @@ public:
                                                              const QueryPlannerParams& params,
                                                              int direction = 1);
 
+    /**
+     * Return a plan that answers the predicates on a non-leading field of the provided compound
+     * index by skipping over the distinct values of the leading fields, or nullptr if the query
+     * has no such predicates. The leading fields of the index must not be constrained by the query
+     * and there may be at most 'internalQueryPlannerMaxSkipScanPrefixFields' of them.
+     */
+    static std::unique_ptr<QuerySolutionNode> makeIndexSkipScan(const IndexEntry& index,
+                                                                const CanonicalQuery& query,
+                                                                const QueryPlannerParams& params);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
@@ -173,6 +173,12 @@ string optionString(size_t options) {
             case QueryPlannerParams::PRESERVE_RECORD_ID:
                 ss << "PRESERVE_RECORD_ID ";
                 break;
+            case QueryPlannerParams::CLUSTERED_COLLECTION:
+                ss << "CLUSTERED_COLLECTION ";
+                break;
+            case QueryPlannerParams::GENERATE_SKIP_SCANS:
+                ss << "GENERATE_SKIP_SCANS ";
+                break;
             case QueryPlannerParams::DEFAULT:
                 MONGO_UNREACHABLE;
                 break;
@@ -328,6 +334,33 @@ std::unique_ptr<QuerySolution> buildWholeIXSoln(const IndexEntry& index,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
 }
 
+std::unique_ptr<QuerySolution> buildSkipScanSoln(const IndexEntry& index,
+                                                 const CanonicalQuery& query,
+                                                 const QueryPlannerParams& params) {
+    std::unique_ptr<QuerySolutionNode> solnRoot(
+        QueryPlannerAccess::makeIndexSkipScan(index, query, params));
+    if (!solnRoot) {
+        return nullptr;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
+}
+
+/**
+ * Returns true if 'index' can be scanned by skipping over the distinct values of its leading
+ * fields. A sparse or partial index may be missing documents that match the query, and a multikey
+ * index would need its keys deduplicated.
+ */
+bool canSkipScan(const IndexEntry& index, const CanonicalQuery& query) {
+    if (index.type != INDEX_BTREE || index.multikey || index.sparse ||
+        index.keyPattern.nFields() < 2) {
+        return false;
+    }
+    if (index.filterExpr && !expression::isSubsetOf(query.root(), index.filterExpr)) {
+        return false;
+    }
+    return CollatorInterface::collatorsMatch(index.collator, query.getCollator());
+}
+
 bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
     return query.getQueryRequest().getSort().isPrefixOf(kp, SimpleBSONElementComparator::kInstance);
 }
@@ -497,6 +530,14 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
         } else {
             return {std::move(soln)};
         }
+    } else if (SolutionCacheData::SKIP_SCAN_SOLN == winnerCacheData.solnType) {
+        auto soln = buildSkipScanSoln(*winnerCacheData.tree->entry, query, params);
+        if (!soln) {
+            return Status(ErrorCodes::NoQueryExecutionPlans,
+                          "plan cache error: index skip scan soln");
+        } else {
+            return {std::move(soln)};
+        }
     } else if (SolutionCacheData::COLLSCAN_SOLN == winnerCacheData.solnType) {
         // The cached solution is a collection scan. We don't cache collscans
         // with tailable==true, hence the false below.
@@ -1101,8 +1142,48 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         }
     }
 
-    // The caller can explicitly ask for a collscan.
-    bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN);
+    // geoNear and text queries *require* an index.
+    // Also, if a hint is specified it indicates that we MUST use it.
+    bool possibleToCollscan =
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT) && hintedIndex.isEmpty();
+
+    // If no index has a predicate on its leading field, a compound index may still be able to
+    // answer a predicate on one of its later fields by skipping from one distinct value of its
+    // leading fields to the next. This only pays off when the leading fields have few distinct
+    // values, which the planner cannot tell, so these plans compete against a collection scan.
+    bool skipScansOnly = false;
+    if (params.options & QueryPlannerParams::GENERATE_SKIP_SCANS && out.size() == 0 &&
+        possibleToCollscan && !isTailable) {
+        for (auto&& index : fullIndexList) {
+            if (!canSkipScan(index, query)) {
+                continue;
+            }
+
+            auto soln = buildSkipScanSoln(index, query, params);
+            if (!soln) {
+                continue;
+            }
+
+            LOGV2_DEBUG(4917700,
+                        5,
+                        "Planner: outputting an index skip scan",
+                        "skipScan"_attr = redact(soln->toString()));
+            PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+            indexTree->setIndexEntry(index);
+            SolutionCacheData* scd = new SolutionCacheData();
+            scd->tree.reset(indexTree);
+            scd->solnType = SolutionCacheData::SKIP_SCAN_SOLN;
+            soln->cacheData.reset(scd);
+
+            out.push_back(std::move(soln));
+            skipScansOnly = true;
+        }
+    }
+
+    // The caller can explicitly ask for a collscan. One also competes against index skip scans.
+    bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN) ||
+        (skipScansOnly && canTableScan);
 
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
     bool collScanRequired = 0 == out.size();
@@ -1111,11 +1192,6 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
                       "No indexed plans available, and running with 'notablescan'");
     }
 
-    // geoNear and text queries *require* an index.
-    // Also, if a hint is specified it indicates that we MUST use it.
-    bool possibleToCollscan =
-        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) &&
-        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT) && hintedIndex.isEmpty();
     if (collScanRequired && !possibleToCollscan) {
         return Status(ErrorCodes::NoQueryExecutionPlans, "No query solutions");
     }
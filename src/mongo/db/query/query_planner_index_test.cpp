@@ -1426,5 +1426,89 @@ TEST_F(QueryPlannerTest, PlansForWholeIndexScanWithSortAreGenerated) {
         "{proj: {spec: {'b': 1, _id: 0}, node: {fetch: {node: {ixscan: {pattern: {a: 1}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, SkipScanOnNonLeadingFieldCompetesWithCollscan) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: 5}, node: {ixscan: {pattern: {a: 1, b: 1}, bounds: "
+        "{a: [['MinKey', 'MaxKey', true, true]], b: [[5, 5, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanIntersectsPredicatesOnSkipField) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << -1 << "b" << 1 << "c" << 1));
+
+    runQuery(fromjson("{b: {$gt: 5, $lte: 10}, c: 1}"));
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$gt: 5, $lte: 10}, c: 1}, node: {ixscan: {pattern: "
+        "{a: -1, b: 1, c: 1}, bounds: {a: [['MaxKey', 'MinKey', true, true]], "
+        "b: [[5, 10, false, true]], c: [['MinKey', 'MaxKey', true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanIsTheOnlyPlanWithNoTableScan) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS | QueryPlannerParams::NO_TABLE_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQuery(fromjson("{b: {$in: [1, 2]}}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$in: [1, 2]}}, node: {ixscan: {pattern: {a: 1, b: 1}, bounds: "
+        "{a: [['MinKey', 'MaxKey', true, true]], b: [[1, 1, true, true], [2, 2, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanIfDisabled) {
+    params.options = QueryPlannerParams::DEFAULT;
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanIfLeadingFieldHasPredicate) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQuery(fromjson("{a: 1, b: 5}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, bounds: "
+        "{a: [[1, 1, true, true]], b: [[5, 5, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanPastMaxPrefixFields) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1));
+
+    runQuery(fromjson("{c: 5}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {c: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanOnMultikeyOrSparseIndex) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1), true);
+    addIndex(BSON("c" << 1 << "b" << 1), false, true);
+
+    runQuery(fromjson("{b: 5}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, NoSkipScanForPredicatesUnderOr) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQuery(fromjson("{$or: [{b: 5}, {c: 6}]}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
 }  // namespace
 }  // namespace mongo
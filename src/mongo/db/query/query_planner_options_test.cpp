@@ -32,6 +32,7 @@
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_test_fixture.h"
+#include "mongo/db/storage/clustered_key.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -934,5 +935,62 @@ TEST_F(QueryPlannerTest, PreserveRecordIdOptionPrecludesSimpleSort) {
         "{sort: {pattern: {a: 1}, limit: 0, type: 'default', node: {cscan: {dir: 1}}}}");
 }
 
+TEST_F(QueryPlannerTest, ClusteredCollectionScanIsBoundedByIdPredicates) {
+    // A clustered collection has no _id index.
+    params.indices.clear();
+    params.options |= QueryPlannerParams::CLUSTERED_COLLECTION;
+
+    auto key = [](const BSONObj& obj) { return clusteredkey::keyForId(obj.firstElement()); };
+    auto collScan = [&] {
+        assertHasOnlyCollscan();
+        return static_cast<const CollectionScanNode*>(solns.front()->root.get());
+    };
+
+    runQuery(fromjson("{_id: 5}"));
+    ASSERT_EQ(key(BSON("" << 5)), collScan()->minRecord);
+    ASSERT_EQ(key(BSON("" << 5)), collScan()->maxRecord);
+
+    const OID oid = OID::gen();
+    runQuery(BSON("_id" << BSON("$gt" << oid) << "a" << 1));
+    ASSERT_EQ(key(BSON("" << oid)), collScan()->minRecord);
+    ASSERT_FALSE(collScan()->maxRecord);
+
+    runQuery(fromjson("{_id: {$gte: 'a', $lt: 'c'}}"));
+    ASSERT_EQ(key(BSON(""
+                       << "a")),
+              collScan()->minRecord);
+    ASSERT_EQ(key(BSON(""
+                       << "c")),
+              collScan()->maxRecord);
+
+    // The tightest bounds of a top-level $and are kept.
+    runQuery(fromjson("{$and: [{_id: {$gte: 1}}, {_id: {$gt: 3}}, {_id: {$lte: 20}}, "
+                      "{_id: {$lt: 10}}]}"));
+    ASSERT_EQ(key(BSON("" << 3)), collScan()->minRecord);
+    ASSERT_EQ(key(BSON("" << 10)), collScan()->maxRecord);
+
+    // Predicates under an $or, or on other fields, do not bound the scan.
+    runQuery(fromjson("{$or: [{_id: 1}, {_id: 2}]}"));
+    ASSERT_FALSE(collScan()->minRecord);
+    ASSERT_FALSE(collScan()->maxRecord);
+
+    runQuery(fromjson("{'_id.a': 1}"));
+    ASSERT_FALSE(collScan()->minRecord);
+    ASSERT_FALSE(collScan()->maxRecord);
+}
+
+TEST_F(QueryPlannerTest, ClusteredCollectionScanIsNotBoundedByCollatedComparisons) {
+    params.indices.clear();
+    params.options |= QueryPlannerParams::CLUSTERED_COLLECTION;
+
+    // The RecordIds order strings with the simple collation.
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {_id: {$gte: 'a', $lt: 5}}, collation: {locale: 'reverse'}}"));
+    assertHasOnlyCollscan();
+    const auto* csn = static_cast<const CollectionScanNode*>(solns.front()->root.get());
+    ASSERT_FALSE(csn->minRecord);
+    ASSERT_EQ(clusteredkey::keyForId(BSON("" << 5).firstElement()), csn->maxRecord);
+}
+
 }  // namespace
 }  // namespace mongo
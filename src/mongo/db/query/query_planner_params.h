@@ -97,6 +97,14 @@ struct QueryPlannerParams {
         // ids. In some cases, record ids can be discarded as an optimization when they will not be
         // consumed downstream.
         PRESERVE_RECORD_ID = 1 << 10,
+
+        // Set this if the collection is clustered, so that collection scans only visit the range of
+        // RecordIds allowed by the query's predicates on _id.
+        CLUSTERED_COLLECTION = 1 << 11,
+
+        // Set this to generate index skip scans for predicates on non-leading fields of compound
+        // indexes when no other indexed plan is available.
+        GENERATE_SKIP_SCANS = 1 << 12,
     };
 
     // See Options enum above.
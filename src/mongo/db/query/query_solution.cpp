@@ -213,6 +213,8 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     copy->direction = this->direction;
     copy->shouldTrackLatestOplogTimestamp = this->shouldTrackLatestOplogTimestamp;
     copy->shouldWaitForOplogVisibility = this->shouldWaitForOplogVisibility;
+    copy->minRecord = this->minRecord;
+    copy->maxRecord = this->maxRecord;
 
     return copy;
 }
@@ -481,6 +483,10 @@ void IndexScanNode::appendToString(str::stream* ss, int indent) const {
     *ss << "direction = " << direction << '\n';
     addIndent(ss, indent + 1);
     *ss << "bounds = " << bounds.toString() << '\n';
+    if (isSkipScan) {
+        addIndent(ss, indent + 1);
+        *ss << "skipScan = 1\n";
+    }
     addCommon(ss, indent);
 }
 
@@ -897,6 +903,7 @@ QuerySolutionNode* IndexScanNode::clone() const {
 
     copy->direction = this->direction;
     copy->addKeyMetadata = this->addKeyMetadata;
+    copy->isSkipScan = this->isSkipScan;
     copy->bounds = this->bounds;
     copy->queryCollator = this->queryCollator;
 
@@ -920,7 +927,7 @@ bool filtersAreEquivalent(const MatchExpression* lhs, const MatchExpression* rhs
 bool IndexScanNode::operator==(const IndexScanNode& other) const {
     return filtersAreEquivalent(filter.get(), other.filter.get()) && index == other.index &&
         direction == other.direction && addKeyMetadata == other.addKeyMetadata &&
-        bounds == other.bounds;
+        isSkipScan == other.isSkipScan && bounds == other.bounds;
 }
 
 //
@@ -419,6 +419,12 @@ struct CollectionScanNode : public QuerySolutionNodeWithSortSet {
     // This field cannot be used in conjunction with 'resumeAfterRecordId'.
     boost::optional<Timestamp> maxTs;
 
+    // If present, the collection scan will only return records whose RecordIds lie within
+    // ['minRecord', 'maxRecord']. Should only be set on scans of clustered collections.
+    // These fields cannot be used in conjunction with 'resumeAfterRecordId'.
+    boost::optional<RecordId> minRecord;
+    boost::optional<RecordId> maxRecord;
+
     // If true, the collection scan will return a token that can be used to resume the scan.
     bool requestResumeToken = false;
 
@@ -602,6 +608,10 @@ struct IndexScanNode : public QuerySolutionNodeWithSortSet {
 
     bool shouldDedup = false;
 
+    // True if the leading fields of the index carry no predicates and 'bounds' only restrict later
+    // fields, so that the scan skips from one distinct prefix of the index keys to the next.
+    bool isSkipScan = false;
+
     IndexBounds bounds;
 
     const CollatorInterface* queryCollator;
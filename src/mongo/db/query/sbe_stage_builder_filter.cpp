@@ -558,7 +558,10 @@ public:
         unsupportedExpression(expr);
     }
     void visit(const InMatchExpression* expr) final {
-        unsupportedExpression(expr);
+        // Only a plain list of equalities is translated into a set membership test.
+        if (!expr->getRegexes().empty() || expr->hasNull() || expr->getCollator()) {
+            unsupportedExpression(expr);
+        }
     }
     void visit(const InternalExprEqMatchExpression* expr) final {
         unsupportedExpression(expr);
@@ -694,7 +697,33 @@ public:
     }
     void visit(const GeoMatchExpression* expr) final {}
     void visit(const GeoNearMatchExpression* expr) final {}
-    void visit(const InMatchExpression* expr) final {}
+    void visit(const InMatchExpression* expr) final {
+        // Put the equalities into a hash set once, so that each element is matched with a single
+        // lookup regardless of the size of the $in list.
+        auto [setTag, setVal] = sbe::value::makeNewArraySet();
+        sbe::value::ValueGuard setGuard{setTag, setVal};
+        auto equalitySet = sbe::value::getArraySetView(setVal);
+        equalitySet->reserve(expr->getEqualities().size());
+        for (auto&& equality : expr->getEqualities()) {
+            auto [tagView, valView] = sbe::bson::convertFrom(true,
+                                                             equality.rawdata(),
+                                                             equality.rawdata() + equality.size(),
+                                                             equality.fieldNameSize() - 1);
+            auto [tag, val] = sbe::value::copyValue(tagView, valView);
+            equalitySet->push_back(tag, val);
+        }
+
+        auto makeEExprFn = [equalitySet](sbe::value::SlotId inputSlot) {
+            // SBE EConstant assumes ownership of the value so we have to make a copy here.
+            auto [tag, val] = sbe::value::makeCopyArraySet(*equalitySet);
+            return makeFillEmptyFalse(sbe::makeE<sbe::EFunction>(
+                "isMember",
+                sbe::makeEs(sbe::makeE<sbe::EVariable>(inputSlot),
+                            sbe::makeE<sbe::EConstant>(tag, val))));
+        };
+
+        generateTraverse(_context, expr, std::move(makeEExprFn));
+    }
     void visit(const InternalExprEqMatchExpression* expr) final {}
     void visit(const InternalSchemaAllElemMatchFromIndexMatchExpression* expr) final {}
     void visit(const InternalSchemaAllowedPropertiesMatchExpression* expr) final {}
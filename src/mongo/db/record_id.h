@@ -33,17 +33,31 @@
 #include <boost/optional.hpp>
 #include <climits>
 #include <cstdint>
+#include <cstring>
 #include <fmt/format.h>
+#include <new>
 #include <ostream>
 
+#include "mongo/base/static_assert.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/util/builder.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
 /**
  * The key that uniquely identifies a Record in a Collection or RecordStore.
+ *
+ * A RecordId is either a 64-bit integer, or a string of bytes which compare like memcmp(). Record
+ * stores key all their records by RecordIds of the same kind: only clustered collections use
+ * strings, made of the KeyString of the _id of their documents.
+ *
+ * Integers and strings of up to kSmallStrMaxSize bytes, which covers the KeyString of an ObjectId,
+ * are held within the RecordId itself. Only longer strings live in a separate, shared buffer, so
+ * that copying and comparing integer RecordIds stays as cheap as copying and comparing integers.
  */
 class RecordId {
 public:
@@ -53,6 +67,9 @@ public:
     static constexpr int64_t kMaxRepr = LLONG_MAX;
     static constexpr int64_t kMinReservedRepr = kMaxRepr - (1024 * 1024);
 
+    // The longest string which is held within the RecordId rather than in a separate buffer.
+    static constexpr int32_t kSmallStrMaxSize = 14;
+
     /**
      * Enumerates all ids in the reserved range that have been allocated for a specific purpose.
      */
@@ -61,17 +78,66 @@ public:
     /**
      * Constructs a Null RecordId.
      */
-    RecordId() : _repr(kNullRepr) {}
+    RecordId() : RecordId(kNullRepr) {}
 
-    explicit RecordId(int64_t repr) : _repr(repr) {}
+    explicit RecordId(int64_t repr) : _format(Format::kLong) {
+        memcpy(_data, &repr, sizeof(repr));
+    }
 
     explicit RecordId(ReservedId repr) : RecordId(static_cast<int64_t>(repr)) {}
 
+    /**
+     * Constructs a RecordId holding a copy of the 'size' bytes at 'data'.
+     */
+    RecordId(const char* data, int32_t size) {
+        invariant(size > 0);
+        if (size <= kSmallStrMaxSize) {
+            _format = Format::kSmallStr;
+            memcpy(_data, data, size);
+            _data[kSmallStrSizeOffset] = static_cast<char>(size);
+            return;
+        }
+
+        _format = Format::kBigStr;
+        auto buffer = SharedBuffer::allocate(size);
+        memcpy(buffer.get(), data, size);
+        new (_data) ConstSharedBuffer(std::move(buffer));
+    }
+
     /**
      * Construct a RecordId from two halves.
      * TODO consider removing.
      */
-    RecordId(int high, int low) : _repr((uint64_t(high) << 32) | uint32_t(low)) {}
+    RecordId(int high, int low)
+        : RecordId(static_cast<int64_t>((uint64_t(high) << 32) | uint32_t(low))) {}
+
+    RecordId(const RecordId& other) {
+        _copyFrom(other);
+    }
+
+    RecordId(RecordId&& other) noexcept {
+        _moveFrom(std::move(other));
+    }
+
+    RecordId& operator=(const RecordId& other) {
+        if (this != &other) {
+            _destroyBigStr();
+            _copyFrom(other);
+        }
+        return *this;
+    }
+
+    RecordId& operator=(RecordId&& other) noexcept {
+        if (this != &other) {
+            _destroyBigStr();
+            _moveFrom(std::move(other));
+        }
+        return *this;
+    }
+
+    ~RecordId() {
+        _destroyBigStr();
+    }
 
     /**
      * A RecordId that compares less than all ids that represent documents in a collection.
@@ -95,11 +161,34 @@ public:
     }
 
     bool isNull() const {
-        return _repr == 0;
+        return _format == Format::kLong && _getLong() == kNullRepr;
+    }
+
+    /**
+     * Returns true if this RecordId is made of a string of bytes rather than of an integer.
+     */
+    bool isStr() const {
+        return _format != Format::kLong;
     }
 
+    /**
+     * The integer of a RecordId which is not made of a string.
+     */
     int64_t repr() const {
-        return _repr;
+        dassert(!isStr());
+        return _getLong();
+    }
+
+    /**
+     * The bytes of a RecordId made of a string.
+     */
+    StringData getStr() const {
+        if (_format == Format::kSmallStr) {
+            return {_data, static_cast<uint8_t>(_data[kSmallStrSizeOffset])};
+        }
+        invariant(_format == Format::kBigStr);
+        const auto& buffer = _getBigStr();
+        return {buffer.get(), buffer.capacity()};
     }
 
     /**
@@ -116,18 +205,30 @@ public:
      * excluding the reserved range at the top of the RecordId space.
      */
     bool isNormal() const {
-        return _repr > 0 && _repr < kMinReservedRepr;
+        return isStr() || (_getLong() > 0 && _getLong() < kMinReservedRepr);
     }
 
     /**
      * Returns true if this RecordId falls within the reserved range at the top of the record space.
      */
     bool isReserved() const {
-        return _repr >= kMinReservedRepr && _repr < kMaxRepr;
+        return !isStr() && _getLong() >= kMinReservedRepr && _getLong() < kMaxRepr;
     }
 
-    int compare(RecordId rhs) const {
-        return _repr == rhs._repr ? 0 : _repr < rhs._repr ? -1 : 1;
+    /**
+     * RecordIds made of integers, including the null one, sort before those made of strings.
+     */
+    int compare(const RecordId& rhs) const {
+        if (MONGO_likely((static_cast<uint8_t>(_format) | static_cast<uint8_t>(rhs._format)) ==
+                         static_cast<uint8_t>(Format::kLong))) {
+            const auto lhsRepr = _getLong();
+            const auto rhsRepr = rhs._getLong();
+            return lhsRepr == rhsRepr ? 0 : lhsRepr < rhsRepr ? -1 : 1;
+        }
+        if (!isStr() || !rhs.isStr()) {
+            return isStr() ? 1 : -1;
+        }
+        return getStr().compare(rhs.getStr());
     }
 
     /**
@@ -135,10 +236,15 @@ public:
      * may differ across platforms. Hash values should not be persisted.
      */
     struct Hasher {
-        size_t operator()(RecordId rid) const {
+        size_t operator()(const RecordId& rid) const {
             size_t hash = 0;
             // TODO consider better hashes
-            boost::hash_combine(hash, rid.repr());
+            if (rid.isStr()) {
+                const auto str = rid.getStr();
+                boost::hash_range(hash, str.rawData(), str.rawData() + str.size());
+            } else {
+                boost::hash_combine(hash, rid.repr());
+            }
             return hash;
         }
     };
@@ -146,59 +252,143 @@ public:
     /// members for Sorter
     struct SorterDeserializeSettings {};  // unused
     void serializeForSorter(BufBuilder& buf) const {
-        buf.appendNum(static_cast<long long>(_repr));
+        // The size of a string is stored negated. No integer RecordId but min() is negative.
+        if (isStr()) {
+            const auto str = getStr();
+            buf.appendNum(-static_cast<long long>(str.size()));
+            buf.appendBuf(str.rawData(), str.size());
+        } else {
+            buf.appendNum(static_cast<long long>(_getLong()));
+        }
     }
     static RecordId deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&) {
-        return RecordId(buf.read<LittleEndian<int64_t>>());
+        const int64_t repr = buf.read<LittleEndian<int64_t>>();
+        if (repr < 0 && repr != kMinRepr) {
+            const int32_t size = static_cast<int32_t>(-repr);
+            return RecordId(static_cast<const char*>(buf.skip(size)), size);
+        }
+        return RecordId(repr);
     }
     int memUsageForSorter() const {
-        return sizeof(RecordId);
+        return sizeof(RecordId) + (_format == Format::kBigStr ? _getBigStr().capacity() : 0);
     }
     RecordId getOwned() const {
         return *this;
     }
 
     void serialize(fmt::memory_buffer& buffer) const {
-        fmt::format_to(buffer, "RecordId({})", _repr);
+        fmt::format_to(buffer, "{}", toString());
     }
 
     void serialize(BSONObjBuilder* builder) const {
-        builder->append("RecordId"_sd, _repr);
+        appendToBSONAs(builder, "RecordId"_sd);
+    }
+
+    /**
+     * Appends this RecordId as a NumberLong, or as BinData if it is made of a string.
+     */
+    void appendToBSONAs(BSONObjBuilder* builder, StringData fieldName) const {
+        if (isStr()) {
+            const auto str = getStr();
+            builder->appendBinData(fieldName, str.size(), BinDataGeneral, str.rawData());
+        } else {
+            builder->append(fieldName, static_cast<long long>(_getLong()));
+        }
+    }
+
+    std::string toString() const {
+        if (isStr()) {
+            const auto str = getStr();
+            return "RecordId(" + toHexLower(str.rawData(), str.size()) + ")";
+        }
+        return "RecordId(" + std::to_string(_getLong()) + ")";
     }
 
 private:
-    int64_t _repr;
+    enum class Format : uint8_t {
+        // '_data' holds an int64_t.
+        kLong = 0,
+        // '_data' holds the bytes of the string, followed by their count at kSmallStrSizeOffset.
+        kSmallStr = 1,
+        // '_data' holds a ConstSharedBuffer of the bytes of the string, whose size is its capacity.
+        kBigStr = 2,
+    };
+
+    static constexpr size_t kSmallStrSizeOffset = kSmallStrMaxSize;
+
+    int64_t _getLong() const {
+        int64_t repr;
+        memcpy(&repr, _data, sizeof(repr));
+        return repr;
+    }
+
+    const ConstSharedBuffer& _getBigStr() const {
+        return *reinterpret_cast<const ConstSharedBuffer*>(_data);
+    }
+
+    void _copyFrom(const RecordId& other) {
+        if (MONGO_unlikely(other._format == Format::kBigStr)) {
+            new (_data) ConstSharedBuffer(other._getBigStr());
+            _format = Format::kBigStr;
+            return;
+        }
+        memcpy(_data, other._data, sizeof(_data));
+        _format = other._format;
+    }
+
+    void _moveFrom(RecordId&& other) {
+        // The buffer of a big string is relocated bitwise, and 'other' is left a null RecordId.
+        memcpy(_data, other._data, sizeof(_data));
+        _format = other._format;
+        if (MONGO_unlikely(_format == Format::kBigStr)) {
+            const int64_t nullRepr = kNullRepr;
+            memcpy(other._data, &nullRepr, sizeof(nullRepr));
+            other._format = Format::kLong;
+        }
+    }
+
+    void _destroyBigStr() {
+        if (MONGO_unlikely(_format == Format::kBigStr)) {
+            reinterpret_cast<ConstSharedBuffer*>(_data)->~ConstSharedBuffer();
+        }
+    }
+
+    alignas(int64_t) char _data[kSmallStrMaxSize + 1];
+    Format _format;
 };
 
-inline bool operator==(RecordId lhs, RecordId rhs) {
-    return lhs.repr() == rhs.repr();
+MONGO_STATIC_ASSERT(sizeof(RecordId) == 16);
+MONGO_STATIC_ASSERT(sizeof(ConstSharedBuffer) <= RecordId::kSmallStrMaxSize);
+
+inline bool operator==(const RecordId& lhs, const RecordId& rhs) {
+    return lhs.compare(rhs) == 0;
 }
-inline bool operator!=(RecordId lhs, RecordId rhs) {
-    return lhs.repr() != rhs.repr();
+inline bool operator!=(const RecordId& lhs, const RecordId& rhs) {
+    return lhs.compare(rhs) != 0;
 }
-inline bool operator<(RecordId lhs, RecordId rhs) {
-    return lhs.repr() < rhs.repr();
+inline bool operator<(const RecordId& lhs, const RecordId& rhs) {
+    return lhs.compare(rhs) < 0;
 }
-inline bool operator<=(RecordId lhs, RecordId rhs) {
-    return lhs.repr() <= rhs.repr();
+inline bool operator<=(const RecordId& lhs, const RecordId& rhs) {
+    return lhs.compare(rhs) <= 0;
 }
-inline bool operator>(RecordId lhs, RecordId rhs) {
-    return lhs.repr() > rhs.repr();
+inline bool operator>(const RecordId& lhs, const RecordId& rhs) {
+    return lhs.compare(rhs) > 0;
 }
-inline bool operator>=(RecordId lhs, RecordId rhs) {
-    return lhs.repr() >= rhs.repr();
+inline bool operator>=(const RecordId& lhs, const RecordId& rhs) {
+    return lhs.compare(rhs) >= 0;
 }
 
 inline StringBuilder& operator<<(StringBuilder& stream, const RecordId& id) {
-    return stream << "RecordId(" << id.repr() << ')';
+    return stream << id.toString();
 }
 
 inline std::ostream& operator<<(std::ostream& stream, const RecordId& id) {
-    return stream << "RecordId(" << id.repr() << ')';
+    return stream << id.toString();
 }
 
 inline std::ostream& operator<<(std::ostream& stream, const boost::optional<RecordId>& id) {
-    return stream << "RecordId(" << (id ? id.get().repr() : 0) << ')';
+    return stream << (id ? id->toString() : RecordId().toString());
 }
 
 }  // namespace mongo
@@ -65,5 +65,42 @@ TEST(RecordId, HashNotEqual) {
     ASSERT_NOT_EQUALS(hasher(original), hasher(reversed));
 }
 
+TEST(RecordId, StringsOfAnySizeRoundTrip) {
+    for (int32_t size : {1, int32_t(RecordId::kSmallStrMaxSize), 64}) {
+        const std::string str(size, 'x');
+        RecordId rid(str.data(), size);
+        ASSERT(rid.isStr());
+        ASSERT(rid.isNormal());
+        ASSERT_EQ(rid.getStr(), str);
+
+        RecordId copy(rid);
+        ASSERT_EQ(copy, rid);
+        RecordId assigned(5);
+        assigned = copy;
+        ASSERT_EQ(assigned.getStr(), str);
+
+        RecordId moved(std::move(copy));
+        ASSERT_EQ(moved.getStr(), str);
+        assigned = RecordId(7);
+        ASSERT_EQ(assigned, RecordId(7));
+
+        BufBuilder buf;
+        rid.serializeForSorter(buf);
+        BufReader reader(buf.buf(), buf.len());
+        ASSERT_EQ(RecordId::deserializeForSorter(reader, {}), rid);
+    }
+}
+
+TEST(RecordId, StringsSortAfterIntegersAndLikeMemcmp) {
+    const std::string shortStr(RecordId::kSmallStrMaxSize, 'a');
+    const std::string longStr(RecordId::kSmallStrMaxSize + 1, 'a');
+    RecordId small(shortStr.data(), shortStr.size());
+    RecordId big(longStr.data(), longStr.size());
+    ASSERT_LT(RecordId::max(), small);
+    ASSERT_LT(small, big);
+    ASSERT_LT(big, RecordId("b", 1));
+    ASSERT_LT(RecordId::min(), RecordId(1));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -425,6 +425,18 @@ void BaseCloner::setInitialSyncFailedStatus(Status status) {
     _sharedData->setInitialSyncStatusIfOK(lk, status);
 }
 
+std::unique_ptr<DBClientConnection> BaseCloner::makeClient() const {
+    if (_createClientFn) {
+        return _createClientFn();
+    }
+
+    auto client = std::make_unique<DBClientConnection>(true /* autoReconnect */);
+    uassertStatusOK(client->connect(_source, StringData()));
+    uassertStatusOK(replAuthenticate(client.get())
+                        .withContext(str::stream() << "Failed to authenticate to " << _source));
+    return client;
+}
+
 bool BaseCloner::mustExit() {
     stdx::lock_guard<InitialSyncSharedData> lk(*_sharedData);
     return !_sharedData->getInitialSyncStatus(lk).isOK();
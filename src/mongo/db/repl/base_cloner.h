@@ -30,6 +30,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
 
 #include "mongo/base/string_data.h"
@@ -79,6 +80,21 @@ public:
      */
     void setStopAfterStage_forTest(std::string stage);
 
+    /**
+     * Type of function to create the additional clients used by cloners which work on several
+     * connections to the sync source concurrently.
+     */
+    using CreateClientFn = std::function<std::unique_ptr<DBClientConnection>()>;
+
+    /**
+     * Overrides how additional clients are created.
+     *
+     * For testing only.
+     */
+    void setCreateClientFn_forTest(CreateClientFn createClientFn) {
+        _createClientFn = std::move(createClientFn);
+    }
+
 private:
     // The _clonerName must be initialized before _mutex, as _clonerName is used to generate the
     // name of the _mutex.
@@ -206,6 +222,16 @@ protected:
      */
     bool mustExit();
 
+    /**
+     * Returns a new client, connected and authenticated to the sync source, for cloners which work
+     * on several connections concurrently. Throws if the connection cannot be established.
+     */
+    std::unique_ptr<DBClientConnection> makeClient() const;
+
+    const CreateClientFn& getCreateClientFn() const {
+        return _createClientFn;
+    }
+
     /**
      * A stage may, but is not required, to call this when we should clear the retrying state
      * because the operation has at least partially succeeded.  If the stage does not call this,
@@ -288,6 +314,9 @@ private:
     // stage.
     std::string _stopAfterStage;  // (X)
 
+    // Overrides how makeClient() creates clients when set, for unit testing.
+    CreateClientFn _createClientFn;  // (R)
+
     // Operation that may currently be retrying.
     InitialSyncSharedData::RetryableOperation _retryableOp;  // (X)
 };
@@ -32,6 +32,8 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands/list_collections_filter.h"
 #include "mongo/db/index_build_entry_helpers.h"
 #include "mongo/db/index_builds_coordinator.h"
@@ -41,7 +43,9 @@
 #include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/logv2/log.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
 namespace repl {
@@ -215,7 +219,17 @@ BaseCloner::AfterStageBehavior CollectionCloner::createCollectionStage() {
 }
 
 BaseCloner::AfterStageBehavior CollectionCloner::queryStage() {
-    runQuery();
+    // The ranges are computed once, so that a retry resumes the unfinished ranges rather than
+    // cloning the collection all over again.
+    if (!_idRangesComputed) {
+        _idRanges = makeIdRanges();
+        _idRangesComputed = true;
+    }
+    if (_idRanges.empty()) {
+        runQuery();
+    } else {
+        runRangeQueries();
+    }
     waitForDatabaseWorkToComplete();
     // We want to free the _collLoader regardless of whether the commit succeeds.
     std::unique_ptr<CollectionBulkLoader> loader = std::move(_collLoader);
@@ -350,6 +364,166 @@ void CollectionCloner::runQuery() {
     }
 }
 
+std::vector<BSONObj> CollectionCloner::computeRangeBounds(const std::vector<BSONObj>& sortedSample,
+                                                         size_t numRanges) {
+    std::vector<BSONObj> bounds;
+    if (numRanges < 2) {
+        return bounds;
+    }
+    for (size_t i = 1; i < numRanges; ++i) {
+        auto index = i * sortedSample.size() / numRanges;
+        if (index == 0 || index >= sortedSample.size()) {
+            continue;
+        }
+        auto bound = BSON("_id" << sortedSample[index]["_id"]);
+        if (bounds.empty() ||
+            SimpleBSONObjComparator::kInstance.evaluate(bounds.back() < bound)) {
+            bounds.push_back(std::move(bound));
+        }
+    }
+    return bounds;
+}
+
+std::vector<CollectionCloner::IdRange> CollectionCloner::makeIdRanges() {
+    const auto numRanges = static_cast<size_t>(collectionClonerRangeParallelism);
+    // The ranges are scanned with $min and $max over the _id index, which must therefore order
+    // _ids the same way as the sample is sorted. Capped collections must be cloned in natural
+    // order.
+    if (numRanges < 2 || _idIndexSpec.isEmpty() || _idIndexSpec.hasField("collation") ||
+        !_collectionOptions.collation.isEmpty() || _collectionOptions.capped) {
+        return {};
+    }
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_stats.documentToCopy < static_cast<size_t>(collectionClonerRangeSplitMinDocuments)) {
+            return {};
+        }
+    }
+
+    // Oversample so that the ranges hold about as many documents each.
+    BSONObj reply;
+    std::vector<BSONObj> sample;
+    try {
+        auto pipeline = BSON_ARRAY(BSON("$sample" << BSON("size" << int(numRanges * 16)))
+                                   << BSON("$project" << BSON("_id" << 1))
+                                   << BSON("$sort" << BSON("_id" << 1)));
+        getClient()->runCommand(_sourceNss.db().toString(),
+                                BSON("aggregate" << _sourceNss.coll() << "pipeline" << pipeline
+                                                 << "cursor"
+                                                 << BSON("batchSize" << int(numRanges * 16))),
+                                reply,
+                                QueryOption_SlaveOk);
+        uassertStatusOK(getStatusFromCommandResult(reply));
+        for (auto&& elem : reply["cursor"]["firstBatch"].Obj()) {
+            sample.push_back(elem.Obj().getOwned());
+        }
+    } catch (const DBException& e) {
+        // Cloning the collection with a single query is always possible.
+        LOGV2_DEBUG(4917801,
+                    1,
+                    "Failed to sample the collection to split it into _id ranges",
+                    "namespace"_attr = _sourceNss,
+                    "error"_attr = e);
+        return {};
+    }
+
+    auto bounds = computeRangeBounds(sample, numRanges);
+    if (bounds.empty()) {
+        return {};
+    }
+    std::vector<IdRange> ranges(bounds.size() + 1);
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        ranges[i].max = bounds[i];
+        ranges[i + 1].min = bounds[i];
+    }
+    LOGV2(4917802,
+          "Cloning collection in _id ranges",
+          "namespace"_attr = _sourceNss,
+          "numRanges"_attr = ranges.size());
+    return ranges;
+}
+
+void CollectionCloner::runRangeQueries() {
+    ThreadPool::Options options;
+    options.poolName = "CollectionClonerRangeWorkers";
+    options.minThreads = 0;
+    options.maxThreads = _idRanges.size();
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName.c_str());
+    };
+    ThreadPool workers(std::move(options));
+    workers.startup();
+
+    Mutex statusMutex = MONGO_MAKE_LATCH("CollectionCloner::runRangeQueries::statusMutex");
+    Status firstError = Status::OK();
+    for (auto& range : _idRanges) {
+        if (range.done) {
+            continue;
+        }
+        workers.schedule([&, range = &range](Status status) {
+            try {
+                uassertStatusOK(status);
+                auto client = makeClient();
+                runRangeQuery(client.get(), range);
+            } catch (const DBException& e) {
+                stdx::lock_guard<Latch> lk(statusMutex);
+                if (firstError.isOK()) {
+                    firstError = e.toStatus();
+                }
+            }
+        });
+    }
+    workers.shutdown();
+    workers.join();
+    uassertStatusOK(firstError);
+}
+
+void CollectionCloner::runRangeQuery(DBClientConnection* client, IdRange* range) {
+    Query query;
+    query.hint(BSON("_id" << 1));
+    const auto& min = range->lastId.isEmpty() ? range->min : range->lastId;
+    if (!min.isEmpty()) {
+        query.minKey(min);
+    }
+    if (!range->max.isEmpty()) {
+        query.maxKey(range->max);
+    }
+
+    client->query(
+        [&](DBClientCursorBatchIterator& iter) {
+            uassert(ErrorCodes::CallbackCanceled,
+                    "Collection cloning cancelled due to initial sync failure",
+                    !mustExit());
+            std::vector<BSONObj> docs;
+            while (iter.moreInCurrentBatch()) {
+                auto doc = iter.nextSafe();
+                // Resuming a range starts from the last document already cloned, inclusive.
+                if (docs.empty() && !range->lastId.isEmpty() &&
+                    doc["_id"].woCompare(range->lastId["_id"], false) == 0) {
+                    continue;
+                }
+                docs.push_back(std::move(doc));
+            }
+            if (docs.empty()) {
+                return;
+            }
+            range->lastId = BSON("_id" << docs.back()["_id"]);
+            {
+                stdx::lock_guard<Latch> lk(_mutex);
+                _stats.receivedBatches++;
+            }
+            bufferDocumentsForInsert(std::move(docs));
+        },
+        _sourceDbAndUuid,
+        query,
+        nullptr /* fieldsToReturn */,
+        QueryOption_NoCursorTimeout | QueryOption_SlaveOk |
+            (collectionClonerUsesExhaust ? QueryOption_Exhaust : 0),
+        _collectionClonerBatchSize,
+        ReadConcernArgs::kImplicitDefault);
+    range->done = true;
+}
+
 void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
     {
         stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
@@ -377,24 +551,15 @@ void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
     }
     _firstBatchOfQueryRound = false;
 
+    std::vector<BSONObj> docs;
+    while (iter.moreInCurrentBatch()) {
+        docs.emplace_back(iter.nextSafe());
+    }
     {
         stdx::lock_guard<Latch> lk(_mutex);
         _stats.receivedBatches++;
-        while (iter.moreInCurrentBatch()) {
-            _documentsToInsert.emplace_back(iter.nextSafe());
-        }
-    }
-
-    // Schedule the next document batch insertion.
-    auto&& scheduleResult = _scheduleDbWorkFn(
-        [=](const executor::TaskExecutor::CallbackArgs& cbd) { insertDocumentsCallback(cbd); });
-
-    if (!scheduleResult.isOK()) {
-        Status newStatus = scheduleResult.getStatus().withContext(
-            str::stream() << "Error cloning collection '" << _sourceNss.ns() << "'");
-        // We must throw an exception to terminate query.
-        uassertStatusOK(newStatus);
     }
+    bufferDocumentsForInsert(std::move(docs));
 
     if (_resumeSupported) {
         // Store the resume token for this batch.
@@ -422,30 +587,65 @@ void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
         });
 }
 
+void CollectionCloner::bufferDocumentsForInsert(std::vector<BSONObj> docs) {
+    size_t bytes = 0;
+    for (const auto& doc : docs) {
+        bytes += doc.objsize();
+    }
+
+    while (true) {
+        {
+            stdx::unique_lock<Latch> lk(_mutex);
+            // A batch larger than the limit is still buffered once the buffer is empty.
+            if (_bufferedBytes == 0 ||
+                _bufferedBytes + bytes <= static_cast<size_t>(collectionClonerMaxBufferedBytes)) {
+                std::move(docs.begin(), docs.end(), std::back_inserter(_documentsToInsert));
+                _bufferedBytes += bytes;
+                break;
+            }
+            _bufferSpaceAvailable.wait_for(lk, Milliseconds(100).toSystemDuration());
+        }
+        uassert(ErrorCodes::CallbackCanceled,
+                "Collection cloning cancelled due to initial sync failure",
+                !mustExit());
+    }
+
+    // Schedule the next document batch insertion.
+    auto&& scheduleResult = _scheduleDbWorkFn(
+        [=](const executor::TaskExecutor::CallbackArgs& cbd) { insertDocumentsCallback(cbd); });
+
+    if (!scheduleResult.isOK()) {
+        Status newStatus = scheduleResult.getStatus().withContext(
+            str::stream() << "Error cloning collection '" << _sourceNss.ns() << "'");
+        // We must throw an exception to terminate query.
+        uassertStatusOK(newStatus);
+    }
+}
+
 void CollectionCloner::insertDocumentsCallback(const executor::TaskExecutor::CallbackArgs& cbd) {
     uassertStatusOK(cbd.status);
 
+    std::vector<BSONObj> docs;
     {
         stdx::lock_guard<Latch> lk(_mutex);
-        std::vector<BSONObj> docs;
         if (_documentsToInsert.size() == 0) {
-            LOGV2_WARNING(21145,
-                          "insertDocumentsCallback, but no documents to insert for ns:{namespace}",
-                          "insertDocumentsCallback, but no documents to insert",
-                          "namespace"_attr = _sourceNss);
+            // An earlier callback already inserted the documents this one was scheduled for.
             return;
         }
         _documentsToInsert.swap(docs);
+        _bufferedBytes = 0;
+        _bufferSpaceAvailable.notify_all();
         _stats.documentsCopied += docs.size();
         ++_stats.fetchedBatches;
         _progressMeter.hit(int(docs.size()));
         invariant(_collLoader);
-
-        // The insert must be done within the lock, because CollectionBulkLoader is not
-        // thread safe.
-        uassertStatusOK(_collLoader->insertDocuments(docs.cbegin(), docs.cend()));
     }
 
+    // The insert is done outside the lock so that the next batches can be fetched and buffered
+    // meanwhile. CollectionBulkLoader is not thread safe, but the database work task runner runs
+    // one insert at a time.
+    uassertStatusOK(_collLoader->insertDocuments(docs.cbegin(), docs.cend()));
+
     initialSyncHangDuringCollectionClone.executeIf(
         [&](const BSONObj&) {
             LOGV2(21138,
@@ -34,6 +34,7 @@
 
 #include "mongo/db/repl/base_cloner.h"
 #include "mongo/db/repl/task_runner.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/progress_meter.h"
 
 namespace mongo {
@@ -117,6 +118,14 @@ public:
         _scheduleDbWorkFn = std::move(scheduleDbWorkFn);
     }
 
+    /**
+     * Returns the boundaries splitting the _id space into at most 'numRanges' ranges holding about
+     * as many documents each, given the _ids of a sample of the collection sorted in ascending
+     * order. Each boundary is an object of the form {_id: <value>}, without duplicates.
+     */
+    static std::vector<BSONObj> computeRangeBounds(const std::vector<BSONObj>& sortedSample,
+                                                   size_t numRanges);
+
 protected:
     ClonerStages getStages() final;
 
@@ -125,6 +134,18 @@ protected:
 private:
     friend class CollectionClonerTest;
 
+    /**
+     * A range of the _id index cloned by its own query, from 'min' (inclusive) to 'max'
+     * (exclusive). An empty bound leaves that side of the range open.
+     */
+    struct IdRange {
+        BSONObj min;
+        BSONObj max;
+        // The _id of the last document cloned from this range, used to resume the range's query.
+        BSONObj lastId;
+        bool done = false;
+    };
+
     class CollectionClonerStage : public ClonerStage<CollectionCloner> {
     public:
         CollectionClonerStage(std::string name, CollectionCloner* cloner, ClonerRunFn stageFunc)
@@ -207,6 +228,13 @@ private:
      */
     void handleNextBatch(DBClientCursorBatchIterator& iter);
 
+    /**
+     * Adds 'docs' to the buffer of documents to insert and schedules their insertion. Blocks while
+     * the buffer holds more than collectionClonerMaxBufferedBytes, so that fetching from the sync
+     * source runs at most that far ahead of the inserts.
+     */
+    void bufferDocumentsForInsert(std::vector<BSONObj> docs);
+
     /**
      * Called whenever there is a new batch of documents ready from the DBClientConnection.
      *
@@ -221,6 +249,24 @@ private:
      */
     void runQuery();
 
+    /**
+     * Splits the _id space of the collection into ranges, using a sample of the collection's _ids.
+     * Returns no ranges if the collection is not worth or not able to be split.
+     */
+    std::vector<IdRange> makeIdRanges();
+
+    /**
+     * Clones the unfinished ranges of _idRanges concurrently, each on its own connection to the
+     * source. Throws the first error any of the range queries failed with, after all of them
+     * stopped; retrying only clones the remainder of the unfinished ranges.
+     */
+    void runRangeQueries();
+
+    /**
+     * Clones the remainder of 'range' using 'client'.
+     */
+    void runRangeQuery(DBClientConnection* client, IdRange* range);
+
     /**
      * Used to terminate the clone when we encounter a fatal error during a non-resumable query.
      * Throws.
@@ -256,7 +302,11 @@ private:
     ScheduleDbWorkFn _scheduleDbWorkFn;  // (R)
     // Documents read from source to insert.
     std::vector<BSONObj> _documentsToInsert;  // (M)
-    Stats _stats;                             // (M)
+    // The total size of _documentsToInsert.
+    size_t _bufferedBytes = 0;  // (M)
+    // Signalled whenever _documentsToInsert is emptied.
+    stdx::condition_variable _bufferSpaceAvailable;  // (S)
+    Stats _stats;                                    // (M)
     // Putting _dbWorkTaskRunner last ensures anything the database work threads depend on,
     // like _documentsToInsert, is destroyed after those threads exit.
     TaskRunner _dbWorkTaskRunner;  // (R)
@@ -277,6 +327,11 @@ private:
     // Signifies that there were changes to the collection on the sync source that resulted in
     // our remote cursor getting killed.
     bool _lostNonResumableCursor = false;  // (X)
+
+    // The _id ranges the collection is split into, if it is cloned by concurrent range queries.
+    // Each range is only accessed by the thread cloning it while the range queries run.
+    std::vector<IdRange> _idRanges;   // (X)
+    bool _idRangesComputed = false;  // (X)
 };
 
 }  // namespace repl
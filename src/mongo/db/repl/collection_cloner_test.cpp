@@ -1148,5 +1148,34 @@ TEST_F(CollectionClonerTestNonResumable, NonResumableCursorErrorThenSuccessEqual
     clonerThread.join();
 }
 
+TEST(CollectionClonerRangeBoundsTest, SplitsSampleEvenly) {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < 16; ++i) {
+        sample.push_back(BSON("_id" << i));
+    }
+    auto bounds = CollectionCloner::computeRangeBounds(sample, 4);
+    ASSERT_EQUALS(3U, bounds.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 4), bounds[0]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 8), bounds[1]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 12), bounds[2]);
+}
+
+TEST(CollectionClonerRangeBoundsTest, SkipsDuplicateBounds) {
+    std::vector<BSONObj> sample = {BSON("_id" << 1),
+                                   BSON("_id" << 1),
+                                   BSON("_id" << 1),
+                                   BSON("_id" << 1),
+                                   BSON("_id" << 1),
+                                   BSON("_id" << 2)};
+    auto bounds = CollectionCloner::computeRangeBounds(sample, 3);
+    ASSERT_EQUALS(1U, bounds.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1), bounds[0]);
+}
+
+TEST(CollectionClonerRangeBoundsTest, NoBoundsForSingleRangeOrEmptySample) {
+    ASSERT(CollectionCloner::computeRangeBounds({BSON("_id" << 1), BSON("_id" << 2)}, 1).empty());
+    ASSERT(CollectionCloner::computeRangeBounds({}, 4).empty());
+}
+
 }  // namespace repl
 }  // namespace mongo
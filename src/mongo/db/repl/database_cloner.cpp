@@ -32,12 +32,15 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/string_data.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands/list_collections_filter.h"
 #include "mongo/db/repl/database_cloner.h"
 #include "mongo/db/repl/database_cloner_common.h"
 #include "mongo/db/repl/database_cloner_gen.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
 namespace repl {
@@ -125,21 +128,83 @@ void DatabaseCloner::postStage() {
             _stats.collectionStats.emplace_back();
             _stats.collectionStats.back().ns = coll.first.ns();
         }
+        _collectionCloners.resize(_collections.size());
     }
-    for (const auto& coll : _collections) {
-        auto& sourceNss = coll.first;
-        auto& collectionOptions = coll.second;
+
+    // This thread clones collections on the database cloner's own connection. Additional workers,
+    // if any, each clone collections on a new connection of their own.
+    const auto numWorkers = std::min(static_cast<size_t>(initialSyncParallelCollectionCloners),
+                                     _collections.size());
+    if (numWorkers > 1) {
+        ThreadPool::Options options;
+        options.poolName = "DatabaseClonerWorkers";
+        options.minThreads = 0;
+        options.maxThreads = numWorkers - 1;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+        ThreadPool workers(std::move(options));
+        workers.startup();
+        for (size_t i = 1; i < numWorkers; ++i) {
+            workers.schedule([this](Status status) {
+                if (!status.isOK()) {
+                    return;
+                }
+                std::unique_ptr<DBClientConnection> client;
+                try {
+                    client = makeClient();
+                } catch (const DBException& e) {
+                    // The other workers clone the collections this one would have.
+                    LOGV2_WARNING(4917800,
+                                  "Failed to open an additional connection to clone collections",
+                                  "database"_attr = _dbName,
+                                  "error"_attr = e);
+                    return;
+                }
+                cloneCollections(client.get());
+            });
+        }
+        cloneCollections(getClient());
+        workers.shutdown();
+        workers.join();
+    } else {
+        cloneCollections(getClient());
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    // The database cloner is aborted if a collection clone failed.
+    if (_collectionCloneFailed) {
+        return;
+    }
+    _stats.end = getSharedData()->getClock()->now();
+}
+
+void DatabaseCloner::cloneCollections(DBClientConnection* client) {
+    while (true) {
+        size_t index;
+        CollectionCloner* collectionCloner;
         {
             stdx::lock_guard<Latch> lk(_mutex);
-            _currentCollectionCloner = std::make_unique<CollectionCloner>(sourceNss,
-                                                                          collectionOptions,
-                                                                          getSharedData(),
-                                                                          getSource(),
-                                                                          getClient(),
-                                                                          getStorageInterface(),
-                                                                          getDBPool());
+            if (_collectionCloneFailed || _nextCollection == _collections.size()) {
+                return;
+            }
+            index = _nextCollection++;
+            const auto& [sourceNss, collectionOptions] = _collections[index];
+            _collectionCloners[index] = std::make_unique<CollectionCloner>(sourceNss,
+                                                                           collectionOptions,
+                                                                           getSharedData(),
+                                                                           getSource(),
+                                                                           client,
+                                                                           getStorageInterface(),
+                                                                           getDBPool());
+            collectionCloner = _collectionCloners[index].get();
+            if (getCreateClientFn()) {
+                collectionCloner->setCreateClientFn_forTest(getCreateClientFn());
+            }
         }
-        auto collStatus = _currentCollectionCloner->run();
+
+        const auto& sourceNss = collectionCloner->getSourceNss();
+        auto collStatus = collectionCloner->run();
         if (collStatus.isOK()) {
             LOGV2_DEBUG(21148,
                         1,
@@ -161,23 +226,25 @@ void DatabaseCloner::postStage() {
         }
         {
             stdx::lock_guard<Latch> lk(_mutex);
-            _stats.collectionStats[_stats.clonedCollections] = _currentCollectionCloner->getStats();
-            _currentCollectionCloner = nullptr;
-            // Abort the database cloner if the collection clone failed.
-            if (!collStatus.isOK())
+            _stats.collectionStats[index] = collectionCloner->getStats();
+            _collectionCloners[index] = nullptr;
+            // Stop cloning collections if the collection clone failed.
+            if (!collStatus.isOK()) {
+                _collectionCloneFailed = true;
                 return;
+            }
             _stats.clonedCollections++;
         }
     }
-    stdx::lock_guard<Latch> lk(_mutex);
-    _stats.end = getSharedData()->getClock()->now();
 }
 
 DatabaseCloner::Stats DatabaseCloner::getStats() const {
     stdx::lock_guard<Latch> lk(_mutex);
     DatabaseCloner::Stats stats = _stats;
-    if (_currentCollectionCloner) {
-        stats.collectionStats[_stats.clonedCollections] = _currentCollectionCloner->getStats();
+    for (size_t i = 0; i < _collectionCloners.size(); ++i) {
+        if (_collectionCloners[i]) {
+            stats.collectionStats[i] = _collectionCloners[i]->getStats();
+        }
     }
     return stats;
 }
@@ -87,10 +87,17 @@ private:
 
     /**
      * The postStage creates and runs the individual CollectionCloners on each database found on
-     * the sync source, and sets the end time in _stats when done.
+     * the sync source, and sets the end time in _stats when done. Up to
+     * initialSyncParallelCollectionCloners collections are cloned concurrently.
      */
     void postStage() final;
 
+    /**
+     * Clones the collections not yet claimed by another thread one after another, using 'client',
+     * until there are none left or a collection clone fails.
+     */
+    void cloneCollections(DBClientConnection* client);
+
     std::string describeForFuzzer(BaseClonerStage* stage) const final {
         return _dbName + " db: { " + stage->getName() + ": 1 } ";
     }
@@ -107,8 +114,12 @@ private:
     const std::string _dbName;                                                // (R)
     ClonerStage<DatabaseCloner> _listCollectionsStage;                        // (R)
     std::vector<std::pair<NamespaceString, CollectionOptions>> _collections;  // (X)
-    std::unique_ptr<CollectionCloner> _currentCollectionCloner;               // (MX)
-    Stats _stats;                                                             // (MX)
+    // The cloners of the collections being cloned, indexed like _collections.
+    std::vector<std::unique_ptr<CollectionCloner>> _collectionCloners;  // (M)
+    // The index in _collections of the next collection to clone.
+    size_t _nextCollection = 0;           // (M)
+    bool _collectionCloneFailed = false;  // (M)
+    Stats _stats;                         // (M)
 };
 
 }  // namespace repl
@@ -32,6 +32,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/repl/cloner_test_fixture.h"
 #include "mongo/db/repl/database_cloner.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/service_context_test_fixture.h"
@@ -39,6 +40,7 @@
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 #include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace repl {
@@ -61,6 +63,8 @@ protected:
                    const BSONObj& idIndexSpec,
                    const std::vector<BSONObj>& secondaryIndexSpecs)
             -> StatusWith<std::unique_ptr<CollectionBulkLoaderMock>> {
+            // Collections may be created concurrently by parallel collection cloners.
+            stdx::lock_guard<Latch> lk(_collectionsMutex);
             const auto collInfo = &_collections[nss];
 
             auto localLoader = std::make_unique<CollectionBulkLoaderMock>(collInfo->stats);
@@ -105,6 +109,7 @@ protected:
         return cloner->_collections;
     }
 
+    Mutex _collectionsMutex = MONGO_MAKE_LATCH("DatabaseClonerTest::_collectionsMutex");
     std::map<NamespaceString, CollectionCloneInfo> _collections;
 
     static std::string _dbName;
@@ -390,6 +395,52 @@ TEST_F(DatabaseClonerTest, CreateCollections) {
     ASSERT(stats.commitCalled);
 }
 
+TEST_F(DatabaseClonerTest, CreateCollectionsInParallel) {
+    auto oldParallelism = initialSyncParallelCollectionCloners;
+    initialSyncParallelCollectionCloners = 3;
+    ON_BLOCK_EXIT([&] { initialSyncParallelCollectionCloners = oldParallelism; });
+
+    const BSONObj idIndexSpec = BSON("v" << 1 << "key" << BSON("_id" << 1) << "name"
+                                         << "_id_");
+    std::vector<BSONObj> sourceInfos;
+    for (auto&& name : {"a", "b", "c"}) {
+        sourceInfos.push_back(BSON("name" << name << "type"
+                                          << "collection"
+                                          << "options" << BSONObj() << "info"
+                                          << BSON("readOnly" << false << "uuid" << UUID::gen())));
+    }
+    _mockServer->setCommandReply("listCollections", createListCollectionsResponse(sourceInfos));
+    _mockServer->setCommandReply(
+        "count", {createCountResponse(0), createCountResponse(0), createCountResponse(0)});
+    _mockServer->setCommandReply("listIndexes",
+                                 {createCursorResponse(_dbName + ".a", BSON_ARRAY(idIndexSpec)),
+                                  createCursorResponse(_dbName + ".b", BSON_ARRAY(idIndexSpec)),
+                                  createCursorResponse(_dbName + ".c", BSON_ARRAY(idIndexSpec))});
+    auto cloner = makeDatabaseCloner();
+    AtomicWord<int> numClientsCreated{0};
+    cloner->setCreateClientFn_forTest([&] {
+        numClientsCreated.fetchAndAdd(1);
+        return std::unique_ptr<DBClientConnection>(
+            new MockDBClientConnection(_mockServer.get()));
+    });
+    auto status = cloner->run();
+    ASSERT_OK(status);
+
+    // The cloner's own connection is used by one of the workers.
+    ASSERT_EQUALS(2, numClientsCreated.load());
+    ASSERT_EQUALS(3U, _collections.size());
+    for (auto&& name : {"a", "b", "c"}) {
+        auto stats = *_collections[NamespaceString{_dbName, name}].stats;
+        ASSERT_EQUALS(0, stats.insertCount);
+        ASSERT(stats.commitCalled);
+    }
+
+    auto dbStats = cloner->getStats();
+    ASSERT_EQUALS(3U, dbStats.collections);
+    ASSERT_EQUALS(3U, dbStats.clonedCollections);
+    ASSERT_NOT_EQUALS(Date_t(), dbStats.end);
+}
+
 TEST_F(DatabaseClonerTest, DatabaseAndCollectionStats) {
     auto uuid1 = UUID::gen();
     auto uuid2 = UUID::gen();
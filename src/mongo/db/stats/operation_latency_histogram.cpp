@@ -154,7 +154,7 @@ void OperationLatencyHistogram::append(bool includeHistograms,
 }
 
 // Computes the log base 2 of value, and checks for cases of split buckets.
-int OperationLatencyHistogram::_getBucket(uint64_t value) {
+int OperationLatencyHistogram::getBucket(uint64_t value) {
     // Zero is a special case since log(0) is undefined.
     if (value == 0) {
         return 0;
@@ -187,7 +187,7 @@ void OperationLatencyHistogram::_incrementData(uint64_t latency, int bucket, His
 }
 
 void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
-    int bucket = _getBucket(latency);
+    int bucket = getBucket(latency);
     switch (type) {
         case Command::ReadWriteType::kRead:
             _incrementData(latency, bucket, &_reads);
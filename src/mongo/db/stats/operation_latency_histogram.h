@@ -59,6 +59,11 @@ public:
      */
     void append(bool includeHistograms, bool slowMSBucketsOnly, BSONObjBuilder* builder) const;
 
+    /**
+     * Returns the index of the bucket that 'latency' falls into.
+     */
+    static int getBucket(uint64_t latency);
+
 private:
     struct HistogramData {
         std::array<uint64_t, kMaxBuckets> buckets{};
@@ -66,8 +71,6 @@ private:
         uint64_t sum = 0;
     };
 
-    static int _getBucket(uint64_t latency);
-
     static uint64_t _getBucketMicros(int bucket);
 
     void _append(const HistogramData& data,
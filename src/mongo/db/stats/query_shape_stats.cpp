@@ -0,0 +1,236 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_shape_stats.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+namespace {
+
+const auto getQueryShapeStatsStore = ServiceContext::declareDecoration<QueryShapeStatsStore>();
+
+constexpr auto kShapePlaceholder = "?"_sd;
+
+/**
+ * Arrays of objects hold the clauses of $and, $or and $nor, and the predicates of $elemMatch over
+ * arrays of documents, which are part of the shape. Any other array holds values.
+ */
+bool isArrayOfObjects(const BSONElement& elem) {
+    if (elem.type() != Array || elem.embeddedObject().isEmpty()) {
+        return false;
+    }
+    for (auto&& child : elem.embeddedObject()) {
+        if (child.type() != Object) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void shapifyInto(const BSONObj& obj, BSONObjBuilder* builder) {
+    for (auto&& elem : obj) {
+        if (elem.type() == Object) {
+            BSONObjBuilder subBuilder(builder->subobjStart(elem.fieldNameStringData()));
+            shapifyInto(elem.embeddedObject(), &subBuilder);
+        } else if (isArrayOfObjects(elem)) {
+            BSONArrayBuilder arrayBuilder(builder->subarrayStart(elem.fieldNameStringData()));
+            for (auto&& child : elem.embeddedObject()) {
+                BSONObjBuilder subBuilder(arrayBuilder.subobjStart());
+                shapifyInto(child.embeddedObject(), &subBuilder);
+            }
+        } else {
+            builder->append(elem.fieldNameStringData(), kShapePlaceholder);
+        }
+    }
+}
+
+}  // namespace
+
+QueryShapeStats::QueryShapeStats(NamespaceString nss,
+                                 uint32_t queryHash,
+                                 BSONObj shape,
+                                 Date_t firstSeen)
+    : _nss(std::move(nss)),
+      _queryHash(queryHash),
+      _shape(shape.getOwned()),
+      _firstSeen(firstSeen),
+      _lastSeenMillis(firstSeen.toMillisSinceEpoch()) {}
+
+void QueryShapeStats::record(bool isNewExecution,
+                             Microseconds latency,
+                             long long docsExamined,
+                             long long keysExamined,
+                             long long docsReturned,
+                             Date_t now) {
+    if (isNewExecution) {
+        _execCount.fetchAndAddRelaxed(1);
+    }
+    _docsExamined.fetchAndAddRelaxed(docsExamined);
+    _keysExamined.fetchAndAddRelaxed(keysExamined);
+    _docsReturned.fetchAndAddRelaxed(docsReturned);
+
+    const auto latencyMicros = std::max(durationCount<Microseconds>(latency), 0LL);
+    _totalLatencyMicros.fetchAndAddRelaxed(latencyMicros);
+    _latencyHistogram[OperationLatencyHistogram::getBucket(latencyMicros)].fetchAndAddRelaxed(1);
+
+    auto maxLatency = _maxLatencyMicros.loadRelaxed();
+    while (latencyMicros > maxLatency &&
+           !_maxLatencyMicros.compareAndSwap(&maxLatency, latencyMicros)) {
+    }
+
+    // Only the most recent operations need to agree on the last time the shape was seen.
+    const auto nowMillis = now.toMillisSinceEpoch();
+    if (nowMillis > _lastSeenMillis.loadRelaxed()) {
+        _lastSeenMillis.store(nowMillis);
+    }
+}
+
+void QueryShapeStats::append(BSONObjBuilder* builder) const {
+    builder->append("ns", _nss.ns());
+    builder->append("queryHash", unsignedIntToFixedLengthHex(_queryHash));
+    builder->append("shape", _shape);
+    builder->append("firstSeen", _firstSeen);
+    builder->append("lastSeen", Date_t::fromMillisSinceEpoch(_lastSeenMillis.loadRelaxed()));
+    builder->append("execCount", _execCount.loadRelaxed());
+    builder->append("docsExamined", _docsExamined.loadRelaxed());
+    builder->append("keysExamined", _keysExamined.loadRelaxed());
+    builder->append("docsReturned", _docsReturned.loadRelaxed());
+
+    BSONObjBuilder latencyBuilder(builder->subobjStart("latencyMicros"));
+    latencyBuilder.append("total", _totalLatencyMicros.loadRelaxed());
+    latencyBuilder.append("max", _maxLatencyMicros.loadRelaxed());
+    BSONArrayBuilder histogramBuilder(latencyBuilder.subarrayStart("histogram"));
+    for (int i = 0; i < OperationLatencyHistogram::kMaxBuckets; ++i) {
+        const auto count = _latencyHistogram[i].loadRelaxed();
+        if (count == 0) {
+            continue;
+        }
+        BSONObjBuilder entryBuilder(histogramBuilder.subobjStart());
+        entryBuilder.append("micros",
+                            static_cast<long long>(OperationLatencyHistogram::kLowerBounds[i]));
+        entryBuilder.append("count", count);
+    }
+}
+
+QueryShapeStatsStore& QueryShapeStatsStore::get(ServiceContext* serviceContext) {
+    return getQueryShapeStatsStore(serviceContext);
+}
+
+BSONObj QueryShapeStatsStore::shapify(const BSONObj& obj) {
+    BSONObjBuilder builder;
+    shapifyInto(obj, &builder);
+    return builder.obj();
+}
+
+QueryShapeStatsStore::QueryShapeStatsStore()
+    : QueryShapeStatsStore(internalQueryShapeStatsMaxEntries.load()) {}
+
+QueryShapeStatsStore::QueryShapeStatsStore(size_t maxEntries) {
+    const auto maxEntriesPerPartition =
+        std::max<size_t>((maxEntries + kNumPartitions - 1) / kNumPartitions, 1);
+    for (size_t i = 0; i < kNumPartitions; ++i) {
+        _partitions.push_back(std::make_unique<Partition>(maxEntriesPerPartition));
+    }
+}
+
+std::shared_ptr<QueryShapeStats> QueryShapeStatsStore::getOrCreate(const NamespaceString& nss,
+                                                                   StringData shapeKey,
+                                                                   uint32_t queryHash,
+                                                                   const BSONObj& filter,
+                                                                   const BSONObj& sort,
+                                                                   const BSONObj& projection) {
+    std::string key;
+    key.reserve(nss.size() + 1 + shapeKey.size());
+    key.append(nss.ns());
+    key.push_back('\0');
+    key.append(shapeKey.rawData(), shapeKey.size());
+
+    auto& partition = *_partitions[std::hash<std::string>{}(key) % kNumPartitions];
+    stdx::lock_guard<Latch> lk(partition.mutex);
+
+    std::shared_ptr<QueryShapeStats>* existing;
+    if (partition.entries.get(key, &existing).isOK()) {
+        return *existing;
+    }
+
+    auto stats = std::make_shared<QueryShapeStats>(
+        nss,
+        queryHash,
+        BSON("filter" << shapify(filter) << "sort" << sort << "projection" << projection),
+        Date_t::now());
+    partition.entries.add(key, new std::shared_ptr<QueryShapeStats>(stats));
+    return stats;
+}
+
+std::vector<BSONObj> QueryShapeStatsStore::getStats() const {
+    std::vector<std::shared_ptr<QueryShapeStats>> entries;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> lk(partition->mutex);
+        for (auto&& entry : partition->entries) {
+            entries.push_back(*entry.second);
+        }
+    }
+
+    // Build the documents outside of the partition mutexes so that reading the store does not
+    // hold up the queries registering their shape.
+    std::vector<BSONObj> stats;
+    stats.reserve(entries.size());
+    for (auto&& entry : entries) {
+        BSONObjBuilder builder;
+        entry->append(&builder);
+        stats.push_back(builder.obj());
+    }
+    return stats;
+}
+
+void QueryShapeStatsStore::clear() {
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> lk(partition->mutex);
+        partition->entries.clear();
+    }
+}
+
+size_t QueryShapeStatsStore::size() const {
+    size_t size = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> lk(partition->mutex);
+        size += partition->entries.size();
+    }
+    return size;
+}
+
+}  // namespace mongo
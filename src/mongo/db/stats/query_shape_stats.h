@@ -0,0 +1,169 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+/**
+ * The runtime statistics accumulated over every execution of the queries of one shape against one
+ * collection. Operations running queries of the same shape update them concurrently without
+ * taking any lock.
+ */
+class QueryShapeStats {
+public:
+    QueryShapeStats(NamespaceString nss, uint32_t queryHash, BSONObj shape, Date_t firstSeen);
+
+    /**
+     * Records the work done by one operation running a query of this shape. The getMores which
+     * continue a query that was already recorded pass false for 'isNewExecution', so that they add
+     * to the totals without being counted as another execution.
+     */
+    void record(bool isNewExecution,
+                Microseconds latency,
+                long long docsExamined,
+                long long keysExamined,
+                long long docsReturned,
+                Date_t now);
+
+    /**
+     * Appends a snapshot of the statistics to 'builder'.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+    const NamespaceString& nss() const {
+        return _nss;
+    }
+
+    long long execCount() const {
+        return _execCount.load();
+    }
+
+private:
+    const NamespaceString _nss;
+    const uint32_t _queryHash;
+
+    // A representative of the queries of this shape, with the values of its predicates replaced.
+    const BSONObj _shape;
+
+    const Date_t _firstSeen;
+    AtomicWord<long long> _lastSeenMillis;
+
+    AtomicWord<long long> _execCount{0};
+    AtomicWord<long long> _docsExamined{0};
+    AtomicWord<long long> _keysExamined{0};
+    AtomicWord<long long> _docsReturned{0};
+    AtomicWord<long long> _totalLatencyMicros{0};
+    AtomicWord<long long> _maxLatencyMicros{0};
+    std::array<AtomicWord<long long>, OperationLatencyHistogram::kMaxBuckets> _latencyHistogram{};
+};
+
+/**
+ * A bounded in-memory store of QueryShapeStats keyed by namespace and query shape, read through
+ * the $queryShapeStats aggregation stage. Shapes are identified by the stable part of the plan
+ * cache key computed by the canonical query encoder, so the queries that share a plan cache entry
+ * also share their statistics.
+ *
+ * The store is split into partitions, each with its own mutex and least recently used eviction
+ * policy, so that concurrent queries seldom contend on registering their shape. The statistics of
+ * a shape are updated outside of the store, through the shared_ptr that registering it returns.
+ */
+class QueryShapeStatsStore {
+public:
+    static constexpr size_t kNumPartitions = 16;
+
+    static QueryShapeStatsStore& get(ServiceContext* serviceContext);
+
+    /**
+     * Returns a copy of 'obj' in which every value other than an object, or an array of objects, is
+     * replaced by the string "?". Operators and field names are kept, so queries which differ only
+     * in the values they compare against have the same representation.
+     */
+    static BSONObj shapify(const BSONObj& obj);
+
+    /**
+     * Constructs a store holding up to 'internalQueryShapeStatsMaxEntries' shapes.
+     */
+    QueryShapeStatsStore();
+
+    explicit QueryShapeStatsStore(size_t maxEntries);
+
+    /**
+     * Returns the statistics for the queries against 'nss' whose stable plan cache key is
+     * 'shapeKey', creating them if the shape was not seen yet. 'filter', 'sort' and 'projection'
+     * are only used to build the representative of a new shape.
+     */
+    std::shared_ptr<QueryShapeStats> getOrCreate(const NamespaceString& nss,
+                                                 StringData shapeKey,
+                                                 uint32_t queryHash,
+                                                 const BSONObj& filter,
+                                                 const BSONObj& sort,
+                                                 const BSONObj& projection);
+
+    /**
+     * Returns a snapshot of the statistics of every shape in the store.
+     */
+    std::vector<BSONObj> getStats() const;
+
+    /**
+     * Removes every shape from the store. Operations which already registered their shape keep
+     * updating statistics which are no longer reported.
+     */
+    void clear();
+
+    size_t size() const;
+
+private:
+    struct Partition {
+        explicit Partition(size_t maxEntries) : entries(maxEntries) {}
+
+        mutable Mutex mutex = MONGO_MAKE_LATCH("QueryShapeStatsStore::Partition::mutex");
+        LRUKeyValue<std::string, std::shared_ptr<QueryShapeStats>> entries;
+    };
+
+    std::vector<std::unique_ptr<Partition>> _partitions;
+};
+
+}  // namespace mongo
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_shape_stats.h"
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+const NamespaceString kNss("test.coll");
+
+BSONObj getStats(const QueryShapeStats& stats) {
+    BSONObjBuilder builder;
+    stats.append(&builder);
+    return builder.obj();
+}
+
+TEST(QueryShapeStatsTest, ShapifyReplacesValues) {
+    const auto query = fromjson("{a: 1, b: {$in: [1, 2]}, c: {$gt: 'x', $lt: 'y'}}");
+    ASSERT_BSONOBJ_EQ(QueryShapeStatsStore::shapify(query),
+                      fromjson("{a: '?', b: {$in: '?'}, c: {$gt: '?', $lt: '?'}}"));
+}
+
+TEST(QueryShapeStatsTest, ShapifyKeepsLogicalOperatorClauses) {
+    ASSERT_BSONOBJ_EQ(
+        QueryShapeStatsStore::shapify(fromjson("{$or: [{a: 1}, {b: {$elemMatch: {c: 2}}}]}")),
+        fromjson("{$or: [{a: '?'}, {b: {$elemMatch: {c: '?'}}}]}"));
+}
+
+TEST(QueryShapeStatsTest, RecordAccumulatesExecutions) {
+    QueryShapeStats stats(kNss, 0xdeadbeef, BSON("filter" << BSON("a" << "?")), Date_t());
+    stats.record(true, Microseconds(100), 10, 5, 2, Date_t::fromMillisSinceEpoch(1000));
+    stats.record(false, Microseconds(3000), 20, 0, 3, Date_t::fromMillisSinceEpoch(2000));
+    stats.record(true, Microseconds(100), 1, 1, 1, Date_t::fromMillisSinceEpoch(1500));
+
+    const auto obj = getStats(stats);
+    ASSERT_EQ(obj["ns"].str(), kNss.ns());
+    ASSERT_EQ(obj["queryHash"].str(), "DEADBEEF");
+    ASSERT_EQ(obj["execCount"].numberLong(), 2);
+    ASSERT_EQ(obj["docsExamined"].numberLong(), 31);
+    ASSERT_EQ(obj["keysExamined"].numberLong(), 6);
+    ASSERT_EQ(obj["docsReturned"].numberLong(), 6);
+    ASSERT_EQ(obj["lastSeen"].date(), Date_t::fromMillisSinceEpoch(2000));
+
+    const auto latency = obj["latencyMicros"].embeddedObject();
+    ASSERT_EQ(latency["total"].numberLong(), 3200);
+    ASSERT_EQ(latency["max"].numberLong(), 3000);
+    ASSERT_BSONOBJ_EQ(latency["histogram"].embeddedObject(),
+                      BSON_ARRAY(BSON("micros" << 64LL << "count" << 2LL)
+                                 << BSON("micros" << 2048LL << "count" << 1LL)));
+}
+
+TEST(QueryShapeStatsTest, StoreReturnsSameStatsForSameShape) {
+    QueryShapeStatsStore store(100);
+    auto stats = store.getOrCreate(kNss, "eqa", 1, BSON("a" << 1), BSONObj(), BSONObj());
+    ASSERT(stats);
+    ASSERT_EQ(stats.get(),
+              store.getOrCreate(kNss, "eqa", 1, BSON("a" << 2), BSONObj(), BSONObj()).get());
+    ASSERT_NE(stats.get(),
+              store.getOrCreate(kNss, "eqb", 2, BSON("b" << 1), BSONObj(), BSONObj()).get());
+    ASSERT_NE(stats.get(),
+              store
+                  .getOrCreate(NamespaceString("test.other"),
+                               "eqa",
+                               1,
+                               BSON("a" << 1),
+                               BSONObj(),
+                               BSONObj())
+                  .get());
+    ASSERT_EQ(store.size(), 3U);
+
+    const auto obj = getStats(*stats);
+    ASSERT_BSONOBJ_EQ(obj["shape"].embeddedObject(),
+                      fromjson("{filter: {a: '?'}, sort: {}, projection: {}}"));
+}
+
+TEST(QueryShapeStatsTest, StoreIsBounded) {
+    QueryShapeStatsStore store(QueryShapeStatsStore::kNumPartitions);
+    for (int i = 0; i < 1000; ++i) {
+        store.getOrCreate(kNss, std::to_string(i), i, BSON("a" << i), BSONObj(), BSONObj());
+    }
+    ASSERT_LTE(store.size(), QueryShapeStatsStore::kNumPartitions);
+    ASSERT_EQ(store.getStats().size(), store.size());
+}
+
+TEST(QueryShapeStatsTest, ClearRemovesAllShapes) {
+    QueryShapeStatsStore store(100);
+    auto stats = store.getOrCreate(kNss, "eqa", 1, BSON("a" << 1), BSONObj(), BSONObj());
+    stats->record(true, Microseconds(1), 1, 1, 1, Date_t::now());
+    ASSERT_EQ(store.getStats().size(), 1U);
+
+    store.clear();
+    ASSERT_EQ(store.size(), 0U);
+    ASSERT(store.getStats().empty());
+
+    // The shape starts over once it is seen again.
+    auto newStats = store.getOrCreate(kNss, "eqa", 1, BSON("a" << 1), BSONObj(), BSONObj());
+    ASSERT_NE(stats.get(), newStats.get());
+    ASSERT_EQ(newStats->execCount(), 0);
+}
+
+}  // namespace
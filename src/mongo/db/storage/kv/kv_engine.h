@@ -279,6 +279,14 @@ public:
         return true;
     }
 
+    /**
+     * Returns true if record stores created with the 'clusteredIndex' collection option use the
+     * _id of each document as its RecordId. This must not change over the lifetime of the engine.
+     */
+    virtual bool supportsClusteredIdIndex() const {
+        return false;
+    }
+
     /**
      * Returns true if storage engine supports --directoryperdb.
      * See:
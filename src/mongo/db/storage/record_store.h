@@ -462,6 +462,9 @@ public:
      * Return the RecordId of an oplog entry as close to startingPosition as possible without
      * being higher. If there are no entries <= startingPosition, return RecordId().
      *
+     * Record stores of clustered collections may implement this too, to position scans over a
+     * range of _ids.
+     *
      * If you don't implement the oplogStartHack, just use the default implementation which
      * returns boost::none.
      */
@@ -199,6 +199,12 @@ public:
      */
     virtual bool supportsCappedCollections() const = 0;
 
+    /**
+     * Returns whether the storage engine supports clustered collections, whose records are keyed
+     * by the _id of their documents.
+     */
+    virtual bool supportsClusteredIdIndex() const = 0;
+
     /**
      * Returns whether the storage engine supports checkpoints.
      */
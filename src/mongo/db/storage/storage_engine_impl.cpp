@@ -789,6 +789,10 @@ bool StorageEngineImpl::supportsCheckpoints() const {
     return _engine->supportsCheckpoints();
 }
 
+bool StorageEngineImpl::supportsClusteredIdIndex() const {
+    return _engine->supportsClusteredIdIndex();
+}
+
 bool StorageEngineImpl::isDurable() const {
     return _engine->isDurable();
 }
@@ -103,6 +103,8 @@ public:
 
     virtual bool supportsCheckpoints() const override;
 
+    virtual bool supportsClusteredIdIndex() const override;
+
     virtual bool isDurable() const override;
 
     virtual bool isEphemeral() const override;
@@ -54,6 +54,9 @@ public:
     bool supportsCheckpoints() const final {
         return false;
     }
+    bool supportsClusteredIdIndex() const final {
+        return false;
+    }
     bool isDurable() const final {
         return false;
     }
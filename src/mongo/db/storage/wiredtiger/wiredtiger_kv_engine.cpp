@@ -1622,6 +1622,7 @@ std::unique_ptr<RecordStore> WiredTigerKVEngine::getGroupedRecordStore(
     params.sizeStorer = _sizeStorer.get();
     params.isReadOnly = _readOnly;
     params.tracksSizeAdjustments = true;
+    params.isClustered = options.clusteredIndex;
 
     params.cappedMaxSize = -1;
     if (options.capped) {
@@ -119,6 +119,10 @@ public:
         return !isEphemeral();
     }
 
+    bool supportsClusteredIdIndex() const override {
+        return true;
+    }
+
     bool isDurable() const override {
         return _durable;
     }
@@ -52,6 +52,8 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_key.h"
+#include "mongo/db/storage/index_entry_comparison.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/oplog_stone_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
@@ -102,6 +104,37 @@ void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
 
     fassertNoTrace(39998, appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
+
+/**
+ * Standard record stores are keyed by 64-bit integers, or by strings of bytes if they are
+ * clustered.
+ */
+RecordId getStandardKey(WT_CURSOR* cursor, bool isClustered) {
+    if (isClustered) {
+        WT_ITEM item;
+        invariantWTOK(cursor->get_key(cursor, &item));
+        return RecordId(static_cast<const char*>(item.data), item.size);
+    }
+
+    std::int64_t recordId;
+    invariantWTOK(cursor->get_key(cursor, &recordId));
+    return RecordId(recordId);
+}
+
+/**
+ * WiredTiger does not copy a key made of bytes, so 'id' must be kept alive until 'cursor' has been
+ * positioned with it. As RecordIds share their bytes, any copy of 'id' will do.
+ */
+void setStandardKey(WT_CURSOR* cursor, const RecordId& id, bool isClustered) {
+    if (isClustered) {
+        const auto str = id.getStr();
+        WiredTigerItem item(str.rawData(), str.size());
+        cursor->set_key(cursor, item.Get());
+        return;
+    }
+
+    cursor->set_key(cursor, id.repr());
+}
 }  // namespace
 
 MONGO_FAIL_POINT_DEFINE(WTWriteConflictException);
@@ -658,9 +691,7 @@ public:
             return {};
         invariantWTOK(advanceRet);
 
-        int64_t key;
-        invariantWTOK(_cursor->get_key(_cursor, &key));
-        const RecordId id = RecordId(key);
+        const RecordId id = getStandardKey(_cursor, _rs->_isClustered);
 
         WT_ITEM value;
         invariantWTOK(_cursor->get_value(_cursor, &value));
@@ -766,7 +797,13 @@ StatusWith<std::string> WiredTigerRecordStore::generateCreateString(
 
     // WARNING: No user-specified config can appear below this line. These options are required
     // for correct behavior of the server.
-    if (prefixed) {
+    if (options.clusteredIndex) {
+        if (prefixed) {
+            return {ErrorCodes::InvalidOptions, "clustered collections cannot be grouped"};
+        }
+        // The records are keyed by the KeyStrings of their _ids, see clusteredkey::keyForId().
+        ss << "key_format=u";
+    } else if (prefixed) {
         ss << "key_format=qq";
     } else {
         ss << "key_format=q";
@@ -810,6 +847,7 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
                     getGlobalReplSettings().usingReplSets() ||
                         repl::ReplSettings::shouldRecoverFromOplogAsStandalone())),
       _isOplog(NamespaceString::oplog(params.ns)),
+      _isClustered(params.isClustered),
       _cappedMaxSize(params.cappedMaxSize),
       _cappedMaxSizeSlack(std::min(params.cappedMaxSize / 10, int64_t(16 * 1024 * 1024))),
       _cappedMaxDocs(params.cappedMaxDocs),
@@ -1475,11 +1513,19 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
+        } else if (_isClustered) {
+            StatusWith<RecordId> status =
+                clusteredkey::extractKey(record.data.data(), record.data.size());
+            if (!status.isOK())
+                return status.getStatus();
+            record.id = status.getValue();
         } else {
             record.id = _nextId(opCtx);
         }
-        dassert(record.id > highestIdRecord.id);
-        highestIdRecord = record;
+        // The records of a clustered collection are inserted in the order of the documents.
+        dassert(_isClustered || record.id > highestIdRecord.id);
+        if (record.id > highestIdRecord.id)
+            highestIdRecord = record;
     }
 
     for (size_t i = 0; i < nRecords; i++) {
@@ -1501,6 +1547,22 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             LOGV2_DEBUG(22403, 4, "inserting record with timestamp {ts}", "ts"_attr = ts);
             fassert(39001, opCtx->recoveryUnit()->setTimestamp(ts));
         }
+        if (_isClustered) {
+            // The _id is the key of the record, so there is no _id index to reject duplicates.
+            // The cursor overwrites existing records, so look for the key before inserting it.
+            setKey(c, record.id);
+            int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+            if (ret == 0) {
+                const BSONObj obj(record.data.data());
+                return buildDupKeyErrorStatus(obj["_id"].wrap(""),
+                                              NamespaceString(ns()),
+                                              "_id_",
+                                              BSON("_id" << 1),
+                                              BSONObj());
+            }
+            if (ret != WT_NOTFOUND)
+                return wtRCToStatus(ret, "WiredTigerRecordStore::insertRecord");
+        }
         setKey(c, record.id);
         WiredTigerItem value(record.data.data(), record.data.size());
         c->set_value(c, value.Get());
@@ -1850,30 +1912,31 @@ boost::optional<RecordId> WiredTigerRecordStore::oplogStartHack(
     OperationContext* opCtx, const RecordId& startingPosition) const {
     dassert(opCtx->lockState()->isReadLocked());
 
-    if (!_isOplog)
+    if (!_isOplog && !_isClustered)
         return boost::none;
 
-    auto wtRu = WiredTigerRecoveryUnit::get(opCtx);
-    wtRu->setIsOplogReader();
-
     RecordId searchFor = startingPosition;
-    auto visibilityTs = wtRu->getOplogVisibilityTs();
-    if (visibilityTs && searchFor.repr() > *visibilityTs) {
-        searchFor = RecordId(*visibilityTs);
+    if (_isOplog) {
+        auto wtRu = WiredTigerRecoveryUnit::get(opCtx);
+        wtRu->setIsOplogReader();
+
+        auto visibilityTs = wtRu->getOplogVisibilityTs();
+        if (visibilityTs && searchFor.repr() > *visibilityTs) {
+            searchFor = RecordId(*visibilityTs);
+        }
     }
 
     WiredTigerCursor cursor(_uri, _tableId, true, opCtx);
     WT_CURSOR* c = cursor.get();
 
+    // Unlike oplog documents, the documents of a clustered collection may be prepared.
     int cmp;
     setKey(c, searchFor);
-    int ret = c->search_near(c, &cmp);
-    if (ret == 0 && cmp > 0)
-        ret = c->prev(c);  // landed one higher than startingPosition
+    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search_near(c, &cmp); });
+    if (ret == 0 && cmp > 0)  // landed one higher than startingPosition
+        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->prev(c); });
     if (ret == WT_NOTFOUND)
         return RecordId();  // nothing <= startingPosition
-    // It's illegal for oplog documents to be in a prepare state.
-    invariant(ret != WT_PREPARE_CONFLICT);
     invariantWTOK(ret);
 
     return getKey(c);
@@ -1894,6 +1957,11 @@ void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* opCtx,
 }
 
 void WiredTigerRecordStore::_initNextIdIfNeeded(OperationContext* opCtx) {
+    // The RecordIds of a clustered record store come from the _ids of its documents.
+    if (_isClustered) {
+        return;
+    }
+
     // In the normal case, this will already be initialized, so use a weak load. Since this value
     // will only change from 0 to a positive integer, the only risk is reading an outdated value, 0,
     // and having to take the mutex.
@@ -2311,13 +2379,11 @@ StandardWiredTigerRecordStore::StandardWiredTigerRecordStore(WiredTigerKVEngine*
     : WiredTigerRecordStore(kvEngine, opCtx, params) {}
 
 RecordId StandardWiredTigerRecordStore::getKey(WT_CURSOR* cursor) const {
-    std::int64_t recordId;
-    invariantWTOK(cursor->get_key(cursor, &recordId));
-    return RecordId(recordId);
+    return getStandardKey(cursor, _isClustered);
 }
 
 void StandardWiredTigerRecordStore::setKey(WT_CURSOR* cursor, RecordId id) const {
-    cursor->set_key(cursor, id.repr());
+    setStandardKey(cursor, id, _isClustered);
 }
 
 std::unique_ptr<SeekableRecordCursor> StandardWiredTigerRecordStore::getCursor(
@@ -2347,19 +2413,16 @@ WiredTigerRecordStoreStandardCursor::WiredTigerRecordStoreStandardCursor(
     : WiredTigerRecordStoreCursorBase(opCtx, rs, forward) {}
 
 void WiredTigerRecordStoreStandardCursor::setKey(WT_CURSOR* cursor, RecordId id) const {
-    cursor->set_key(cursor, id.repr());
+    setStandardKey(cursor, id, _rs._isClustered);
 }
 
 RecordId WiredTigerRecordStoreStandardCursor::getKey(WT_CURSOR* cursor) const {
-    std::int64_t recordId;
-    invariantWTOK(cursor->get_key(cursor, &recordId));
-
-    return RecordId(recordId);
+    return getStandardKey(cursor, _rs._isClustered);
 }
 
 bool WiredTigerRecordStoreStandardCursor::hasWrongPrefix(WT_CURSOR* cursor,
                                                          RecordId* recordId) const {
-    invariantWTOK(cursor->get_key(cursor, recordId));
+    *recordId = getKey(cursor);
     return false;
 }
 
@@ -2428,7 +2491,9 @@ RecordId WiredTigerRecordStorePrefixedCursor::getKey(WT_CURSOR* cursor) const {
 bool WiredTigerRecordStorePrefixedCursor::hasWrongPrefix(WT_CURSOR* cursor,
                                                          RecordId* recordId) const {
     std::int64_t prefix;
-    invariantWTOK(cursor->get_key(cursor, &prefix, recordId));
+    std::int64_t repr;
+    invariantWTOK(cursor->get_key(cursor, &prefix, &repr));
+    *recordId = RecordId(repr);
 
     return prefix != _prefix.repr();
 }
@@ -2436,9 +2501,9 @@ bool WiredTigerRecordStorePrefixedCursor::hasWrongPrefix(WT_CURSOR* cursor,
 void WiredTigerRecordStorePrefixedCursor::initCursorToBeginning() {
     WT_CURSOR* cursor = _cursor->get();
     if (_forward) {
-        cursor->set_key(cursor, _prefix.repr(), RecordId::min());
+        cursor->set_key(cursor, _prefix.repr(), RecordId::min().repr());
     } else {
-        cursor->set_key(cursor, _prefix.repr(), RecordId::max());
+        cursor->set_key(cursor, _prefix.repr(), RecordId::max().repr());
     }
 
     int exact;
@@ -72,6 +72,7 @@ extern const std::string kWiredTigerEngineName;
 
 class WiredTigerRecordStore : public RecordStore {
     friend class WiredTigerRecordStoreCursorBase;
+    friend class WiredTigerRecordStoreStandardCursor;
 
     friend class StandardWiredTigerRecordStore;
     friend class PrefixedWiredTigerRecordStore;
@@ -114,6 +115,8 @@ public:
         WiredTigerSizeStorer* sizeStorer;
         bool isReadOnly;
         bool tracksSizeAdjustments;
+        // Records are keyed by the _id of their documents, see clusteredkey::extractKey().
+        bool isClustered = false;
     };
 
     WiredTigerRecordStore(WiredTigerKVEngine* kvEngine, OperationContext* opCtx, Params params);
@@ -356,6 +359,8 @@ private:
     const bool _isLogged;
     // True if the namespace of this record store starts with "local.oplog.", and false otherwise.
     const bool _isOplog;
+    // True if the RecordIds of this record store are made of the _id of its documents.
+    const bool _isClustered;
     int64_t _cappedMaxSize;
     const int64_t _cappedMaxSizeSlack;  // when to start applying backpressure
     const int64_t _cappedMaxDocs;
@@ -36,6 +36,7 @@
 #include <memory>
 
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
@@ -45,6 +46,8 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/logv2/log.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -189,7 +192,33 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
 
 namespace {
 AtomicWord<unsigned long long> nextTableId(WiredTigerSession::kLastTableId);
+
+template <size_t N>
+void recordInHistogram(std::array<AtomicWord<long long>, N>* histogram, long long value) {
+    size_t bucket = 0;
+    while (value > 0 && bucket < N - 1) {
+        value >>= 1;
+        ++bucket;
+    }
+    (*histogram)[bucket].fetchAndAdd(1);
+}
+
+template <size_t N>
+void appendHistogram(BSONObjBuilder* builder,
+                     StringData histogramName,
+                     StringData boundName,
+                     const std::array<AtomicWord<long long>, N>& histogram) {
+    BSONArrayBuilder arrayBuilder(builder->subarrayStart(histogramName));
+    for (size_t bucket = 0; bucket < N; ++bucket) {
+        auto count = histogram[bucket].load();
+        if (count == 0) {
+            continue;
+        }
+        long long lowerBound = bucket == 0 ? 0 : 1LL << (bucket - 1);
+        arrayBuilder.append(BSON(boundName << lowerBound << "count" << count));
+    }
 }
+}  // namespace
 // static
 uint64_t WiredTigerSession::genTableId() {
     return nextTableId.fetchAndAdd(1);
@@ -220,11 +249,12 @@ void WiredTigerSessionCache::shuttingDown() {
     if (_shuttingDown.fetchAndBitOr(kShuttingDownMask) & kShuttingDownMask)
         return;
 
-    // Spin as long as there are threads in releaseSession
+    // Spin as long as there are threads in releaseSession or waitUntilDurable
     while (_shuttingDown.load() != kShuttingDownMask) {
         sleepmillis(1);
     }
 
+    _shutDownGroupCommit();
     closeAll();
 }
 
@@ -322,19 +352,31 @@ void WiredTigerSessionCache::waitUntilDurable(OperationContext* opCtx,
         token = journalListener->getToken(opCtx);
     }
 
-    uint32_t start = _lastSyncTime.load();
-    // Do the remainder in a critical section that ensures only a single thread at a time
-    // will attempt to synchronize.
-    stdx::unique_lock<Latch> lk(_lastSyncMutex);
-    uint32_t current = _lastSyncTime.loadRelaxed();  // synchronized with writes through mutex
-    if (current != start) {
-        // Someone else synced already since we read lastSyncTime, so we're done!
-        return;
+    if (gWiredTigerGroupCommitEnabled.load()) {
+        // Let the group commit thread flush on behalf of this and all other concurrent callers.
+        _enqueueGroupCommit().get();
+    } else {
+        uint32_t start = _lastSyncTime.load();
+        // Do the remainder in a critical section that ensures only a single thread at a time
+        // will attempt to synchronize.
+        stdx::unique_lock<Latch> lk(_lastSyncMutex);
+        uint32_t current = _lastSyncTime.loadRelaxed();  // synchronized with writes through mutex
+        if (current != start) {
+            // Someone else synced already since we read lastSyncTime, so we're done!
+            return;
+        }
+        _lastSyncTime.store(current + 1);
+
+        // Nobody has synched yet, so we have to sync ourselves.
+        _flushJournal(lk);
     }
-    _lastSyncTime.store(current + 1);
 
-    // Nobody has synched yet, so we have to sync ourselves.
+    if (token) {
+        journalListener->onDurable(token.get());
+    }
+}
 
+void WiredTigerSessionCache::_flushJournal(WithLock) {
     // Initialize on first use.
     if (!_waitUntilDurableSession) {
         invariantWTOK(
@@ -349,10 +391,88 @@ void WiredTigerSessionCache::waitUntilDurable(OperationContext* opCtx,
         invariantWTOK(_waitUntilDurableSession->checkpoint(_waitUntilDurableSession, nullptr));
         LOGV2_DEBUG(22420, 4, "created checkpoint");
     }
+}
 
-    if (token) {
-        journalListener->onDurable(token.get());
+Future<void> WiredTigerSessionCache::_enqueueGroupCommit() {
+    auto pf = makePromiseFuture<void>();
+
+    stdx::lock_guard<Latch> lk(_groupCommitMutex);
+    invariant(!_groupCommitShuttingDown);
+    if (!_groupCommitThread.joinable()) {
+        _groupCommitThread = stdx::thread([this] { _groupCommitLoop(); });
     }
+    _groupCommitQueue.push_back({std::move(pf.promise), Timer()});
+    _groupCommitCond.notify_one();
+    return std::move(pf.future);
+}
+
+void WiredTigerSessionCache::_groupCommitLoop() {
+    setThreadName("WTGroupCommit");
+
+    std::vector<GroupCommitWaiter> batch;
+    stdx::unique_lock<Latch> lk(_groupCommitMutex);
+    while (true) {
+        {
+            MONGO_IDLE_THREAD_BLOCK;
+            _groupCommitCond.wait(
+                lk, [&] { return _groupCommitShuttingDown || !_groupCommitQueue.empty(); });
+        }
+        if (_groupCommitQueue.empty()) {
+            invariant(_groupCommitShuttingDown);
+            return;
+        }
+
+        // Give more callers the chance to join the batch, unless enough of them already have.
+        auto interval = Microseconds(gWiredTigerGroupCommitIntervalMicros.load());
+        if (interval > Microseconds(0)) {
+            _groupCommitCond.wait_for(lk, interval.toSystemDuration(), [&] {
+                return _groupCommitShuttingDown ||
+                    _groupCommitQueue.size() >=
+                    static_cast<size_t>(gWiredTigerGroupCommitMaxBatchSize.load());
+            });
+        }
+
+        // The flush below starts after every caller in the batch queued up, so it makes all their
+        // writes durable. Callers which queue up in the meantime form the next batch.
+        batch.swap(_groupCommitQueue);
+        lk.unlock();
+
+        {
+            stdx::lock_guard<Latch> syncLk(_lastSyncMutex);
+            _lastSyncTime.fetchAndAdd(1);
+            _flushJournal(syncLk);
+        }
+
+        _numGroupCommits.fetchAndAdd(1);
+        _numGroupCommitWaiters.fetchAndAdd(batch.size());
+        recordInHistogram(&_groupCommitBatchSizes, batch.size());
+        for (auto&& waiter : batch) {
+            recordInHistogram(&_groupCommitWaitMicros, waiter.queuedTimer.micros());
+            waiter.promise.emplaceValue();
+        }
+        batch.clear();
+
+        lk.lock();
+    }
+}
+
+void WiredTigerSessionCache::_shutDownGroupCommit() {
+    {
+        stdx::lock_guard<Latch> lk(_groupCommitMutex);
+        _groupCommitShuttingDown = true;
+    }
+
+    if (_groupCommitThread.joinable()) {
+        _groupCommitCond.notify_one();
+        _groupCommitThread.join();
+    }
+}
+
+void WiredTigerSessionCache::appendGroupCommitStats(BSONObjBuilder* builder) const {
+    builder->append("commits", _numGroupCommits.load());
+    builder->append("waiters", _numGroupCommitWaiters.load());
+    appendHistogram(builder, "batch sizes", "size", _groupCommitBatchSizes);
+    appendHistogram(builder, "wait micros", "micros", _groupCommitWaitMicros);
 }
 
 void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx,
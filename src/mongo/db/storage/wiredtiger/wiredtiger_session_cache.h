@@ -29,8 +29,10 @@
 
 #pragma once
 
+#include <array>
 #include <list>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
@@ -38,10 +40,17 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/future.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -298,9 +307,11 @@ public:
     /**
      * Waits until all commits that happened before this call are made durable.
      *
-     * Specifying Fsync::kJournal will flush only the (oplog) journal to disk. Callers are
-     * serialized by a mutex and will return early if it is discovered that another thread started
-     * and completed a flush while they slept.
+     * Specifying Fsync::kJournal will flush only the (oplog) journal to disk. Callers queue up on
+     * a dedicated group commit thread, which flushes once on behalf of every caller that queued
+     * before the flush started, and wakes them up when it completes. If group commit is disabled,
+     * callers are instead serialized by a mutex and will return early if it is discovered that
+     * another thread started and completed a flush while they slept.
      *
      * Specifying Fsync::kCheckpointStableTimestamp will take a checkpoint up to and including the
      * stable timestamp.
@@ -363,7 +374,47 @@ public:
         return _prepareCommitOrAbortCounter.loadRelaxed();
     }
 
+    /**
+     * Appends the number of group commits, the number of callers they made durable and histograms
+     * of their batch sizes and of the time callers spent waiting for them.
+     */
+    void appendGroupCommitStats(BSONObjBuilder* builder) const;
+
 private:
+    // Power of two buckets: bucket 'i' counts the values in [2^(i-1), 2^i), bucket 0 counts zeros
+    // and the last bucket also counts everything above it.
+    static constexpr size_t kNumGroupCommitHistogramBuckets = 24;
+    using GroupCommitHistogram =
+        std::array<AtomicWord<long long>, kNumGroupCommitHistogramBuckets>;
+
+    struct GroupCommitWaiter {
+        Promise<void> promise;
+        Timer queuedTimer;
+    };
+
+    /**
+     * Flushes the journal, or takes a checkpoint if journaling is disabled. Must be called while
+     * holding '_lastSyncMutex'.
+     */
+    void _flushJournal(WithLock);
+
+    /**
+     * Queues the caller for the next group commit, starting the group commit thread on first use.
+     * The returned future is ready once a flush that started after this call has completed.
+     */
+    Future<void> _enqueueGroupCommit();
+
+    /**
+     * Body of the group commit thread: waits for callers to queue up, then flushes on behalf of
+     * all of them at once.
+     */
+    void _groupCommitLoop();
+
+    /**
+     * Stops the group commit thread. Must only be called once no more callers can queue up.
+     */
+    void _shutDownGroupCommit();
+
     WiredTigerKVEngine* _engine;      // not owned, might be NULL
     WT_CONNECTION* _conn;             // not owned
     ClockSource* const _clockSource;  // not owned
@@ -389,6 +440,18 @@ private:
     AtomicWord<unsigned> _lastSyncTime;
     Mutex _lastSyncMutex = MONGO_MAKE_LATCH("WiredTigerSessionCache::_lastSyncMutex");
 
+    // Protects the group commit queue and the lifetime of the group commit thread.
+    Mutex _groupCommitMutex = MONGO_MAKE_LATCH("WiredTigerSessionCache::_groupCommitMutex");
+    stdx::condition_variable _groupCommitCond;
+    std::vector<GroupCommitWaiter> _groupCommitQueue;
+    stdx::thread _groupCommitThread;
+    bool _groupCommitShuttingDown = false;
+
+    AtomicWord<long long> _numGroupCommits{0};
+    AtomicWord<long long> _numGroupCommitWaiters{0};
+    GroupCommitHistogram _groupCommitBatchSizes{};
+    GroupCommitHistogram _groupCommitWaitMicros{};
+
     // Mutex and cond var for waiting on prepare commit or abort.
     Mutex _prepareCommittedOrAbortedMutex =
         MONGO_MAKE_LATCH("WiredTigerSessionCache::_prepareCommittedOrAbortedMutex");
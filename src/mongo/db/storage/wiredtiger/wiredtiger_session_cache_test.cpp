@@ -33,10 +33,14 @@
 #include <string>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/system_clock_source.h"
 
 namespace mongo {
@@ -113,4 +117,53 @@ TEST(WiredTigerSessionCacheTest, CheckSessionCacheCleanup) {
     ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
 }
 
+TEST(WiredTigerSessionCacheTest, GroupCommitBatchesConcurrentWaiters) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    // Give every waiter plenty of time to join the first batch.
+    const int numThreads = 8;
+    const int originalInterval = gWiredTigerGroupCommitIntervalMicros.swap(1000000);
+    const int originalBatchSize = gWiredTigerGroupCommitMaxBatchSize.swap(numThreads);
+    ON_BLOCK_EXIT([&] {
+        gWiredTigerGroupCommitIntervalMicros.store(originalInterval);
+        gWiredTigerGroupCommitMaxBatchSize.store(originalBatchSize);
+    });
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&] {
+            sessionCache->waitUntilDurable(nullptr,
+                                           WiredTigerSessionCache::Fsync::kJournal,
+                                           WiredTigerSessionCache::UseJournalListener::kSkip);
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    BSONObjBuilder builder;
+    sessionCache->appendGroupCommitStats(&builder);
+    auto stats = builder.obj();
+    ASSERT_EQ(stats["waiters"].numberLong(), numThreads);
+    ASSERT_LTE(stats["commits"].numberLong(), numThreads);
+    ASSERT_GTE(stats["commits"].numberLong(), 1);
+
+    long long batchedWaiters = 0;
+    for (auto&& bucket : stats["batch sizes"].Obj()) {
+        ASSERT_GTE(bucket.Obj()["count"].numberLong(), 1);
+        batchedWaiters += bucket.Obj()["count"].numberLong();
+    }
+    ASSERT_EQ(batchedWaiters, stats["commits"].numberLong());
+
+    // Waiting for durability after shutdown is refused rather than left hanging.
+    sessionCache->shuttingDown();
+    ASSERT_THROWS_CODE(
+        sessionCache->waitUntilDurable(nullptr,
+                                       WiredTigerSessionCache::Fsync::kJournal,
+                                       WiredTigerSessionCache::UseJournalListener::kSkip),
+        DBException,
+        ErrorCodes::ShutdownInProgress);
+}
+
 }  // namespace mongo
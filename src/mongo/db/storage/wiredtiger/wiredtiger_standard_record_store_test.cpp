@@ -44,6 +44,7 @@
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_key.h"
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
@@ -95,6 +96,11 @@ public:
     }
 
     virtual std::unique_ptr<RecordStore> newNonCappedRecordStore(const std::string& ns) {
+        return newNonCappedRecordStore(ns, CollectionOptions());
+    }
+
+    std::unique_ptr<RecordStore> newNonCappedRecordStore(const std::string& ns,
+                                                         const CollectionOptions& options) {
         WiredTigerRecoveryUnit* ru =
             checked_cast<WiredTigerRecoveryUnit*>(_engine.newRecoveryUnit());
         OperationContextNoop opCtx(ru);
@@ -102,7 +108,7 @@ public:
 
         const bool prefixed = false;
         StatusWith<std::string> result = WiredTigerRecordStore::generateCreateString(
-            kWiredTigerEngineName, ns, CollectionOptions(), "", prefixed);
+            kWiredTigerEngineName, ns, options, "", prefixed);
         ASSERT_TRUE(result.isOK());
         std::string config = result.getValue();
 
@@ -118,6 +124,7 @@ public:
         params.ident = ns;
         params.engineName = kWiredTigerEngineName;
         params.isCapped = false;
+        params.isClustered = options.clusteredIndex;
         params.isEphemeral = false;
         params.cappedMaxSize = -1;
         params.cappedMaxDocs = -1;
@@ -213,6 +220,68 @@ TEST(WiredTigerRecordStoreTest, StorageSizeStatisticsDisabled) {
     ASSERT_THROWS(rs->storageSize(opCtx.get()), AssertionException);
 }
 
+TEST(WiredTigerRecordStoreTest, ClusteredRecordStoreIsKeyedById) {
+    WiredTigerHarnessHelper harnessHelper;
+    CollectionOptions options;
+    options.clusteredIndex = true;
+    unique_ptr<RecordStore> rs(harnessHelper.newNonCappedRecordStore("a.b", options));
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+    auto insert = [&](const BSONObj& doc) {
+        WriteUnitOfWork uow(opCtx.get());
+        auto res = rs->insertRecord(opCtx.get(), doc.objdata(), doc.objsize(), Timestamp());
+        if (res.isOK()) {
+            uow.commit();
+        }
+        return res;
+    };
+
+    auto key = [](const BSONObj& doc) { return clusteredkey::keyForId(doc["_id"]); };
+
+    // Records are keyed by their _id, regardless of the order in which they are inserted.
+    const OID oid = OID::gen();
+    const std::vector<BSONObj> docs{BSON("_id" << 30LL),
+                                    BSON("_id" << oid),
+                                    BSON("_id" << 10),
+                                    BSON("_id"
+                                         << "a"),
+                                    BSON("_id" << 20.5)};
+    for (auto&& doc : docs) {
+        auto res = insert(doc);
+        ASSERT_OK(res.getStatus());
+        ASSERT(res.getValue().isStr());
+        ASSERT_EQ(key(doc), res.getValue());
+    }
+
+    // The _ids which compare equal across numeric types are the same key.
+    ASSERT_EQ(ErrorCodes::DuplicateKey, insert(BSON("_id" << 30)).getStatus());
+    ASSERT_EQ(ErrorCodes::DuplicateKey, insert(BSON("_id" << 10.0)).getStatus());
+    ASSERT_EQ(ErrorCodes::DuplicateKey, insert(BSON("_id" << oid)).getStatus());
+    ASSERT_EQ(ErrorCodes::BadValue, insert(BSON("x" << 1)).getStatus());
+    ASSERT_EQ(5, rs->numRecords(opCtx.get()));
+
+    // Scans return the records in the order of their _ids.
+    const std::vector<BSONObj> sorted{docs[2], docs[4], docs[0], docs[3], docs[1]};
+    auto cursor = rs->getCursor(opCtx.get());
+    for (auto&& doc : sorted) {
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQ(key(doc), record->id);
+        ASSERT_BSONOBJ_EQ(doc, record->data.toBson());
+    }
+    ASSERT_FALSE(cursor->next());
+
+    auto record = cursor->seekExact(key(docs[1]));
+    ASSERT(record);
+    ASSERT_BSONOBJ_EQ(docs[1], record->data.toBson());
+    ASSERT_FALSE(cursor->seekExact(key(BSON("_id" << 11))));
+
+    // Range scans position themselves on the closest record at or before their lower bound.
+    ASSERT_EQ(key(docs[4]), *rs->oplogStartHack(opCtx.get(), key(BSON("_id" << 25))));
+    ASSERT_EQ(key(docs[4]), *rs->oplogStartHack(opCtx.get(), key(docs[4])));
+    ASSERT_EQ(RecordId(), *rs->oplogStartHack(opCtx.get(), key(BSON("_id" << 1))));
+}
+
 TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
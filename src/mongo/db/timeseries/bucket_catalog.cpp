@@ -0,0 +1,232 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_catalog.h"
+
+#include "mongo/base/counter.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/timeseries/bucket_catalog_server_parameters_gen.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+const auto getBucketCatalog = ServiceContext::declareDecoration<BucketCatalog>();
+
+Counter64 bucketsOpenedCounter;
+Counter64 measurementsInsertedCounter;
+ServerStatusMetricField<Counter64> displayBucketsOpened("timeseries.bucketsOpened",
+                                                        &bucketsOpenedCounter);
+ServerStatusMetricField<Counter64> displayMeasurementsInserted("timeseries.measurementsInserted",
+                                                               &measurementsInsertedCounter);
+
+const BSONObj kMinKeyObj = BSON("" << MINKEY);
+const BSONObj kMaxKeyObj = BSON("" << MAXKEY);
+
+/**
+ * Returns the key of the open bucket for the measurements of the collection 'collectionUUID' with
+ * the metadata 'meta'. Metadata values are only considered equal if their BSON is identical.
+ */
+std::string makeBucketKey(const UUID& collectionUUID, BSONElement meta) {
+    auto uuid = collectionUUID.toCDR();
+    std::string key(uuid.data(), uuid.length());
+    key.push_back(meta.type());
+    if (!meta.eoo()) {
+        key.append(meta.value(), meta.valuesize());
+    }
+    return key;
+}
+
+}  // namespace
+
+constexpr StringData BucketCatalog::kControlFieldName;
+constexpr StringData BucketCatalog::kMetaFieldName;
+constexpr StringData BucketCatalog::kDataFieldName;
+constexpr StringData BucketCatalog::kControlMinFieldNamePrefix;
+constexpr StringData BucketCatalog::kControlMaxFieldNamePrefix;
+
+void BucketCatalog::BucketUpdate::addMeasurement(const TimeseriesOptions& options,
+                                                 int32_t index,
+                                                 const BSONObj& measurement) {
+    const auto metaField = options.getMetaField();
+    for (auto&& elem : measurement) {
+        auto fieldName = elem.fieldNameStringData();
+        if (metaField && fieldName == *metaField) {
+            continue;
+        }
+
+        _data.appendAs(elem, str::stream() << kDataFieldName << "." << fieldName << "." << index);
+
+        auto min = elem;
+        auto max = elem;
+        if (elem.type() == BSONType::Array) {
+            min = kMinKeyObj.firstElement();
+            max = kMaxKeyObj.firstElement();
+        }
+        auto [minIt, minInserted] = _min.try_emplace(fieldName, min);
+        if (!minInserted && min.woCompare(minIt->second, 0) < 0) {
+            minIt->second = min;
+        }
+        auto [maxIt, maxInserted] = _max.try_emplace(fieldName, max);
+        if (!maxInserted && max.woCompare(maxIt->second, 0) > 0) {
+            maxIt->second = max;
+        }
+    }
+}
+
+BSONObj BucketCatalog::BucketUpdate::getQuery() const {
+    return BSON("_id" << _bucketId);
+}
+
+BSONObj BucketCatalog::BucketUpdate::getUpdate() {
+    BSONObjBuilder update;
+    {
+        BSONObjBuilder set(update.subobjStart("$set"));
+        set.append(str::stream() << kControlFieldName << ".version", kBucketVersion);
+        if (!_meta.eoo()) {
+            set.appendAs(_meta, kMetaFieldName);
+        }
+        set.appendElements(_data.asTempObj());
+    }
+    {
+        BSONObjBuilder min(update.subobjStart("$min"));
+        for (auto&& [fieldName, value] : _min) {
+            min.appendAs(value, kControlMinFieldNamePrefix + fieldName);
+        }
+    }
+    {
+        BSONObjBuilder max(update.subobjStart("$max"));
+        for (auto&& [fieldName, value] : _max) {
+            max.appendAs(value, kControlMaxFieldNamePrefix + fieldName);
+        }
+    }
+    return update.obj();
+}
+
+BucketCatalog& BucketCatalog::get(ServiceContext* serviceContext) {
+    return getBucketCatalog(serviceContext);
+}
+
+BucketCatalog& BucketCatalog::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+StatusWith<BucketCatalog::InsertResult> BucketCatalog::insert(const UUID& collectionUUID,
+                                                              const TimeseriesOptions& options,
+                                                              const BSONObj& measurement) {
+    auto time = measurement[options.getTimeField()];
+    if (time.type() != BSONType::Date) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "'" << options.getTimeField()
+                              << "' must be present and contain a valid BSON UTC datetime value"};
+    }
+
+    const auto metaField = options.getMetaField();
+    for (auto&& elem : measurement) {
+        auto fieldName = elem.fieldNameStringData();
+        if (metaField && fieldName == *metaField) {
+            continue;
+        }
+        // The fields of a measurement become paths of the bucket document.
+        if (fieldName.empty() || fieldName.startsWith("$") ||
+            fieldName.find('.') != std::string::npos) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Invalid field name for a time-series measurement: '"
+                                  << fieldName << "'"};
+        }
+    }
+
+    const auto key =
+        makeBucketKey(collectionUUID, metaField ? measurement[*metaField] : BSONElement());
+    const auto maxSpan = Seconds(options.getBucketMaxSpanSeconds());
+    const auto size = measurement.objsize();
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _buckets.find(key);
+    if (it != _buckets.end()) {
+        const auto& bucket = it->second;
+        if (bucket.numMeasurements >= gTimeseriesBucketMaxCount.load() ||
+            bucket.size + size > gTimeseriesBucketMaxSize.load() ||
+            time.date() < bucket.openedAt || time.date() >= bucket.openedAt + maxSpan) {
+            _close(lk, it);
+            it = _buckets.end();
+        }
+    }
+
+    if (it == _buckets.end()) {
+        // The bucket starts at the second of its first measurement, which is the timestamp of its
+        // _id, so that the _id index orders the buckets by time.
+        Bucket bucket;
+        const auto openedAt = durationCount<Seconds>(time.date().toDurationSinceEpoch());
+        bucket.openedAt = Date_t::fromDurationSinceEpoch(Seconds(openedAt));
+        bucket.id = OID::gen();
+        bucket.id.setTimestamp(openedAt);
+        _lru.push_front(key);
+        bucket.lruPos = _lru.begin();
+        it = _buckets.emplace(key, std::move(bucket)).first;
+        bucketsOpenedCounter.increment();
+
+        while (_buckets.size() > static_cast<size_t>(gTimeseriesMaxOpenBuckets.load())) {
+            _close(lk, _buckets.find(_lru.back()));
+        }
+    } else {
+        _lru.splice(_lru.begin(), _lru, it->second.lruPos);
+    }
+
+    auto& bucket = it->second;
+    InsertResult result{bucket.id, bucket.numMeasurements++};
+    bucket.size += size;
+    measurementsInsertedCounter.increment();
+    return result;
+}
+
+void BucketCatalog::clear(const UUID& collectionUUID, const BucketUpdate& update) {
+    const auto key = makeBucketKey(collectionUUID, update.getMeta());
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _buckets.find(key);
+    if (it != _buckets.end() && it->second.id == update.getBucketId()) {
+        _close(lk, it);
+    }
+}
+
+size_t BucketCatalog::numOpenBuckets() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _buckets.size();
+}
+
+void BucketCatalog::_close(WithLock, stdx::unordered_map<std::string, Bucket>::iterator it) {
+    _lru.erase(it->second.lruPos);
+    _buckets.erase(it);
+}
+
+}  // namespace mongo
@@ -0,0 +1,174 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <string>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/oid.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+/**
+ * Keeps track of the open buckets of the time-series collections, so that each measurement
+ * inserted into a time-series collection is added to a bucket document holding many measurements,
+ * rather than stored as a document of its own.
+ *
+ * A bucket holds measurements with the same metadata, whose time falls within
+ * 'bucketMaxSpanSeconds' of the time the bucket was opened at, up to a maximum number and size of
+ * measurements. The buckets of the time-series collection "db.coll" are stored in
+ * "db.system.buckets.coll" as documents of the form:
+ *
+ *    {
+ *        _id: <ObjectId whose timestamp is the time the bucket was opened at>,
+ *        control: {
+ *            version: 1,
+ *            min: {<field>: <minimum value of the field>, ...},
+ *            max: {<field>: <maximum value of the field>, ...}
+ *        },
+ *        meta: <metadata of the measurements, missing if they have none>,
+ *        data: {<field>: {"0": <value of the field in measurement 0>, "1": ...}, ...}
+ *    }
+ *
+ * The minimum and maximum of a field are taken in the BSON order. A field which holds an array in
+ * any of the measurements of the bucket has a minimum of MinKey and a maximum of MaxKey.
+ *
+ * The catalog only keeps the state of the open buckets in memory, and the callers write the bucket
+ * documents. A bucket is closed once it cannot hold a new measurement, and the least recently used
+ * open buckets are forgotten when there are more than 'timeseriesMaxOpenBuckets'.
+ */
+class BucketCatalog {
+public:
+    static constexpr StringData kControlFieldName = "control"_sd;
+    static constexpr StringData kMetaFieldName = "meta"_sd;
+    static constexpr StringData kDataFieldName = "data"_sd;
+    static constexpr StringData kControlMinFieldNamePrefix = "control.min."_sd;
+    static constexpr StringData kControlMaxFieldNamePrefix = "control.max."_sd;
+    static constexpr int kBucketVersion = 1;
+
+    struct InsertResult {
+        OID bucketId;
+
+        // The position of the measurement within the bucket.
+        int32_t index;
+    };
+
+    /**
+     * Accumulates the measurements a write adds to one bucket, so that they are all written with a
+     * single upsert of the bucket document. Refers to the measurements, which must outlive it.
+     */
+    class BucketUpdate {
+    public:
+        BucketUpdate(const OID& bucketId, BSONElement meta) : _bucketId(bucketId), _meta(meta) {}
+
+        void addMeasurement(const TimeseriesOptions& options,
+                            int32_t index,
+                            const BSONObj& measurement);
+
+        /**
+         * Returns the query and the update to apply with 'upsert: true' to the bucket document.
+         */
+        BSONObj getQuery() const;
+        BSONObj getUpdate();
+
+        const OID& getBucketId() const {
+            return _bucketId;
+        }
+
+        BSONElement getMeta() const {
+            return _meta;
+        }
+
+    private:
+        OID _bucketId;
+        BSONElement _meta;
+
+        BSONObjBuilder _data;
+        StringMap<BSONElement> _min;
+        StringMap<BSONElement> _max;
+    };
+
+    static BucketCatalog& get(ServiceContext* serviceContext);
+    static BucketCatalog& get(OperationContext* opCtx);
+
+    /**
+     * Assigns 'measurement' to a bucket of the time-series collection 'collectionUUID', opening a
+     * new bucket if the open one for its metadata cannot hold it. Returns an error if 'measurement'
+     * is not a valid measurement for the collection.
+     */
+    StatusWith<InsertResult> insert(const UUID& collectionUUID,
+                                    const TimeseriesOptions& options,
+                                    const BSONObj& measurement);
+
+    /**
+     * Forgets the bucket which 'update' was meant for, if it is still open, after 'update' failed
+     * or was not applied. The measurements insert() assigned to the bucket are then no longer
+     * counted against its limits, and the measurements which follow go to a new bucket rather than
+     * after positions the bucket document never received.
+     */
+    void clear(const UUID& collectionUUID, const BucketUpdate& update);
+
+    size_t numOpenBuckets() const;
+
+private:
+    struct Bucket {
+        OID id;
+        Date_t openedAt;
+        int32_t numMeasurements = 0;
+        int64_t size = 0;
+
+        // The position of the bucket in '_lru'.
+        std::list<std::string>::iterator lruPos;
+    };
+
+    void _close(WithLock, stdx::unordered_map<std::string, Bucket>::iterator it);
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("BucketCatalog::_mutex");
+
+    // Open buckets by collection UUID and metadata value.
+    stdx::unordered_map<std::string, Bucket> _buckets;
+
+    // The keys of '_buckets', most recently used first.
+    std::list<std::string> _lru;
+};
+
+}  // namespace mongo
@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_catalog.h"
+
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/db/timeseries/bucket_catalog_server_parameters_gen.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class BucketCatalogTest : public ServiceContextTest {
+protected:
+    void setUp() override {
+        _options.setTimeField("time"_sd);
+        _options.setMetaField("meta"_sd);
+        _options.setBucketMaxSpanSeconds(60);
+    }
+
+    BSONObj measurement(Date_t time, int meta, int value) {
+        return BSON("time" << time << "meta" << meta << "value" << value);
+    }
+
+    BucketCatalog::InsertResult insert(const UUID& uuid, const BSONObj& doc) {
+        return uassertStatusOK(_catalog().insert(uuid, _options, doc));
+    }
+
+    BucketCatalog& _catalog() {
+        return BucketCatalog::get(getServiceContext());
+    }
+
+    TimeseriesOptions _options;
+    UUID _uuid = UUID::gen();
+    Date_t _start = Date_t::fromMillisSinceEpoch(1600000000000);
+};
+
+TEST_F(BucketCatalogTest, MeasurementsWithTheSameMetaShareABucket) {
+    auto first = insert(_uuid, measurement(_start, 1, 0));
+    auto second = insert(_uuid, measurement(_start + Seconds(1), 1, 1));
+    ASSERT_EQ(first.bucketId, second.bucketId);
+    ASSERT_EQ(0, first.index);
+    ASSERT_EQ(1, second.index);
+    ASSERT_EQ(1U, _catalog().numOpenBuckets());
+
+    // The bucket _id carries the time of its first measurement.
+    ASSERT_EQ(_start, first.bucketId.asDateT());
+}
+
+TEST_F(BucketCatalogTest, MeasurementsWithDifferentMetaOrCollectionUseDifferentBuckets) {
+    auto first = insert(_uuid, measurement(_start, 1, 0));
+    auto otherMeta = insert(_uuid, measurement(_start, 2, 0));
+    auto otherCollection = insert(UUID::gen(), measurement(_start, 1, 0));
+    ASSERT_NE(first.bucketId, otherMeta.bucketId);
+    ASSERT_NE(first.bucketId, otherCollection.bucketId);
+    ASSERT_NE(otherMeta.bucketId, otherCollection.bucketId);
+    ASSERT_EQ(3U, _catalog().numOpenBuckets());
+}
+
+TEST_F(BucketCatalogTest, MeasurementOutsideTheTimeSpanOpensANewBucket) {
+    auto first = insert(_uuid, measurement(_start, 1, 0));
+    auto later = insert(_uuid, measurement(_start + Seconds(60), 1, 0));
+    ASSERT_NE(first.bucketId, later.bucketId);
+    ASSERT_EQ(0, later.index);
+
+    auto earlier = insert(_uuid, measurement(_start - Seconds(1), 1, 0));
+    ASSERT_NE(later.bucketId, earlier.bucketId);
+    ASSERT_EQ(1U, _catalog().numOpenBuckets());
+}
+
+TEST_F(BucketCatalogTest, FullBucketIsClosed) {
+    const auto maxCount = gTimeseriesBucketMaxCount.load();
+    gTimeseriesBucketMaxCount.store(2);
+    ON_BLOCK_EXIT([&] { gTimeseriesBucketMaxCount.store(maxCount); });
+
+    auto first = insert(_uuid, measurement(_start, 1, 0));
+    ASSERT_EQ(first.bucketId, insert(_uuid, measurement(_start, 1, 1)).bucketId);
+    auto third = insert(_uuid, measurement(_start, 1, 2));
+    ASSERT_NE(first.bucketId, third.bucketId);
+    ASSERT_EQ(0, third.index);
+}
+
+TEST_F(BucketCatalogTest, LeastRecentlyUsedBucketIsForgotten) {
+    const auto maxOpenBuckets = gTimeseriesMaxOpenBuckets.load();
+    gTimeseriesMaxOpenBuckets.store(2);
+    ON_BLOCK_EXIT([&] { gTimeseriesMaxOpenBuckets.store(maxOpenBuckets); });
+
+    auto first = insert(_uuid, measurement(_start, 1, 0));
+    auto second = insert(_uuid, measurement(_start, 2, 0));
+    ASSERT_EQ(first.bucketId, insert(_uuid, measurement(_start, 1, 1)).bucketId);
+    insert(_uuid, measurement(_start, 3, 0));
+    ASSERT_EQ(2U, _catalog().numOpenBuckets());
+
+    ASSERT_EQ(first.bucketId, insert(_uuid, measurement(_start, 1, 2)).bucketId);
+    ASSERT_NE(second.bucketId, insert(_uuid, measurement(_start, 2, 1)).bucketId);
+}
+
+TEST_F(BucketCatalogTest, ClearedBucketIsForgotten) {
+    const auto doc = measurement(_start, 1, 0);
+    auto first = insert(_uuid, doc);
+    BucketCatalog::BucketUpdate update(first.bucketId, doc["meta"]);
+    _catalog().clear(_uuid, update);
+    ASSERT_EQ(0U, _catalog().numOpenBuckets());
+
+    auto second = insert(_uuid, measurement(_start, 1, 1));
+    ASSERT_NE(first.bucketId, second.bucketId);
+    ASSERT_EQ(0, second.index);
+
+    // Clearing a bucket which was already replaced leaves its replacement open.
+    _catalog().clear(_uuid, update);
+    ASSERT_EQ(second.bucketId, insert(_uuid, measurement(_start, 1, 2)).bucketId);
+}
+
+TEST_F(BucketCatalogTest, InvalidMeasurementsAreRejected) {
+    ASSERT_EQ(ErrorCodes::BadValue,
+              _catalog().insert(_uuid, _options, BSON("meta" << 1 << "value" << 1)).getStatus());
+    ASSERT_EQ(ErrorCodes::BadValue,
+              _catalog().insert(_uuid, _options, BSON("time" << 1 << "value" << 1)).getStatus());
+    ASSERT_EQ(ErrorCodes::BadValue,
+              _catalog().insert(_uuid, _options, BSON("time" << _start << "a.b" << 1)).getStatus());
+    ASSERT_EQ(0U, _catalog().numOpenBuckets());
+}
+
+TEST_F(BucketCatalogTest, BucketUpdateSetsDataAndWidensTheControlFields) {
+    auto first = BSON("time" << _start << "meta" << 1 << "a" << 5 << "b" << BSON_ARRAY(1));
+    auto second = BSON("time" << _start + Seconds(1) << "meta" << 1 << "a" << 3);
+
+    auto id = OID::gen();
+    BucketCatalog::BucketUpdate update(id, first["meta"]);
+    update.addMeasurement(_options, 0, first);
+    update.addMeasurement(_options, 1, second);
+
+    ASSERT_BSONOBJ_EQ(BSON("_id" << id), update.getQuery());
+
+    auto obj = update.getUpdate();
+    ASSERT_BSONOBJ_EQ(BSON("control.version" << 1 << "meta" << 1 << "data.time.0" << _start
+                                             << "data.a.0" << 5 << "data.b.0" << BSON_ARRAY(1)
+                                             << "data.time.1" << _start + Seconds(1)
+                                             << "data.a.1" << 3),
+                      obj["$set"].Obj());
+    ASSERT_EQ(_start, obj["$min"]["control.min.time"].date());
+    ASSERT_EQ(3, obj["$min"]["control.min.a"].numberInt());
+    ASSERT_EQ(5, obj["$max"]["control.max.a"].numberInt());
+    ASSERT_EQ(_start + Seconds(1), obj["$max"]["control.max.time"].date());
+    ASSERT_EQ(BSONType::MinKey, obj["$min"]["control.min.b"].type());
+    ASSERT_EQ(BSONType::MaxKey, obj["$max"]["control.max.b"].type());
+    ASSERT(obj["$min"]["control.min.meta"].eoo());
+}
+
+}  // namespace
+}  // namespace mongo
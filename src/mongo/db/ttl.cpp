@@ -33,6 +33,9 @@
 
 #include "mongo/db/ttl.h"
 
+#include <algorithm>
+#include <map>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -41,13 +44,15 @@
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/fsync_locked.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
-#include "mongo/db/exec/delete.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/ops/insert.h"
+#include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
@@ -57,6 +62,8 @@
 #include "mongo/logv2/log.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -66,6 +73,45 @@ namespace {
 
 const auto getTTLMonitor = ServiceContext::declareDecoration<std::unique_ptr<TTLMonitor>>();
 
+/**
+ * Paces the deletes of all the TTL monitor threads so that, on average, they do not delete more
+ * than ttlMonitorMaxDeletesPerSecond documents per second. Deletes are charged once they are done,
+ * so a thread may overdraw the budget by one batch, which the following batches then pay back.
+ */
+class TTLDeleteBudget {
+public:
+    /**
+     * Charges 'numDeleted' deletes to the budget and returns how long the caller must wait before
+     * deleting more documents.
+     */
+    Milliseconds charge(long long numDeleted) {
+        const int rate = ttlMonitorMaxDeletesPerSecond.load();
+        const auto now = Date_t::now();
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        const auto elapsed = now - _lastRefill;
+        _lastRefill = now;
+        if (rate <= 0) {
+            _balance = 0;
+            return Milliseconds(0);
+        }
+
+        // Unused budget accumulates for at most a second.
+        _balance =
+            std::min<double>(rate, _balance + durationCount<Milliseconds>(elapsed) * rate / 1000.0);
+        _balance -= numDeleted;
+        if (_balance >= 0) {
+            return Milliseconds(0);
+        }
+        return Milliseconds(static_cast<long long>(-_balance * 1000 / rate) + 1);
+    }
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("TTLDeleteBudget::_mutex");
+    double _balance = 0;
+    Date_t _lastRefill = Date_t::now();
+};
+
 }  // namespace
 
 MONGO_FAIL_POINT_DEFINE(hangTTLMonitorWithLock);
@@ -109,6 +155,26 @@ public:
             tc.get()->setSystemOperationKillable(lk);
         }
 
+        // The TTL indexes are processed concurrently by a pool of workers, each of which deletes
+        // the expired documents of one index at a time.
+        ThreadPool::Options options;
+        options.poolName = "TTLMonitorWorkers";
+        options.minThreads = 0;
+        options.maxThreads = ttlMonitorWorkerThreads;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+            AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+
+            stdx::lock_guard<Client> lk(cc());
+            cc().setSystemOperationKillable(lk);
+        };
+        ThreadPool workers(std::move(options));
+        workers.startup();
+        ON_BLOCK_EXIT([&] {
+            workers.shutdown();
+            workers.join();
+        });
+
         while (true) {
             {
                 // Wait until either ttlMonitorSleepSecs passes or a shutdown is requested.
@@ -139,7 +205,7 @@ public:
             }
 
             try {
-                doTTLPass();
+                doTTLPass(&workers);
             } catch (const WriteConflictException&) {
                 LOGV2_DEBUG(22531, 1, "got WriteConflictException");
             } catch (const ExceptionForCat<ErrorCategory::Interruption>& interruption) {
@@ -159,17 +225,56 @@ public:
         {
             stdx::lock_guard<Latch> lk(_stateMutex);
             _shuttingDown = true;
-            _shuttingDownCV.notify_one();
+            // Also wakes up the workers waiting for the delete budget.
+            _shuttingDownCV.notify_all();
         }
         wait();
         LOGV2(3684101, "Finished shutting down TTL collection monitor thread");
     }
 
+    /**
+     * Appends the statistics of the most recent pass over each TTL index to 'builder'.
+     */
+    void appendIndexStats(BSONArrayBuilder* builder) const {
+        stdx::lock_guard<Latch> lk(_indexStatsMutex);
+        for (auto&& [key, stats] : _indexStats) {
+            BSONObjBuilder indexBuilder(builder->subobjStart());
+            indexBuilder.append("ns", key.first);
+            indexBuilder.append("name", key.second);
+            indexBuilder.append("lastPassStarted", stats.lastPassStarted);
+            indexBuilder.append("lastPassDurationMillis",
+                                durationCount<Milliseconds>(stats.lastPassDuration));
+            indexBuilder.append("lastPassDeleted", stats.lastPassDeleted);
+            indexBuilder.append("lagMillis", durationCount<Milliseconds>(stats.lag));
+        }
+    }
+
 private:
+    struct IndexStats {
+        Date_t lastPassStarted;
+        Milliseconds lastPassDuration{0};
+        long long lastPassDeleted = 0;
+
+        // How long the oldest document the index had expired was overdue when the pass started,
+        // that is, how far behind the TTL monitor is on this index.
+        Milliseconds lag{0};
+
+        // The pass which last processed the index, to forget about indexes which no longer exist.
+        long long passNumber = 0;
+    };
+
+    struct BatchResult {
+        long long numDeleted = 0;
+
+        // Whether the batch deleted the last of the documents expired as of the start of the pass.
+        bool exhausted = true;
+    };
+
     /**
-     * Gets all TTL indexes from every collection and performs doTTLForIndex().
+     * Gets all TTL indexes from every collection and performs doTTLForIndex() on each of them
+     * concurrently, using the threads of 'workers'.
      */
-    void doTTLPass() {
+    void doTTLPass(ThreadPool* workers) {
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
 
@@ -186,6 +291,7 @@ private:
         std::vector<std::pair<NamespaceString, BSONObj>> ttlIndexes;
 
         ttlPasses.increment();
+        const long long passNumber = ++_passNumber;
 
         // Get all TTL indexes from every collection.
         for (const std::pair<UUID, std::string>& ttlInfo : ttlInfos) {
@@ -233,33 +339,83 @@ private:
             ttlIndexes.push_back(std::make_pair(*nss, spec.getOwned()));
         }
 
+        // Don't pin the snapshot used to read the catalog while the workers delete documents.
+        opCtx.recoveryUnit()->abandonSnapshot();
+
+        auto mutex = MONGO_MAKE_LATCH("TTLMonitor::doTTLPass::mutex");
+        stdx::condition_variable allDone;
+        size_t numRunning = ttlIndexes.size();
+        AtomicWord<bool> interrupted{false};
+
         for (const auto& it : ttlIndexes) {
-            try {
-                doTTLForIndex(&opCtx, it.first, it.second);
-            } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+            workers->schedule([&](Status status) {
+                if (status.isOK() && !interrupted.load()) {
+                    doTTLForIndexOnWorker(it.first, it.second, passNumber, &interrupted);
+                }
+
+                stdx::lock_guard<Latch> lk(mutex);
+                if (--numRunning == 0) {
+                    allDone.notify_all();
+                }
+            });
+        }
+
+        {
+            stdx::unique_lock<Latch> lk(mutex);
+            allDone.wait(lk, [&] { return numRunning == 0; });
+        }
+
+        // Forget about the indexes which were not part of this pass.
+        stdx::lock_guard<Latch> lk(_indexStatsMutex);
+        for (auto it = _indexStats.begin(); it != _indexStats.end();) {
+            if (it->second.passNumber != passNumber) {
+                it = _indexStats.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * Runs doTTLForIndex() with an operation of the worker's own. Sets 'interrupted' if the
+     * operation is interrupted, so that the remaining indexes are skipped until the next pass.
+     */
+    void doTTLForIndexOnWorker(const NamespaceString& collectionNSS,
+                               const BSONObj& idx,
+                               long long passNumber,
+                               AtomicWord<bool>* interrupted) {
+        const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
+        try {
+            doTTLForIndex(opCtx.get(), collectionNSS, idx, passNumber);
+        } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+            if (!interrupted->swap(true)) {
                 LOGV2_WARNING(22537,
                               "TTLMonitor was interrupted, waiting {ttlMonitorSleepSecs_load} "
                               "seconds before doing another pass",
                               "TTLMonitor was interrupted, waiting before doing another pass",
                               "wait"_attr = Milliseconds(Seconds(ttlMonitorSleepSecs.load())));
-                return;
-            } catch (const DBException& dbex) {
-                LOGV2_ERROR(22538,
-                            "Error processing ttl index: {it_second} -- {dbex}",
-                            "Error processing TTL index",
-                            "index"_attr = it.second,
-                            "error"_attr = dbex);
-                // Continue on to the next index.
-                continue;
             }
+        } catch (const DBException& dbex) {
+            LOGV2_ERROR(22538,
+                        "Error processing ttl index: {it_second} -- {dbex}",
+                        "Error processing TTL index",
+                        "index"_attr = idx,
+                        "error"_attr = dbex);
         }
     }
 
     /**
      * Removes documents from the collection using the specified TTL index after a sufficient amount
      * of time has passed according to its expiry specification.
+     *
+     * The expired documents are deleted in batches of up to ttlMonitorBatchSize documents, each in
+     * a storage transaction of its own, and the deletes of all the workers are paced according to
+     * ttlMonitorMaxDeletesPerSecond.
      */
-    void doTTLForIndex(OperationContext* opCtx, NamespaceString collectionNSS, BSONObj idx) {
+    void doTTLForIndex(OperationContext* opCtx,
+                       NamespaceString collectionNSS,
+                       BSONObj idx,
+                       long long passNumber) {
         if (collectionNSS.isDropPendingNamespace()) {
             return;
         }
@@ -274,7 +430,7 @@ private:
         }
 
         const BSONObj key = idx["key"].Obj();
-        const StringData name = idx["name"].valueStringData();
+        const std::string name = idx["name"].str();
         if (key.nFields() != 1) {
             LOGV2_ERROR(22540,
                         "key for ttl index can only have 1 field, skipping ttl job for: {index}",
@@ -290,6 +446,49 @@ private:
                     "key"_attr = key,
                     "name"_attr = name);
 
+        // Documents which expire while the pass is running are left for the next pass, so that a
+        // busy index cannot keep a worker to itself.
+        const Date_t passStarted = Date_t::now();
+        long long numDeleted = 0;
+        boost::optional<Milliseconds> lag;
+        while (true) {
+            auto batch = deleteExpiredBatch(opCtx, collectionNSS, name, passStarted, &lag);
+            if (!batch) {
+                break;
+            }
+
+            numDeleted += batch->numDeleted;
+            ttlDeletedDocuments.increment(batch->numDeleted);
+
+            const auto wait = _deleteBudget.charge(batch->numDeleted);
+            if (batch->exhausted || !waitForDeleteBudget(opCtx, wait)) {
+                break;
+            }
+        }
+
+        {
+            stdx::lock_guard<Latch> lk(_indexStatsMutex);
+            auto& stats = _indexStats[std::make_pair(collectionNSS.ns(), name)];
+            stats.lastPassStarted = passStarted;
+            stats.lastPassDuration = Date_t::now() - passStarted;
+            stats.lastPassDeleted = numDeleted;
+            stats.lag = lag.value_or(Milliseconds(0));
+            stats.passNumber = passNumber;
+        }
+
+        LOGV2_DEBUG(22536, 1, "deleted: {numDeleted}", "numDeleted"_attr = numDeleted);
+    }
+
+    /**
+     * Deletes, in a single storage transaction, up to ttlMonitorBatchSize documents which had
+     * expired according to the TTL index 'indexName' when the pass started, in RecordId order.
+     * Returns boost::none if the index cannot be processed. Sets 'lag' on the first batch.
+     */
+    boost::optional<BatchResult> deleteExpiredBatch(OperationContext* opCtx,
+                                                    const NamespaceString& collectionNSS,
+                                                    StringData indexName,
+                                                    Date_t passStarted,
+                                                    boost::optional<Milliseconds>* lag) {
         AutoGetCollection autoGetCollection(opCtx, collectionNSS, MODE_IX);
         if (MONGO_unlikely(hangTTLMonitorWithLock.shouldFail())) {
             LOGV2(22534, "Hanging due to hangTTLMonitorWithLock fail point");
@@ -300,33 +499,35 @@ private:
         Collection* collection = autoGetCollection.getCollection();
         if (!collection) {
             // Collection was dropped.
-            return;
+            return boost::none;
         }
 
         if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, collectionNSS)) {
-            return;
+            return boost::none;
         }
 
-        const IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
+        const IndexDescriptor* desc =
+            collection->getIndexCatalog()->findIndexByName(opCtx, indexName);
         if (!desc) {
             LOGV2_DEBUG(22535,
                         1,
                         "index not found (index build in progress? index dropped?), skipping ttl "
                         "job for: {idx}",
-                        "idx"_attr = idx);
-            return;
+                        "idx"_attr = indexName);
+            return boost::none;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition changed
         // before we re-acquired the collection lock.
-        idx = desc->infoObj();
+        const BSONObj idx = desc->infoObj();
+        const BSONObj key = idx["key"].Obj();
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             LOGV2_ERROR(22541,
                         "special index can't be used as a ttl index, skipping ttl job for: {index}",
                         "Special index can't be used as a TTL index, skipping TTL job",
                         "index"_attr = idx);
-            return;
+            return boost::none;
         }
 
         BSONElement secondsExpireElt = idx[IndexDescriptor::kExpireAfterSecondsFieldName];
@@ -338,12 +539,12 @@ private:
                         "field"_attr = IndexDescriptor::kExpireAfterSecondsFieldName,
                         "type"_attr = typeName(secondsExpireElt.type()),
                         "index"_attr = idx);
-            return;
+            return boost::none;
         }
 
         const Date_t kDawnOfTime =
             Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
-        const Date_t expirationTime = Date_t::now() - Seconds(secondsExpireElt.numberLong());
+        const Date_t expirationTime = passStarted - Seconds(secondsExpireElt.numberLong());
         const BSONObj startKey = BSON("" << kDawnOfTime);
         const BSONObj endKey = BSON("" << expirationTime);
         // The canonical check as to whether a key pattern element is "ascending" or
@@ -352,9 +553,8 @@ private:
             ? InternalPlanner::Direction::FORWARD
             : InternalPlanner::Direction::BACKWARD;
 
-        // We need to pass into the DeleteStageParams (below) a CanonicalQuery with a BSONObj that
-        // queries for the expired documents correctly so that we do not delete documents that are
-        // not actually expired when our snapshot changes during deletion.
+        // Each document is matched against a query for the expired documents before it is
+        // deleted, so that we do not delete documents that were updated after the index scan.
         const char* keyFieldName = key.firstElement().fieldName();
         BSONObj query =
             BSON(keyFieldName << BSON("$gte" << kDawnOfTime << "$lte" << expirationTime));
@@ -362,40 +562,86 @@ private:
         qr->setFilter(query);
         auto canonicalQuery = CanonicalQuery::canonicalize(opCtx, std::move(qr));
         invariant(canonicalQuery.getStatus());
+        const MatchExpression* expired = canonicalQuery.getValue()->root();
 
-        auto params = std::make_unique<DeleteStageParams>();
-        params->isMulti = true;
-        params->canonicalQuery = canonicalQuery.getValue().get();
-
-        auto exec =
-            InternalPlanner::deleteWithIndexScan(opCtx,
-                                                 collection,
-                                                 std::move(params),
-                                                 desc,
-                                                 startKey,
-                                                 endKey,
-                                                 BoundInclusion::kIncludeBothStartAndEndKeys,
-                                                 PlanYieldPolicy::YieldPolicy::YIELD_AUTO,
-                                                 direction);
+        int batchSize = ttlMonitorBatchSize.load();
+        if (int rate = ttlMonitorMaxDeletesPerSecond.load(); rate > 0) {
+            batchSize = std::min(batchSize, rate);
+        }
 
+        BatchResult result;
         try {
-            exec->executePlan();
-        } catch (const ExceptionFor<ErrorCodes::QueryPlanKilled>&) {
-            // It is expected that a collection drop can kill a query plan while the TTL monitor is
-            // deleting an old document, so ignore this error.
-            return;
+            // The scan starts at the oldest key. It holds the collection lock for the time it
+            // takes to read one batch, so it never yields.
+            auto exec = InternalPlanner::indexScan(opCtx,
+                                                   collection,
+                                                   desc,
+                                                   startKey,
+                                                   endKey,
+                                                   BoundInclusion::kIncludeBothStartAndEndKeys,
+                                                   PlanYieldPolicy::YieldPolicy::INTERRUPT_ONLY,
+                                                   direction);
+
+            std::vector<RecordId> recordIds;
+            BSONObj indexKey;
+            RecordId recordId;
+            PlanExecutor::ExecState state;
+            while (recordIds.size() < static_cast<size_t>(batchSize) &&
+                   PlanExecutor::ADVANCED == (state = exec->getNext(&indexKey, &recordId))) {
+                if (!*lag && indexKey.firstElement().type() == BSONType::Date) {
+                    *lag = expirationTime - indexKey.firstElement().date();
+                }
+                recordIds.push_back(recordId);
+            }
+            result.exhausted = recordIds.size() < static_cast<size_t>(batchSize);
+            if (!*lag) {
+                *lag = Milliseconds(0);
+            }
+
+            // Deleting in RecordId order touches each page of the collection once per batch. A
+            // document has a key per element of an indexed array, so its RecordId may repeat.
+            std::sort(recordIds.begin(), recordIds.end());
+            recordIds.erase(std::unique(recordIds.begin(), recordIds.end()), recordIds.end());
+
+            writeConflictRetry(opCtx, "ttl", collectionNSS.ns(), [&] {
+                result.numDeleted = 0;
+                WriteUnitOfWork wuow(opCtx);
+                for (auto&& id : recordIds) {
+                    Snapshotted<BSONObj> doc;
+                    if (!collection->findDoc(opCtx, id, &doc) ||
+                        !expired->matchesBSON(doc.value())) {
+                        continue;
+                    }
+                    collection->deleteDocument(
+                        opCtx, kUninitializedStmtId, id, &CurOp::get(opCtx)->debug());
+                    ++result.numDeleted;
+                }
+                wuow.commit();
+            });
         } catch (const DBException& exception) {
             LOGV2_WARNING(22543,
                           "ttl query execution for index {index} failed with status: {error}",
                           "TTL query execution failed",
                           "index"_attr = idx,
                           "error"_attr = redact(exception.toStatus()));
-            return;
+            return boost::none;
         }
 
-        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
-        ttlDeletedDocuments.increment(numDeleted);
-        LOGV2_DEBUG(22536, 1, "deleted: {numDeleted}", "numDeleted"_attr = numDeleted);
+        return result;
+    }
+
+    /**
+     * Waits for 'wait' to pass before the next batch of deletes. Returns false if the monitor is
+     * shutting down.
+     */
+    bool waitForDeleteBudget(OperationContext* opCtx, Milliseconds wait) {
+        stdx::unique_lock<Latch> lk(_stateMutex);
+        if (wait > Milliseconds(0)) {
+            MONGO_IDLE_THREAD_BLOCK;
+            opCtx->waitForConditionOrInterruptFor(
+                _shuttingDownCV, lk, wait, [&] { return _shuttingDown; });
+        }
+        return !_shuttingDown;
     }
 
     // Protects the state below.
@@ -406,8 +652,44 @@ private:
     mutable stdx::condition_variable _shuttingDownCV;
 
     bool _shuttingDown = false;
+
+    // Only accessed by the TTL monitor thread.
+    long long _passNumber = 0;
+
+    TTLDeleteBudget _deleteBudget;
+
+    // Keyed by the namespace and the name of the index.
+    mutable Mutex _indexStatsMutex = MONGO_MAKE_LATCH("TTLMonitor::_indexStatsMutex");
+    std::map<std::pair<std::string, std::string>, IndexStats> _indexStats;
 };
 
+namespace {
+
+/**
+ * Reports how far behind the TTL monitor is on each TTL index. Not included by default, as there
+ * may be thousands of TTL indexes.
+ */
+class TTLServerStatusSection : public ServerStatusSection {
+public:
+    TTLServerStatusSection() : ServerStatusSection("ttl") {}
+
+    bool includeByDefault() const override {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        if (auto ttlMonitor = TTLMonitor::get(opCtx->getServiceContext())) {
+            BSONArrayBuilder indexesBuilder(builder.subarrayStart("indexes"));
+            ttlMonitor->appendIndexStats(&indexesBuilder);
+        }
+        return builder.obj();
+    }
+} ttlServerStatusSection;
+
+}  // namespace
+
 void startTTLMonitor(ServiceContext* serviceContext) {
     std::unique_ptr<TTLMonitor> ttlMonitor = std::make_unique<TTLMonitor>();
     ttlMonitor->go();
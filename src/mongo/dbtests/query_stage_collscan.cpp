@@ -47,10 +47,13 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/plan_executor_factory.h"
+#include "mongo/db/storage/clustered_key.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
 
 namespace query_stage_collection_scan {
 
@@ -429,4 +432,74 @@ TEST_F(QueryStageCollectionScanTest, QueryTestCollscanResumeAfterRecordIdSeekFai
     ASSERT_THROWS_CODE(ps->work(&id), DBException, ErrorCodes::KeyNotFound);
 }
 
+// Scans of a clustered collection only return the records within ['minRecord', 'maxRecord'], and
+// hit EOF on the first record past the end of the range.
+TEST_F(QueryStageCollectionScanTest, QueryStageCollscanClusteredBounds) {
+    if (!_opCtx.getServiceContext()->getStorageEngine()->supportsClusteredIdIndex()) {
+        return;
+    }
+
+    const NamespaceString clusteredNss{"unittests.QueryStageCollectionScanClustered"};
+    DBDirectClient client(&_opCtx);
+    BSONObj info;
+    ASSERT(client.runCommand(clusteredNss.db().toString(),
+                             BSON("create" << clusteredNss.coll() << "clusteredIndex" << true),
+                             info))
+        << info;
+    ON_BLOCK_EXIT([&] { client.dropCollection(clusteredNss.ns()); });
+
+    // Insert the _ids out of order, with a gap between 10 and 20.
+    for (int i = numObj() - 1; i >= 0; --i) {
+        if (i <= 10 || i >= 20) {
+            client.insert(clusteredNss.ns(), BSON("_id" << i));
+        }
+    }
+
+    AutoGetCollectionForReadCommand ctx(&_opCtx, clusteredNss);
+    auto collection = ctx.getCollection();
+    ASSERT(collection->isClustered());
+
+    auto key = [](double id) { return clusteredkey::keyForId(BSON("" << id).firstElement()); };
+    auto scan = [&](CollectionScanParams::Direction direction,
+                    boost::optional<RecordId> minRecord,
+                    boost::optional<RecordId> maxRecord) {
+        CollectionScanParams params;
+        params.direction = direction;
+        params.minRecord = minRecord;
+        params.maxRecord = maxRecord;
+
+        WorkingSet ws;
+        CollectionScan scan(_expCtx.get(), collection, params, &ws, nullptr);
+        std::vector<int> ids;
+        while (!scan.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            if (PlanStage::ADVANCED == scan.work(&id)) {
+                ids.push_back(ws.get(id)->doc.value().toBson()["_id"].numberInt());
+            }
+        }
+
+        // No record past the end of the range is examined.
+        auto stats = static_cast<const CollectionScanStats*>(scan.getSpecificStats());
+        ASSERT_EQ(ids.size(), stats->docsTested);
+        return ids;
+    };
+
+    ASSERT(std::vector<int>({5, 6, 7, 8, 9, 10, 20, 21, 22}) ==
+           scan(CollectionScanParams::FORWARD, key(5), key(22)));
+    ASSERT(std::vector<int>({22, 21, 20, 10, 9, 8, 7, 6, 5}) ==
+           scan(CollectionScanParams::BACKWARD, key(5), key(22)));
+
+    // The bounds need not be the _id of a record.
+    ASSERT(std::vector<int>({10, 20}) == scan(CollectionScanParams::FORWARD, key(9.5), key(20.5)));
+    ASSERT(std::vector<int>({20, 10}) ==
+           scan(CollectionScanParams::BACKWARD, key(9.5), key(20.5)));
+    ASSERT(scan(CollectionScanParams::FORWARD, key(12), key(18)).empty());
+    ASSERT(scan(CollectionScanParams::BACKWARD, key(12), key(18)).empty());
+
+    // A scan may only be bounded on one end.
+    ASSERT(std::vector<int>({0, 1, 2}) == scan(CollectionScanParams::FORWARD, boost::none, key(2)));
+    ASSERT(std::vector<int>({49, 48}) ==
+           scan(CollectionScanParams::BACKWARD, key(48), boost::none));
+}
+
 }  // namespace query_stage_collection_scan
@@ -57,6 +57,7 @@
 #include "mongo/db/query/stage_builder_util.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -88,6 +89,8 @@ public:
     }
 
     virtual ~QueryStageMultiPlanTest() {
+        _opCtx->recoveryUnit()->abandonSnapshot();
+        _opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kNoTimestamp);
         dbtests::WriteContextForTests ctx(_opCtx.get(), nss.ns());
         _client.dropCollection(nss.ns());
     }
@@ -110,6 +113,15 @@ public:
         return _opCtx.get();
     }
 
+    /**
+     * Makes the operation read at a timestamp, which the parallel trial period requires.
+     */
+    void readAtTimestamp() {
+        _opCtx->recoveryUnit()->abandonSnapshot();
+        _opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kProvided,
+                                                       Timestamp(1, 1));
+    }
+
     ServiceContext* serviceContext() {
         return _opCtx->getServiceContext();
     }
@@ -276,6 +288,145 @@ TEST_F(QueryStageMultiPlanTest, MPSCollectionScanVsHighlySelectiveIXScan) {
     ASSERT_EQUALS(results, N / 10);
 }
 
+// With a single thread in the parallel trial pool, the first candidate plan hits EOF before the
+// second one gets to work at all. The second one must then be worked on the operation's thread so
+// that it can be ranked.
+TEST_F(QueryStageMultiPlanTest, MPSWorksPlansStoppedBeforeTheirFirstWorkInParallel) {
+    for (int i = 0; i < 100; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+
+    addIndex(BSON("foo" << 1));
+
+    // The pool of threads is created with this many threads when first used.
+    internalQueryPlanEvaluationParallelThreads = 1;
+    ON_BLOCK_EXIT([] { internalQueryPlanEvaluationParallelThreads = 0; });
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    const Collection* coll = ctx.getCollection();
+    readAtTimestamp();
+
+    // No document matches, so the index scan hits EOF on its first call to work().
+    unique_ptr<WorkingSet> sharedWs(new WorkingSet());
+    auto ixScanWs = std::make_unique<WorkingSet>();
+    unique_ptr<PlanStage> ixScanRoot = getIxScanPlan(_expCtx.get(), coll, ixScanWs.get(), 100);
+
+    BSONObj filterObj = BSON("foo" << 100);
+    unique_ptr<MatchExpression> filter = makeMatchExpressionFromFilter(_expCtx.get(), filterObj);
+    auto collScanWs = std::make_unique<WorkingSet>();
+    unique_ptr<PlanStage> collScanRoot =
+        getCollScanPlan(_expCtx.get(), coll, collScanWs.get(), filter.get());
+
+    auto cq = makeCanonicalQuery(_opCtx.get(), nss, filterObj);
+
+    unique_ptr<MultiPlanStage> mps =
+        std::make_unique<MultiPlanStage>(_expCtx.get(), ctx.getCollection(), cq.get());
+    mps->addPlan(
+        createQuerySolution(), std::move(ixScanRoot), sharedWs.get(), std::move(ixScanWs));
+    mps->addPlan(
+        createQuerySolution(), std::move(collScanRoot), sharedWs.get(), std::move(collScanWs));
+
+    NoopYieldPolicy yieldPolicy(_clock);
+    ASSERT_OK(mps->pickBestPlan(&yieldPolicy));
+    ASSERT(mps->bestPlanChosen());
+    ASSERT_EQUALS(0, mps->bestPlanIdx());
+
+    for (auto&& child : mps->getChildren()) {
+        ASSERT_GT(child->getStats()->common.works, 0U);
+    }
+}
+
+// Same as the first test, but the candidate plans have working sets of their own and are worked
+// on the threads of the parallel trial pool.
+TEST_F(QueryStageMultiPlanTest, MPSWorksPlansWithTheirOwnWorkingSetsInParallel) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+
+    addIndex(BSON("foo" << 1));
+
+    // Enables the parallel trial period. The pool keeps the size it was first created with.
+    internalQueryPlanEvaluationParallelThreads = 2;
+    ON_BLOCK_EXIT([] { internalQueryPlanEvaluationParallelThreads = 0; });
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    const Collection* coll = ctx.getCollection();
+    readAtTimestamp();
+
+    unique_ptr<WorkingSet> sharedWs(new WorkingSet());
+    auto ixScanWs = std::make_unique<WorkingSet>();
+    unique_ptr<PlanStage> ixScanRoot = getIxScanPlan(_expCtx.get(), coll, ixScanWs.get(), 7);
+
+    BSONObj filterObj = BSON("foo" << 7);
+    unique_ptr<MatchExpression> filter = makeMatchExpressionFromFilter(_expCtx.get(), filterObj);
+    auto collScanWs = std::make_unique<WorkingSet>();
+    unique_ptr<PlanStage> collScanRoot =
+        getCollScanPlan(_expCtx.get(), coll, collScanWs.get(), filter.get());
+
+    auto cq = makeCanonicalQuery(_opCtx.get(), nss, filterObj);
+
+    unique_ptr<MultiPlanStage> mps =
+        std::make_unique<MultiPlanStage>(_expCtx.get(), ctx.getCollection(), cq.get());
+    mps->addPlan(
+        createQuerySolution(), std::move(ixScanRoot), sharedWs.get(), std::move(ixScanWs));
+    mps->addPlan(
+        createQuerySolution(), std::move(collScanRoot), sharedWs.get(), std::move(collScanWs));
+
+    NoopYieldPolicy yieldPolicy(_clock);
+    ASSERT_OK(mps->pickBestPlan(&yieldPolicy));
+    ASSERT(mps->bestPlanChosen());
+    ASSERT_EQUALS(0, mps->bestPlanIdx());
+
+    // The index scan returns enough results to end the trial period long before it runs out of
+    // keys.
+    ASSERT_LT(getBestPlanWorks(mps.get()), static_cast<size_t>(N / 10));
+
+    auto statusWithPlanExecutor =
+        plan_executor_factory::make(std::move(cq),
+                                    std::move(sharedWs),
+                                    std::move(mps),
+                                    coll,
+                                    PlanYieldPolicy::YieldPolicy::NO_YIELD);
+    ASSERT_OK(statusWithPlanExecutor.getStatus());
+    auto exec = std::move(statusWithPlanExecutor.getValue());
+
+    // The results produced during the trial period come out first, then the rest, all through the
+    // shared working set.
+    int results = 0;
+    BSONObj obj;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+        ASSERT_EQUALS(obj["foo"].numberInt(), 7);
+        ++results;
+    }
+    ASSERT_EQUALS(PlanExecutor::IS_EOF, state);
+    ASSERT_EQUALS(results, N / 10);
+}
+
+TEST_F(QueryStageMultiPlanTest, MPSWorksPlansInParallelOnlyWithoutExpressionsAndWithATimestamp) {
+    internalQueryPlanEvaluationParallelThreads = 2;
+    ON_BLOCK_EXIT([] { internalQueryPlanEvaluationParallelThreads = 0; });
+
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    for (int i = 0; i < 2; ++i) {
+        solutions.push_back(createQuerySolution());
+        solutions.back()->root = std::make_unique<CollectionScanNode>();
+    }
+
+    auto cq = makeCanonicalQuery(_opCtx.get(), nss, BSON("foo" << 7));
+    auto exprCq = makeCanonicalQuery(_opCtx.get(), nss, fromjson("{$expr: {$eq: ['$foo', 7]}}"));
+
+    // The operation reads the latest data, which the threads of the pool cannot share.
+    ASSERT_FALSE(MultiPlanStage::canWorkPlansInParallel(_opCtx.get(), *cq, solutions));
+
+    readAtTimestamp();
+    ASSERT_TRUE(MultiPlanStage::canWorkPlansInParallel(_opCtx.get(), *cq, solutions));
+
+    // $expr evaluates expressions with the ExpressionContext of the operation.
+    ASSERT_FALSE(MultiPlanStage::canWorkPlansInParallel(_opCtx.get(), *exprCq, solutions));
+}
+
 TEST_F(QueryStageMultiPlanTest, MPSDoesNotCreateActiveCacheEntryImmediately) {
     const int N = 100;
     for (int i = 0; i < N; ++i) {
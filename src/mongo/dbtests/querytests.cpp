@@ -50,6 +50,8 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/find.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_key.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/timer.h"
@@ -1517,6 +1519,63 @@ public:
     }
 };
 
+class ClusteredHelperByIdTest : public CollectionBase {
+public:
+    ClusteredHelperByIdTest() : CollectionBase("clusteredhelpertestbyid") {}
+
+    void run() {
+        if (!_opCtx.getServiceContext()->getStorageEngine()->supportsClusteredIdIndex()) {
+            return;
+        }
+
+        BSONObj info;
+        ASSERT(_client.runCommand(nss().db().toString(),
+                                  BSON("create" << nss().coll() << "clusteredIndex" << true),
+                                  info))
+            << info;
+
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+
+        const OID oid = OID::gen();
+        insert(ns(), BSON("_id" << oid << "x" << 1));
+        insert(ns(),
+               BSON("_id"
+                    << "a"
+                    << "x" << 2));
+        for (int i = 0; i < 100; i += 2) {
+            insert(ns(), BSON("_id" << i << "x" << i * 2));
+        }
+
+        // There is no _id index: the _id is looked up in the record store.
+        BSONObj res;
+        bool nsFound = false;
+        bool indexFound = false;
+        ASSERT(Helpers::findById(
+            &_opCtx, ctx.db(), ns(), BSON("_id" << oid), res, &nsFound, &indexFound));
+        ASSERT(nsFound);
+        ASSERT(indexFound);
+        ASSERT_EQUALS(1, res["x"].numberInt());
+
+        ASSERT(Helpers::findById(&_opCtx,
+                                 ctx.db(),
+                                 ns(),
+                                 BSON("_id"
+                                      << "a"),
+                                 res));
+        ASSERT_EQUALS(2, res["x"].numberInt());
+
+        for (int i = 0; i < 100; i++) {
+            bool found = Helpers::findById(&_opCtx, ctx.db(), ns(), BSON("_id" << i), res);
+            ASSERT_EQUALS(i % 2 == 0, found);
+        }
+
+        const BSONObj id = BSON("_id" << 42);
+        ASSERT_EQ(clusteredkey::keyForId(id.firstElement()),
+                  Helpers::findById(&_opCtx, ctx.getCollection(), id));
+        ASSERT(Helpers::findById(&_opCtx, ctx.getCollection(), BSON("_id" << 43)).isNull());
+    }
+};
+
 class ClientCursorTest : public CollectionBase {
     ClientCursorTest() : CollectionBase("clientcursortest") {}
 
@@ -2049,6 +2108,7 @@ public:
         add<TailableCappedRaceCondition>();
         add<HelperTest>();
         add<HelperByIdTest>();
+        add<ClusteredHelperByIdTest>();
         add<FindingStartPartiallyFull>();
         add<FindingStartStale>();
         add<WhatsMyUri>();
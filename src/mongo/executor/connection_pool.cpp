@@ -51,7 +51,7 @@
 using namespace fmt::literals;
 
 // One interesting implementation note herein concerns how setup() and
-// refresh() are invoked outside of the global lock, but setTimeout is not.
+// refresh() are invoked outside of the specific pool's lock, but setTimeout is not.
 // This implementation detail simplifies mocks, allowing them to return
 // synchronously sometimes, whereas having timeouts fire instantly adds little
 // value. In practice, dumping the locks is always safe (because we restrict
@@ -241,12 +241,20 @@ public:
     auto guardCallback(Callback&& cb) {
         return
             [this, cb = std::forward<Callback>(cb), anchor = shared_from_this()](auto&&... args) {
-                stdx::lock_guard lk(_parent->_mutex);
+                stdx::lock_guard lk(_mutex);
                 cb(std::forward<decltype(args)>(args)...);
                 updateState();
             };
     }
 
+    /**
+     * Returns the mutex protecting the state of this pool. It must be held to call any function
+     * of the pool other than host().
+     */
+    Mutex& mutex() const {
+        return _mutex;
+    }
+
     SpecificPool(std::shared_ptr<ConnectionPool> parent,
                  const HostAndPort& hostAndPort,
                  transport::ConnectSSLMode sslMode);
@@ -254,6 +262,8 @@ public:
 
     /**
      * Create and initialize a SpecificPool
+     *
+     * This should only be called while holding the mutex of the partition the pool is put in.
      */
     static auto make(std::shared_ptr<ConnectionPool> parent,
                      const HostAndPort& hostAndPort,
@@ -268,8 +278,15 @@ public:
     void updateState();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns true if this pool has been delisted from its ConnectionPool and can no longer
+     * service requests.
+     */
+    bool isShutdown() const {
+        return _health.isShutdown;
+    }
+
+    /**
+     * Gets a connection from the specific pool.
      */
     Future<ConnectionHandle> getConnection(Milliseconds timeout);
 
@@ -278,6 +295,8 @@ public:
      * and calls processFailure below with the status provided. This immediately removes this pool
      * from the ConnectionPool. The actual destruction will happen eventually as ConnectionHandles
      * are deleted.
+     *
+     * This acquires the mutex of the pool's partition, so that mutex must not already be held.
      */
     void triggerShutdown(const Status& status);
 
@@ -390,12 +409,22 @@ private:
     // Update the event timer for this host pool
     void updateEventTimer();
 
-    // Update the controller and potentially change the controls
-    void updateController();
+    // Update the controller and potentially change the controls. Returns the state of the host
+    // group, which must be acted upon by updateHostGroup() after this pool's mutex is released.
+    boost::optional<HostGroupState> updateController();
+
+    // Shutdown or create the pools of the other hosts in the group. This must be called without
+    // holding the mutex of any pool.
+    void updateHostGroup(const HostGroupState& hostGroup);
 
 private:
     const std::shared_ptr<ConnectionPool> _parent;
 
+    // Protects all the state below. Checking out and returning connections for this host only
+    // needs this mutex.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1),
+                                            "ExecutorConnectionPool::SpecificPool::_mutex");
+
     const transport::ConnectSSLMode _sslMode;
     const HostAndPort _hostAndPort;
 
@@ -438,6 +467,9 @@ auto ConnectionPool::SpecificPool::make(std::shared_ptr<ConnectionPool> parent,
 
     auto pool = std::make_shared<SpecificPool>(std::move(parent), hostAndPort, sslMode);
 
+    // The pool is not visible to anyone else yet, but its timers may fire as soon as they are set.
+    stdx::lock_guard lk(pool->_mutex);
+
     // Inform the controller that we exist
     controller.addHost(pool->_id, hostAndPort);
 
@@ -476,40 +508,79 @@ ConnectionPool::~ConnectionPool() {
     shutdown();
 }
 
+auto ConnectionPool::_getPartition(const HostAndPort& hostAndPort) const -> PoolPartition& {
+    return _partitions[absl::Hash<HostAndPort>{}(hostAndPort) % kNumPoolPartitions];
+}
+
+auto ConnectionPool::_findPool(const HostAndPort& hostAndPort) const
+    -> std::shared_ptr<SpecificPool> {
+    auto& partition = _getPartition(hostAndPort);
+    stdx::lock_guard lk(partition.mutex);
+
+    auto iter = partition.pools.find(hostAndPort);
+    if (iter == partition.pools.end())
+        return nullptr;
+
+    return iter->second;
+}
+
+auto ConnectionPool::_getOrMakePool(const HostAndPort& hostAndPort,
+                                    transport::ConnectSSLMode sslMode)
+    -> std::shared_ptr<SpecificPool> {
+    auto& partition = _getPartition(hostAndPort);
+    stdx::lock_guard lk(partition.mutex);
+
+    auto& pool = partition.pools[hostAndPort];
+    if (!pool) {
+        pool = SpecificPool::make(shared_from_this(), hostAndPort, sslMode);
+    } else {
+        pool->fassertSSLModeIs(sslMode);
+    }
+
+    return pool;
+}
+
+auto ConnectionPool::_getAllPools() const -> std::vector<std::shared_ptr<SpecificPool>> {
+    std::vector<std::shared_ptr<SpecificPool>> pools;
+    for (auto& partition : _partitions) {
+        stdx::lock_guard lk(partition.mutex);
+        for (const auto& pair : partition.pools) {
+            pools.push_back(pair.second);
+        }
+    }
+
+    return pools;
+}
+
 void ConnectionPool::shutdown() {
     _factory->shutdown();
 
-    // Grab all current pools (under the lock)
-    auto pools = [&] {
-        stdx::lock_guard lk(_mutex);
-        return _pools;
-    }();
+    // Grab all current pools (under the partition locks)
+    auto pools = _getAllPools();
 
-    for (const auto& pair : pools) {
-        stdx::lock_guard lk(_mutex);
-        pair.second->triggerShutdown(
+    for (const auto& pool : pools) {
+        stdx::lock_guard lk(pool->mutex());
+        pool->triggerShutdown(
             Status(ErrorCodes::ShutdownInProgress, "Shutting down the connection pool"));
     }
 }
 
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::lock_guard lk(_mutex);
+    auto pool = _findPool(hostAndPort);
 
-    auto iter = _pools.find(hostAndPort);
-
-    if (iter == _pools.end())
+    if (!pool)
         return;
 
-    auto& pool = iter->second;
+    stdx::lock_guard lk(pool->mutex());
     pool->triggerShutdown(
         Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"));
 }
 
 void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
-    stdx::lock_guard lk(_mutex);
+    auto pools = _getAllPools();
 
-    for (const auto& pair : _pools) {
-        auto& pool = pair.second;
+    for (const auto& pool : pools) {
+        stdx::lock_guard lk(pool->mutex());
 
         if (pool->matchesTags(tags))
             continue;
@@ -522,14 +593,12 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
 void ConnectionPool::mutateTags(
     const HostAndPort& hostAndPort,
     const std::function<transport::Session::TagMask(transport::Session::TagMask)>& mutateFunc) {
-    stdx::lock_guard lk(_mutex);
-
-    auto iter = _pools.find(hostAndPort);
+    auto pool = _findPool(hostAndPort);
 
-    if (iter == _pools.end())
+    if (!pool)
         return;
 
-    auto pool = iter->second;
+    stdx::lock_guard lk(pool->mutex());
     pool->mutateTags(mutateFunc);
 }
 
@@ -548,43 +617,44 @@ void ConnectionPool::get_forTest(const HostAndPort& hostAndPort,
 SemiFuture<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort& hostAndPort,
                                                                  transport::ConnectSSLMode sslMode,
                                                                  Milliseconds timeout) {
-    stdx::lock_guard lk(_mutex);
+    while (true) {
+        auto pool = _getOrMakePool(hostAndPort, sslMode);
+        invariant(pool);
 
-    auto& pool = _pools[hostAndPort];
-    if (!pool) {
-        pool = SpecificPool::make(shared_from_this(), hostAndPort, sslMode);
-    } else {
-        pool->fassertSSLModeIs(sslMode);
-    }
+        stdx::lock_guard lk(pool->mutex());
 
-    invariant(pool);
+        // The pool may have been delisted between looking it up and locking it. If so, the next
+        // lookup will find or make its replacement.
+        if (pool->isShutdown()) {
+            continue;
+        }
 
-    auto connFuture = pool->getConnection(timeout);
-    pool->updateState();
+        auto connFuture = pool->getConnection(timeout);
+        pool->updateState();
 
-    return std::move(connFuture).semi();
+        return std::move(connFuture).semi();
+    }
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
-    stdx::lock_guard lk(_mutex);
+    auto pools = _getAllPools();
 
-    for (const auto& kv : _pools) {
-        HostAndPort host = kv.first;
+    for (const auto& pool : pools) {
+        stdx::lock_guard lk(pool->mutex());
 
-        auto& pool = kv.second;
         ConnectionStatsPer hostStats{pool->inUseConnections(),
                                      pool->availableConnections(),
                                      pool->createdConnections(),
                                      pool->refreshingConnections()};
-        stats->updateStatsForHost(_name, host, hostStats);
+        stats->updateStatsForHost(_name, pool->host(), hostStats);
     }
 }
 
 size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
-    stdx::lock_guard lk(_mutex);
-    auto iter = _pools.find(hostAndPort);
-    if (iter != _pools.end()) {
-        return iter->second->openConnections();
+    auto pool = _findPool(hostAndPort);
+    if (pool) {
+        stdx::lock_guard lk(pool->mutex());
+        return pool->openConnections();
     }
 
     return 0;
@@ -596,7 +666,7 @@ ConnectionPool::SpecificPool::SpecificPool(std::shared_ptr<ConnectionPool> paren
     : _parent(std::move(parent)),
       _sslMode(sslMode),
       _hostAndPort(hostAndPort),
-      _id(_parent->_nextPoolId++),
+      _id(_parent->_nextPoolId.fetchAndAdd(1)),
       _readyPool(std::numeric_limits<size_t>::max()) {
     invariant(_parent);
     _eventTimer = _parent->_factory->makeTimer();
@@ -678,7 +748,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
 
 auto ConnectionPool::SpecificPool::makeHandle(ConnectionInterface* connection) -> ConnectionHandle {
     auto deleter = [this, anchor = shared_from_this()](ConnectionInterface* connection) {
-        stdx::lock_guard lk(_parent->_mutex);
+        stdx::lock_guard lk(_mutex);
         returnConnection(connection);
         _lastActiveTime = _parent->_factory->now();
         updateState();
@@ -902,7 +972,15 @@ void ConnectionPool::SpecificPool::triggerShutdown(const Status& status) {
     // it could be only in the map of pools
     auto anchor = shared_from_this();
     _parent->_controller->removeHost(_id);
-    _parent->_pools.erase(_hostAndPort);
+    {
+        auto& partition = _parent->_getPartition(_hostAndPort);
+        stdx::lock_guard lk(partition.mutex);
+
+        auto iter = partition.pools.find(_hostAndPort);
+        if (iter != partition.pools.end() && iter->second.get() == this) {
+            partition.pools.erase(iter);
+        }
+    }
 
     processFailure(status);
 
@@ -1144,9 +1222,9 @@ void ConnectionPool::SpecificPool::updateEventTimer() {
     _eventTimer->setTimeout(timeout, std::move(deferredStateUpdateFunc));
 }
 
-void ConnectionPool::SpecificPool::updateController() {
+auto ConnectionPool::SpecificPool::updateController() -> boost::optional<HostGroupState> {
     if (_health.isShutdown) {
-        return;
+        return boost::none;
     }
 
     auto& controller = *_parent->_controller;
@@ -1167,15 +1245,27 @@ void ConnectionPool::SpecificPool::updateController() {
                 "poolState"_attr = state);
     auto hostGroup = controller.updateHost(_id, std::move(state));
 
+    if (!hostGroup.canShutdown) {
+        spawnConnections();
+    }
+
+    return hostGroup;
+}
+
+void ConnectionPool::SpecificPool::updateHostGroup(const HostGroupState& hostGroup) {
     // If we can shutdown, then do so
     if (hostGroup.canShutdown) {
         for (const auto& host : hostGroup.hosts) {
-            auto it = _parent->_pools.find(host);
-            if (it == _parent->_pools.end()) {
+            auto pool = _parent->_findPool(host);
+            if (!pool) {
+                continue;
+            }
+
+            stdx::lock_guard lk(pool->_mutex);
+            if (pool->_health.isShutdown) {
                 continue;
             }
 
-            auto& pool = it->second;
             if (!pool->_health.isExpired) {
                 // Just because a HostGroup "canShutdown" doesn't mean that a SpecificPool should
                 // shutdown. For example, it is always inappropriate to shutdown a SpecificPool with
@@ -1204,15 +1294,10 @@ void ConnectionPool::SpecificPool::updateController() {
         return;
     }
 
-
     // Make sure all related hosts exist
     for (const auto& host : hostGroup.hosts) {
-        if (auto& pool = _parent->_pools[host]; !pool) {
-            pool = SpecificPool::make(_parent, host, _sslMode);
-        }
+        _parent->_getOrMakePool(host, _sslMode);
     }
-
-    spawnConnections();
 }
 
 // Updates our state and manages the request timer
@@ -1238,9 +1323,17 @@ void ConnectionPool::SpecificPool::updateState() {
         .getAsync([this, anchor = shared_from_this()](Status&& status) mutable {
             invariant(status);
 
-            stdx::lock_guard lk(_parent->_mutex);
-            _updateScheduled = false;
-            updateController();
+            auto hostGroup = [&] {
+                stdx::lock_guard lk(_mutex);
+                _updateScheduled = false;
+                return updateController();
+            }();
+
+            // The other hosts in the group have their own mutexes, which must not be acquired
+            // while holding ours.
+            if (hostGroup) {
+                updateHostGroup(*hostGroup);
+            }
         });
 }
 
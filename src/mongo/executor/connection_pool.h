@@ -29,12 +29,15 @@
 
 #pragma once
 
+#include <array>
 #include <functional>
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "mongo/executor/egress_tag_closer.h"
 #include "mongo/executor/egress_tag_closer_manager.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/session.h"
@@ -259,13 +262,40 @@ private:
     const std::shared_ptr<DependentTypeFactoryInterface> _factory;
     Options _options;
 
+    /**
+     * A partition of the specific pools, chosen by hashing the HostAndPort. The partition mutex
+     * only protects the map itself: the state of each SpecificPool is protected by that pool's own
+     * mutex, so checking out and returning connections for different hosts never contend.
+     */
+    struct PoolPartition {
+        mutable Mutex mutex = MONGO_MAKE_LATCH("ExecutorConnectionPool::PoolPartition::mutex");
+        stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> pools;
+    };
+
+    static constexpr size_t kNumPoolPartitions = 16;
+
+    PoolPartition& _getPartition(const HostAndPort& hostAndPort) const;
+
+    /**
+     * Returns the pool for the given host, or nullptr if there is none.
+     */
+    std::shared_ptr<SpecificPool> _findPool(const HostAndPort& hostAndPort) const;
+
+    /**
+     * Returns the pool for the given host, creating it if necessary.
+     */
+    std::shared_ptr<SpecificPool> _getOrMakePool(const HostAndPort& hostAndPort,
+                                                 transport::ConnectSSLMode sslMode);
+
+    /**
+     * Returns a snapshot of all the current pools.
+     */
+    std::vector<std::shared_ptr<SpecificPool>> _getAllPools() const;
+
     std::shared_ptr<ControllerInterface> _controller;
 
-    // The global mutex for specific pool access and the generation counter
-    mutable Mutex _mutex =
-        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1), "ExecutorConnectionPool::_mutex");
-    PoolId _nextPoolId = 0;
-    stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> _pools;
+    AtomicWord<PoolId> _nextPoolId{0};
+    mutable std::array<PoolPartition, kNumPoolPartitions> _partitions;
 
     EgressTagCloserManager* _manager;
 };
@@ -0,0 +1,191 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/executor/connection_pool.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+namespace executor {
+namespace {
+
+/**
+ * A timer that never fires. The benchmark runs for far less time than any of the pool's refresh or
+ * expiration timeouts.
+ */
+class BenchmarkTimer final : public ConnectionPool::TimerInterface {
+public:
+    void setTimeout(Milliseconds timeout, TimeoutCallback cb) override {}
+
+    void cancelTimeout() override {}
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+};
+
+/**
+ * A connection that needs no networking: setup and refresh succeed as soon as the executor gets
+ * to them.
+ */
+class BenchmarkConnection final : public ConnectionPool::ConnectionInterface {
+public:
+    BenchmarkConnection(const HostAndPort& hostAndPort,
+                        size_t generation,
+                        std::shared_ptr<OutOfLineExecutor> executor)
+        : ConnectionInterface(generation),
+          _hostAndPort(hostAndPort),
+          _executor(std::move(executor)) {}
+
+    const HostAndPort& getHostAndPort() const override {
+        return _hostAndPort;
+    }
+
+    transport::ConnectSSLMode getSslMode() const override {
+        return transport::kGlobalSSLMode;
+    }
+
+    bool isHealthy() override {
+        return true;
+    }
+
+    void setTimeout(Milliseconds timeout, TimeoutCallback cb) override {}
+
+    void cancelTimeout() override {}
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+
+private:
+    void setup(Milliseconds timeout, SetupCallback cb) override {
+        // The callback takes the specific pool's lock, which is held by our caller.
+        _executor->schedule([this, cb = std::move(cb)](Status) mutable {
+            indicateUsed();
+            cb(this, Status::OK());
+        });
+    }
+
+    void refresh(Milliseconds timeout, RefreshCallback cb) override {
+        _executor->schedule([this, cb = std::move(cb)](Status) mutable {
+            indicateUsed();
+            cb(this, Status::OK());
+        });
+    }
+
+    const HostAndPort _hostAndPort;
+    const std::shared_ptr<OutOfLineExecutor> _executor;
+};
+
+class BenchmarkTypeFactory final : public ConnectionPool::DependentTypeFactoryInterface {
+public:
+    explicit BenchmarkTypeFactory(std::shared_ptr<OutOfLineExecutor> executor)
+        : _executor(std::move(executor)) {}
+
+    std::shared_ptr<ConnectionPool::ConnectionInterface> makeConnection(
+        const HostAndPort& hostAndPort,
+        transport::ConnectSSLMode sslMode,
+        size_t generation) override {
+        return std::make_shared<BenchmarkConnection>(hostAndPort, generation, _executor);
+    }
+
+    const std::shared_ptr<OutOfLineExecutor>& getExecutor() override {
+        return _executor;
+    }
+
+    std::shared_ptr<ConnectionPool::TimerInterface> makeTimer() override {
+        return std::make_shared<BenchmarkTimer>();
+    }
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+
+    void shutdown() override {
+        // The executor outlives the pool, see BM_ConnectionPoolGetAndReturn.
+    }
+
+private:
+    const std::shared_ptr<OutOfLineExecutor> _executor;
+};
+
+/**
+ * Benchmark checking out a connection and returning it to the pool. Every thread uses the same
+ * pool, and the threads are spread over state.range(0) hosts. With as many hosts as threads, no
+ * two threads ever touch the same host, which exercises the contention between specific pools.
+ */
+void BM_ConnectionPoolGetAndReturn(benchmark::State& state) {
+    static std::shared_ptr<ThreadPool> executor;
+    static std::shared_ptr<ConnectionPool> pool;
+    if (state.thread_index == 0) {
+        ThreadPool::Options options;
+        options.poolName = "ConnectionPoolBenchmark";
+        options.minThreads = 1;
+        options.maxThreads = 4;
+        executor = std::make_shared<ThreadPool>(std::move(options));
+        executor->startup();
+
+        pool = std::make_shared<ConnectionPool>(std::make_shared<BenchmarkTypeFactory>(executor),
+                                                "ConnectionPoolBenchmark");
+    }
+
+    const auto numHosts = static_cast<int>(state.range(0));
+    const HostAndPort host("host", 20000 + (state.thread_index % numHosts));
+
+    for (auto keepRunning : state) {
+        auto conn = pool->get(host, transport::kGlobalSSLMode, Seconds(10)).get();
+        conn->indicateUsed();
+        conn->indicateSuccess();
+        conn.reset();
+    }
+
+    if (state.thread_index == 0) {
+        pool->shutdown();
+        pool.reset();
+
+        // Drain the pool's outstanding updates before stopping the executor.
+        executor->shutdown();
+        executor->join();
+        executor.reset();
+    }
+}
+
+BENCHMARK(BM_ConnectionPoolGetAndReturn)
+    ->ArgName("hosts")
+    ->Arg(1)
+    ->Arg(64)
+    ->ThreadRange(1, 128)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace executor
+}  // namespace mongo
@@ -1518,6 +1518,42 @@ TEST_F(ConnectionPoolTest, AsyncGet) {
     }
 }
 
+/**
+ * Verify that the pools for many hosts, several of which share a partition of the pool map, keep
+ * their connections separate.
+ */
+TEST_F(ConnectionPoolTest, ManyHostsKeepSeparateConnections) {
+    auto pool = makePool();
+
+    const int kNumHosts = 64;
+    auto hostAt = [](int i) { return HostAndPort("localhost", 30000 + i); };
+
+    std::vector<ConnectionPool::ConnectionHandle> conns;
+    for (int i = 0; i < kNumHosts; ++i) {
+        auto connFuture = getFromPool(hostAt(i), transport::kGlobalSSLMode, Seconds(1));
+        ConnectionImpl::pushSetup(Status::OK());
+        conns.push_back(std::move(connFuture).get());
+        ASSERT_EQ(conns.back()->getHostAndPort(), hostAt(i));
+    }
+
+    for (auto& conn : conns) {
+        doneWith(conn);
+    }
+
+    for (int i = 0; i < kNumHosts; ++i) {
+        ASSERT_EQ(1ul, pool->getNumConnectionsPerHost(hostAt(i)));
+    }
+
+    // Dropping the connections to one host leaves every other host alone.
+    for (int i = 0; i < kNumHosts; i += 2) {
+        pool->dropConnections(hostAt(i));
+    }
+
+    for (int i = 0; i < kNumHosts; ++i) {
+        ASSERT_EQ(i % 2 ? 1ul : 0ul, pool->getNumConnectionsPerHost(hostAt(i)));
+    }
+}
+
 TEST_F(ConnectionPoolTest, ReturnAfterShutdown) {
     auto pool = makePool();
 
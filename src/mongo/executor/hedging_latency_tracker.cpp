@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/hedging_latency_tracker.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+namespace {
+const auto hedgingLatencyTrackerDecoration =
+    ServiceContext::declareDecoration<HedgingLatencyTracker>();
+}  // namespace
+
+HedgingLatencyTracker* HedgingLatencyTracker::get(ServiceContext* service) {
+    return &hedgingLatencyTrackerDecoration(service);
+}
+
+void HedgingLatencyTracker::record(const HostAndPort& host, Milliseconds latency, Date_t now) {
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    // Sweep at most once per idle period, so that recording stays cheap with many hosts.
+    if (now - _lastIdleHostsEviction >= kMaxHostIdleTime) {
+        for (auto it = _hosts.begin(); it != _hosts.end();) {
+            if (now - it->second.lastRecorded >= kMaxHostIdleTime) {
+                _hosts.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+        _lastIdleHostsEviction = now;
+    }
+
+    auto& hostSamples = _hosts[host];
+    hostSamples.lastRecorded = now;
+
+    if (hostSamples.samples.size() < kMaxSamplesPerHost) {
+        hostSamples.samples.push_back(latency);
+        return;
+    }
+
+    hostSamples.samples[hostSamples.next] = latency;
+    hostSamples.next = (hostSamples.next + 1) % kMaxSamplesPerHost;
+}
+
+boost::optional<Milliseconds> HedgingLatencyTracker::getPercentile(const HostAndPort& host,
+                                                                   int percentile) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _getPercentile(lk, host, percentile);
+}
+
+boost::optional<Milliseconds> HedgingLatencyTracker::_getPercentile(WithLock,
+                                                                    const HostAndPort& host,
+                                                                    int percentile) const {
+    invariant(percentile > 0 && percentile <= 100);
+
+    auto it = _hosts.find(host);
+    if (it == _hosts.end() || it->second.samples.size() < kMinSamplesPerHost) {
+        return boost::none;
+    }
+
+    // Select the nearest-rank percentile from a copy so that the ring buffer order is preserved.
+    auto samples = it->second.samples;
+    auto rank = (samples.size() * percentile + 99) / 100;
+    auto nth = samples.begin() + (rank - 1);
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+HedgingLatencyTracker::HedgePlan HedgingLatencyTracker::planHedgedRequest(
+    std::vector<HostAndPort>* targets, int percentile) const {
+    invariant(targets && !targets->empty());
+
+    HedgePlan plan;
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    plan.delay = _getPercentile(lk, targets->front(), percentile);
+    if (!plan.delay) {
+        return plan;
+    }
+
+    auto isSlower = [&](const HostAndPort& target) {
+        auto median = _getPercentile(lk, target, 50);
+        return median && *median > *plan.delay;
+    };
+
+    auto newEnd = std::remove_if(targets->begin() + 1, targets->end(), isSlower);
+    plan.numSkippedTargets = std::distance(newEnd, targets->end());
+    targets->erase(newEnd, targets->end());
+
+    return plan;
+}
+
+void HedgingLatencyTracker::clear() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _hosts.clear();
+}
+
+}  // namespace mongo
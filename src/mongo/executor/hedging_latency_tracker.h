@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/db/service_context.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/net/hostandport.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Keeps a bounded window of recent response times for each remote host that hedgeable reads are
+ * sent to, and uses them to decide when (and to which hosts) hedged requests should be dispatched.
+ */
+class HedgingLatencyTracker {
+    HedgingLatencyTracker(const HedgingLatencyTracker&) = delete;
+    HedgingLatencyTracker& operator=(const HedgingLatencyTracker&) = delete;
+
+public:
+    // The number of most recent response times remembered for each host.
+    static constexpr size_t kMaxSamplesPerHost = 128;
+
+    // The minimum number of response times needed before a host's latency distribution is used.
+    static constexpr size_t kMinSamplesPerHost = 16;
+
+    // Hosts with no response time recorded for this long are forgotten.
+    static constexpr Minutes kMaxHostIdleTime{10};
+
+    struct HedgePlan {
+        // How long to wait for the first request before sending the hedged requests, or none if
+        // there is not enough history for the first target and the hedges should go out at once.
+        boost::optional<Milliseconds> delay;
+
+        // The number of hedge targets dropped because they are known to be slower than the first
+        // target.
+        size_t numSkippedTargets = 0;
+    };
+
+    HedgingLatencyTracker() = default;
+
+    static HedgingLatencyTracker* get(ServiceContext* service);
+
+    /**
+     * Records that a request to 'host' completed after 'latency', at time 'now'. Forgets the hosts
+     * that were idle for longer than kMaxHostIdleTime.
+     */
+    void record(const HostAndPort& host, Milliseconds latency, Date_t now);
+
+    /**
+     * Returns the given percentile (in the range [1, 100]) of the recent response times from
+     * 'host', or none if not enough responses from that host have been recorded.
+     */
+    boost::optional<Milliseconds> getPercentile(const HostAndPort& host, int percentile) const;
+
+    /**
+     * Decides how to hedge a request whose first choice is targets[0]. The hedge delay is the given
+     * percentile of the first target's recent response times. Hedge targets whose median response
+     * time exceeds that delay cannot be expected to beat the first target, so they are removed
+     * from 'targets'. The first target is never removed.
+     */
+    HedgePlan planHedgedRequest(std::vector<HostAndPort>* targets, int percentile) const;
+
+    /**
+     * Forgets all recorded response times.
+     */
+    void clear();
+
+private:
+    struct HostSamples {
+        // Ring buffer of at most kMaxSamplesPerHost response times.
+        std::vector<Milliseconds> samples;
+
+        // Position in 'samples' that the next response time overwrites once the buffer is full.
+        size_t next = 0;
+
+        // When the most recent response time was recorded.
+        Date_t lastRecorded;
+    };
+
+    boost::optional<Milliseconds> _getPercentile(WithLock,
+                                                 const HostAndPort& host,
+                                                 int percentile) const;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("HedgingLatencyTracker::_mutex");
+    stdx::unordered_map<HostAndPort, HostSamples> _hosts;
+
+    // When the idle hosts were last forgotten.
+    Date_t _lastIdleHostsEviction;
+};
+
+}  // namespace mongo
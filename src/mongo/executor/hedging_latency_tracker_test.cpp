@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/hedging_latency_tracker.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const HostAndPort kHost1("host1", 27017);
+const HostAndPort kHost2("host2", 27017);
+const HostAndPort kHost3("host3", 27017);
+const Date_t kNow = Date_t::fromMillisSinceEpoch(1000 * 1000);
+
+/**
+ * Records the response times 1ms, 2ms, ..., count ms for 'host', multiplied by 'scale'.
+ */
+void recordLinear(HedgingLatencyTracker& tracker,
+                  const HostAndPort& host,
+                  size_t count,
+                  int scale = 1) {
+    for (size_t i = 1; i <= count; ++i) {
+        tracker.record(host, Milliseconds(static_cast<int>(i) * scale), kNow);
+    }
+}
+
+TEST(HedgingLatencyTrackerTest, NoEstimateWithoutEnoughSamples) {
+    HedgingLatencyTracker tracker;
+    ASSERT_FALSE(tracker.getPercentile(kHost1, 95));
+
+    recordLinear(tracker, kHost1, HedgingLatencyTracker::kMinSamplesPerHost - 1);
+    ASSERT_FALSE(tracker.getPercentile(kHost1, 95));
+
+    tracker.record(kHost1, Milliseconds(1), kNow);
+    ASSERT_TRUE(tracker.getPercentile(kHost1, 95));
+    ASSERT_FALSE(tracker.getPercentile(kHost2, 95));
+}
+
+TEST(HedgingLatencyTrackerTest, NearestRankPercentiles) {
+    HedgingLatencyTracker tracker;
+    recordLinear(tracker, kHost1, 100);
+
+    ASSERT_EQ(*tracker.getPercentile(kHost1, 1), Milliseconds(1));
+    ASSERT_EQ(*tracker.getPercentile(kHost1, 50), Milliseconds(50));
+    ASSERT_EQ(*tracker.getPercentile(kHost1, 95), Milliseconds(95));
+    ASSERT_EQ(*tracker.getPercentile(kHost1, 100), Milliseconds(100));
+}
+
+TEST(HedgingLatencyTrackerTest, OldSamplesAreEvicted) {
+    HedgingLatencyTracker tracker;
+    recordLinear(tracker, kHost1, HedgingLatencyTracker::kMaxSamplesPerHost, 1000);
+    ASSERT_EQ(*tracker.getPercentile(kHost1, 100),
+              Milliseconds(static_cast<int>(1000 * HedgingLatencyTracker::kMaxSamplesPerHost)));
+
+    // A full window of fast responses replaces every slow one.
+    for (size_t i = 0; i < HedgingLatencyTracker::kMaxSamplesPerHost; ++i) {
+        tracker.record(kHost1, Milliseconds(5), kNow);
+    }
+    ASSERT_EQ(*tracker.getPercentile(kHost1, 100), Milliseconds(5));
+}
+
+TEST(HedgingLatencyTrackerTest, PlanWithoutHistorySendsHedgesImmediately) {
+    HedgingLatencyTracker tracker;
+    recordLinear(tracker, kHost2, 100, 1000);
+
+    std::vector<HostAndPort> targets{kHost1, kHost2};
+    auto plan = tracker.planHedgedRequest(&targets, 95);
+
+    ASSERT_FALSE(plan.delay);
+    ASSERT_EQ(plan.numSkippedTargets, 0U);
+    ASSERT_EQ(targets.size(), 2U);
+}
+
+TEST(HedgingLatencyTrackerTest, PlanDelaysHedgesAndSkipsSlowerHosts) {
+    HedgingLatencyTracker tracker;
+    recordLinear(tracker, kHost1, 100);
+    recordLinear(tracker, kHost2, 100);
+    recordLinear(tracker, kHost3, 100, 10);
+
+    std::vector<HostAndPort> targets{kHost1, kHost3, kHost2};
+    auto plan = tracker.planHedgedRequest(&targets, 95);
+
+    ASSERT_TRUE(plan.delay);
+    ASSERT_EQ(*plan.delay, Milliseconds(95));
+    ASSERT_EQ(plan.numSkippedTargets, 1U);
+    ASSERT_EQ(targets.size(), 2U);
+    ASSERT_EQ(targets[0], kHost1);
+    ASSERT_EQ(targets[1], kHost2);
+}
+
+TEST(HedgingLatencyTrackerTest, PlanNeverSkipsFirstTarget) {
+    HedgingLatencyTracker tracker;
+    recordLinear(tracker, kHost1, 100, 10);
+    recordLinear(tracker, kHost2, 100);
+
+    std::vector<HostAndPort> targets{kHost1, kHost2};
+    auto plan = tracker.planHedgedRequest(&targets, 95);
+
+    ASSERT_EQ(*plan.delay, Milliseconds(950));
+    ASSERT_EQ(plan.numSkippedTargets, 0U);
+    ASSERT_EQ(targets.size(), 2U);
+}
+
+TEST(HedgingLatencyTrackerTest, ClearForgetsHistory) {
+    HedgingLatencyTracker tracker;
+    recordLinear(tracker, kHost1, 100);
+    tracker.clear();
+    ASSERT_FALSE(tracker.getPercentile(kHost1, 50));
+}
+
+TEST(HedgingLatencyTrackerTest, IdleHostsAreForgotten) {
+    HedgingLatencyTracker tracker;
+    recordLinear(tracker, kHost1, 100);
+    for (int i = 1; i <= 100; ++i) {
+        tracker.record(kHost2, Milliseconds(i), kNow + Minutes(5));
+    }
+
+    // Nothing is forgotten before the idle time has passed.
+    tracker.record(kHost3, Milliseconds(1), kNow + Minutes(1));
+    ASSERT_TRUE(tracker.getPercentile(kHost1, 50));
+
+    // Only the host that was idle for longer than the idle time is forgotten.
+    tracker.record(
+        kHost3, Milliseconds(1), kNow + HedgingLatencyTracker::kMaxHostIdleTime + Minutes(1));
+    ASSERT_FALSE(tracker.getPercentile(kHost1, 50));
+    ASSERT_TRUE(tracker.getPercentile(kHost2, 50));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -67,12 +67,30 @@ void HedgingMetrics::incrementNumAdvantageouslyHedgedOperations() {
     _numAdvantageouslyHedgedOperations.fetchAndAdd(1);
 }
 
+long long HedgingMetrics::getNumSkippedHedgeTargets() const {
+    return _numSkippedHedgeTargets.load();
+}
+
+void HedgingMetrics::incrementNumSkippedHedgeTargets(long long n) {
+    _numSkippedHedgeTargets.fetchAndAdd(n);
+}
+
+long long HedgingMetrics::getNumHedgesAvoidedByDelay() const {
+    return _numHedgesAvoidedByDelay.load();
+}
+
+void HedgingMetrics::incrementNumHedgesAvoidedByDelay() {
+    _numHedgesAvoidedByDelay.fetchAndAdd(1);
+}
+
 BSONObj HedgingMetrics::toBSON() const {
     BSONObjBuilder builder;
 
     builder.append("numTotalOperations", _numTotalOperations.load());
     builder.append("numTotalHedgedOperations", _numTotalHedgedOperations.load());
     builder.append("numAdvantageouslyHedgedOperations", _numAdvantageouslyHedgedOperations.load());
+    builder.append("numSkippedHedgeTargets", _numSkippedHedgeTargets.load());
+    builder.append("numHedgesAvoidedByDelay", _numHedgesAvoidedByDelay.load());
 
     return builder.obj();
 }
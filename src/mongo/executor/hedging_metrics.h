@@ -56,6 +56,12 @@ public:
     long long getNumAdvantageouslyHedgedOperations() const;
     void incrementNumAdvantageouslyHedgedOperations();
 
+    long long getNumSkippedHedgeTargets() const;
+    void incrementNumSkippedHedgeTargets(long long n);
+
+    long long getNumHedgesAvoidedByDelay() const;
+    void incrementNumHedgesAvoidedByDelay();
+
     BSONObj toBSON() const;
 
 private:
@@ -68,6 +74,14 @@ private:
     // The number of all operations where a rpc other than the first one fulfilled the client
     // request.
     AtomicWord<long long> _numAdvantageouslyHedgedOperations{0};
+
+    // The number of hedge targets that were not sent an additional rpc because their recent
+    // response times showed them to be slower than the first target.
+    AtomicWord<long long> _numSkippedHedgeTargets{0};
+
+    // The number of operations whose hedged rpcs were delayed and never sent because the first rpc
+    // completed before the delay expired.
+    AtomicWord<long long> _numHedgesAvoidedByDelay{0};
 };
 
 }  // namespace mongo
@@ -35,6 +35,7 @@
 
 #include "mongo/db/server_options.h"
 #include "mongo/executor/connection_pool_tl.h"
+#include "mongo/executor/hedging_latency_tracker.h"
 #include "mongo/executor/hedging_metrics.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -384,6 +385,14 @@ void NetworkInterfaceTL::CommandStateBase::tryFinish(Status status) noexcept {
 
     // The command has resolved one way or another.
     timer->cancel(baton);
+    if (hedgeTimer) {
+        hedgeTimer->cancel(baton);
+
+        // The first request answered within the delay, so the held back hedges were never sent.
+        if (status.isOK() && !hedgeTimerFired.load()) {
+            HedgingMetrics::get(interface->_svcCtx)->incrementNumHedgesAvoidedByDelay();
+        }
+    }
 
     if (interface->_counters) {
         // Increment our counters for the integration test
@@ -473,6 +482,20 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
                   });
     }
 
+    // When adaptive hedging is enabled, work out how long the hedged requests should be held back
+    // and drop the hedge targets that are known to be slower than the first one.
+    boost::optional<Milliseconds> hedgeDelay;
+    if (_svcCtx && request.hedgeOptions && request.hedgeOptions->hedgeDelayPercentile > 0 &&
+        request.target.size() > 1 && !targetHostsInAlphabeticalOrder) {
+        auto plan = HedgingLatencyTracker::get(_svcCtx)->planHedgedRequest(
+            &request.target, request.hedgeOptions->hedgeDelayPercentile);
+        hedgeDelay = plan.delay;
+
+        if (plan.numSkippedTargets > 0) {
+            HedgingMetrics::get(_svcCtx)->incrementNumSkippedHedgeTargets(plan.numSkippedTargets);
+        }
+    }
+
     auto [cmdState, future] = CommandState::make(this, request, cbHandle);
     if (cmdState->requestOnAny.timeout != cmdState->requestOnAny.kNoTimeout) {
         cmdState->deadline = cmdState->stopwatch.start() + cmdState->requestOnAny.timeout;
@@ -534,21 +557,61 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         return Status::OK();
     }
 
-    // Attempt to get a connection to every target host
-    for (size_t idx = 0; idx < request.target.size(); ++idx) {
+    auto acquireConnection = [this, cmdState = cmdState, targetHostsInAlphabeticalOrder](
+                                 size_t idx) {
+        const auto& request = cmdState->requestOnAny;
         auto connFuture = _pool->get(request.target[idx], request.sslMode, request.timeout);
 
         // If connection future is ready or requests should be sent in order, send the request
         // immediately.
         if (connFuture.isReady() || targetHostsInAlphabeticalOrder) {
             cmdState->requestManager->trySend(std::move(connFuture).getNoThrow(), idx);
-            continue;
+            return;
         }
 
         // Otherwise, schedule the request.
         std::move(connFuture).thenRunOn(_reactor).getAsync([cmdState = cmdState, idx](auto swConn) {
             cmdState->requestManager->trySend(std::move(swConn), idx);
         });
+    };
+
+    // Only the first target is contacted right away if the hedged requests are being held back.
+    const size_t numImmediateTargets = hedgeDelay ? 1 : request.target.size();
+
+    if (numImmediateTargets < request.target.size()) {
+        LOGV2_DEBUG(4917400,
+                    2,
+                    "Delaying hedged requests",
+                    "requestId"_attr = request.id,
+                    "delay"_attr = *hedgeDelay);
+
+        // Arm the hedge timer before sending anything so that finishing the command always finds
+        // it to cancel.
+        cmdState->hedgeTimer = _reactor->makeTimer();
+        cmdState->hedgeTimer->waitUntil(now() + *hedgeDelay, baton)
+            .getAsync([this, cmdState = cmdState, acquireConnection, numImmediateTargets](
+                          Status status) {
+                // The timer is canceled once the command finishes, which counts the hedges it
+                // avoided.
+                if (!status.isOK()) {
+                    return;
+                }
+
+                cmdState->hedgeTimerFired.store(true);
+                if (cmdState->finishLine.isReady()) {
+                    return;
+                }
+
+                for (size_t idx = numImmediateTargets; idx < cmdState->requestOnAny.target.size();
+                     ++idx) {
+                    acquireConnection(idx);
+                }
+            });
+    }
+
+    // Attempt to get a connection to every target host that should not wait for the hedge timer.
+    for (size_t idx = 0; idx < numImmediateTargets; ++idx) {
+        acquireConnection(idx);
     }
 
     return Status::OK();
@@ -808,6 +871,17 @@ void NetworkInterfaceTL::RequestState::resolve(Future<RemoteCommandResponse> fut
             returnConnection(status);
 
             auto commandStatus = getStatusFromCommandResult(response.data);
+
+            // Feed the response times of hedgeable reads back into the delay used for later
+            // hedged reads. Responses cut short by maxTimeMS or _killOperations say nothing about
+            // how fast the host is.
+            if (auto svcCtx = interface()->_svcCtx; svcCtx && cmdState->requestOnAny.hedgeOptions &&
+                status.isOK() && commandStatus != ErrorCodes::MaxTimeMSExpired &&
+                !ErrorCodes::isInterruption(commandStatus)) {
+                HedgingLatencyTracker::get(svcCtx)->record(
+                    host, stopwatch.elapsed(), svcCtx->getFastClockSource()->now());
+            }
+
             // Ignore maxTimeMS expiration errors for hedged reads without triggering the finish
             // line.
             if (isHedge && commandStatus == ErrorCodes::MaxTimeMSExpired) {
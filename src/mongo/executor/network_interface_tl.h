@@ -171,6 +171,12 @@ private:
         BatonHandle baton;
         std::unique_ptr<transport::ReactorTimer> timer;
 
+        // Fires when the hedged requests that were held back for adaptive hedging should be sent.
+        std::unique_ptr<transport::ReactorTimer> hedgeTimer;
+
+        // Set once 'hedgeTimer' fired, whether or not the command still needed the hedges then.
+        AtomicWord<bool> hedgeTimerFired{false};
+
         std::unique_ptr<RequestManager> requestManager;
 
         // TODO replace the finishLine with an atomic bool. It is no longer tracking allowed
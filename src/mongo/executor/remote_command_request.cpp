@@ -147,6 +147,9 @@ std::string RemoteCommandRequestImpl<T>::toString() const {
     if (hedgeOptions) {
         invariant(operationKey);
         out << " hedgeOptions.count: " << hedgeOptions->count;
+        if (hedgeOptions->hedgeDelayPercentile) {
+            out << " hedgeOptions.hedgeDelayPercentile: " << hedgeOptions->hedgeDelayPercentile;
+        }
         out << " operationKey: " << operationKey.get();
     }
 
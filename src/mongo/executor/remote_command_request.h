@@ -46,6 +46,9 @@ struct RemoteCommandRequestBase {
     struct HedgeOptions {
         size_t count = 0;
         int maxTimeMSForHedgedReads = 0;
+        // If non-zero, the hedged requests are held back until the first request has been
+        // outstanding for this percentile of the recent response times from its target.
+        int hedgeDelayPercentile = 0;
     };
 
     enum FireAndForgetMode { kOn, kOff };
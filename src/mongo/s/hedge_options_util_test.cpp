@@ -93,10 +93,13 @@ protected:
     static inline const std::string kReadHedgingModeFieldName = "readHedgingMode";
     static inline const std::string kMaxTimeMSForHedgedReadsFieldName = "maxTimeMSForHedgedReads";
     static inline const int kMaxTimeMSForHedgedReadsDefault = 10;
+    static inline const std::string kHedgedReadsDelayPercentileFieldName =
+        "hedgedReadsDelayPercentile";
 
     static inline const BSONObj kDefaultParameters =
         BSON(kReadHedgingModeFieldName << "on" << kMaxTimeMSForHedgedReadsFieldName
-                                       << kMaxTimeMSForHedgedReadsDefault);
+                                       << kMaxTimeMSForHedgedReadsDefault
+                                       << kHedgedReadsDelayPercentileFieldName << 0);
 
 private:
     ServiceContext::UniqueServiceContext _serviceCtx = ServiceContext::make();
@@ -191,5 +194,31 @@ TEST_F(HedgeOptionsUtilTestFixture, MaxTimeMSForHedgedReads) {
     checkHedgeOptions(parameters, cmdObj, rspObj, true, 100);
 }
 
+TEST_F(HedgeOptionsUtilTestFixture, HedgedReadsDelayPercentileDefault) {
+    const auto cmdObj = BSON("find" << kCollName);
+    const auto rspObj = BSON("mode"
+                             << "nearest"
+                             << "hedge" << BSONObj());
+
+    auto readPref = uassertStatusOK(ReadPreferenceSetting::fromInnerBSON(rspObj));
+    auto hedgeOptions = extractHedgeOptions(cmdObj, readPref);
+    ASSERT_TRUE(hedgeOptions.has_value());
+    ASSERT_EQ(hedgeOptions->hedgeDelayPercentile, 0);
+}
+
+TEST_F(HedgeOptionsUtilTestFixture, HedgedReadsDelayPercentile) {
+    setParameters(BSON(kHedgedReadsDelayPercentileFieldName << 95));
+    const auto cmdObj = BSON("find" << kCollName);
+    const auto rspObj = BSON("mode"
+                             << "nearest"
+                             << "hedge" << BSONObj());
+
+    auto readPref = uassertStatusOK(ReadPreferenceSetting::fromInnerBSON(rspObj));
+    auto hedgeOptions = extractHedgeOptions(cmdObj, readPref);
+    ASSERT_TRUE(hedgeOptions.has_value());
+    ASSERT_EQ(hedgeOptions->hedgeDelayPercentile, 95);
+    ASSERT_EQ(hedgeOptions->maxTimeMSForHedgedReads, kMaxTimeMSForHedgedReadsDefault);
+}
+
 }  // namespace
 }  // namespace mongo
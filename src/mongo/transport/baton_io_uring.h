@@ -0,0 +1,580 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/transport/baton.h"
+#include "mongo/transport/io_uring.h"
+#include "mongo/transport/session_io_uring.h"
+#include "mongo/transport/transport_layer_asio.h"
+#include "mongo/util/concepts.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/functional.h"
+#include "mongo/util/future.h"
+#include "mongo/util/hierarchical_acquisition.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * TransportLayerIOUring Baton implementation.
+ *
+ * This mirrors TransportLayerASIO::BatonASIO, except that sessions are waited on with io_uring poll
+ * requests instead of ::poll. A poll request stays armed until its session becomes ready or is
+ * canceled, so waiting again on the same sessions does not resubmit them.
+ */
+class TransportLayerIOUring::BatonIOUring : public NetworkingBaton {
+    static const inline auto kDetached = Status(ErrorCodes::ShutdownInProgress, "Baton detached");
+    static const inline auto kCanceled =
+        Status(ErrorCodes::CallbackCanceled, "Baton wait canceled");
+
+    static constexpr unsigned kRingEntries = 64;
+
+    // The tokens identifying the poll on the wakeup eventfd and the requests removing polls. The
+    // tokens of session polls come after them.
+    static constexpr uint64_t kWakeupToken = 0;
+    static constexpr uint64_t kRemovePollToken = 1;
+    static constexpr uint64_t kFirstSessionToken = 2;
+
+    /**
+     * We use this internal reactor timer to exit run_until calls (by forcing an early timeout for
+     * the wait on the ring).
+     *
+     * Its methods are all unreachable because we never actually use its timer-ness (we just need
+     * its address for baton book keeping).
+     */
+    class InternalReactorTimer : public ReactorTimer {
+    public:
+        void cancel(const BatonHandle& baton = nullptr) override {
+            MONGO_UNREACHABLE;
+        }
+
+        Future<void> waitUntil(Date_t timeout, const BatonHandle& baton = nullptr) override {
+            MONGO_UNREACHABLE;
+        }
+    };
+
+    /**
+     * The ring and wakeup eventfd of a client, shared by the batons of its successive operations.
+     * The polls of a detached baton are removed, but their completions may still show up while the
+     * next baton waits, which ignores them as their tokens are never reused.
+     */
+    struct ClientRing {
+        ClientRing() : ring(kRingEntries), efd(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+            if (efd < 0) {
+                auto savedErrno = errno;
+                std::string reason = str::stream()
+                    << "error in creating eventfd: " << errnoWithDescription(savedErrno);
+
+                auto code = (savedErrno == EMFILE || savedErrno == ENFILE)
+                    ? ErrorCodes::TooManyFilesOpen
+                    : ErrorCodes::UnknownError;
+
+                uasserted(code, reason);
+            }
+        }
+
+        ~ClientRing() {
+            ::close(efd);
+        }
+
+        ClientRing(const ClientRing&) = delete;
+        ClientRing& operator=(const ClientRing&) = delete;
+
+        // Writes to the underlying eventfd
+        void notify() {
+            while (true) {
+                if (::eventfd_write(efd, 1) == 0) {
+                    break;
+                }
+
+                invariant(errno == EINTR);
+            }
+        }
+
+        // Resets the eventfd after its poll fired.
+        void drain() {
+            uint64_t u;
+            while (::eventfd_read(efd, &u) != 0 && errno == EINTR) {
+            }
+        }
+
+        IOUring ring;
+        const int efd;
+
+        // Whether a poll on 'efd' is armed.
+        bool efdArmed = false;
+
+        uint64_t nextToken = kFirstSessionToken;
+    };
+
+    // Created by the first baton of the client, as most clients never need one.
+    static inline const auto getClientRing =
+        Client::declareDecoration<std::unique_ptr<ClientRing>>();
+
+public:
+    BatonIOUring(OperationContext* opCtx) : _opCtx(opCtx) {
+        auto& clientRing = getClientRing(_opCtx->getClient());
+        if (!clientRing) {
+            clientRing = std::make_unique<ClientRing>();
+        }
+    }
+
+    ~BatonIOUring() {
+        invariant(!_opCtx);
+        invariant(_sessions.empty());
+        invariant(_scheduled.empty());
+        invariant(_timers.empty());
+    }
+
+    void markKillOnClientDisconnect() noexcept override {
+        if (_opCtx->getClient() && _opCtx->getClient()->session()) {
+            addSessionImpl(*(_opCtx->getClient()->session()), POLLRDHUP).getAsync([this](Status s) {
+                if (!s.isOK()) {
+                    return;
+                }
+
+                _opCtx->markKilled(ErrorCodes::ClientDisconnect);
+            });
+        }
+    }
+
+    Future<void> addSession(Session& session, Type type) noexcept override {
+        return addSessionImpl(session, type == Type::In ? POLLIN : POLLOUT);
+    }
+
+    Future<void> waitUntil(const ReactorTimer& timer, Date_t expiration) noexcept override try {
+        auto pf = makePromiseFuture<void>();
+        auto id = timer.id();
+
+        stdx::unique_lock lk(_mutex);
+
+        _safeExecute(std::move(lk), [ expiration, timer = Timer{id, std::move(pf.promise)},
+                                      this ](stdx::unique_lock<Mutex>) mutable noexcept {
+            auto iter = _timers.emplace(expiration, std::move(timer));
+            _timersById[iter->second.id] = iter;
+        });
+
+        return std::move(pf.future);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+
+    bool canWait() noexcept override {
+        stdx::lock_guard lk(_mutex);
+        return _opCtx;
+    }
+
+    bool cancelSession(Session& session) noexcept override {
+        const auto id = session.id();
+
+        stdx::unique_lock lk(_mutex);
+
+        if (_sessions.find(id) == _sessions.end()) {
+            return false;
+        }
+
+        _safeExecute(std::move(lk), [ id, this ](stdx::unique_lock<Mutex> lk) noexcept {
+            auto iter = _sessions.find(id);
+            if (iter == _sessions.end()) {
+                return;
+            }
+            auto session = std::exchange(iter->second, {});
+            _sessions.erase(iter);
+            _sessionsByToken.erase(session.token);
+            _removePoll(session.token);
+            lk.unlock();
+
+            session.promise.setError(kCanceled);
+        });
+
+        return true;
+    }
+
+    bool cancelTimer(const ReactorTimer& timer) noexcept override {
+        const auto id = timer.id();
+
+        stdx::unique_lock lk(_mutex);
+
+        if (_timersById.find(id) == _timersById.end()) {
+            return false;
+        }
+
+        _safeExecute(std::move(lk), [ id, this ](stdx::unique_lock<Mutex> lk) noexcept {
+            auto iter = _timersById.find(id);
+
+            if (iter == _timersById.end()) {
+                return;
+            }
+
+            auto timer = std::exchange(iter->second->second, {});
+            _timers.erase(iter->second);
+            _timersById.erase(iter);
+            lk.unlock();
+
+            timer.promise.setError(kCanceled);
+        });
+
+        return true;
+    }
+
+    void schedule(Task func) noexcept override {
+        stdx::unique_lock lk(_mutex);
+
+        if (!_opCtx) {
+            lk.unlock();
+            func(kDetached);
+
+            return;
+        }
+
+        _scheduled.push_back(
+            [ this, func = std::move(func) ](stdx::unique_lock<Mutex> lk) mutable noexcept {
+                auto status = Status::OK();
+                if (!_opCtx) {
+                    status = kDetached;
+                }
+                lk.unlock();
+
+                func(status);
+            });
+
+        if (_inPoll) {
+            _clientRing().notify();
+        }
+    }
+
+    void notify() noexcept override {
+        _clientRing().notify();
+    }
+
+    /**
+     * We synthesize a run_until by creating a synthetic timer which we use to exit run early (we
+     * create a regular waitUntil baton event off the timer, with the passed deadline).
+     */
+    Waitable::TimeoutState run_until(ClockSource* clkSource, Date_t deadline) noexcept override {
+        InternalReactorTimer irt;
+        auto future = waitUntil(irt, deadline);
+
+        run(clkSource);
+
+        // If the future is ready our timer has fired, in which case we timed out
+        if (future.isReady()) {
+            future.get();
+
+            return Waitable::TimeoutState::Timeout;
+        } else {
+            cancelTimer(irt);
+
+            return Waitable::TimeoutState::NoTimeout;
+        }
+    }
+
+    void run(ClockSource* clkSource) noexcept override {
+        std::vector<Promise<void>> toFulfill;
+
+        // We'll fulfill promises and run jobs on the way out, ensuring we don't hold any locks
+        const auto guard = makeGuard([&] {
+            for (auto& promise : toFulfill) {
+                promise.emplaceValue();
+            }
+
+            auto lk = stdx::unique_lock(_mutex);
+            while (_scheduled.size()) {
+                auto scheduled = std::exchange(_scheduled, {});
+                for (auto& job : scheduled) {
+                    job(std::move(lk));
+                    job = nullptr;
+
+                    lk = stdx::unique_lock(_mutex);
+                }
+            }
+        });
+
+        stdx::unique_lock lk(_mutex);
+
+        // If anything was scheduled, run it now.  No need to wait on the ring
+        if (_scheduled.size()) {
+            return;
+        }
+
+        boost::optional<Date_t> deadline;
+
+        // If we have a timer, wait no longer than that
+        if (_timers.size()) {
+            deadline = _timers.begin()->first;
+        }
+
+        auto& clientRing = _clientRing();
+        if (!clientRing.efdArmed) {
+            auto sqe = _getSqe();
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = clientRing.efd;
+            sqe->poll32_events = POLLIN;
+            sqe->user_data = kWakeupToken;
+            clientRing.efdArmed = true;
+        }
+
+        auto now = clkSource->now();
+
+        // If we don't have a timeout, or we have a timeout that's unexpired, wait on the ring.
+        // Otherwise only submit the polls prepared since the last wait.
+        if (!deadline || (*deadline > now)) {
+            if (deadline && !clkSource->tracksSystemClock()) {
+                invariant(clkSource->setAlarm(*deadline,
+                                              [this, anchor = shared_from_this()] { notify(); }));
+
+                deadline.reset();
+            }
+
+            _inPoll = true;
+            lk.unlock();
+            auto status = clientRing.ring.submitAndWait(
+                deadline ? boost::make_optional(Milliseconds(*deadline - now)) : boost::none);
+            lk.lock();
+            _inPoll = false;
+
+            if (!status.isOK()) {
+                LOGV2_FATAL(4917900,
+                            "error waiting on io_uring: {error}",
+                            "error waiting on io_uring",
+                            "error"_attr = status);
+            }
+        } else {
+            invariant(clientRing.ring.submit());
+        }
+
+        now = clkSource->now();
+
+        // Fire expired timers
+        for (auto iter = _timers.begin(); iter != _timers.end() && iter->first <= now;) {
+            toFulfill.push_back(std::move(iter->second.promise));
+            _timersById.erase(iter->second.id);
+            iter = _timers.erase(iter);
+        }
+
+        // Errors polling a session are left for the operation on the session to run into.
+        clientRing.ring.reapCompletions([&](const io_uring_cqe& cqe) {
+            if (cqe.user_data == kWakeupToken) {
+                clientRing.drain();
+                clientRing.efdArmed = false;
+                return;
+            }
+
+            auto tokenIter = _sessionsByToken.find(cqe.user_data);
+            if (tokenIter == _sessionsByToken.end()) {
+                // A removed poll, or a request removing one.
+                return;
+            }
+
+            auto sessionIter = _sessions.find(tokenIter->second);
+            toFulfill.push_back(std::move(sessionIter->second.promise));
+            _sessions.erase(sessionIter);
+            _sessionsByToken.erase(tokenIter);
+        });
+    }
+
+private:
+    Future<void> addSessionImpl(Session& session, short type) noexcept try {
+        auto fd = _getNativeHandle(session);
+        auto id = session.id();
+        auto pf = makePromiseFuture<void>();
+
+        stdx::unique_lock lk(_mutex);
+
+        _safeExecute(std::move(lk),
+                     [ id, fd, type, promise = std::move(pf.promise),
+                       this ](stdx::unique_lock<Mutex>) mutable noexcept {
+                         const auto token = _clientRing().nextToken++;
+
+                         auto sqe = _getSqe();
+                         sqe->opcode = IORING_OP_POLL_ADD;
+                         sqe->fd = fd;
+                         sqe->poll32_events = type;
+                         sqe->user_data = token;
+
+                         auto ret =
+                             _sessions.emplace(id, TransportSession{token, std::move(promise)});
+                         invariant(ret.second);
+                         _sessionsByToken[token] = id;
+                     });
+        return std::move(pf.future);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+
+    void detachImpl() noexcept override {
+        decltype(_scheduled) scheduled;
+        decltype(_sessions) sessions;
+        decltype(_timers) timers;
+
+        {
+            stdx::lock_guard lk(_mutex);
+
+            // Nothing else may wait on the polls of this baton, the ring outlives it.
+            for (auto& session : _sessions) {
+                _removePoll(session.second.token);
+            }
+            if (!_sessions.empty()) {
+                invariant(_clientRing().ring.submit());
+            }
+            _sessionsByToken.clear();
+
+            invariant(_opCtx->getBaton().get() == this);
+            _opCtx->setBaton(nullptr);
+
+            _opCtx = nullptr;
+
+            using std::swap;
+            swap(_scheduled, scheduled);
+            swap(_sessions, sessions);
+            swap(_timers, timers);
+        }
+
+        for (auto& job : scheduled) {
+            job(stdx::unique_lock(_mutex));
+            job = nullptr;
+        }
+
+        for (auto& session : sessions) {
+            session.second.promise.setError(kDetached);
+        }
+
+        for (auto& pair : timers) {
+            pair.second.promise.setError(kDetached);
+        }
+    }
+
+    static int _getNativeHandle(Session& session) {
+        if (auto ioUringSession = dynamic_cast<IOUringSession*>(&session)) {
+            return ioUringSession->fd();
+        }
+        // Egress sessions belong to the ASIO transport layer.
+        return TransportLayerASIO::getNativeHandle(session);
+    }
+
+    /**
+     * Prepares the removal of the poll identified by 'token'. Must be called with exclusive access
+     * to the Baton internals.
+     */
+    void _removePoll(uint64_t token) {
+        auto sqe = _getSqe();
+        sqe->opcode = IORING_OP_POLL_REMOVE;
+        sqe->fd = -1;
+        sqe->addr = token;
+        sqe->user_data = kRemovePollToken;
+    }
+
+    io_uring_sqe* _getSqe() {
+        auto& ring = _clientRing().ring;
+        auto sqe = ring.getSqe();
+        if (!sqe) {
+            // Make room by submitting what was prepared so far.
+            invariant(ring.submit());
+            sqe = ring.getSqe();
+            invariant(sqe);
+        }
+        return sqe;
+    }
+
+    struct Timer {
+        size_t id;
+        Promise<void> promise;  // Needs to be mutable to move from it while in std::set.
+    };
+
+    struct TransportSession {
+        uint64_t token;
+        Promise<void> promise;
+    };
+
+    // Internally, the BatonIOUring thinks in terms of synchronized units of work, just like the
+    // BatonASIO. The ring is only ever accessed by such jobs and by the thread running the baton,
+    // which is why it needs no synchronization of its own.
+    using Job = unique_function<void(stdx::unique_lock<Mutex>)>;
+
+    /**
+     * Invoke a job with exclusive access to the Baton internals.
+     *
+     * If we are currently _inPoll, the polling thread owns the Baton and thus we tell it to wake up
+     * and run our job. If we are not _inPoll, take exclusive access and run our job on the local
+     * thread. Note that _safeExecute() will throw if the Baton has been detached.
+     */
+    TEMPLATE(typename Callback)
+    REQUIRES(std::is_nothrow_invocable_v<Callback, stdx::unique_lock<Mutex>>)
+    void _safeExecute(stdx::unique_lock<Mutex> lk, Callback&& job) {
+        if (!_opCtx) {
+            // If we're detached, no job can safely execute.
+            uassertStatusOK(kDetached);
+        }
+
+        if (_inPoll) {
+            _scheduled.push_back(std::forward<Callback>(job));
+
+            _clientRing().notify();
+        } else {
+            job(std::move(lk));
+        }
+    }
+
+    ClientRing& _clientRing() {
+        return *getClientRing(_opCtx->getClient());
+    }
+
+    Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "BatonIOUring::_mutex");
+
+    OperationContext* _opCtx;
+
+    bool _inPoll = false;
+
+    // The sessions with a poll armed, and the sessions by the token of their poll.
+    stdx::unordered_map<SessionId, TransportSession> _sessions;
+    stdx::unordered_map<uint64_t, SessionId> _sessionsByToken;
+
+    // The set is used to find the next timer which will fire.  The unordered_map looks up the
+    // timers so we can remove them in O(1)
+    std::multimap<Date_t, Timer> _timers;
+    stdx::unordered_map<size_t, decltype(_timers)::iterator> _timersById;
+
+    // For tasks that come in via schedule.  Or that were deferred because we were in poll
+    std::vector<Job> _scheduled;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,241 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/io_uring.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "mongo/util/assert_util.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+int sysIOUringSetup(unsigned entries, io_uring_params* params) {
+    return ::syscall(__NR_io_uring_setup, entries, params);
+}
+
+int sysIOUringEnter(
+    int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, void* arg, size_t argSize) {
+    return ::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize);
+}
+
+int sysIOUringRegister(int fd, unsigned opcode, const void* arg, unsigned nrArgs) {
+    return ::syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs);
+}
+
+Status checkIOUringSupported() {
+    io_uring_params params{};
+    int fd = sysIOUringSetup(4, &params);
+    if (fd < 0) {
+        return {ErrorCodes::OperationFailed,
+                str::stream() << "io_uring is not available: " << errnoWithDescription(errno)};
+    }
+    ON_BLOCK_EXIT([&] { ::close(fd); });
+
+    // Waiting with a timeout without a timeout request needs IORING_FEAT_EXT_ARG (Linux 5.11).
+    constexpr auto kRequiredFeatures =
+        IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if ((params.features & kRequiredFeatures) != kRequiredFeatures) {
+        return {ErrorCodes::OperationFailed,
+                "io_uring is missing required features, Linux 5.11 or newer is needed"};
+    }
+
+    constexpr auto kNumOps = 64;
+    std::vector<char> probeBuffer(sizeof(io_uring_probe) + kNumOps * sizeof(io_uring_probe_op));
+    auto probe = reinterpret_cast<io_uring_probe*>(probeBuffer.data());
+    if (sysIOUringRegister(fd, IORING_REGISTER_PROBE, probe, kNumOps) < 0) {
+        return {ErrorCodes::OperationFailed,
+                str::stream() << "Failed to probe io_uring operations: "
+                              << errnoWithDescription(errno)};
+    }
+    for (auto op : {IORING_OP_ACCEPT,
+                    IORING_OP_RECV,
+                    IORING_OP_SEND,
+                    IORING_OP_READ_FIXED,
+                    IORING_OP_LINK_TIMEOUT,
+                    IORING_OP_POLL_ADD,
+                    IORING_OP_POLL_REMOVE}) {
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+            return {ErrorCodes::OperationFailed,
+                    str::stream() << "io_uring does not support operation " << int(op)};
+        }
+    }
+    return Status::OK();
+}
+
+}  // namespace
+
+Status IOUring::checkSupported() {
+    static const Status supported = checkIOUringSupported();
+    return supported;
+}
+
+IOUring::IOUring(unsigned entries) {
+    _fd = sysIOUringSetup(entries, &_params);
+    if (_fd < 0) {
+        auto savedErrno = errno;
+        uasserted((savedErrno == EMFILE || savedErrno == ENFILE) ? ErrorCodes::TooManyFilesOpen
+                                                                 : ErrorCodes::OperationFailed,
+                  str::stream() << "Failed to set up io_uring: "
+                                << errnoWithDescription(savedErrno));
+    }
+    auto cleanup = makeGuard([&] { this->~IOUring(); });
+
+    auto mapRing = [&](size_t size, off_t offset) {
+        auto ptr = ::mmap(
+            nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, offset);
+        uassert(ErrorCodes::OperationFailed,
+                str::stream() << "Failed to map io_uring: " << errnoWithDescription(errno),
+                ptr != MAP_FAILED);
+        return ptr;
+    };
+
+    // checkSupported() guarantees that both rings share a single mapping.
+    invariant(_params.features & IORING_FEAT_SINGLE_MMAP);
+    _sqRingSize = std::max(_params.sq_off.array + _params.sq_entries * sizeof(unsigned),
+                           _params.cq_off.cqes + _params.cq_entries * sizeof(io_uring_cqe));
+    _sqRing = mapRing(_sqRingSize, IORING_OFF_SQ_RING);
+    _cqRing = _sqRing;
+    _sqesSize = _params.sq_entries * sizeof(io_uring_sqe);
+    _sqes = static_cast<io_uring_sqe*>(mapRing(_sqesSize, IORING_OFF_SQES));
+
+    auto sq = static_cast<char*>(_sqRing);
+    _sqHead = reinterpret_cast<unsigned*>(sq + _params.sq_off.head);
+    _sqTail = reinterpret_cast<unsigned*>(sq + _params.sq_off.tail);
+    _sqMask = reinterpret_cast<unsigned*>(sq + _params.sq_off.ring_mask);
+    _sqEntries = reinterpret_cast<unsigned*>(sq + _params.sq_off.ring_entries);
+    _sqArray = reinterpret_cast<unsigned*>(sq + _params.sq_off.array);
+
+    auto cq = static_cast<char*>(_cqRing);
+    _cqHead = reinterpret_cast<unsigned*>(cq + _params.cq_off.head);
+    _cqTail = reinterpret_cast<unsigned*>(cq + _params.cq_off.tail);
+    _cqMask = reinterpret_cast<unsigned*>(cq + _params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cq + _params.cq_off.cqes);
+
+    _sqeTail = *_sqTail;
+    cleanup.dismiss();
+}
+
+IOUring::~IOUring() {
+    if (_sqes) {
+        ::munmap(_sqes, _sqesSize);
+        _sqes = nullptr;
+    }
+    if (_sqRing) {
+        ::munmap(_sqRing, _sqRingSize);
+        _sqRing = _cqRing = nullptr;
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+io_uring_sqe* IOUring::getSqe() {
+    const auto head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+    if (_sqeTail - head >= *_sqEntries) {
+        return nullptr;
+    }
+
+    const auto index = _sqeTail & *_sqMask;
+    _sqArray[index] = index;
+    ++_sqeTail;
+
+    auto sqe = &_sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+Status IOUring::submit() {
+    return _enter(0, boost::none);
+}
+
+Status IOUring::submitAndWait(boost::optional<Milliseconds> timeout) {
+    return _enter(1, timeout);
+}
+
+Status IOUring::registerBuffers(const iovec* buffers, unsigned count) {
+    if (sysIOUringRegister(_fd, IORING_REGISTER_BUFFERS, buffers, count) < 0) {
+        return {ErrorCodes::OperationFailed,
+                str::stream() << "Failed to register io_uring buffers: "
+                              << errnoWithDescription(errno)};
+    }
+    return Status::OK();
+}
+
+Status IOUring::_enter(unsigned waitNr, boost::optional<Milliseconds> timeout) {
+    // Publish the prepared entries. Entries the kernel did not consume on an earlier call are
+    // still counted, so they get submitted this time.
+    __atomic_store_n(_sqTail, _sqeTail, __ATOMIC_RELEASE);
+    const auto toSubmit = _sqeTail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+    if (toSubmit == 0 && waitNr == 0) {
+        return Status::OK();
+    }
+
+    unsigned flags = waitNr ? IORING_ENTER_GETEVENTS : 0;
+    __kernel_timespec ts{};
+    io_uring_getevents_arg arg{};
+    void* argPtr = nullptr;
+    size_t argSize = 0;
+    if (waitNr && timeout) {
+        const auto millis = std::max(timeout->count(), Milliseconds::rep(0));
+        ts.tv_sec = millis / 1000;
+        ts.tv_nsec = (millis % 1000) * 1000 * 1000;
+        arg.ts = reinterpret_cast<uint64_t>(&ts);
+        flags |= IORING_ENTER_EXT_ARG;
+        argPtr = &arg;
+        argSize = sizeof(arg);
+    }
+
+    if (sysIOUringEnter(_fd, toSubmit, waitNr, flags, argPtr, argSize) < 0) {
+        auto savedErrno = errno;
+        // Timing out, getting interrupted and needing to reap completions before submitting more
+        // all leave the caller to look at the completions and try again.
+        if (savedErrno == ETIME || savedErrno == EINTR || savedErrno == EAGAIN ||
+            savedErrno == EBUSY) {
+            return Status::OK();
+        }
+        return {ErrorCodes::OperationFailed,
+                str::stream() << "io_uring_enter failed: " << errnoWithDescription(savedErrno)};
+    }
+    return Status::OK();
+}
+
+}  // namespace transport
+}  // namespace mongo
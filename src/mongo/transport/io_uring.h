@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+#include "mongo/base/status.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * A minimal wrapper around a Linux io_uring instance, built directly on the io_uring system calls.
+ *
+ * The submission queue entries handed out by getSqe() only reach the kernel on the next call to
+ * submit() or submitAndWait(), so that all the operations prepared in between are submitted with a
+ * single system call. An IOUring is not thread safe: it must only be used by one thread at a time.
+ */
+class IOUring {
+    IOUring(const IOUring&) = delete;
+    IOUring& operator=(const IOUring&) = delete;
+
+public:
+    /**
+     * Returns OK if the running kernel supports io_uring with every feature and operation that the
+     * io_uring transport layer relies on (Linux 5.11 or newer), or why not otherwise.
+     */
+    static Status checkSupported();
+
+    /**
+     * Sets up a ring with at least 'entries' submission queue entries. Throws if the kernel refuses
+     * to create the ring.
+     */
+    explicit IOUring(unsigned entries);
+
+    ~IOUring();
+
+    /**
+     * Returns a zeroed submission queue entry for the caller to prepare, or nullptr if the
+     * submission queue is full of entries that were not submitted yet.
+     */
+    io_uring_sqe* getSqe();
+
+    /**
+     * Submits the prepared entries to the kernel without waiting for any of them to complete.
+     */
+    Status submit();
+
+    /**
+     * Submits the prepared entries and waits until at least one completion is available, 'timeout'
+     * elapses, or the wait is interrupted by a signal.
+     */
+    Status submitAndWait(boost::optional<Milliseconds> timeout = boost::none);
+
+    /**
+     * Invokes 'callback' with each available completion queue entry, in order of completion, and
+     * consumes them. Returns the number of entries consumed.
+     */
+    template <typename Callback>
+    size_t reapCompletions(Callback&& callback) {
+        auto head = *_cqHead;
+        const auto tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+        size_t count = 0;
+        for (; head != tail; ++head, ++count) {
+            // Copy the entry out first, as the callback may submit more work to the ring.
+            const io_uring_cqe cqe = _cqes[head & *_cqMask];
+            __atomic_store_n(_cqHead, head + 1, __ATOMIC_RELEASE);
+            callback(cqe);
+        }
+        return count;
+    }
+
+    /**
+     * Registers 'count' buffers with the ring, for use by IORING_OP_READ_FIXED operations which
+     * select them by their index in 'buffers'.
+     */
+    Status registerBuffers(const iovec* buffers, unsigned count);
+
+private:
+    Status _enter(unsigned waitNr, boost::optional<Milliseconds> timeout);
+
+    int _fd = -1;
+    io_uring_params _params{};
+
+    void* _sqRing = nullptr;
+    size_t _sqRingSize = 0;
+    void* _cqRing = nullptr;
+    size_t _cqRingSize = 0;
+    io_uring_sqe* _sqes = nullptr;
+    size_t _sqesSize = 0;
+
+    unsigned* _sqHead = nullptr;
+    unsigned* _sqTail = nullptr;
+    unsigned* _sqMask = nullptr;
+    unsigned* _sqEntries = nullptr;
+    unsigned* _sqArray = nullptr;
+    unsigned* _cqHead = nullptr;
+    unsigned* _cqTail = nullptr;
+    unsigned* _cqMask = nullptr;
+    io_uring_cqe* _cqes = nullptr;
+
+    // The tail of the submission queue including the entries prepared but not yet submitted.
+    unsigned _sqeTail = 0;
+};
+
+}  // namespace transport
+}  // namespace mongo
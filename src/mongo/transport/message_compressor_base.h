@@ -42,6 +42,7 @@ enum class MessageCompressor : uint8_t {
     kSnappy = 1,
     kZlib = 2,
     kZstd = 3,
+    kZstdDict = 4,
     kExtended = 255,
 };
 
@@ -56,7 +57,8 @@ public:
     virtual ~MessageCompressorBase() = default;
 
     /*
-     * Returns the name for subclass compressors (e.g. "snappy", "zlib", "zstd" or "noop")
+     * Returns the name for subclass compressors (e.g. "snappy", "zlib", "zstd", "zstdDict" or
+     * "noop")
      */
     const std::string& getName() const {
         return _name;
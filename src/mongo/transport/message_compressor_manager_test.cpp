@@ -43,6 +43,7 @@
 #include "mongo/transport/message_compressor_snappy.h"
 #include "mongo/transport/message_compressor_zlib.h"
 #include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/transport/message_compressor_zstd_dict.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -240,6 +241,11 @@ TEST(ZstdMessageCompressor, Fidelity) {
     checkFidelity(testMessage, std::make_unique<ZstdMessageCompressor>());
 }
 
+TEST(ZstdDictMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, std::make_unique<ZstdDictMessageCompressor>());
+}
+
 TEST(SnappyMessageCompressor, Overflow) {
     checkOverflow(std::make_unique<SnappyMessageCompressor>());
 }
@@ -252,6 +258,42 @@ TEST(ZstdMessageCompressor, Overflow) {
     checkOverflow(std::make_unique<ZstdMessageCompressor>());
 }
 
+TEST(ZstdDictMessageCompressor, Overflow) {
+    checkOverflow(std::make_unique<ZstdDictMessageCompressor>());
+}
+
+TEST(ZstdDictMessageCompressor, SmallRepliesCompressBetterThanZstd) {
+    // A typical small reply consists mostly of field names that repeat across messages but not
+    // within the message itself.
+    const auto batch = BSON_ARRAY(BSON("_id" << 1 << "x" << 2));
+    const auto reply = BSON("cursor" << BSON("firstBatch" << batch << "id" << 0LL << "ns"
+                                                          << "test.coll")
+                                     << "ok" << 1.0 << "$clusterTime"
+                                     << BSON("clusterTime" << Timestamp(1, 1)) << "operationTime"
+                                     << Timestamp(1, 1));
+    ConstDataRange input(reply.objdata(), reply.objsize());
+
+    auto compressedSize = [&](MessageCompressorBase* compressor) {
+        std::vector<char> buffer(compressor->getMaxCompressedSize(input.length()));
+        auto sws = compressor->compressData(input, DataRange(buffer.data(), buffer.size()));
+        ASSERT_OK(sws);
+
+        std::vector<char> roundTrip(input.length());
+        auto swd = compressor->decompressData(ConstDataRange(buffer.data(), sws.getValue()),
+                                              DataRange(roundTrip.data(), roundTrip.size()));
+        ASSERT_OK(swd);
+        ASSERT_EQ(swd.getValue(), input.length());
+        ASSERT_EQ(memcmp(roundTrip.data(), input.data(), input.length()), 0);
+        return sws.getValue();
+    };
+
+    ZstdMessageCompressor zstd;
+    ZstdDictMessageCompressor zstdDict;
+    ASSERT_LT(compressedSize(&zstdDict), compressedSize(&zstd));
+    ASSERT_EQ(zstdDict.getCompressorBytesIn(), input.length());
+    ASSERT_EQ(zstdDict.getDecompressorBytesOut(), input.length());
+}
+
 TEST(MessageCompressorManager, SERVER_28008) {
 
     // Create a client and server that will negotiate the same compressors,
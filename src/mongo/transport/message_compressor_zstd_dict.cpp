@@ -0,0 +1,284 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_zstd_dict.h"
+
+#include <zstd.h>
+
+#include "mongo/base/init.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Takes a context out of 'pool', or creates one with 'create' if the pool is empty.
+ */
+template <typename Context>
+Context* checkOutContext(Mutex& mutex, std::vector<Context*>& pool, Context* (*create)()) {
+    {
+        stdx::lock_guard<Latch> lk(mutex);
+        if (!pool.empty()) {
+            auto context = pool.back();
+            pool.pop_back();
+            return context;
+        }
+    }
+
+    auto context = create();
+    invariant(context);
+    return context;
+}
+
+/**
+ * Returns 'context' to 'pool', or frees it with 'free' if the pool already holds 'maxPooled'.
+ */
+template <typename Context>
+void checkInContext(Mutex& mutex,
+                    std::vector<Context*>& pool,
+                    size_t maxPooled,
+                    Context* context,
+                    size_t (*free)(Context*)) {
+    {
+        stdx::lock_guard<Latch> lk(mutex);
+        if (pool.size() < maxPooled) {
+            pool.push_back(context);
+            return;
+        }
+    }
+
+    free(context);
+}
+
+/**
+ * Builds the raw content dictionary out of representative commands and replies. zstd finds
+ * matches closer to the end of the dictionary more cheaply, so the metadata that is attached to
+ * nearly every message comes last.
+ *
+ * Everything here is part of the wire format of the "zstdDict" compressor and must never change.
+ */
+std::string buildDictionary() {
+    const char zeroUUID[16] = {};
+    const char zeroHash[20] = {};
+    const auto lsid = BSON("id" << BSONBinData(zeroUUID, sizeof(zeroUUID), newUUID));
+    const auto signature =
+        BSON("hash" << BSONBinData(zeroHash, sizeof(zeroHash), BinDataGeneral) << "keyId" << 0LL);
+    const auto clusterTime = BSON("clusterTime" << Timestamp() << "signature" << signature);
+    const auto opTime = BSON("ts" << Timestamp() << "t" << 1LL);
+
+    std::vector<BSONObj> samples;
+
+    // Handshake.
+    samples.push_back(BSON(
+        "ismaster" << true << "topologyVersion"
+                   << BSON("processId" << OID() << "counter" << 0LL) << "hosts"
+                   << BSON_ARRAY("localhost:27017") << "setName"
+                   << "rs0"
+                   << "setVersion" << 1 << "secondary" << false << "primary"
+                   << "localhost:27017"
+                   << "me"
+                   << "localhost:27017"
+                   << "electionId" << OID() << "lastWrite"
+                   << BSON("opTime" << opTime << "lastWriteDate" << Date_t() << "majorityOpTime"
+                                    << opTime << "majorityWriteDate" << Date_t())
+                   << "maxBsonObjectSize" << 16777216 << "maxMessageSizeBytes" << 48000000
+                   << "maxWriteBatchSize" << 100000 << "localTime" << Date_t()
+                   << "logicalSessionTimeoutMinutes" << 30 << "connectionId" << 1
+                   << "minWireVersion" << 0 << "maxWireVersion" << 9 << "readOnly" << false));
+
+    // Writes and their replies.
+    samples.push_back(BSON("insert"
+                           << "collection"
+                           << "documents" << BSON_ARRAY(BSON("_id" << OID())) << "ordered" << true
+                           << "writeConcern"
+                           << BSON("w"
+                                   << "majority"
+                                   << "wtimeout" << 0 << "j" << true)));
+    samples.push_back(BSON("update"
+                           << "collection"
+                           << "updates"
+                           << BSON_ARRAY(BSON("q" << BSON("_id" << OID()) << "u"
+                                                  << BSON("$set" << BSONObj()) << "upsert" << false
+                                                  << "multi" << false))
+                           << "ordered" << true));
+    samples.push_back(BSON("delete"
+                           << "collection"
+                           << "deletes" << BSON_ARRAY(BSON("q" << BSONObj() << "limit" << 1))));
+    samples.push_back(BSON("n" << 1 << "nModified" << 1 << "upserted"
+                               << BSON_ARRAY(BSON("index" << 0 << "_id" << OID())) << "writeErrors"
+                               << BSON_ARRAY(BSON("index" << 0 << "code" << 11000 << "errmsg"
+                                                          << "E11000 duplicate key error"))));
+
+    // Reads and their replies.
+    samples.push_back(BSON("aggregate"
+                           << "collection"
+                           << "pipeline"
+                           << BSON_ARRAY(BSON("$match" << BSONObj())
+                                         << BSON("$group" << BSON("_id"
+                                                                  << "$field"
+                                                                  << "count" << BSON("$sum" << 1)))
+                                         << BSON("$project" << BSONObj()))
+                           << "cursor" << BSON("batchSize" << 101) << "allowDiskUse" << false));
+    samples.push_back(BSON("find"
+                           << "collection"
+                           << "filter" << BSONObj() << "projection" << BSONObj() << "sort"
+                           << BSON("_id" << 1) << "limit" << 1 << "batchSize" << 101
+                           << "singleBatch" << false << "maxTimeMS" << 1000 << "readConcern"
+                           << BSON("level"
+                                   << "majority"
+                                   << "afterClusterTime" << Timestamp())
+                           << "$readPreference"
+                           << BSON("mode"
+                                   << "secondaryPreferred")));
+    samples.push_back(BSON("getMore" << 0LL << "collection"
+                                     << "collection"
+                                     << "batchSize" << 101));
+    samples.push_back(BSON("cursor" << BSON("nextBatch" << BSONArray() << "id" << 0LL << "ns"
+                                                        << "db.collection")));
+    samples.push_back(BSON("cursor" << BSON("firstBatch" << BSONArray() << "id" << 0LL << "ns"
+                                                         << "db.collection"
+                                                         << "postBatchResumeToken"
+                                                         << BSONObj())));
+
+    // Errors.
+    samples.push_back(BSON("ok" << 0.0 << "errmsg"
+                                << "error"
+                                << "code" << 0 << "codeName"
+                                << "Error"
+                                << "errorLabels" << BSON_ARRAY("TransientTransactionError")));
+
+    // Metadata attached to nearly every request and reply.
+    samples.push_back(BSON("lsid" << lsid << "txnNumber" << 1LL << "autocommit" << false
+                                  << "startTransaction" << true << "$db"
+                                  << "admin"));
+    samples.push_back(BSON("$gleStats" << BSON("lastOpTime" << opTime << "electionId" << OID())
+                                       << "lastCommittedOpTime" << Timestamp()
+                                       << "$configServerState" << BSON("opTime" << opTime)));
+    samples.push_back(BSON("ok" << 1.0 << "$clusterTime" << clusterTime << "operationTime"
+                                << Timestamp()));
+
+    std::string dictionary;
+    for (auto&& sample : samples) {
+        dictionary.append(sample.objdata(), sample.objsize());
+    }
+    return dictionary;
+}
+
+}  // namespace
+
+const std::string& ZstdDictMessageCompressor::getDictionary() {
+    static const auto dictionary = buildDictionary();
+    return dictionary;
+}
+
+ZstdDictMessageCompressor::ZstdDictMessageCompressor()
+    : MessageCompressorBase(MessageCompressor::kZstdDict) {
+    const auto& dictionary = getDictionary();
+    _cdict = ZSTD_createCDict(dictionary.data(), dictionary.size(), ZSTD_CLEVEL_DEFAULT);
+    _ddict = ZSTD_createDDict(dictionary.data(), dictionary.size());
+    invariant(_cdict && _ddict);
+
+    _cctxPool.reserve(kMaxPooledContexts);
+    _dctxPool.reserve(kMaxPooledContexts);
+}
+
+ZstdDictMessageCompressor::~ZstdDictMessageCompressor() {
+    for (auto cctx : _cctxPool) {
+        ZSTD_freeCCtx(cctx);
+    }
+    for (auto dctx : _dctxPool) {
+        ZSTD_freeDCtx(dctx);
+    }
+    ZSTD_freeCDict(_cdict);
+    ZSTD_freeDDict(_ddict);
+}
+
+std::size_t ZstdDictMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize);
+}
+
+StatusWith<std::size_t> ZstdDictMessageCompressor::compressData(ConstDataRange input,
+                                                                DataRange output) {
+    auto cctx = checkOutContext(_contextsMutex, _cctxPool, &ZSTD_createCCtx);
+    ON_BLOCK_EXIT([&] {
+        checkInContext(_contextsMutex, _cctxPool, kMaxPooledContexts, cctx, &ZSTD_freeCCtx);
+    });
+
+    size_t ret = ZSTD_compress_usingCDict(cctx,
+                                          const_cast<char*>(output.data()),
+                                          output.length(),
+                                          input.data(),
+                                          input.length(),
+                                          _cdict);
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    }
+    counterHitCompress(input.length(), ret);
+    return {ret};
+}
+
+StatusWith<std::size_t> ZstdDictMessageCompressor::decompressData(ConstDataRange input,
+                                                                  DataRange output) {
+    auto dctx = checkOutContext(_contextsMutex, _dctxPool, &ZSTD_createDCtx);
+    ON_BLOCK_EXIT([&] {
+        checkInContext(_contextsMutex, _dctxPool, kMaxPooledContexts, dctx, &ZSTD_freeDCtx);
+    });
+
+    size_t ret = ZSTD_decompress_usingDDict(dctx,
+                                            const_cast<char*>(output.data()),
+                                            output.length(),
+                                            input.data(),
+                                            input.length(),
+                                            _ddict);
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not decompress message: " << ZSTD_getErrorName(ret)};
+    }
+
+    counterHitDecompress(input.length(), ret);
+    return {ret};
+}
+
+
+MONGO_INITIALIZER_GENERAL(ZstdDictMessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    auto& compressorRegistry = MessageCompressorRegistry::get();
+    compressorRegistry.registerImplementation(std::make_unique<ZstdDictMessageCompressor>());
+    return Status::OK();
+}
+}  // namespace mongo
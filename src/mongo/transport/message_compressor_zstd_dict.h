@@ -0,0 +1,87 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/platform/mutex.h"
+#include "mongo/transport/message_compressor_base.h"
+
+struct ZSTD_CCtx_s;
+struct ZSTD_CDict_s;
+struct ZSTD_DCtx_s;
+struct ZSTD_DDict_s;
+
+namespace mongo {
+
+/**
+ * A zstd message compressor that primes every message with a built-in dictionary of common wire
+ * protocol content (command names, reply field names, $clusterTime/lsid metadata, etc.).
+ *
+ * Each message is still compressed independently, so the compressor remains stateless across
+ * messages and safe to share between sessions, but small OP_MSG requests and replies, whose
+ * field names make up a large share of their bytes, compress much better than with plain "zstd".
+ *
+ * The dictionary is part of the wire format: both peers must use byte-for-byte the same
+ * dictionary, which is guaranteed by only ever negotiating this compressor by its name. Changing
+ * the dictionary requires registering it under a new compressor id and name.
+ */
+class ZstdDictMessageCompressor final : public MessageCompressorBase {
+public:
+    ZstdDictMessageCompressor();
+    ~ZstdDictMessageCompressor();
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override;
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+    /**
+     * Returns the raw content of the dictionary shared by all instances of this compressor.
+     */
+    static const std::string& getDictionary();
+
+private:
+    // Contexts are expensive to create and hold no state between messages. Up to this many of
+    // each kind are kept for reuse, and any beyond that are freed after their message.
+    static constexpr size_t kMaxPooledContexts = 16;
+
+    ZSTD_CDict_s* _cdict;
+    ZSTD_DDict_s* _ddict;
+
+    Mutex _contextsMutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0),
+                                            "ZstdDictMessageCompressor::_contextsMutex");
+    std::vector<ZSTD_CCtx_s*> _cctxPool;
+    std::vector<ZSTD_DCtx_s*> _dctxPool;
+};
+
+}  // namespace mongo
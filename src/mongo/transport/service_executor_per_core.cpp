@@ -0,0 +1,367 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_per_core.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "mongo/base/error_codes.h"
+#include "mongo/logv2/log.h"
+#include "mongo/transport/service_executor_gen.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+MONGO_FAIL_POINT_DEFINE(hangBeforeSchedulingServiceExecutorPerCoreTask);
+
+namespace transport {
+namespace {
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "perCore"_sd;
+constexpr auto kNumCores = "cores"_sd;
+constexpr auto kTasksStolen = "tasksStolen"_sd;
+constexpr auto kRunQueueDepth = "runQueueDepth"_sd;
+}  // namespace
+
+ServiceExecutorPerCore::ServiceExecutorPerCore(Options options) : _options(std::move(options)) {
+    auto numCores = _options.numCores;
+    if (numCores == 0) {
+        numCores = static_cast<size_t>(std::max(ProcessInfo::getNumAvailableCores(), 1UL));
+    }
+
+    _cores.reserve(numCores);
+    for (size_t i = 0; i < numCores; ++i) {
+        _cores.push_back(std::make_unique<Core>());
+    }
+
+#ifdef __linux__
+    // Spread the cores over the CPUs the process may run on, wrapping around if there are more
+    // cores than CPUs.
+    cpu_set_t allowed;
+    if (_options.pinThreadsToCpus && sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        std::vector<int> allowedCpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                allowedCpus.push_back(cpu);
+            }
+        }
+        for (size_t i = 0; i < numCores && !allowedCpus.empty(); ++i) {
+            _cpus.push_back(allowedCpus[i % allowedCpus.size()]);
+        }
+    }
+#endif
+}
+
+ServiceExecutorPerCore::~ServiceExecutorPerCore() {
+    invariant(!_canScheduleWork.load());
+    if (_state == State::kNotStarted)
+        return;
+
+    // Ensures we always call "shutdown" after staring the service executor
+    invariant(_state == State::kStopped);
+    for (auto& core : _cores) {
+        if (core->thread.joinable()) {
+            core->thread.join();
+        }
+    }
+    invariant(_numRunningExecutorThreads.load() == 0);
+}
+
+Status ServiceExecutorPerCore::start() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto oldState = std::exchange(_state, State::kRunning);
+    invariant(oldState == State::kNotStarted);
+    _canScheduleWork.store(true);
+
+    for (size_t i = 0; i < _cores.size(); ++i) {
+        _numRunningExecutorThreads.fetchAndAdd(1);
+        _cores[i]->thread = stdx::thread([this, i] { _runCore(i); });
+    }
+
+    LOGV2_DEBUG(4917500,
+                3,
+                "Started per-core service executor",
+                "name"_attr = _options.poolName,
+                "numCores"_attr = _cores.size());
+    return Status::OK();
+}
+
+Status ServiceExecutorPerCore::shutdown(Milliseconds timeout) {
+    LOGV2_DEBUG(
+        4917501, 3, "Shutting down per-core service executor", "name"_attr = _options.poolName);
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    _canScheduleWork.store(false);
+    if (std::exchange(_state, State::kStopped) == State::kRunning) {
+        for (auto& core : _cores) {
+            stdx::lock_guard<Latch> coreLk(core->mutex);
+            core->cv.notify_one();
+        }
+    }
+
+    bool success = _shutdownCondition.wait_for(lk, timeout.toSystemDuration(), [this] {
+        return _numRunningExecutorThreads.load() == 0;
+    });
+    return success ? Status::OK()
+                   : Status(ErrorCodes::ExceededTimeLimit,
+                            "Failed to shutdown all executor threads within the time limit");
+}
+
+Status ServiceExecutorPerCore::scheduleTask(Task task, ScheduleFlags flags) {
+    if (!_canScheduleWork.load()) {
+        return Status(ErrorCodes::ShutdownInProgress, "Executor is not running");
+    }
+
+    if (_localExecutor == this) {
+        if ((flags & ScheduleFlags::kMayRecurse) &&
+            _localRecursionDepth < perCoreServiceExecutorRecursionLimit.loadRelaxed()) {
+            // Recursively executing the task on the executor thread.
+            ++_localRecursionDepth;
+            task();
+            --_localRecursionDepth;
+            return Status::OK();
+        }
+
+        // Keep the task on the core that is currently running it.
+        return _enqueue(_localCoreId, std::move(task));
+    }
+
+    hangBeforeSchedulingServiceExecutorPerCoreTask.pauseWhileSet();
+
+    return _enqueue(_pickCoreForNewTask(), std::move(task));
+}
+
+void ServiceExecutorPerCore::appendStats(BSONObjBuilder* bob) const {
+    size_t runQueueDepth = 0;
+    for (auto& core : _cores) {
+        runQueueDepth += core->runQueueDepth.load();
+    }
+
+    *bob << kExecutorLabel << kExecutorName << kThreadsRunning
+         << static_cast<int>(_numRunningExecutorThreads.load()) << kNumCores
+         << static_cast<int>(_cores.size()) << kTasksStolen << _numTasksStolen.load()
+         << kRunQueueDepth << static_cast<long long>(runQueueDepth);
+}
+
+void ServiceExecutorPerCore::_runCore(size_t coreId) {
+    setThreadName(str::stream() << _options.poolName << "-" << coreId);
+    _pinToCpu(coreId);
+    _localExecutor = this;
+    _localCoreId = coreId;
+
+    auto& core = *_cores[coreId];
+    while (_canScheduleWork.load()) {
+        auto task = _popLocal(core);
+        if (!task) {
+            task = _steal(coreId);
+        }
+
+        if (!task) {
+            _waitForWork(core);
+            continue;
+        }
+
+        _localRecursionDepth = 1;
+        (*task)();
+    }
+
+    // Like the thread pool behind ServiceExecutorFixed, run the tasks that were queued on this
+    // core before shutdown rather than dropping them. "_enqueue" rejects new tasks from now on,
+    // so the run queue is drained once this loop returns.
+    while (auto task = _popLocal(core)) {
+        _localRecursionDepth = 1;
+        (*task)();
+    }
+
+    _localExecutor = nullptr;
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_numRunningExecutorThreads.subtractAndFetch(1) == 0) {
+        _shutdownCondition.notify_all();
+    }
+}
+
+void ServiceExecutorPerCore::_pinToCpu(size_t coreId) {
+#ifdef __linux__
+    if (_cpus.empty()) {
+        return;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(_cpus[coreId], &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        const auto error = errno;
+        LOGV2_WARNING(4918036,
+                      "Failed to bind a per-core service executor thread to its CPU",
+                      "name"_attr = _options.poolName,
+                      "core"_attr = coreId,
+                      "cpu"_attr = _cpus[coreId],
+                      "error"_attr = errnoWithDescription(error));
+    }
+#endif
+}
+
+Status ServiceExecutorPerCore::_enqueue(size_t coreId, Task task) {
+    auto& core = *_cores[coreId];
+    bool hasBacklog = false;
+    {
+        stdx::lock_guard<Latch> lk(core.mutex);
+        // Checking under the core's lock guarantees that "shutdown" has not yet woken this core
+        // up for the last time, so the task cannot be stranded in the run queue.
+        if (!_canScheduleWork.load()) {
+            return Status(ErrorCodes::ShutdownInProgress, "Executor is not running");
+        }
+
+        hasBacklog = !core.runQueue.empty();
+        core.runQueue.push_back(std::move(task));
+        core.runQueueDepth.store(core.runQueue.size());
+        if (core.idle.load()) {
+            core.cv.notify_one();
+            return Status::OK();
+        }
+    }
+
+    // The owning core is busy running another task and already had work queued behind it. Rather
+    // than waiting for the owner to drain its backlog, let an idle core steal some of it.
+    if (hasBacklog && _numIdleCores.load() > 0) {
+        _wakeIdleCore(coreId);
+    }
+    return Status::OK();
+}
+
+boost::optional<ServiceExecutor::Task> ServiceExecutorPerCore::_popLocal(Core& core) {
+    if (core.runQueueDepth.load() == 0) {
+        return boost::none;
+    }
+
+    stdx::lock_guard<Latch> lk(core.mutex);
+    if (core.runQueue.empty()) {
+        return boost::none;
+    }
+
+    auto task = std::move(core.runQueue.front());
+    core.runQueue.pop_front();
+    core.runQueueDepth.store(core.runQueue.size());
+    return std::move(task);
+}
+
+boost::optional<ServiceExecutor::Task> ServiceExecutorPerCore::_steal(size_t thiefId) {
+    const auto numCores = _cores.size();
+    for (size_t i = 1; i < numCores; ++i) {
+        auto& victim = *_cores[(thiefId + i) % numCores];
+        if (victim.runQueueDepth.load() == 0 || victim.idle.load()) {
+            // An idle victim is about to run its own tasks, so leave them where they are.
+            continue;
+        }
+
+        stdx::lock_guard<Latch> lk(victim.mutex);
+        if (victim.runQueue.empty()) {
+            continue;
+        }
+
+        // Take the most recently queued task, leaving the older ones to the victim, which is
+        // going to run them next.
+        auto task = std::move(victim.runQueue.back());
+        victim.runQueue.pop_back();
+        victim.runQueueDepth.store(victim.runQueue.size());
+        _numTasksStolen.fetchAndAdd(1);
+        return std::move(task);
+    }
+
+    return boost::none;
+}
+
+void ServiceExecutorPerCore::_waitForWork(Core& core) {
+    stdx::unique_lock<Latch> lk(core.mutex);
+    if (!core.runQueue.empty() || !_canScheduleWork.load()) {
+        return;
+    }
+
+    core.idle.store(true);
+    _numIdleCores.fetchAndAdd(1);
+
+    // Wake up periodically even if nobody asks us to, so that tasks stuck behind a long-running
+    // task on another core are eventually stolen.
+    const auto stealInterval =
+        Milliseconds(perCoreServiceExecutorStealIntervalMillis.loadRelaxed());
+    core.cv.wait_for(lk, stealInterval.toSystemDuration(), [&] {
+        return !core.runQueue.empty() || core.shouldSteal || !_canScheduleWork.load();
+    });
+
+    core.shouldSteal = false;
+    _numIdleCores.fetchAndSubtract(1);
+    core.idle.store(false);
+}
+
+void ServiceExecutorPerCore::_wakeIdleCore(size_t fromCoreId) {
+    const auto numCores = _cores.size();
+    for (size_t i = 1; i < numCores; ++i) {
+        auto& core = *_cores[(fromCoreId + i) % numCores];
+        if (!core.idle.load()) {
+            continue;
+        }
+
+        stdx::lock_guard<Latch> lk(core.mutex);
+        if (!core.idle.load()) {
+            continue;
+        }
+
+        core.shouldSteal = true;
+        core.cv.notify_one();
+        return;
+    }
+}
+
+size_t ServiceExecutorPerCore::_pickCoreForNewTask() {
+    // Pick the less loaded of two candidate cores, preferring idle ones.
+    const auto numCores = _cores.size();
+    const auto first = _nextCore.fetchAndAdd(1) % numCores;
+    const auto second = (first + 1) % numCores;
+
+    auto load = [&](size_t coreId) {
+        auto& core = *_cores[coreId];
+        return core.runQueueDepth.load() + (core.idle.load() ? 0 : 1);
+    };
+    return load(second) < load(first) ? second : first;
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/util/hierarchical_acquisition.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * A service executor that runs one worker thread per core, each of which owns a run queue.
+ *
+ * On Linux, each worker thread is bound to its own CPU among those the process may run on. Tasks
+ * scheduled from a worker thread are queued on that worker's own run queue, so a session stays on
+ * the CPU that last ran it and keeps its working set warm in that CPU's caches. Elsewhere, or when
+ * binding fails, a session only stays on the same thread. Tasks scheduled from outside the
+ * executor (e.g., the first task of a new session) are placed on the less loaded of two cores
+ * picked round-robin. A worker whose run queue is empty steals tasks from the run queues of other
+ * cores, and is woken up early to do so whenever a busy core builds up a backlog.
+ *
+ * Like ServiceExecutorFixed, this executor does not serve ingress sessions yet: their state
+ * machines read the next request synchronously on the thread running them, which would hold a
+ * core for as long as the client stays idle.
+ */
+class ServiceExecutorPerCore final : public ServiceExecutor {
+public:
+    struct Options {
+        // The number of run queues and worker threads. Zero creates one per available core.
+        size_t numCores = 0;
+
+        std::string poolName = "ServiceExecutorPerCore";
+
+        // Whether to bind each worker thread to one CPU. Only supported on Linux.
+        bool pinThreadsToCpus = true;
+    };
+
+    explicit ServiceExecutorPerCore(Options options);
+    ~ServiceExecutorPerCore();
+
+    Status start() override;
+    Status shutdown(Milliseconds timeout) override;
+    Status scheduleTask(Task task, ScheduleFlags flags) override;
+
+    Mode transportMode() const override {
+        return Mode::kSynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const override;
+
+    size_t numCores() const {
+        return _cores.size();
+    }
+
+private:
+    struct Core {
+        mutable Mutex mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0),
+                                               "ServiceExecutorPerCore::Core::mutex");
+        stdx::condition_variable cv;
+        std::deque<Task> runQueue;
+
+        // Set by another core to wake this (idle) core up so it looks for tasks to steal.
+        bool shouldSteal = false;
+
+        // Readable without holding "mutex" so that schedulers and thieves can pick a core cheaply.
+        AtomicWord<size_t> runQueueDepth{0};
+        AtomicWord<bool> idle{false};
+
+        stdx::thread thread;
+    };
+
+    void _runCore(size_t coreId);
+    void _pinToCpu(size_t coreId);
+
+    Status _enqueue(size_t coreId, Task task);
+    boost::optional<Task> _popLocal(Core& core);
+    boost::optional<Task> _steal(size_t thiefId);
+    void _waitForWork(Core& core);
+    void _wakeIdleCore(size_t fromCoreId);
+    size_t _pickCoreForNewTask();
+
+    AtomicWord<size_t> _numRunningExecutorThreads{0};
+    AtomicWord<size_t> _numIdleCores{0};
+    AtomicWord<size_t> _nextCore{0};
+    AtomicWord<long long> _numTasksStolen{0};
+    AtomicWord<bool> _canScheduleWork{false};
+
+    mutable Mutex _mutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1), "ServiceExecutorPerCore::_mutex");
+    stdx::condition_variable _shutdownCondition;
+
+    /**
+     * State transition diagram: kNotStarted ---> kRunning ---> kStopped
+     * The service executor cannot be in "kRunning" when its destructor is invoked.
+     */
+    enum State { kNotStarted, kRunning, kStopped } _state = kNotStarted;
+
+    Options _options;
+    std::vector<std::unique_ptr<Core>> _cores;
+
+    // The CPU the worker thread of each core is bound to, by core id. Empty if the worker threads
+    // are not bound to CPUs.
+    std::vector<int> _cpus;
+
+    static inline thread_local ServiceExecutorPerCore* _localExecutor = nullptr;
+    static inline thread_local size_t _localCoreId = 0;
+    static inline thread_local int _localRecursionDepth = 0;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -34,11 +34,16 @@
 #include "boost/optional.hpp"
 #include <algorithm>
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/service_context.h"
 #include "mongo/logv2/log.h"
 #include "mongo/transport/service_executor_fixed.h"
 #include "mongo/transport/service_executor_gen.h"
+#include "mongo/transport/service_executor_per_core.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/unittest/barrier.h"
@@ -48,6 +53,7 @@
 #include "mongo/util/fail_point.h"
 #include "mongo/util/future.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 #include <asio.hpp>
 
@@ -343,5 +349,235 @@ TEST_F(ServiceExecutorFixedFixture, ScheduleFailsAfterShutdown) {
     schedulerThread->join();
 }
 
+
+class ServiceExecutorPerCoreFixture : public unittest::Test {
+public:
+    static constexpr size_t kNumCores = 2;
+
+    void setUp() override {
+        ServiceExecutorPerCore::Options options;
+        options.numCores = kNumCores;
+        options.poolName = "Test";
+        _executor = std::make_shared<ServiceExecutorPerCore>(std::move(options));
+    }
+
+    void tearDown() override {
+        if (_skipShutdown)
+            return;
+        ASSERT_OK(_executor->shutdown(kShutdownTime));
+    }
+
+    void skipShutdown(bool skip) {
+        _skipShutdown = skip;
+    }
+
+    auto getServiceExecutor() const {
+        return _executor;
+    }
+
+    auto startAndGetServiceExecutor() {
+        ASSERT_OK(_executor->start());
+        return getServiceExecutor();
+    }
+
+private:
+    bool _skipShutdown = false;
+    std::shared_ptr<ServiceExecutorPerCore> _executor;
+};
+
+TEST_F(ServiceExecutorPerCoreFixture, ScheduleFailsBeforeStartup) {
+    auto executor = getServiceExecutor();
+    ASSERT_NOT_OK(executor->scheduleTask([] {}, ServiceExecutor::kEmptyFlags));
+}
+
+DEATH_TEST_F(ServiceExecutorPerCoreFixture, DestructorFailsBeforeShutdown, "invariant") {
+    startAndGetServiceExecutor();
+    skipShutdown(true);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, BasicTaskRuns) {
+    auto executor = startAndGetServiceExecutor();
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    ASSERT_OK(executor->scheduleTask([barrier]() mutable { barrier->countDownAndWait(); },
+                                     ServiceExecutor::kEmptyFlags));
+    barrier->countDownAndWait();
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, RecursiveTask) {
+    auto executor = startAndGetServiceExecutor();
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    AtomicWord<int> recursionDepth{0};
+
+    std::function<void()> recursiveTask;
+    recursiveTask = [&, barrier] {
+        recursionDepth.fetchAndAdd(1);
+        auto recursionGuard = makeGuard([&] { recursionDepth.fetchAndSubtract(1); });
+        if (recursionDepth.load() < perCoreServiceExecutorRecursionLimit.load()) {
+            ASSERT_OK(executor->scheduleTask(recursiveTask, ServiceExecutor::kMayRecurse));
+        } else {
+            // This test never returns unless the service executor can satisfy the recursion depth.
+            barrier->countDownAndWait();
+        }
+    };
+
+    // Schedule recursive task and wait for the recursion to stop
+    ASSERT_OK(executor->scheduleTask(recursiveTask, ServiceExecutor::kMayRecurse));
+    barrier->countDownAndWait();
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, TasksStayOnTheirCore) {
+    // Push the periodic steal scan of idle cores out past the end of the test.
+    const auto stealInterval = perCoreServiceExecutorStealIntervalMillis.load();
+    perCoreServiceExecutorStealIntervalMillis.store(60 * 60 * 1000);
+    ON_BLOCK_EXIT([&] { perCoreServiceExecutorStealIntervalMillis.store(stealInterval); });
+
+    auto executor = startAndGetServiceExecutor();
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    AtomicWord<int> tasksToSchedule{100};
+    stdx::thread::id firstThread;
+
+    // Each task reschedules the next one from the executor thread it runs on. The idle core is
+    // never asked to steal since there is no backlog, so every task must run on the same thread.
+    std::function<void()> task;
+    task = [&, barrier] {
+        if (firstThread == stdx::thread::id()) {
+            firstThread = stdx::this_thread::get_id();
+        }
+        ASSERT_EQ(firstThread, stdx::this_thread::get_id());
+
+        if (tasksToSchedule.fetchAndSubtract(1) > 0) {
+            ASSERT_OK(executor->scheduleTask(task, ServiceExecutor::kEmptyFlags));
+        } else {
+            barrier->countDownAndWait();
+        }
+    };
+
+    ASSERT_OK(executor->scheduleTask(task, ServiceExecutor::kEmptyFlags));
+    barrier->countDownAndWait();
+}
+
+#ifdef __linux__
+TEST_F(ServiceExecutorPerCoreFixture, WorkerThreadsAreBoundToOneCpu) {
+    auto executor = startAndGetServiceExecutor();
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    int numCpus = 0;
+    ASSERT_OK(executor->scheduleTask(
+        [&, barrier] {
+            cpu_set_t set;
+            if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+                numCpus = CPU_COUNT(&set);
+            }
+            barrier->countDownAndWait();
+        },
+        ServiceExecutor::kEmptyFlags));
+    barrier->countDownAndWait();
+    ASSERT_EQ(1, numCpus);
+}
+#endif
+
+TEST_F(ServiceExecutorPerCoreFixture, IdleCoreStealsFromBusyCore) {
+    auto executor = startAndGetServiceExecutor();
+    auto blockerRunning = std::make_shared<SharedPromise<void>>();
+    auto mayReturn = std::make_shared<SharedPromise<void>>();
+    auto stolenTaskRan = std::make_shared<SharedPromise<void>>();
+
+    // Block one core and, from that core, queue a task behind the blocker. The only way for the
+    // queued task to run before the blocker returns is for the other core to steal it.
+    ASSERT_OK(executor->scheduleTask(
+        [executor, blockerRunning, mayReturn, stolenTaskRan]() mutable {
+            ASSERT_OK(executor->scheduleTask([stolenTaskRan] { stolenTaskRan->emplaceValue(); },
+                                             ServiceExecutor::kEmptyFlags));
+            blockerRunning->emplaceValue();
+            mayReturn->getFuture().get();
+        },
+        ServiceExecutor::kEmptyFlags));
+
+    blockerRunning->getFuture().get();
+    stolenTaskRan->getFuture().get();
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    ASSERT_EQ(bob.obj().getField("tasksStolen").safeNumberLong(), 1);
+
+    mayReturn->emplaceValue();
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, ShutdownTimeLimit) {
+    auto executor = startAndGetServiceExecutor();
+    auto invoked = std::make_shared<SharedPromise<void>>();
+    auto mayReturn = std::make_shared<SharedPromise<void>>();
+
+    ASSERT_OK(executor->scheduleTask(
+        [executor, invoked, mayReturn]() mutable {
+            invoked->emplaceValue();
+            mayReturn->getFuture().get();
+        },
+        ServiceExecutor::kEmptyFlags));
+
+    invoked->getFuture().get();
+    ASSERT_NOT_OK(executor->shutdown(kShutdownTime));
+
+    // Ensure the service executor is stopped before leaving the test.
+    mayReturn->emplaceValue();
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, TasksQueuedBeforeShutdownRun) {
+    auto executor = startAndGetServiceExecutor();
+    auto blockerRunning = std::make_shared<SharedPromise<void>>();
+    auto mayReturn = std::make_shared<SharedPromise<void>>();
+    auto queuedTaskRan = std::make_shared<SharedPromise<void>>();
+
+    // Queue a task behind a blocker on the blocker's core, then begin shutting down. The queued
+    // task must still run once the blocker returns.
+    ASSERT_OK(executor->scheduleTask(
+        [executor, blockerRunning, mayReturn, queuedTaskRan]() mutable {
+            ASSERT_OK(executor->scheduleTask([queuedTaskRan] { queuedTaskRan->emplaceValue(); },
+                                             ServiceExecutor::kEmptyFlags));
+            blockerRunning->emplaceValue();
+            mayReturn->getFuture().get();
+        },
+        ServiceExecutor::kEmptyFlags));
+
+    blockerRunning->getFuture().get();
+    auto shutdownThread = stdx::thread([executor] { executor->shutdown(kShutdownTime).ignore(); });
+    while (executor->scheduleTask([] {}, ServiceExecutor::kEmptyFlags).isOK()) {
+        sleepmillis(1);
+    }
+    mayReturn->emplaceValue();
+    queuedTaskRan->getFuture().get();
+    shutdownThread.join();
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, Stats) {
+    auto executor = startAndGetServiceExecutor();
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    auto obj = bob.obj();
+    ASSERT_EQ(obj.getStringField("executor"), "perCore"_sd);
+    ASSERT_EQ(obj.getIntField("cores"), static_cast<int>(kNumCores));
+    ASSERT_EQ(obj.getIntField("threadsRunning"), static_cast<int>(kNumCores));
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, ScheduleFailsAfterShutdown) {
+    auto executor = startAndGetServiceExecutor();
+    std::unique_ptr<stdx::thread> schedulerThread;
+
+    {
+        // Spawn a thread to schedule a task, and block it before it can queue the task on a core.
+        // Then shutdown the service executor and unblock the scheduler thread. This order of
+        // events must cause "schedule()" to return a non-okay status.
+        FailPointEnableBlock failpoint("hangBeforeSchedulingServiceExecutorPerCoreTask");
+        schedulerThread = std::make_unique<stdx::thread>([executor] {
+            ASSERT_NOT_OK(
+                executor->scheduleTask([] { MONGO_UNREACHABLE; }, ServiceExecutor::kEmptyFlags));
+        });
+        failpoint->waitForTimesEntered(1);
+        ASSERT_OK(executor->shutdown(kShutdownTime));
+    }
+
+    schedulerThread->join();
+}
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,504 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "mongo/db/stats/counters.h"
+#include "mongo/rpc/message.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/transport/baton.h"
+#include "mongo/transport/io_uring.h"
+#include "mongo/transport/transport_layer_io_uring.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/net/socket_utils.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * A synchronous ingress session served through its own io_uring instance.
+ *
+ * Requests are received into a fixed size buffer which is registered with the ring, so the kernel
+ * does not have to map it on every receive. Whatever arrives past the end of a request (pipelined
+ * requests, typically) is kept for the next call to sourceMessage(). Requests too large for the
+ * buffer are received directly into their own message buffer.
+ *
+ * sinkMessage() only prepares the send of a reply: it is submitted along with the receive of the
+ * next request, saving a system call per round trip. Errors sending a reply are returned by the
+ * next sourceMessage() or sinkMessage() call.
+ */
+class TransportLayerIOUring::IOUringSession final : public Session {
+    IOUringSession(const IOUringSession&) = delete;
+    IOUringSession& operator=(const IOUringSession&) = delete;
+
+    // A send and a receive, each linked to a timeout, may be in flight at the same time.
+    static constexpr unsigned kRingEntries = 8;
+
+    enum Token : uint64_t { kRecv = 1, kRecvTimeout, kSend, kSendTimeout };
+
+    struct Operation {
+        // The number of completions still expected for the operation and its linked timeout.
+        int pending = 0;
+        int result = 0;
+        bool timedOut = false;
+        __kernel_timespec timeout{};
+    };
+
+public:
+    // Takes ownership of 'fd', an accepted socket, once constructed. Throws if the session can not
+    // be set up, in which case the caller keeps the ownership of 'fd'.
+    IOUringSession(TransportLayerIOUring* tl, int fd, size_t recvBufferBytes)
+        : _tl(tl),
+          _fd(fd),
+          _recvBuffer(new char[recvBufferBytes]),
+          _recvBufferSize(recvBufferBytes),
+          _ring(kRingEntries) {
+        sockaddr_storage addr;
+        socklen_t addrLen = sizeof(addr);
+        uassert(ErrorCodes::SocketException,
+                str::stream() << "getsockname failed: " << errnoWithDescription(errno),
+                ::getsockname(_fd, reinterpret_cast<sockaddr*>(&addr), &addrLen) == 0);
+        _localAddr = SockAddr(reinterpret_cast<sockaddr*>(&addr), addrLen);
+
+        addrLen = sizeof(addr);
+        uassert(ErrorCodes::SocketException,
+                str::stream() << "getpeername failed: " << errnoWithDescription(errno),
+                ::getpeername(_fd, reinterpret_cast<sockaddr*>(&addr), &addrLen) == 0);
+        _remoteAddr = SockAddr(reinterpret_cast<sockaddr*>(&addr), addrLen);
+
+        const auto family = _localAddr.getType();
+        if (family == AF_INET || family == AF_INET6) {
+            const int on = 1;
+            uassert(ErrorCodes::SocketException,
+                    str::stream() << "Failed to configure socket: " << errnoWithDescription(errno),
+                    ::setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)) == 0 &&
+                        ::setsockopt(_fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on)) == 0);
+            setSocketKeepAliveParams(_fd);
+        }
+
+        _local = HostAndPort(_localAddr.toString(true));
+        _remote = HostAndPort(_remoteAddr.toString(true));
+
+        // Registering the buffer pins its pages, which may exceed RLIMIT_MEMLOCK on older
+        // kernels. Plain receives into the same buffer work just as well, only a bit slower.
+        const iovec recvBuffer{_recvBuffer.get(), _recvBufferSize};
+        _recvBufferRegistered = _ring.registerBuffers(&recvBuffer, 1).isOK();
+    }
+
+    ~IOUringSession() {
+        // The kernel may still be reading from the last reply, and a deferred reply has not even
+        // been submitted yet: make sure it got out before closing the socket.
+        try {
+            _waitForSend().ignore();
+        } catch (const DBException&) {
+        }
+        end();
+        ::close(_fd);
+    }
+
+    TransportLayer* getTransportLayer() const override {
+        return _tl;
+    }
+
+    const HostAndPort& remote() const override {
+        return _remote;
+    }
+
+    const HostAndPort& local() const override {
+        return _local;
+    }
+
+    const SockAddr& remoteAddr() const override {
+        return _remoteAddr;
+    }
+
+    const SockAddr& localAddr() const override {
+        return _localAddr;
+    }
+
+    int fd() const {
+        return _fd;
+    }
+
+    void end() override {
+        // Wakes up any operation in flight on the socket, including from other threads.
+        if (::shutdown(_fd, SHUT_RDWR) != 0 && errno != ENOTCONN) {
+            LOGV2_ERROR(4917908,
+                        "Error shutting down socket: {error}",
+                        "Error shutting down socket",
+                        "error"_attr = errnoWithDescription(errno));
+        }
+    }
+
+    StatusWith<Message> sourceMessage() override try {
+        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+        uassertStatusOK(_fillRecvBuffer(kHeaderSize));
+        const auto msgLen =
+            size_t(MSGHEADER::ConstView(_recvBuffer.get() + _recvBegin).getMessageLength());
+        if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
+            StringBuilder sb;
+            sb << "recv(): message msgLen " << msgLen << " is invalid. "
+               << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
+            LOGV2(4917909,
+                  "recv(): message msgLen {msgLen} is invalid. Min: {min} Max: {max}",
+                  "recv(): message msgLen is invalid",
+                  "msgLen"_attr = msgLen,
+                  "min"_attr = kHeaderSize,
+                  "max"_attr = MaxMessageSizeBytes);
+            return Status(ErrorCodes::ProtocolError, sb.str());
+        }
+
+        auto buffer = SharedBuffer::allocate(msgLen);
+        if (msgLen <= _recvBufferSize) {
+            uassertStatusOK(_fillRecvBuffer(msgLen));
+            std::memcpy(buffer.get(), _recvBuffer.get() + _recvBegin, msgLen);
+            _recvBegin += msgLen;
+        } else {
+            auto received = _recvEnd - _recvBegin;
+            std::memcpy(buffer.get(), _recvBuffer.get() + _recvBegin, received);
+            _recvBegin = _recvEnd = 0;
+            while (received < msgLen) {
+                received += uassertStatusOK(_recv(buffer.get() + received, msgLen - received));
+            }
+        }
+
+        networkCounter.hitPhysicalIn(msgLen);
+        return Message(std::move(buffer));
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+
+    Future<Message> asyncSourceMessage(const BatonHandle& handle = nullptr) override {
+        return Future<Message>::makeReady(sourceMessage());
+    }
+
+    Status sinkMessage(Message message) override try {
+        // Only one send may be in flight, as it refers to '_sendMessage'.
+        uassertStatusOK(_waitForSend());
+
+        _sendMessage = std::move(message);
+        _sendOffset = 0;
+        _prepareSend();
+
+        // A reply flagged with moreToCome is followed by another reply rather than by a request,
+        // so there is no receive to submit it with.
+        if (OpMsg::isFlagSet(_sendMessage, OpMsg::kMoreToCome)) {
+            uassertStatusOK(_ring.submit());
+        }
+        return Status::OK();
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+
+    Future<void> asyncSinkMessage(Message message, const BatonHandle& handle = nullptr) override {
+        return Future<void>::makeReady(sinkMessage(std::move(message)));
+    }
+
+    void cancelAsyncOperations(const BatonHandle& baton = nullptr) override {
+        if (baton && baton->networking()) {
+            baton->networking()->cancelSession(*this);
+        }
+    }
+
+    void setTimeout(boost::optional<Milliseconds> timeout) override {
+        invariant(!timeout || timeout->count() > 0);
+        _configuredTimeout = timeout;
+    }
+
+    bool isConnected() override {
+        pollfd pollItem{_fd, POLLIN, 0};
+        const auto rval = ::poll(&pollItem, 1, 0);
+        if (rval < 0) {
+            LOGV2_WARNING(4917910,
+                          "Failed to poll socket for connectivity check: {error}",
+                          "Failed to poll socket for connectivity check",
+                          "error"_attr = errnoWithDescription(errno));
+            return false;
+        }
+        if (rval == 0 || _recvEnd > _recvBegin) {
+            return true;
+        }
+
+        if (pollItem.revents & POLLIN) {
+            char testByte;
+            const auto size = ::recv(_fd, &testByte, sizeof(testByte), MSG_PEEK);
+            if (size == sizeof(testByte)) {
+                return true;
+            } else if (size == -1) {
+                LOGV2_WARNING(4917911,
+                              "Failed to check socket connectivity: {error}",
+                              "Failed to check socket connectivity",
+                              "error"_attr = errnoWithDescription(errno));
+            }
+            // If size == 0 then we got disconnected and we should return false.
+        }
+        return false;
+    }
+
+#ifdef MONGO_CONFIG_SSL
+    const SSLConfiguration* getSSLConfiguration() const override {
+        return nullptr;
+    }
+
+    const std::shared_ptr<SSLManagerInterface> getSSLManager() const override {
+        return nullptr;
+    }
+#endif
+
+private:
+    /**
+     * Receives into the receive buffer until it holds at least 'needed' unconsumed bytes.
+     */
+    Status _fillRecvBuffer(size_t needed) {
+        invariant(needed <= _recvBufferSize);
+        if (_recvBegin == _recvEnd) {
+            _recvBegin = _recvEnd = 0;
+        }
+
+        while (_recvEnd - _recvBegin < needed) {
+            if (_recvBegin + needed > _recvBufferSize) {
+                std::memmove(
+                    _recvBuffer.get(), _recvBuffer.get() + _recvBegin, _recvEnd - _recvBegin);
+                _recvEnd -= _recvBegin;
+                _recvBegin = 0;
+            }
+
+            auto swReceived = _recv(_recvBuffer.get() + _recvEnd, _recvBufferSize - _recvEnd);
+            if (!swReceived.isOK()) {
+                return swReceived.getStatus();
+            }
+            _recvEnd += swReceived.getValue();
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Receives at most 'len' bytes into 'ptr', which is either in the receive buffer or the buffer
+     * of a message too large for it, and returns how many were received.
+     */
+    StatusWith<size_t> _recv(char* ptr, size_t len) {
+        const bool intoRecvBuffer =
+            ptr >= _recvBuffer.get() && ptr < _recvBuffer.get() + _recvBufferSize;
+
+        auto sqe = _getSqe();
+        if (intoRecvBuffer && _recvBufferRegistered) {
+            sqe->opcode = IORING_OP_READ_FIXED;
+            sqe->buf_index = 0;
+        } else {
+            sqe->opcode = IORING_OP_RECV;
+            // The rest of a large message is all we are waiting for, there is no point waking up
+            // for each segment of it.
+            sqe->msg_flags = intoRecvBuffer ? 0 : MSG_WAITALL;
+        }
+        sqe->fd = _fd;
+        sqe->addr = reinterpret_cast<uint64_t>(ptr);
+        sqe->len = len;
+        sqe->user_data = kRecv;
+        _prepareOperation(sqe, _recvOperation, kRecvTimeout);
+
+        while (_recvOperation.pending) {
+            _waitForCompletions();
+        }
+
+        // A reply that failed to be sent is reported first, as it is what broke the connection.
+        uassertStatusOK(_sendStatus);
+        if (_recvOperation.result == 0) {
+            return Status(ErrorCodes::HostUnreachable, "Connection closed by peer");
+        }
+        if (_recvOperation.result < 0) {
+            return _errorStatus(_recvOperation, "recv");
+        }
+        return size_t(_recvOperation.result);
+    }
+
+    /**
+     * Prepares the send of what remains of '_sendMessage'. It gets submitted with the next
+     * operation.
+     */
+    void _prepareSend() {
+        auto sqe = _getSqe();
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = _fd;
+        sqe->addr = reinterpret_cast<uint64_t>(_sendMessage.buf() + _sendOffset);
+        sqe->len = _sendMessage.size() - _sendOffset;
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->user_data = kSend;
+        _prepareOperation(sqe, _sendOperation, kSendTimeout);
+    }
+
+    /**
+     * Called once the send and its timeout, if any, have both completed.
+     */
+    void _onSendCompleted() {
+        if (_sendOperation.result > 0) {
+            _sendOffset += _sendOperation.result;
+            if (_sendOffset < size_t(_sendMessage.size())) {
+                _prepareSend();
+                return;
+            }
+            networkCounter.hitPhysicalOut(_sendMessage.size());
+        } else {
+            _sendStatus = _errorStatus(_sendOperation, "send");
+        }
+        _sendMessage.reset();
+    }
+
+    Status _waitForSend() {
+        while (!_sendMessage.empty()) {
+            _waitForCompletions();
+        }
+        return _sendStatus;
+    }
+
+    /**
+     * Links a timeout to the operation prepared in 'sqe' if the session has one configured.
+     */
+    void _prepareOperation(io_uring_sqe* sqe, Operation& op, Token timeoutToken) {
+        op.pending = 1;
+        op.result = 0;
+        op.timedOut = false;
+        if (!_configuredTimeout) {
+            return;
+        }
+
+        sqe->flags |= IOSQE_IO_LINK;
+        const auto millis = durationCount<Milliseconds>(*_configuredTimeout);
+        op.timeout.tv_sec = millis / 1000;
+        op.timeout.tv_nsec = (millis % 1000) * 1000 * 1000;
+
+        auto timeoutSqe = _getSqe();
+        timeoutSqe->opcode = IORING_OP_LINK_TIMEOUT;
+        timeoutSqe->fd = -1;
+        timeoutSqe->addr = reinterpret_cast<uint64_t>(&op.timeout);
+        timeoutSqe->len = 1;
+        timeoutSqe->user_data = timeoutToken;
+        ++op.pending;
+    }
+
+    io_uring_sqe* _getSqe() {
+        auto sqe = _ring.getSqe();
+        // The ring is sized for every operation the session can have in flight at once.
+        invariant(sqe);
+        return sqe;
+    }
+
+    void _waitForCompletions() {
+        uassertStatusOK(_ring.submitAndWait());
+        _ring.reapCompletions([&](const io_uring_cqe& cqe) {
+            switch (cqe.user_data) {
+                case kRecv:
+                    _recvOperation.result = cqe.res;
+                    --_recvOperation.pending;
+                    break;
+                case kRecvTimeout:
+                    _recvOperation.timedOut = (cqe.res == -ETIME);
+                    --_recvOperation.pending;
+                    break;
+                case kSend:
+                    _sendOperation.result = cqe.res;
+                    --_sendOperation.pending;
+                    break;
+                case kSendTimeout:
+                    _sendOperation.timedOut = (cqe.res == -ETIME);
+                    --_sendOperation.pending;
+                    break;
+                default:
+                    MONGO_UNREACHABLE;
+            }
+
+            if (cqe.user_data >= kSend && _sendOperation.pending == 0) {
+                _onSendCompleted();
+            }
+        });
+    }
+
+    Status _errorStatus(const Operation& op, StringData what) {
+        const auto error = -op.result;
+        if (op.timedOut || error == ETIME || error == EAGAIN) {
+            return {ErrorCodes::NetworkTimeout,
+                    str::stream() << what << " timed out on connection to " << _remote};
+        }
+        if (error == ECANCELED) {
+            return {ErrorCodes::CallbackCanceled,
+                    str::stream() << what << " canceled on connection to " << _remote};
+        }
+        if (error == 0) {
+            return {ErrorCodes::HostUnreachable, "Connection closed by peer"};
+        }
+        if (error == ECONNRESET || error == ENETRESET || error == EPIPE) {
+            return {ErrorCodes::HostUnreachable,
+                    str::stream() << "Connection reset by peer: " << errnoWithDescription(error)};
+        }
+        return {ErrorCodes::SocketException,
+                str::stream() << what << " failed on connection to " << _remote << ": "
+                              << errnoWithDescription(error)};
+    }
+
+    TransportLayerIOUring* const _tl;
+    const int _fd;
+
+    std::unique_ptr<char[]> _recvBuffer;
+    const size_t _recvBufferSize;
+    bool _recvBufferRegistered = false;
+
+    // The part of '_recvBuffer' received but not consumed yet.
+    size_t _recvBegin = 0;
+    size_t _recvEnd = 0;
+
+    Operation _recvOperation;
+
+    // The reply being sent, and how much of it was sent already.
+    Message _sendMessage;
+    size_t _sendOffset = 0;
+    Operation _sendOperation;
+    Status _sendStatus = Status::OK();
+
+    // Declared after the buffers the kernel may be accessing, so that it is torn down first.
+    IOUring _ring;
+
+    boost::optional<Milliseconds> _configuredTimeout;
+
+    HostAndPort _remote;
+    HostAndPort _local;
+
+    SockAddr _remoteAddr;
+    SockAddr _localAddr;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -1229,6 +1229,10 @@ BatonHandle TransportLayerASIO::makeBaton(OperationContext* opCtx) const {
 
     return baton;
 }
+
+int TransportLayerASIO::getNativeHandle(Session& session) {
+    return checked_cast<ASIOSession&>(session).getSocket().native_handle();
+}
 #endif
 
 }  // namespace transport
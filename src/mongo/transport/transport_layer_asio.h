@@ -141,6 +141,12 @@ public:
 
 #ifdef __linux__
     BatonHandle makeBaton(OperationContext* opCtx) const override;
+
+    /**
+     * Returns the file descriptor of 'session', which must belong to a TransportLayerASIO. Lets the
+     * batons of other transport layers wait on egress sessions.
+     */
+    static int getNativeHandle(Session& session);
 #endif
 
 #ifdef MONGO_CONFIG_SSL
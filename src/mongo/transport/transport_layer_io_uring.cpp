@@ -0,0 +1,440 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/transport_layer_io_uring.h"
+
+#include <netinet/in.h>
+#include <set>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mongo/logv2/log.h"
+#include "mongo/transport/io_uring.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/transport_options_gen.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/net/socket_utils.h"
+#include "mongo/util/scopeguard.h"
+
+// These define the classes nested in TransportLayerIOUring.
+#include "mongo/transport/session_io_uring.h"
+
+#include "mongo/transport/baton_io_uring.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// One multishot accept request per listening socket, plus the poll on the wakeup eventfd.
+constexpr unsigned kListenerRingEntries = 64;
+
+constexpr uint64_t kWakeupToken = 0;
+constexpr uint64_t kFirstAcceptorToken = 1;
+
+}  // namespace
+
+TransportLayerIOUring::Options::Options(const ServerGlobalParams* params)
+    : port(params->port),
+      ipList(params->bind_ips),
+      useUnixSockets(!params->noUnixSocket),
+      enableIPv6(params->enableIPv6),
+      recvBufferBytes(gIOUringSessionRecvBufferBytes) {}
+
+TransportLayerIOUring::TransportLayerIOUring(const Options& opts,
+                                             ServiceEntryPoint* sep,
+                                             std::unique_ptr<TransportLayer> egress)
+    : _sep(sep), _egress(std::move(egress)), _listenerOptions(opts) {
+    invariant(_egress);
+}
+
+TransportLayerIOUring::~TransportLayerIOUring() {
+    // Tearing the ring down first cancels the accept requests still armed on the sockets.
+    _listener.ring.reset();
+    for (auto& acceptor : _acceptors) {
+        if (acceptor.fd >= 0) {
+            ::close(acceptor.fd);
+        }
+    }
+    if (_listener.wakeupFd >= 0) {
+        ::close(_listener.wakeupFd);
+    }
+}
+
+StatusWith<SessionHandle> TransportLayerIOUring::connect(HostAndPort peer,
+                                                         ConnectSSLMode sslMode,
+                                                         Milliseconds timeout) {
+    return _egress->connect(std::move(peer), sslMode, timeout);
+}
+
+Future<SessionHandle> TransportLayerIOUring::asyncConnect(HostAndPort peer,
+                                                          ConnectSSLMode sslMode,
+                                                          const ReactorHandle& reactor,
+                                                          Milliseconds timeout) {
+    return _egress->asyncConnect(std::move(peer), sslMode, reactor, timeout);
+}
+
+Status TransportLayerIOUring::setup() try {
+    uassertStatusOK(IOUring::checkSupported());
+
+    std::vector<std::string> listenAddrs;
+    if (_listenerOptions.ipList.empty()) {
+        listenAddrs = {"127.0.0.1"};
+        if (_listenerOptions.enableIPv6) {
+            listenAddrs.emplace_back("::1");
+        }
+    } else {
+        listenAddrs = _listenerOptions.ipList;
+    }
+
+    if (_listenerOptions.useUnixSockets) {
+        listenAddrs.emplace_back(makeUnixSockPath(_listenerOptions.port));
+    }
+
+    _listenerPort = _listenerOptions.port;
+
+    // Self-deduplicating list of unique addresses.
+    std::set<SockAddr> addrs;
+    for (auto& ip : listenAddrs) {
+        if (ip.empty()) {
+            LOGV2_WARNING(4917912, "Skipping empty bind address");
+            continue;
+        }
+
+        auto resolved = SockAddr::createAll(
+            ip, _listenerPort, _listenerOptions.enableIPv6 ? AF_UNSPEC : AF_INET);
+        if (resolved.empty()) {
+            LOGV2_WARNING(4917913,
+                          "Found no addresses for {peer}",
+                          "Found no addresses for peer",
+                          "peer"_attr = ip);
+            continue;
+        }
+        addrs.insert(resolved.begin(), resolved.end());
+    }
+
+    for (auto& addr : addrs) {
+        const auto family = addr.getType();
+        if (family == AF_UNIX) {
+            if (::unlink(addr.getAddr().c_str()) == -1 && errno != ENOENT) {
+                LOGV2_ERROR(4917907,
+                            "Failed to unlink socket file {path} {error}",
+                            "Failed to unlink socket file",
+                            "path"_attr = addr.getAddr(),
+                            "error"_attr = errnoWithDescription(errno));
+                fassertFailedNoTrace(4917920);
+            }
+        }
+        if (family == AF_INET6 && !_listenerOptions.enableIPv6) {
+            return {ErrorCodes::BadValue, "Specified ipv6 bind address, but ipv6 is disabled"};
+        }
+
+        const int fd = ::socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            // Allow the server to start when "ipv6: true" and "bindIpAll: true", but the platform
+            // does not support ipv6 (e.g., ipv6 kernel module is not loaded in Linux).
+            if (errno == EAFNOSUPPORT && family == AF_INET6 && addr.isDefaultRoute()) {
+                LOGV2_WARNING(4917919,
+                              "Failed to bind to {address} as the platform does not support ipv6",
+                              "Failed to bind to address as the platform does not support ipv6",
+                              "address"_attr = addr.toString());
+                continue;
+            }
+            return {ErrorCodes::SocketException,
+                    str::stream() << "Failed to create socket for " << addr.toString() << ": "
+                                  << errnoWithDescription(errno)};
+        }
+        _acceptors.push_back({addr, fd});
+
+        const int on = 1;
+        if (::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) != 0 ||
+            (family == AF_INET6 && ::setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &on, sizeof(on)))) {
+            return {ErrorCodes::SocketException,
+                    str::stream() << "Failed to configure socket for " << addr.toString() << ": "
+                                  << errnoWithDescription(errno)};
+        }
+
+        if (::bind(fd, addr.raw(), addr.addressSize) != 0) {
+            return {ErrorCodes::SocketException,
+                    str::stream() << "Failed to bind to " << addr.toString() << ": "
+                                  << errnoWithDescription(errno)};
+        }
+
+        if (family == AF_UNIX) {
+            if (::chmod(addr.getAddr().c_str(), serverGlobalParams.unixSocketPermissions) == -1) {
+                LOGV2_ERROR(4917916,
+                            "Failed to chmod socket file {path} {error}",
+                            "Failed to chmod socket file",
+                            "path"_attr = addr.getAddr(),
+                            "error"_attr = errnoWithDescription(errno));
+                fassertFailedNoTrace(4917921);
+            }
+        }
+
+        if (_listenerOptions.port == 0 && (family == AF_INET || family == AF_INET6)) {
+            if (_listenerPort != _listenerOptions.port) {
+                return Status(ErrorCodes::BadValue,
+                              "Port 0 (ephemeral port) is not allowed when"
+                              " listening on multiple IP interfaces");
+            }
+            sockaddr_storage bound;
+            socklen_t boundLen = sizeof(bound);
+            if (::getsockname(fd, reinterpret_cast<sockaddr*>(&bound), &boundLen) != 0) {
+                return {ErrorCodes::SocketException,
+                        str::stream() << "getsockname failed: " << errnoWithDescription(errno)};
+            }
+            _listenerPort = SockAddr(reinterpret_cast<sockaddr*>(&bound), boundLen).getPort();
+        }
+    }
+
+    if (_acceptors.empty()) {
+        return Status(ErrorCodes::SocketException, "No available addresses/ports to bind to");
+    }
+
+    _listener.ring = std::make_unique<IOUring>(kListenerRingEntries);
+    _listener.wakeupFd = ::eventfd(0, EFD_CLOEXEC);
+    if (_listener.wakeupFd < 0) {
+        return {ErrorCodes::UnknownError,
+                str::stream() << "error in creating eventfd: " << errnoWithDescription(errno)};
+    }
+
+    return _egress->setup();
+} catch (const DBException& ex) {
+    return ex.toStatus();
+}
+
+void TransportLayerIOUring::_armAccept(size_t acceptorIndex) {
+    auto& acceptor = _acceptors[acceptorIndex];
+    auto sqe = _listener.ring->getSqe();
+    invariant(sqe);
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = acceptor.fd;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    if (acceptor.multishot) {
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    }
+    sqe->user_data = kFirstAcceptorToken + acceptorIndex;
+}
+
+void TransportLayerIOUring::_armWakeup() {
+    auto sqe = _listener.ring->getSqe();
+    invariant(sqe);
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = _listener.wakeupFd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = kWakeupToken;
+}
+
+void TransportLayerIOUring::_runListener() noexcept {
+    setThreadName("listener");
+
+    stdx::unique_lock lk(_mutex);
+    if (_isShutdown.load()) {
+        return;
+    }
+
+    for (size_t i = 0; i < _acceptors.size(); ++i) {
+        auto& acceptor = _acceptors[i];
+        if (::listen(acceptor.fd, serverGlobalParams.listenBacklog) != 0) {
+            LOGV2_FATAL(4917901,
+                        "Error listening for new connections on {listenAddress}: {error}",
+                        "Error listening for new connections on listen address",
+                        "listenAddrs"_attr = acceptor.addr,
+                        "error"_attr = errnoWithDescription(errno));
+        }
+
+        _armAccept(i);
+        LOGV2(4917902, "Listening on", "address"_attr = acceptor.addr.getAddr());
+    }
+    _armWakeup();
+
+    LOGV2(4917903,
+          "Waiting for connections",
+          "port"_attr = _listenerPort,
+          "ssl"_attr = "off",
+          "transportLayer"_attr = "io_uring");
+
+    _listener.active = true;
+    _listener.cv.notify_all();
+    ON_BLOCK_EXIT([&] {
+        _listener.active = false;
+        _listener.cv.notify_all();
+    });
+
+    // Accepting connections only touches the listener's own state, so it runs without the mutex.
+    lk.unlock();
+    auto& ring = *_listener.ring;
+    while (!_isShutdown.load()) {
+        auto status = ring.submitAndWait();
+        if (!status.isOK()) {
+            LOGV2_FATAL(4917904,
+                        "Error waiting for new connections: {error}",
+                        "Error waiting for new connections",
+                        "error"_attr = status);
+        }
+
+        ring.reapCompletions([&](const io_uring_cqe& cqe) {
+            if (cqe.user_data == kWakeupToken) {
+                // Only ever written to on shutdown.
+                return;
+            }
+
+            const auto index = cqe.user_data - kFirstAcceptorToken;
+            auto& acceptor = _acceptors[index];
+            if (cqe.res >= 0) {
+                _acceptSession(cqe.res);
+            } else if (cqe.res == -EINVAL && acceptor.multishot) {
+                acceptor.multishot = false;
+            } else if (!_isShutdown.load()) {
+                LOGV2(4917905,
+                      "Error accepting new connection on {localEndpoint}: {error}",
+                      "Error accepting new connection on local endpoint",
+                      "localEndpoint"_attr = acceptor.addr,
+                      "error"_attr = errnoWithDescription(-cqe.res));
+            }
+
+            // A multishot accept request stays armed until it runs into an error.
+            if (!(cqe.flags & IORING_CQE_F_MORE) && !_isShutdown.load()) {
+                _armAccept(index);
+            }
+        });
+    }
+    lk.lock();
+
+    // Shutting the listening sockets down fails the accept requests still armed on them and
+    // prevents new connections from being opened.
+    for (auto& acceptor : _acceptors) {
+        ::shutdown(acceptor.fd, SHUT_RDWR);
+        auto& addr = acceptor.addr;
+        if (addr.getType() == AF_UNIX && !addr.isAnonymousUNIXSocket()) {
+            auto path = addr.getAddr();
+            LOGV2(4917917,
+                  "removing socket file: {path}",
+                  "removing socket file",
+                  "path"_attr = path);
+            if (::unlink(path.c_str()) != 0) {
+                const auto ewd = errnoWithDescription();
+                LOGV2_WARNING(4917918,
+                              "Unable to remove UNIX socket {path}: {error}",
+                              "Unable to remove UNIX socket",
+                              "path"_attr = path,
+                              "error"_attr = ewd);
+            }
+        }
+    }
+}
+
+void TransportLayerIOUring::_acceptSession(int fd) {
+    std::shared_ptr<IOUringSession> session;
+    try {
+        session = std::make_shared<IOUringSession>(this, fd, _listenerOptions.recvBufferBytes);
+    } catch (const DBException& e) {
+        ::close(fd);
+        LOGV2_WARNING(4917906,
+                      "Error accepting new connection: {error}",
+                      "Error accepting new connection",
+                      "error"_attr = e);
+        return;
+    }
+
+    try {
+        _sep->startSession(std::move(session));
+    } catch (const DBException& e) {
+        LOGV2_WARNING(4917922,
+                      "Error starting session for new connection: {error}",
+                      "Error starting session for new connection",
+                      "error"_attr = e);
+    }
+}
+
+Status TransportLayerIOUring::start() {
+    stdx::unique_lock lk(_mutex);
+
+    // Make sure we haven't shutdown already
+    invariant(!_isShutdown.load());
+
+    if (auto status = _egress->start(); !status.isOK()) {
+        return status;
+    }
+
+    _listener.thread = stdx::thread([this] { _runListener(); });
+    _listener.cv.wait(lk, [&] { return _isShutdown.load() || _listener.active; });
+    return Status::OK();
+}
+
+void TransportLayerIOUring::shutdown() {
+    stdx::unique_lock lk(_mutex);
+
+    if (_isShutdown.swap(true)) {
+        // We were already stopped
+        return;
+    }
+
+    auto thread = std::exchange(_listener.thread, {});
+    if (thread.joinable()) {
+        // Wake the listener thread up, and wait for it to die.
+        while (::eventfd_write(_listener.wakeupFd, 1) != 0) {
+            invariant(errno == EINTR);
+        }
+        lk.unlock();
+        thread.join();
+    } else {
+        lk.unlock();
+    }
+
+    _egress->shutdown();
+}
+
+ReactorHandle TransportLayerIOUring::getReactor(WhichReactor which) {
+    // Ingress sessions are synchronous and never need a reactor.
+    return _egress->getReactor(which);
+}
+
+BatonHandle TransportLayerIOUring::makeBaton(OperationContext* opCtx) const {
+    invariant(!opCtx->getBaton());
+
+    auto baton = std::make_shared<BatonIOUring>(opCtx);
+    opCtx->setBaton(baton);
+
+    return baton;
+}
+
+#ifdef MONGO_CONFIG_SSL
+Status TransportLayerIOUring::rotateCertificates(std::shared_ptr<SSLManagerInterface> manager) {
+    return _egress->rotateCertificates(std::move(manager));
+}
+#endif
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/config.h"
+#include "mongo/db/server_options.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/hierarchical_acquisition.h"
+#include "mongo/util/net/sockaddr.h"
+
+namespace mongo {
+
+class ServiceEntryPoint;
+
+namespace transport {
+
+class IOUring;
+
+/**
+ * An ingress TransportLayer for Linux built on io_uring.
+ *
+ * The listener thread accepts connections with multishot accept requests, which keep delivering
+ * new connections without being resubmitted. Each session owns a small ring through which it
+ * receives into a buffer registered with the kernel, and defers sending a reply until it starts
+ * receiving the next request so that both are submitted with a single system call. Batons wait
+ * on sessions and timers through a ring as well.
+ *
+ * Sessions are served in synchronous mode only, and TLS is not supported. Egress connections are
+ * delegated to the 'egress' transport layer passed in at construction.
+ */
+class TransportLayerIOUring final : public TransportLayer {
+    TransportLayerIOUring(const TransportLayerIOUring&) = delete;
+    TransportLayerIOUring& operator=(const TransportLayerIOUring&) = delete;
+
+public:
+    struct Options {
+        explicit Options(const ServerGlobalParams* params);
+        Options() = default;
+
+        int port = ServerGlobalParams::DefaultDBPort;  // port to bind to
+        std::vector<std::string> ipList;               // addresses to bind to
+        bool useUnixSockets = true;                    // whether to allow UNIX sockets in ipList
+        bool enableIPv6 = false;                       // whether to allow IPv6 sockets in ipList
+        size_t recvBufferBytes = 16 * 1024;            // size of each session's receive buffer
+    };
+
+    TransportLayerIOUring(const Options& opts,
+                          ServiceEntryPoint* sep,
+                          std::unique_ptr<TransportLayer> egress);
+
+    ~TransportLayerIOUring();
+
+    StatusWith<SessionHandle> connect(HostAndPort peer,
+                                      ConnectSSLMode sslMode,
+                                      Milliseconds timeout) final;
+
+    Future<SessionHandle> asyncConnect(HostAndPort peer,
+                                       ConnectSSLMode sslMode,
+                                       const ReactorHandle& reactor,
+                                       Milliseconds timeout) final;
+
+    Status setup() final;
+
+    ReactorHandle getReactor(WhichReactor which) final;
+
+    Status start() final;
+
+    void shutdown() final;
+
+    BatonHandle makeBaton(OperationContext* opCtx) const override;
+
+#ifdef MONGO_CONFIG_SSL
+    Status rotateCertificates(std::shared_ptr<SSLManagerInterface> manager) override;
+#endif
+
+    int listenerPort() const {
+        return _listenerPort;
+    }
+
+private:
+    class BatonIOUring;
+    class IOUringSession;
+
+    struct Acceptor {
+        SockAddr addr;
+        int fd = -1;
+
+        // Cleared if the kernel does not support multishot accept requests (Linux 5.19).
+        bool multishot = true;
+    };
+
+    void _runListener() noexcept;
+    void _armAccept(size_t acceptorIndex);
+    void _armWakeup();
+    void _acceptSession(int fd);
+
+    Mutex _mutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TransportLayerIOUring::_mutex");
+
+    std::vector<Acceptor> _acceptors;
+
+    struct Listener {
+        stdx::thread thread;
+        stdx::condition_variable cv;
+        bool active = false;
+
+        // Only used by the listener thread once started.
+        std::unique_ptr<IOUring> ring;
+
+        // An eventfd written to by shutdown() to wake the listener thread up.
+        int wakeupFd = -1;
+    };
+    Listener _listener;
+
+    ServiceEntryPoint* const _sep = nullptr;
+    const std::unique_ptr<TransportLayer> _egress;
+
+    Options _listenerOptions;
+    // The real incoming port in case of _listenerOptions.port==0 (ephemeral).
+    int _listenerPort = 0;
+
+    AtomicWord<bool> _isShutdown{false};
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,282 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kTest
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/transport_layer_io_uring.h"
+
+#include "mongo/db/server_options.h"
+#include "mongo/logv2/log.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/transport/io_uring.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/transport_layer_asio.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/net/sock.h"
+
+namespace mongo {
+namespace {
+
+class ServiceEntryPointUtil : public ServiceEntryPoint {
+public:
+    void startSession(transport::SessionHandle session) override {
+        stdx::unique_lock<Latch> lk(_mutex);
+        _sessions.push_back(std::move(session));
+        _cv.notify_one();
+    }
+
+    void endAllSessions(transport::Session::TagMask tags) override {
+        std::vector<transport::SessionHandle> oldSessions;
+        {
+            stdx::unique_lock<Latch> lock(_mutex);
+            oldSessions.swap(_sessions);
+        }
+        oldSessions.clear();
+    }
+
+    Status start() override {
+        return Status::OK();
+    }
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    void appendStats(BSONObjBuilder*) const override {}
+
+    size_t numOpenSessions() const override {
+        stdx::unique_lock<Latch> lock(_mutex);
+        return _sessions.size();
+    }
+
+    DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
+        MONGO_UNREACHABLE;
+    }
+
+    transport::SessionHandle waitForConnect() {
+        stdx::unique_lock<Latch> lock(_mutex);
+        _cv.wait(lock, [&] { return !_sessions.empty(); });
+        return _sessions.back();
+    }
+
+private:
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ServiceEntryPointUtil::_mutex");
+    stdx::condition_variable _cv;
+    std::vector<transport::SessionHandle> _sessions;
+};
+
+class TransportLayerIOUringTest : public unittest::Test {
+protected:
+    void setUp() override {
+        if (auto status = transport::IOUring::checkSupported(); !status.isOK()) {
+            LOGV2(4917930, "Skipping test, io_uring is not supported", "reason"_attr = status);
+            _supported = false;
+            return;
+        }
+
+        ServerGlobalParams params;
+        params.noUnixSocket = true;
+        transport::TransportLayerIOUring::Options options(&params);
+        options.port = 0;
+        options.recvBufferBytes = kRecvBufferBytes;
+
+        transport::TransportLayerASIO::Options egressOptions;
+        egressOptions.mode = transport::TransportLayerASIO::Options::kEgress;
+
+        _tl = std::make_unique<transport::TransportLayerIOUring>(
+            options,
+            &_sep,
+            std::make_unique<transport::TransportLayerASIO>(egressOptions, nullptr));
+        ASSERT_OK(_tl->setup());
+        ASSERT_OK(_tl->start());
+        ASSERT_GT(_tl->listenerPort(), 0);
+    }
+
+    void tearDown() override {
+        if (_tl) {
+            _sep.endAllSessions({});
+            _tl->shutdown();
+        }
+    }
+
+    /**
+     * Connects 'socket' to the transport layer and returns the session it accepted.
+     */
+    transport::SessionHandle connect(Socket& socket) {
+        SockAddr sa{"localhost", _tl->listenerPort(), AF_INET};
+        ASSERT_TRUE(socket.connect(sa));
+        return _sep.waitForConnect();
+    }
+
+    static Message makeMessage(int size) {
+        auto msg = OpMsgRequest::fromDBAndBody(
+                       "admin", BSON("ping" << 1 << "padding" << std::string(size, 'x')))
+                       .serialize();
+        msg.header().setId(size);
+        return msg;
+    }
+
+    static void sendMessages(Socket& socket, const std::vector<Message>& messages) {
+        std::string bytes;
+        for (auto&& msg : messages) {
+            bytes.append(msg.buf(), msg.size());
+        }
+        socket.send(bytes.data(), bytes.size(), "sendMessages");
+    }
+
+    static void assertSameMessage(const Message& actual, const Message& expected) {
+        ASSERT_EQ(actual.size(), expected.size());
+        ASSERT_EQ(std::memcmp(actual.buf(), expected.buf(), expected.size()), 0);
+    }
+
+    static constexpr size_t kRecvBufferBytes = 1024;
+
+    bool _supported = true;
+    ServiceEntryPointUtil _sep;
+    std::unique_ptr<transport::TransportLayerIOUring> _tl;
+};
+
+TEST_F(TransportLayerIOUringTest, PortZeroConnect) {
+    if (!_supported) {
+        return;
+    }
+
+    Socket socket;
+    auto session = connect(socket);
+    ASSERT_TRUE(session->isConnected());
+}
+
+TEST_F(TransportLayerIOUringTest, SourcePipelinedMessages) {
+    if (!_supported) {
+        return;
+    }
+
+    Socket socket;
+    auto session = connect(socket);
+
+    // Both messages arrive with a single receive, the second one is kept for the next call.
+    std::vector<Message> messages{makeMessage(10), makeMessage(20)};
+    sendMessages(socket, messages);
+    for (auto&& expected : messages) {
+        auto swMsg = session->sourceMessage();
+        ASSERT_OK(swMsg.getStatus());
+        assertSameMessage(swMsg.getValue(), expected);
+    }
+}
+
+TEST_F(TransportLayerIOUringTest, SourceMessageLargerThanRecvBuffer) {
+    if (!_supported) {
+        return;
+    }
+
+    Socket socket;
+    auto session = connect(socket);
+
+    std::vector<Message> messages{makeMessage(10), makeMessage(kRecvBufferBytes * 64)};
+    sendMessages(socket, messages);
+    for (auto&& expected : messages) {
+        auto swMsg = session->sourceMessage();
+        ASSERT_OK(swMsg.getStatus());
+        assertSameMessage(swMsg.getValue(), expected);
+    }
+}
+
+TEST_F(TransportLayerIOUringTest, SinkMessageIsSentWithNextSource) {
+    if (!_supported) {
+        return;
+    }
+
+    Socket socket;
+    auto session = connect(socket);
+
+    auto request = makeMessage(10);
+    sendMessages(socket, {request});
+    ASSERT_OK(session->sourceMessage().getStatus());
+
+    auto reply = makeMessage(kRecvBufferBytes * 4);
+    ASSERT_OK(session->sinkMessage(reply));
+
+    // The client only sends its next request once it got the reply, which the session sends as
+    // it starts receiving.
+    stdx::thread client([&] {
+        std::string received(reply.size(), '\0');
+        socket.recv(&received[0], received.size());
+        ASSERT_EQ(std::memcmp(received.data(), reply.buf(), reply.size()), 0);
+        sendMessages(socket, {request});
+    });
+
+    auto swMsg = session->sourceMessage();
+    client.join();
+    ASSERT_OK(swMsg.getStatus());
+    assertSameMessage(swMsg.getValue(), request);
+}
+
+TEST_F(TransportLayerIOUringTest, SourceSyncTimeoutTimesOut) {
+    if (!_supported) {
+        return;
+    }
+
+    Socket socket;
+    auto session = connect(socket);
+
+    session->setTimeout(Milliseconds{500});
+    ASSERT_EQ(session->sourceMessage().getStatus(), ErrorCodes::NetworkTimeout);
+}
+
+TEST_F(TransportLayerIOUringTest, SourceInvalidMessageLength) {
+    if (!_supported) {
+        return;
+    }
+
+    Socket socket;
+    auto session = connect(socket);
+
+    auto msg = makeMessage(10);
+    msg.header().setLen(4);
+    socket.send(msg.buf(), msg.size(), "SourceInvalidMessageLength");
+    ASSERT_EQ(session->sourceMessage().getStatus(), ErrorCodes::ProtocolError);
+}
+
+TEST_F(TransportLayerIOUringTest, SourceFailsOnceClientDisconnects) {
+    if (!_supported) {
+        return;
+    }
+
+    auto socket = std::make_unique<Socket>();
+    auto session = connect(*socket);
+
+    socket.reset();
+    ASSERT_EQ(session->sourceMessage().getStatus(), ErrorCodes::HostUnreachable);
+    ASSERT_FALSE(session->isConnected());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -45,7 +45,14 @@
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer_asio.h"
+#include "mongo/transport/transport_options_gen.h"
+#include "mongo/util/net/ssl_options.h"
 #include "mongo/util/net/ssl_types.h"
+
+#ifdef __linux__
+#include "mongo/transport/io_uring.h"
+#include "mongo/transport/transport_layer_io_uring.h"
+#endif
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -141,6 +148,32 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
     ctx->setServiceExecutor(std::make_unique<ServiceExecutorSynchronous>(ctx));
 
     std::vector<std::unique_ptr<TransportLayer>> retVector;
+#ifdef __linux__
+    if (gUseIOUringTransportLayer) {
+        auto status = IOUring::checkSupported();
+        if (status.isOK() && getSSLGlobalParams().sslMode.load() != SSLParams::SSLMode_disabled) {
+            status = {ErrorCodes::IllegalOperation,
+                      "the io_uring transport layer does not support TLS"};
+        }
+
+        if (status.isOK()) {
+            LOGV2(4917915, "Using the io_uring transport layer for ingress connections");
+            transport::TransportLayerASIO::Options egressOpts(config);
+            egressOpts.mode = transport::TransportLayerASIO::Options::kEgress;
+            egressOpts.ipList.clear();
+            retVector.emplace_back(std::make_unique<transport::TransportLayerIOUring>(
+                transport::TransportLayerIOUring::Options(config),
+                sep,
+                std::make_unique<transport::TransportLayerASIO>(egressOpts, nullptr)));
+            return std::make_unique<TransportLayerManager>(std::move(retVector));
+        }
+
+        LOGV2_WARNING(4917914,
+                      "Falling back to the ASIO transport layer: {reason}",
+                      "Falling back to the ASIO transport layer",
+                      "reason"_attr = status);
+    }
+#endif
     retVector.emplace_back(std::make_unique<transport::TransportLayerASIO>(opts, sep));
     return std::make_unique<TransportLayerManager>(std::move(retVector));
 }
@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/bump_arena.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "mongo/util/allocator.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+// Every allocation is preceded by a header which points to its chunk, or is null for allocations
+// from the heap, so that deallocate() does not depend on where the heap places its blocks.
+constexpr size_t kHeaderBytes = BumpArena::kAlignment;
+
+// Allocations do not touch the reference count of their chunk. Instead, the count starts out
+// biased by a number larger than the number of allocations a chunk can hold, and the arena takes
+// back the bias minus the number of allocations it made when it retires the chunk. Deallocations
+// cannot bring the count to zero before then.
+constexpr uint32_t kChunkRefBias = 1u << 30;
+
+size_t alignUp(size_t bytes) {
+    return (bytes + BumpArena::kAlignment - 1) & ~(BumpArena::kAlignment - 1);
+}
+
+}  // namespace
+
+struct BumpArena::Chunk {
+    std::atomic<uint32_t> refs{kChunkRefBias};  // NOLINT
+
+    static void release(Chunk* chunk, uint32_t refs) {
+        if (chunk->refs.fetch_sub(refs, std::memory_order_acq_rel) == refs) {
+            chunk->~Chunk();
+            std::free(chunk);
+            _totalChunkBytes.subtractAndFetch(kChunkBytes);
+        }
+    }
+};
+
+static_assert(sizeof(void*) <= kHeaderBytes);
+static_assert(alignof(std::max_align_t) >= BumpArena::kAlignment);
+static_assert(BumpArena::kChunkBytes / kHeaderBytes < kChunkRefBias);
+
+BumpArena::~BumpArena() {
+    _retireChunk();
+}
+
+void* BumpArena::allocate(size_t bytes) {
+    if (auto arena = _threadArena; arena && bytes <= kMaxArenaAllocationBytes) {
+        return arena->_allocate(bytes);
+    }
+
+    auto block = static_cast<char*>(mongoMalloc(kHeaderBytes + bytes));
+    *reinterpret_cast<Chunk**>(block) = nullptr;
+    return block + kHeaderBytes;
+}
+
+void BumpArena::deallocate(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    auto block = static_cast<char*>(ptr) - kHeaderBytes;
+    if (auto chunk = *reinterpret_cast<Chunk**>(block)) {
+        Chunk::release(chunk, 1);
+    } else {
+        std::free(block);
+    }
+}
+
+void* BumpArena::_allocate(size_t bytes) {
+    const size_t blockBytes = alignUp(kHeaderBytes + bytes);
+    if (static_cast<size_t>(_end - _next) < blockBytes) {
+        _retireChunk();
+
+        auto memory = static_cast<char*>(mongoMalloc(kChunkBytes));
+        _totalChunkBytes.addAndFetch(kChunkBytes);
+        _chunk = new (memory) Chunk();
+        _next = memory + alignUp(sizeof(Chunk));
+        _end = memory + kChunkBytes;
+    }
+
+    auto block = _next;
+    _next += blockBytes;
+    ++_numChunkAllocations;
+    *reinterpret_cast<Chunk**>(block) = _chunk;
+    return block + kHeaderBytes;
+}
+
+void BumpArena::_retireChunk() {
+    if (!_chunk) {
+        return;
+    }
+
+    Chunk::release(_chunk, kChunkRefBias - _numChunkAllocations);
+    _chunk = nullptr;
+    _next = _end = nullptr;
+    _numChunkAllocations = 0;
+}
+
+}  // namespace mongo
@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+/**
+ * A region allocator for the many small, short-lived buffers which make up the documents flowing
+ * through a pipeline.
+ *
+ * An arena hands out memory by bumping a pointer through fixed-size chunks. Every allocation from
+ * an arena is preceded by a header pointing to its chunk, and a chunk is freed as a whole once the
+ * arena moved on to a new chunk and every allocation from the chunk was deallocated. Allocations
+ * may therefore outlive their arena and be deallocated from any thread, while allocating costs
+ * neither a call into malloc nor an atomic operation. Heap allocations carry a null header.
+ *
+ * allocate() serves the calling thread from the arena installed by the innermost active
+ * BumpArena::Scope of the thread, if any, and from the heap otherwise. Allocations too large for
+ * the arena always come from the heap. deallocate() accepts memory from either source.
+ *
+ * Since a chunk stays alive as long as any of its allocations, an arena should only serve memory
+ * which mostly dies at about the same time.
+ */
+class BumpArena {
+    BumpArena(const BumpArena&) = delete;
+    BumpArena& operator=(const BumpArena&) = delete;
+
+public:
+    // The size of the chunks, including their bookkeeping.
+    static constexpr size_t kChunkBytes = 32 * 1024;
+
+    // Larger allocations come from the heap.
+    static constexpr size_t kMaxArenaAllocationBytes = 2 * 1024;
+
+    // The alignment of all allocations.
+    static constexpr size_t kAlignment = 8;
+
+    /**
+     * Installs an arena as the source of the allocations of the current thread for the lifetime of
+     * the scope. A null arena makes the thread allocate from the heap.
+     */
+    class Scope {
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    public:
+        explicit Scope(BumpArena* arena) : _previous(_threadArena) {
+            _threadArena = arena;
+        }
+
+        ~Scope() {
+            _threadArena = _previous;
+        }
+
+    private:
+        BumpArena* const _previous;
+    };
+
+    /**
+     * A deleter for std::unique_ptr which returns memory obtained from allocate().
+     */
+    struct Deleter {
+        void operator()(void* ptr) const {
+            BumpArena::deallocate(ptr);
+        }
+    };
+
+    BumpArena() = default;
+    ~BumpArena();
+
+    /**
+     * Returns 'bytes' bytes of memory aligned to kAlignment, from the arena of the current thread
+     * if it has one.
+     */
+    static void* allocate(size_t bytes);
+
+    /**
+     * Returns memory obtained from allocate(). Accepts nullptr.
+     */
+    static void deallocate(void* ptr);
+
+    /**
+     * Returns whether allocate() serves the current thread from an arena.
+     */
+    static bool threadHasArena() {
+        return _threadArena;
+    }
+
+    /**
+     * Returns the number of bytes held by the chunks of all arenas.
+     */
+    static int64_t totalChunkBytes() {
+        return _totalChunkBytes.load();
+    }
+
+private:
+    struct Chunk;
+
+    void* _allocate(size_t bytes);
+
+    void _retireChunk();
+
+    Chunk* _chunk = nullptr;
+    char* _next = nullptr;
+    char* _end = nullptr;
+
+    // The number of allocations made from '_chunk' so far.
+    uint32_t _numChunkAllocations = 0;
+
+    static inline thread_local BumpArena* _threadArena = nullptr;
+
+    static inline AtomicWord<int64_t> _totalChunkBytes{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/bump_arena.h"
+
+namespace mongo {
+namespace {
+
+bool isAligned(void* ptr) {
+    return reinterpret_cast<uintptr_t>(ptr) % BumpArena::kAlignment == 0;
+}
+
+TEST(BumpArenaTest, AllocatesFromHeapWithoutArena) {
+    const auto chunkBytes = BumpArena::totalChunkBytes();
+    void* ptr = BumpArena::allocate(100);
+    ASSERT(isAligned(ptr));
+    std::memset(ptr, 'x', 100);
+    ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes);
+    BumpArena::deallocate(ptr);
+    BumpArena::deallocate(nullptr);
+}
+
+TEST(BumpArenaTest, DeallocatesHeapAndArenaAllocationsOfAnyAlignment) {
+    const auto chunkBytes = BumpArena::totalChunkBytes();
+    BumpArena arena;
+    std::vector<void*> ptrs;
+    for (size_t size = 1; size <= 4 * BumpArena::kAlignment; ++size) {
+        ptrs.push_back(BumpArena::allocate(size));
+        BumpArena::Scope scope(&arena);
+        ptrs.push_back(BumpArena::allocate(size));
+    }
+
+    for (auto ptr : ptrs) {
+        ASSERT(isAligned(ptr));
+        BumpArena::deallocate(ptr);
+    }
+    BumpArena::Scope scope(&arena);
+    BumpArena::deallocate(BumpArena::allocate(1));
+    ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes + BumpArena::kChunkBytes);
+}
+
+TEST(BumpArenaTest, AllocatesFromArenaOfScope) {
+    const auto chunkBytes = BumpArena::totalChunkBytes();
+    std::vector<char*> ptrs;
+    {
+        BumpArena arena;
+        BumpArena::Scope scope(&arena);
+        for (size_t size = 1; size < 200; ++size) {
+            auto ptr = static_cast<char*>(BumpArena::allocate(size));
+            ASSERT(isAligned(ptr));
+            std::memset(ptr, static_cast<int>(size), size);
+            ptrs.push_back(ptr);
+        }
+        ASSERT_GT(BumpArena::totalChunkBytes(), chunkBytes);
+    }
+
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+        const size_t size = i + 1;
+        for (size_t j = 0; j < size; ++j) {
+            ASSERT_EQ(ptrs[i][j], static_cast<char>(size));
+        }
+    }
+
+    for (auto ptr : ptrs) {
+        BumpArena::deallocate(ptr);
+    }
+    ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes);
+}
+
+TEST(BumpArenaTest, ChunkOutlivesArenaUntilAllocationsAreDeallocated) {
+    const auto chunkBytes = BumpArena::totalChunkBytes();
+    auto arena = std::make_unique<BumpArena>();
+    void* first;
+    void* second;
+    {
+        BumpArena::Scope scope(arena.get());
+        first = BumpArena::allocate(16);
+        second = BumpArena::allocate(16);
+    }
+    ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes + BumpArena::kChunkBytes);
+
+    arena.reset();
+    BumpArena::deallocate(first);
+    ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes + BumpArena::kChunkBytes);
+    BumpArena::deallocate(second);
+    ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes);
+}
+
+TEST(BumpArenaTest, CurrentChunkOutlivesItsAllocations) {
+    const auto chunkBytes = BumpArena::totalChunkBytes();
+    BumpArena arena;
+    BumpArena::Scope scope(&arena);
+    BumpArena::deallocate(BumpArena::allocate(16));
+    ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes + BumpArena::kChunkBytes);
+
+    // The arena keeps using its current chunk.
+    BumpArena::deallocate(BumpArena::allocate(16));
+    ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes + BumpArena::kChunkBytes);
+}
+
+TEST(BumpArenaTest, FullChunksAreReleased) {
+    const auto chunkBytes = BumpArena::totalChunkBytes();
+    BumpArena arena;
+    BumpArena::Scope scope(&arena);
+    for (size_t i = 0; i < 10 * BumpArena::kChunkBytes / 64; ++i) {
+        BumpArena::deallocate(BumpArena::allocate(64));
+    }
+    ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes + BumpArena::kChunkBytes);
+}
+
+TEST(BumpArenaTest, LargeAllocationsComeFromHeap) {
+    const auto chunkBytes = BumpArena::totalChunkBytes();
+    BumpArena arena;
+    BumpArena::Scope scope(&arena);
+    void* ptr = BumpArena::allocate(BumpArena::kMaxArenaAllocationBytes + 1);
+    ASSERT(isAligned(ptr));
+    ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes);
+    BumpArena::deallocate(ptr);
+}
+
+TEST(BumpArenaTest, NestedScopesRestoreTheOuterArena) {
+    const auto chunkBytes = BumpArena::totalChunkBytes();
+    BumpArena outer;
+    BumpArena::Scope outerScope(&outer);
+    {
+        BumpArena::Scope heapScope(nullptr);
+        BumpArena::deallocate(BumpArena::allocate(16));
+        ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes);
+    }
+
+    BumpArena::deallocate(BumpArena::allocate(16));
+    ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes + BumpArena::kChunkBytes);
+}
+
+TEST(BumpArenaTest, DeallocatesFromOtherThreads) {
+    const auto chunkBytes = BumpArena::totalChunkBytes();
+    std::vector<void*> ptrs;
+    {
+        BumpArena arena;
+        BumpArena::Scope scope(&arena);
+        for (size_t i = 0; i < 4 * BumpArena::kChunkBytes / 64; ++i) {
+            ptrs.push_back(BumpArena::allocate(48));
+        }
+    }
+
+    std::vector<stdx::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = t; i < ptrs.size(); i += 4) {
+                BumpArena::deallocate(ptrs[i]);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(BumpArena::totalChunkBytes(), chunkBytes);
+}
+
+}  // namespace
+}  // namespace mongo
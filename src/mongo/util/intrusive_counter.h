@@ -35,6 +35,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/allocator.h"
+#include "mongo/util/bump_arena.h"
 
 namespace mongo {
 
@@ -124,7 +125,7 @@ public:
 #pragma warning(push)
 #pragma warning(disable : 4291)
     void operator delete(void* ptr) {
-        free(ptr);
+        BumpArena::deallocate(ptr);
     }
 #pragma warning(pop)
 
@@ -132,7 +133,7 @@ private:
     // these can only be created by calling create()
     RCString(){};
     void* operator new(size_t objSize, size_t realSize) {
-        return mongoMalloc(realSize);
+        return BumpArena::allocate(realSize);
     }
 
     int _size;  // does NOT include trailing NUL byte.